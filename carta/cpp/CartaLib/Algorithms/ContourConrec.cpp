@@ -6,6 +6,7 @@
 #include "ContourConrec.h"
 #include "IImage.h"
 #include "LineCombiner.h"
+#include "CartaLib/Trace.h"
 
 #include <cmath>
 #include <QString>
@@ -302,6 +303,8 @@ ContourConrec::setLevels( const std::vector < double > & levels )
 ContourConrec::Result
 ContourConrec::compute( NdArray::RawViewInterface * view )
 {
+    CARTA_TRACE_SCOPE( "contour", "ContourConrec::compute" );
+
     // if no input view was set, we are done
     if ( ! view || m_levels.size() == 0 ) {
         Result result( m_levels.size() );
@@ -365,7 +368,8 @@ ContourConrec::compute( NdArray::RawViewInterface * view )
             }
         }
         result.push_back( lc.getPolygons());
-        qDebug() << "compress" << v.size() << "-->" << result.back().size();
+        CARTA_TRACE_COUNT( "contour.segments", v.size() );
+        CARTA_TRACE_COUNT( "contour.polylines", result.back().size() );
     }
 
 //    Result result =
@@ -0,0 +1,138 @@
+/**
+ *
+ **/
+
+#include "CurveDecimation.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Carta
+{
+namespace Lib
+{
+namespace Algorithms
+{
+namespace
+{
+/// pixel column of an x value, -1 and columns for values outside of the range
+int
+columnOf( double x, double xMin, double scale, int columns )
+{
+    double col = std::floor( ( x - xMin ) * scale );
+    if ( col < 0 ) {
+        return - 1;
+    }
+    if ( col >= columns ) {
+        return columns;
+    }
+    return static_cast < int > ( col );
+}
+
+/// calls flush( first, last ) for every run of finite points in the same column
+/// and keep( index ) for non-finite points
+template < typename Flush, typename Keep >
+void
+forEachRun( const double * xs, const double * ys, int count,
+            double xMin, double xMax, int columns, Flush flush, Keep keep )
+{
+    // a reversed axis maps just as well
+    double scale = double( columns ) / ( xMax - xMin );
+    int runStart = - 1;
+    int runColumn = 0;
+    for ( int i = 0 ; i < count ; i++ ) {
+        if ( ! std::isfinite( xs[i] ) || ! std::isfinite( ys[i] ) ) {
+            if ( runStart >= 0 ) {
+                flush( runStart, i - 1 );
+                runStart = - 1;
+            }
+            keep( i );
+            continue;
+        }
+        int col = columnOf( xs[i], xMin, scale, columns );
+        if ( runStart >= 0 && col != runColumn ) {
+            flush( runStart, i - 1 );
+            runStart = - 1;
+        }
+        if ( runStart < 0 ) {
+            runStart = i;
+            runColumn = col;
+        }
+    }
+    if ( runStart >= 0 ) {
+        flush( runStart, count - 1 );
+    }
+} // forEachRun
+
+/// all indices, for when there is nothing to decimate
+std::vector < int >
+allIndices( int count )
+{
+    std::vector < int > indices( std::max( count, 0 ) );
+    for ( int i = 0 ; i < count ; i++ ) {
+        indices[i] = i;
+    }
+    return indices;
+}
+}
+
+std::vector < int >
+m4Decimate( const double * xs, const double * ys, int count,
+            double xMin, double xMax, int columns )
+{
+    if ( columns <= 0 || ! ( xMax != xMin ) || ! std::isfinite( xMax - xMin ) ) {
+        return allIndices( count );
+    }
+    std::vector < int > indices;
+    indices.reserve( std::min( count, 4 * ( columns + 2 ) ) );
+    auto flush = [&] ( int first, int last ) {
+        int minIndex = first;
+        int maxIndex = first;
+        for ( int i = first + 1 ; i <= last ; i++ ) {
+            if ( ys[i] < ys[minIndex] ) {
+                minIndex = i;
+            }
+            if ( ys[i] > ys[maxIndex] ) {
+                maxIndex = i;
+            }
+        }
+        int keep[4] = { first, std::min( minIndex, maxIndex ), std::max( minIndex, maxIndex ), last };
+        for ( int index : keep ) {
+            if ( indices.empty() || indices.back() != index ) {
+                indices.push_back( index );
+            }
+        }
+    };
+    auto keep = [&] ( int index ) {
+        indices.push_back( index );
+    };
+    forEachRun( xs, ys, count, xMin, xMax, columns, flush, keep );
+    return indices;
+}
+
+std::vector < int >
+maxPerColumn( const double * xs, const double * ys, int count,
+              double xMin, double xMax, int columns )
+{
+    if ( columns <= 0 || ! ( xMax != xMin ) || ! std::isfinite( xMax - xMin ) ) {
+        return allIndices( count );
+    }
+    std::vector < int > indices;
+    indices.reserve( std::min( count, columns + 2 ) );
+    auto flush = [&] ( int first, int last ) {
+        int maxIndex = first;
+        for ( int i = first + 1 ; i <= last ; i++ ) {
+            if ( ys[i] > ys[maxIndex] ) {
+                maxIndex = i;
+            }
+        }
+        indices.push_back( maxIndex );
+    };
+    auto keep = [&] ( int index ) {
+        indices.push_back( index );
+    };
+    forEachRun( xs, ys, count, xMin, xMax, columns, flush, keep );
+    return indices;
+}
+}
+}
+}
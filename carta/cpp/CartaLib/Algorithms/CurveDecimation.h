@@ -0,0 +1,39 @@
+/**
+ * Decimation of curves for drawing.
+ *
+ * A curve with many more points than there are pixel columns looks the same if, for
+ * every column, only the first, last, smallest and largest points are drawn (M4
+ * aggregation). The functions here return the indices of the points to keep, so the
+ * same selection can be applied to any arrays that go with the points.
+ *
+ * Points are grouped by runs of consecutive points that fall into the same column,
+ * so curves whose x values are not sorted are decimated correctly too. Points left or
+ * right of the visible range fall into one extra column on each side, which keeps
+ * lines leaving the plot intact.
+ **/
+
+#pragma once
+
+#include <vector>
+
+namespace Carta
+{
+namespace Lib
+{
+namespace Algorithms
+{
+/// indices (ascending) of the points to draw for a polyline through xs/ys drawn
+/// over [xMin, xMax] with the given number of pixel columns
+/// points with a non-finite coordinate are always kept, they break the curve
+std::vector < int >
+m4Decimate( const double * xs, const double * ys, int count,
+            double xMin, double xMax, int columns );
+
+/// indices (ascending) of the largest value of every run of points falling into
+/// the same pixel column, for columns/bars drawn up from a baseline
+std::vector < int >
+maxPerColumn( const double * xs, const double * ys, int count,
+              double xMin, double xMax, int columns );
+}
+}
+}
@@ -0,0 +1,296 @@
+/**
+ *
+ **/
+
+#include "FrameDelta.h"
+#include <algorithm>
+#include <vector>
+
+namespace Carta
+{
+namespace Lib
+{
+namespace Algorithms
+{
+namespace
+{
+const char MAGIC[] = "CFD1";
+const int MAGIC_SIZE = 4;
+const quint8 FLAG_KEYFRAME = 1;
+
+/// zero runs shorter than this are cheaper to send as literals
+const int MIN_ZERO_RUN = 4;
+
+void
+writeVarint( QByteArray & out, quint64 value )
+{
+    while ( value >= 0x80 ) {
+        out.append( char ( ( value & 0x7f ) | 0x80 ) );
+        value >>= 7;
+    }
+    out.append( char ( value ) );
+}
+
+/// bounds checked reader, stays failed after the first error
+class Reader
+{
+public:
+
+    Reader( const QByteArray & data, int pos = 0 )
+        : m_data( reinterpret_cast < const uchar * > ( data.constData() ) ),
+          m_size( data.size() ),
+          m_pos( pos )
+    { }
+
+    Reader( const uchar * data, int size )
+        : m_data( data ),
+          m_size( data ? size : 0 ),
+          m_pos( 0 )
+    { }
+
+    quint64
+    varint()
+    {
+        quint64 value = 0;
+        for ( int shift = 0 ; shift < 64 ; shift += 7 ) {
+            if ( m_pos >= m_size ) {
+                m_ok = false;
+                return 0;
+            }
+            uchar byte = m_data[m_pos++];
+            value |= quint64( byte & 0x7f ) << shift;
+            if ( ! ( byte & 0x80 ) ) {
+                return value;
+            }
+        }
+        m_ok = false;
+        return 0;
+    }
+
+    /// skip count bytes and return a pointer to them
+    const uchar *
+    bytes( quint64 count )
+    {
+        if ( ! m_ok || count > quint64( m_size - m_pos ) ) {
+            m_ok = false;
+            return nullptr;
+        }
+        const uchar * ptr = m_data + m_pos;
+        m_pos += count;
+        return ptr;
+    }
+
+    bool
+    ok() const { return m_ok; }
+
+private:
+
+    const uchar * m_data;
+    int m_size;
+    int m_pos;
+    bool m_ok = true;
+};
+
+/// the geometry of the tiles of a frame
+struct TileGrid {
+    TileGrid( int width, int height, int tileSize )
+        : width( width ), height( height ), tileSize( tileSize ),
+          cols( ( width + tileSize - 1 ) / tileSize ),
+          rows( ( height + tileSize - 1 ) / tileSize )
+    { }
+
+    QRect
+    tile( int index ) const
+    {
+        int x = ( index % cols ) * tileSize;
+        int y = ( index / cols ) * tileSize;
+        return QRect( x, y, std::min( tileSize, width - x ), std::min( tileSize, height - y ) );
+    }
+
+    int width, height, tileSize, cols, rows;
+};
+
+/// pack the bytes of a tile as pairs of zero run, literal run
+void
+packTile( const uchar * bytes, int count, QByteArray & out )
+{
+    int pos = 0;
+    while ( pos < count ) {
+        int zeroStart = pos;
+        while ( pos < count && bytes[pos] == 0 ) {
+            pos++;
+        }
+        int litStart = pos;
+        while ( pos < count ) {
+            if ( bytes[pos] != 0 ) {
+                pos++;
+                continue;
+            }
+            // end the literals at the first zero run worth its own pair
+            int zeroEnd = pos;
+            while ( zeroEnd < count && bytes[zeroEnd] == 0 && zeroEnd - pos < MIN_ZERO_RUN ) {
+                zeroEnd++;
+            }
+            if ( zeroEnd - pos >= MIN_ZERO_RUN || zeroEnd == count ) {
+                break;
+            }
+            pos = zeroEnd;
+        }
+        writeVarint( out, litStart - zeroStart );
+        writeVarint( out, pos - litStart );
+        out.append( reinterpret_cast < const char * > ( bytes + litStart ), pos - litStart );
+    }
+} // packTile
+}
+
+FrameDeltaEncoder::FrameDeltaEncoder( int tileSize, int keyframeInterval )
+    : m_tileSize( std::max( tileSize, 1 ) ),
+      m_keyframeInterval( keyframeInterval )
+{ }
+
+QByteArray
+FrameDeltaEncoder::encode( const QImage & input )
+{
+    QImage frame = input;
+    if ( frame.format() != QImage::Format_ARGB32_Premultiplied ) {
+        frame = frame.convertToFormat( QImage::Format_ARGB32_Premultiplied );
+    }
+    bool keyframe = m_keyframeRequested || m_previous.size() != frame.size()
+                    || ( m_keyframeInterval > 0 && m_frameNumber % m_keyframeInterval == 0 );
+
+    TileGrid grid( frame.width(), frame.height(), m_tileSize );
+    int tileCount = frame.isNull() ? 0 : grid.cols * grid.rows;
+
+    QByteArray tiles;
+    std::vector < uchar > bytes( m_tileSize * m_tileSize * 4 );
+    QByteArray packed;
+    int sent = 0;
+    int lastSent = - 1;
+    for ( int index = 0 ; index < tileCount ; index++ ) {
+        QRect rect = grid.tile( index );
+        bool changed = keyframe;
+        uchar * out = bytes.data();
+        for ( int y = rect.top() ; y <= rect.bottom() ; y++ ) {
+            const QRgb * line = reinterpret_cast < const QRgb * > ( frame.constScanLine( y ) );
+            const QRgb * prevLine = keyframe ? nullptr
+                                    : reinterpret_cast < const QRgb * > ( m_previous.constScanLine( y ) );
+            for ( int x = rect.left() ; x <= rect.right() ; x++ ) {
+                quint32 pixel = line[x] ^ ( prevLine ? prevLine[x] : 0 );
+                changed = changed || pixel != 0;
+                * out++ = pixel & 0xff;
+                * out++ = ( pixel >> 8 ) & 0xff;
+                * out++ = ( pixel >> 16 ) & 0xff;
+                * out++ = pixel >> 24;
+            }
+        }
+        if ( ! changed ) {
+            continue;
+        }
+        packed.clear();
+        packTile( bytes.data(), out - bytes.data(), packed );
+        writeVarint( tiles, index - lastSent );
+        writeVarint( tiles, packed.size() );
+        tiles.append( packed );
+        lastSent = index;
+        sent++;
+    }
+
+    QByteArray packet( MAGIC, MAGIC_SIZE );
+    packet.append( char ( keyframe ? FLAG_KEYFRAME : 0 ) );
+    writeVarint( packet, m_frameNumber );
+    writeVarint( packet, frame.width() );
+    writeVarint( packet, frame.height() );
+    writeVarint( packet, m_tileSize );
+    writeVarint( packet, sent );
+    packet.append( tiles );
+
+    m_previous = frame;
+    m_frameNumber++;
+    m_keyframeRequested = false;
+    m_lastTileCount = sent;
+    m_lastKeyframe = keyframe;
+    return packet;
+} // encode
+
+void
+FrameDeltaEncoder::requestKeyframe()
+{
+    m_keyframeRequested = true;
+}
+
+void
+FrameDeltaEncoder::reset()
+{
+    m_previous = QImage();
+    m_frameNumber = 0;
+    m_keyframeRequested = true;
+}
+
+bool
+FrameDeltaDecoder::decode( const QByteArray & packet )
+{
+    if ( ! packet.startsWith( QByteArray( MAGIC, MAGIC_SIZE ) ) || packet.size() <= MAGIC_SIZE ) {
+        return false;
+    }
+    bool keyframe = quint8( packet[MAGIC_SIZE] ) & FLAG_KEYFRAME;
+    Reader reader( packet, MAGIC_SIZE + 1 );
+    qint64 frameNumber = reader.varint();
+    int width = reader.varint();
+    int height = reader.varint();
+    int tileSize = reader.varint();
+    quint64 tileCount = reader.varint();
+    if ( ! reader.ok() || tileSize <= 0 || width < 0 || height < 0 ) {
+        return false;
+    }
+
+    if ( keyframe ) {
+        m_frame = QImage( width, height, QImage::Format_ARGB32_Premultiplied );
+        m_frame.fill( 0 );
+    }
+    else if ( m_frame.isNull() || m_frame.size() != QSize( width, height )
+              || frameNumber != m_frameNumber + 1 ) {
+        return false;
+    }
+
+    TileGrid grid( width, height, tileSize );
+    quint64 gridTiles = quint64( grid.cols ) * grid.rows;
+    quint64 index = quint64( - 1 );
+    for ( quint64 i = 0 ; i < tileCount ; i++ ) {
+        index += reader.varint();
+        quint64 packedSize = reader.varint();
+        if ( ! reader.ok() || index >= gridTiles ) {
+            m_frame = QImage();
+            return false;
+        }
+        const uchar * tile = reader.bytes( packedSize );
+        Reader tileReader( tile, int ( packedSize ) );
+        QRect rect = grid.tile( index );
+        quint64 byteCount = quint64( rect.width() ) * rect.height() * 4;
+        quint64 pos = 0;
+        while ( reader.ok() && pos < byteCount ) {
+            pos += tileReader.varint();
+            quint64 literals = tileReader.varint();
+            const uchar * bytes = tileReader.bytes( literals );
+            if ( ! tileReader.ok() || pos + literals > byteCount ) {
+                m_frame = QImage();
+                return false;
+            }
+            for ( quint64 k = 0 ; k < literals ; k++, pos++ ) {
+                int pixel = pos / 4;
+                int x = rect.left() + pixel % rect.width();
+                int y = rect.top() + pixel / rect.width();
+                QRgb * line = reinterpret_cast < QRgb * > ( m_frame.scanLine( y ) );
+                line[x] ^= quint32( bytes[k] ) << ( 8 * ( pos % 4 ) );
+            }
+        }
+        if ( ! reader.ok() ) {
+            m_frame = QImage();
+            return false;
+        }
+    }
+    m_frameNumber = frameNumber;
+    return true;
+} // decode
+}
+}
+}
@@ -0,0 +1,113 @@
+/**
+ * Lossless frame-difference encoding of rendered views, for streaming animations.
+ *
+ * Successive frames of a channel animation differ in few pixels. The encoder splits
+ * each frame into square tiles, XORs every tile with the same tile of the previous
+ * frame and sends only the tiles that changed. The XOR of similar frames is mostly
+ * zero bytes, so a tile is packed as runs of zero bytes and literal bytes, which is
+ * cheap to encode and trivial to decode in a browser. Every N-th frame, the first
+ * frame and any frame of a new size are keyframes that carry all tiles. Layout:
+ *
+ *   "CFD1"            magic
+ *   u8                flags, bit 0 = keyframe
+ *   varint            frame number
+ *   varint w, h       frame size in pixels
+ *   varint            tile size in pixels
+ *   varint n          number of tiles in the packet
+ *   n times:
+ *     varint          tile index minus the previous tile index plus one (tiles are
+ *                     numbered row by row and sent in increasing order)
+ *     varint          size of the packed tile in bytes
+ *     packed tile     pairs of varint zero run, varint literal count, literal bytes
+ *
+ * A tile is the XOR of its pixels (against zero for keyframes), row by row, each
+ * pixel as four bytes b, g, r, a of a premultiplied ARGB32 pixel. Integers are
+ * LEB128 varints, as in VG streams.
+ *
+ * The HTML5 client decodes the same format in skel.boundWidgets.View.FrameDelta.
+ **/
+
+#pragma once
+
+#include "CartaLib/CartaLib.h"
+#include <QByteArray>
+#include <QImage>
+
+namespace Carta
+{
+namespace Lib
+{
+namespace Algorithms
+{
+/// turns the frames of a view into a stream of delta packets
+class FrameDeltaEncoder
+{
+    CLASS_BOILERPLATE( FrameDeltaEncoder );
+
+public:
+
+    /// \param tileSize edge of the square tiles in pixels
+    /// \param keyframeInterval every keyframeInterval-th frame is a keyframe
+    FrameDeltaEncoder( int tileSize = 64, int keyframeInterval = 30 );
+
+    /// encode the next frame
+    /// \return the packet to send
+    QByteArray
+    encode( const QImage & frame );
+
+    /// make the next frame a keyframe, e.g. when a client joins or lost a packet
+    void
+    requestKeyframe();
+
+    /// number of tiles in the last packet
+    int
+    lastTileCount() const { return m_lastTileCount; }
+
+    /// was the last packet a keyframe
+    bool
+    lastWasKeyframe() const { return m_lastKeyframe; }
+
+    /// forget the previous frame, the next frame will be a keyframe
+    void
+    reset();
+
+private:
+
+    int m_tileSize;
+    int m_keyframeInterval;
+    qint64 m_frameNumber = 0;
+    bool m_keyframeRequested = true;
+    int m_lastTileCount = 0;
+    bool m_lastKeyframe = false;
+    QImage m_previous;
+};
+
+/// rebuilds the frames from a stream of delta packets
+class FrameDeltaDecoder
+{
+    CLASS_BOILERPLATE( FrameDeltaDecoder );
+
+public:
+
+    /// apply a packet to the current frame
+    /// \return false if the packet is invalid or a delta that does not follow the
+    /// current frame; the frame is then invalid until the next keyframe
+    bool
+    decode( const QByteArray & packet );
+
+    /// the current frame, null until the first keyframe was decoded
+    const QImage &
+    frame() const { return m_frame; }
+
+    /// number of the current frame
+    qint64
+    frameNumber() const { return m_frameNumber; }
+
+private:
+
+    QImage m_frame;
+    qint64 m_frameNumber = - 1;
+};
+}
+}
+}
@@ -0,0 +1,168 @@
+/**
+ *
+ **/
+
+#include "PlusCompositor.h"
+#include <algorithm>
+
+#if defined( __SSE2__ )
+#include <emmintrin.h>
+#endif
+
+namespace Carta
+{
+namespace Lib
+{
+namespace Algorithms
+{
+namespace
+{
+/// a layer ready for compositing
+struct Input
+{
+    QImage image;
+    quint32 mask;
+
+    /// opacity in 8.8 fixed point, 256 = opaque
+    uint k;
+
+    /// whether the image is already premultiplied
+    bool premultiplied;
+};
+
+/// x / 255 rounded, valid for x <= 255 * 255
+inline uint
+div255( uint x )
+{
+    x += 128;
+    return ( x + ( x >> 8 ) ) >> 8;
+}
+
+/// mask, premultiply, scale and add a row of pixels, one pixel at a time
+void
+rowScalar( QRgb * dst, const QRgb * src, int width, const Input & in )
+{
+    for ( int x = 0 ; x < width ; x++ ) {
+        quint32 p = src[x] & in.mask;
+        quint32 d = dst[x];
+        uint a = p >> 24;
+        uint m = in.premultiplied ? 255 : a;
+        quint32 out = std::min < uint > ( ( ( a * in.k ) >> 8 ) + ( d >> 24 ), 255 ) << 24;
+        for ( int shift = 0 ; shift < 24 ; shift += 8 ) {
+            uint c = div255( ( ( p >> shift ) & 0xff ) * m );
+            c = ( ( c * in.k ) >> 8 ) + ( ( d >> shift ) & 0xff );
+            out |= std::min < uint > ( c, 255 ) << shift;
+        }
+        dst[x] = out;
+    }
+}
+
+#if defined( __SSE2__ )
+/// same as rowScalar, four pixels at a time with 16 bit lanes
+void
+rowSse2( QRgb * dst, const QRgb * src, int width, const Input & in )
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i maskv = _mm_set1_epi32( in.mask );
+    const __m128i kv = _mm_set1_epi16( in.k );
+    const __m128i c128 = _mm_set1_epi16( 128 );
+    const __m128i c255 = _mm_set1_epi16( 255 );
+
+    // lanes holding alpha, the alpha channel itself is never premultiplied
+    const __m128i alphaLanes = _mm_set_epi16( - 1, 0, 0, 0, - 1, 0, 0, 0 );
+
+    auto scale = [&] ( __m128i v ) -> __m128i {
+        __m128i m = c255;
+        if ( ! in.premultiplied ) {
+            m = _mm_shufflelo_epi16( v, _MM_SHUFFLE( 3, 3, 3, 3 ) );
+            m = _mm_shufflehi_epi16( m, _MM_SHUFFLE( 3, 3, 3, 3 ) );
+            m = _mm_or_si128( _mm_andnot_si128( alphaLanes, m ),
+                              _mm_and_si128( alphaLanes, c255 ) );
+        }
+        __m128i t = _mm_add_epi16( _mm_mullo_epi16( v, m ), c128 );
+        t = _mm_srli_epi16( _mm_add_epi16( t, _mm_srli_epi16( t, 8 ) ), 8 );
+        return _mm_srli_epi16( _mm_mullo_epi16( t, kv ), 8 );
+    };
+
+    int x = 0;
+    for ( ; x + 4 <= width ; x += 4 ) {
+        __m128i p = _mm_and_si128(
+            _mm_loadu_si128( reinterpret_cast < const __m128i * > ( src + x ) ), maskv );
+        __m128i lo = scale( _mm_unpacklo_epi8( p, zero ) );
+        __m128i hi = scale( _mm_unpackhi_epi8( p, zero ) );
+        __m128i s = _mm_packus_epi16( lo, hi );
+        __m128i * dptr = reinterpret_cast < __m128i * > ( dst + x );
+        _mm_storeu_si128( dptr, _mm_adds_epu8( _mm_loadu_si128( dptr ), s ) );
+    }
+    rowScalar( dst + x, src + x, width - x, in );
+} // rowSse2
+#endif
+
+void
+compositeImpl( QImage & dst, const std::vector < PlusCompositor::Layer > & layers, bool simd )
+{
+    if ( dst.isNull() ) {
+        return;
+    }
+    if ( dst.format() != QImage::Format_ARGB32_Premultiplied ) {
+        dst = dst.convertToFormat( QImage::Format_ARGB32_Premultiplied );
+    }
+
+    // prepare the inputs, images are only converted if they are in an unusual format
+    std::vector < Input > inputs;
+    for ( const PlusCompositor::Layer & layer : layers ) {
+        uint k = qRound( std::max( 0.0, std::min( layer.alpha, 1.0 ) ) * 256 );
+        if ( layer.image.isNull() || k == 0 ) {
+            continue;
+        }
+        Input in;
+        in.image = layer.image;
+        QImage::Format format = in.image.format();
+        if ( format != QImage::Format_ARGB32 && format != QImage::Format_RGB32
+             && format != QImage::Format_ARGB32_Premultiplied ) {
+            in.image = in.image.convertToFormat( QImage::Format_ARGB32_Premultiplied );
+        }
+        in.premultiplied = in.image.format() == QImage::Format_ARGB32_Premultiplied;
+        in.mask = layer.mask;
+        in.k = k;
+        inputs.push_back( in );
+    }
+
+    auto row = rowScalar;
+#if defined( __SSE2__ )
+    if ( simd ) {
+        row = rowSse2;
+    }
+#else
+    Q_UNUSED( simd );
+#endif
+
+    // make sure dst is detached before taking raw pointers
+    dst.bits();
+    for ( int y = 0 ; y < dst.height() ; y++ ) {
+        QRgb * dstRow = reinterpret_cast < QRgb * > ( dst.scanLine( y ) );
+        for ( const Input & in : inputs ) {
+            if ( y >= in.image.height() ) {
+                continue;
+            }
+            const QRgb * srcRow = reinterpret_cast < const QRgb * > ( in.image.constScanLine( y ) );
+            row( dstRow, srcRow, std::min( dst.width(), in.image.width() ), in );
+        }
+    }
+} // compositeImpl
+}
+
+void
+PlusCompositor::composite( QImage & dst, const std::vector < Layer > & layers )
+{
+    compositeImpl( dst, layers, true );
+}
+
+void
+PlusCompositor::compositeScalar( QImage & dst, const std::vector < Layer > & layers )
+{
+    compositeImpl( dst, layers, false );
+}
+}
+}
+}
@@ -0,0 +1,56 @@
+/**
+ * Fused compositing of layers using the 'plus' composition mode.
+ *
+ * Equivalent to painting each layer with QPainter::CompositionMode_Plus after
+ * masking its pixels with an RGB mask and setting the painter's opacity, but done in
+ * a single pass over the destination without temporary images. Each destination row
+ * is visited once, all layers are accumulated into it while it is hot in the cache.
+ *
+ * The destination is kept premultiplied, which is what CompositionMode_Plus
+ * operates on.
+ **/
+
+#pragma once
+
+#include <QImage>
+#include <vector>
+
+namespace Carta
+{
+namespace Lib
+{
+namespace Algorithms
+{
+class PlusCompositor
+{
+public:
+
+    /// one input layer
+    struct Layer
+    {
+        Layer( const QImage & p_image, quint32 p_mask = 0xffffffff, double p_alpha = 1.0 )
+            : image( p_image ), mask( p_mask ), alpha( p_alpha )
+        { }
+
+        QImage image;
+
+        /// ARGB mask applied to every source pixel
+        quint32 mask;
+
+        /// opacity of the whole layer, 0..1
+        double alpha;
+    };
+
+    /// add the layers to dst, saturating each channel
+    /// dst is converted to Format_ARGB32_Premultiplied if it is not already
+    /// layers are drawn at (0,0) and clipped to dst
+    static void
+    composite( QImage & dst, const std::vector < Layer > & layers );
+
+    /// same as composite(), using scalar code only, useful for testing
+    static void
+    compositeScalar( QImage & dst, const std::vector < Layer > & layers );
+};
+}
+}
+}
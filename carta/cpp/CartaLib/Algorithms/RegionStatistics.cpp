@@ -0,0 +1,114 @@
+/**
+ *
+ **/
+
+#include "RegionStatistics.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Carta
+{
+namespace Lib
+{
+namespace Algorithms
+{
+double
+RegionMoments::mean() const
+{
+    return count > 0 ? sum / count : std::nan( "" );
+}
+
+double
+RegionMoments::rms() const
+{
+    return count > 0 ? std::sqrt( sumSq / count ) : std::nan( "" );
+}
+
+double
+RegionMoments::sigma() const
+{
+    if ( count < 2 ) {
+        return count == 1 ? 0 : std::nan( "" );
+    }
+    double variance = ( sumSq - sum * sum / count ) / ( count - 1 );
+    return std::sqrt( std::max( variance, 0.0 ) );
+}
+
+void
+RegionMoments::merge( const RegionMoments & other )
+{
+    if ( other.count == 0 ) {
+        return;
+    }
+    if ( count == 0 || other.min < min ) {
+        min = other.min;
+        minX = other.minX;
+        minY = other.minY;
+    }
+    if ( count == 0 || other.max > max ) {
+        max = other.max;
+        maxX = other.maxX;
+        maxY = other.maxY;
+    }
+    count += other.count;
+    sum += other.sum;
+    sumSq += other.sumSq;
+}
+
+RegionMoments
+accumulateRegion( const RegionMask & mask, const float * plane, int width, int height )
+{
+    RegionMoments moments;
+    if ( ! plane || width <= 0 || height <= 0 ) {
+        return moments;
+    }
+    double min = 0, max = 0;
+    const float * minPtr = nullptr;
+    const float * maxPtr = nullptr;
+    for ( const RegionMask::Run & run : mask.getRuns() ) {
+        if ( run.y < 0 || run.y >= height ) {
+            continue;
+        }
+        int x0 = std::max( run.xMin, 0 );
+        int x1 = std::min( run.xMax, width - 1 );
+        const float * row = plane + static_cast < qint64 > ( run.y ) * width;
+
+        // partial sums per run keep the rounding error of long sums small
+        double sum = 0, sumSq = 0;
+        qint64 count = 0;
+        for ( int x = x0 ; x <= x1 ; x++ ) {
+            double val = row[x];
+            if ( ! std::isfinite( val ) ) {
+                continue;
+            }
+            sum += val;
+            sumSq += val * val;
+            if ( ! minPtr || val < min ) {
+                min = val;
+                minPtr = row + x;
+            }
+            if ( ! maxPtr || val > max ) {
+                max = val;
+                maxPtr = row + x;
+            }
+            count++;
+        }
+        moments.sum += sum;
+        moments.sumSq += sumSq;
+        moments.count += count;
+    }
+    if ( moments.count > 0 ) {
+        moments.min = min;
+        moments.max = max;
+        qint64 minOffset = minPtr - plane;
+        qint64 maxOffset = maxPtr - plane;
+        moments.minX = minOffset % width;
+        moments.minY = minOffset / width;
+        moments.maxX = maxOffset % width;
+        moments.maxY = maxOffset / width;
+    }
+    return moments;
+}
+}
+}
+}
@@ -0,0 +1,58 @@
+/**
+ * Statistics of the pixels of regions on an image plane.
+ *
+ * Each region is described by its rasterised mask, so only the pixels of the region
+ * are visited, run by run, without building a sub-image for it. The moments of
+ * several regions (or of several parts of one region) can be merged, which lets the
+ * caller spread the work over threads.
+ **/
+
+#pragma once
+
+#include "CartaLib/RegionMask.h"
+
+namespace Carta
+{
+namespace Lib
+{
+namespace Algorithms
+{
+/// running moments of a set of pixels, NaNs and infinities are skipped
+struct RegionMoments
+{
+    /// number of finite pixels
+    qint64 count = 0;
+    double sum = 0;
+    double sumSq = 0;
+    double min = 0;
+    double max = 0;
+
+    /// location of the minimum and maximum
+    int minX = 0;
+    int minY = 0;
+    int maxX = 0;
+    int maxY = 0;
+
+    double
+    mean() const;
+
+    double
+    rms() const;
+
+    /// sample standard deviation (divided by count - 1)
+    double
+    sigma() const;
+
+    /// combine with the moments of other pixels
+    void
+    merge( const RegionMoments & other );
+};
+
+/// accumulate the pixels of a mask on a plane
+/// \param plane width * height values, x varies fastest
+/// pixels of the mask outside of the plane are ignored
+RegionMoments
+accumulateRegion( const RegionMask & mask, const float * plane, int width, int height );
+}
+}
+}
@@ -0,0 +1,79 @@
+#include "BitMask.h"
+
+namespace Carta {
+namespace Lib {
+
+const int BitMask::WORD_BITS;
+const BitMask::Word BitMask::FULL_WORD;
+
+BitMask::BitMask() :
+    m_size( 0 ){
+}
+
+BitMask::BitMask( qint64 size, bool valid ) :
+    m_words( ( qMax<qint64>( size, 0 ) + WORD_BITS - 1 ) / WORD_BITS, valid ? FULL_WORD : 0 ),
+    m_size( qMax<qint64>( size, 0 ) ){
+    _clearTail();
+}
+
+void BitMask::_clearTail(){
+    int tailBits = m_size % WORD_BITS;
+    if ( tailBits > 0 ){
+        m_words.back() &= ( Word( 1 ) << tailBits ) - 1;
+    }
+}
+
+qint64 BitMask::countValid() const {
+    qint64 count = 0;
+    for ( Word word : m_words ){
+        count += qPopulationCount( word );
+    }
+    return count;
+}
+
+bool BitMask::get( qint64 index ) const {
+    Q_ASSERT( 0 <= index && index < m_size );
+    return ( m_words[index / WORD_BITS] >> ( index % WORD_BITS ) ) & 1;
+}
+
+const std::vector<BitMask::Word>& BitMask::getWords() const {
+    return m_words;
+}
+
+bool BitMask::isAllValid() const {
+    return countValid() == m_size;
+}
+
+bool BitMask::isEmpty() const {
+    return m_size == 0;
+}
+
+BitMask& BitMask::operator&=( const BitMask& other ){
+    Q_ASSERT( m_size == other.m_size );
+    int wordCount = qMin( m_words.size(), other.m_words.size() );
+    for ( int i = 0; i < wordCount; i++ ){
+        m_words[i] &= other.m_words[i];
+    }
+    return *this;
+}
+
+void BitMask::set( qint64 index, bool valid ){
+    Q_ASSERT( 0 <= index && index < m_size );
+    Word bit = Word( 1 ) << ( index % WORD_BITS );
+    if ( valid ){
+        m_words[index / WORD_BITS] |= bit;
+    }
+    else {
+        m_words[index / WORD_BITS] &= ~bit;
+    }
+}
+
+qint64 BitMask::size() const {
+    return m_size;
+}
+
+BitMask::~BitMask(){
+}
+
+}
+}
@@ -0,0 +1,197 @@
+/**
+ * A pixel mask stored as one bit per pixel.
+ *
+ * Bits are set for valid pixels and packed into 64 bit words, so a mask takes an
+ * eighth of the memory of a mask of booleans.  Runs of valid or masked pixels are
+ * found a word at a time; the common case of a word without masked pixels costs a
+ * single comparison.
+ **/
+
+#pragma once
+
+#include <QtGlobal>
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace Carta {
+namespace Lib {
+
+class BitMask {
+public:
+
+    typedef quint64 Word;
+    static const int WORD_BITS = 64;
+
+    /**
+     * Constructs an empty mask.
+     */
+    BitMask();
+
+    /**
+     * Constructs a mask with all pixels valid or all pixels masked.
+     * @param size - the number of pixels.
+     * @param valid - true if the pixels are valid; false if they are masked.
+     */
+    explicit BitMask( qint64 size, bool valid = true );
+
+    /**
+     * Packs a mask of booleans.
+     * @param values - true for valid pixels.
+     * @param count - the number of pixels.
+     * @return - the packed mask.
+     */
+    template <typename Bool>
+    static BitMask fromBools( const Bool* values, qint64 count );
+
+    /**
+     * Return the number of pixels in the mask.
+     * @return - the number of pixels.
+     */
+    qint64 size() const;
+
+    /**
+     * Returns true if the mask has no pixels.
+     * @return - true if the mask is empty; false otherwise.
+     */
+    bool isEmpty() const;
+
+    /**
+     * Returns true if the pixel is valid.
+     * @param index - the index of a pixel.
+     * @return - true if the pixel is valid; false if it is masked.
+     */
+    bool get( qint64 index ) const;
+
+    /**
+     * Mark a pixel as valid or masked.
+     * @param index - the index of a pixel.
+     * @param valid - true if the pixel is valid; false if it is masked.
+     */
+    void set( qint64 index, bool valid );
+
+    /**
+     * Return the number of valid pixels.
+     * @return - the number of valid pixels.
+     */
+    qint64 countValid() const;
+
+    /**
+     * Returns true if no pixel is masked.
+     * @return - true if all pixels are valid; false otherwise.
+     */
+    bool isAllValid() const;
+
+    /**
+     * Masks every pixel that is masked in the other mask.
+     * @param other - a mask of the same size.
+     * @return - this mask.
+     */
+    BitMask& operator&=( const BitMask& other );
+
+    /**
+     * Calls func( first, count, valid ) for every run of pixels that are all valid
+     * or all masked, in order.
+     * @param func - the function to call for each run.
+     */
+    template <typename Func>
+    void forEachRun( Func func ) const;
+
+    /**
+     * Replace the masked values by NaN, or leave them alone for types without NaN.
+     * @param values - one value per pixel of the mask.
+     */
+    template <typename T>
+    void blankMasked( T* values ) const;
+
+    /**
+     * Return the words of the mask; the bits past the last pixel are clear.
+     * @return - the packed bits, pixel i is bit i % 64 of word i / 64.
+     */
+    const std::vector<Word>& getWords() const;
+
+    virtual ~BitMask();
+
+private:
+
+    static const Word FULL_WORD = ~Word( 0 );
+
+    void _clearTail();
+
+    std::vector<Word> m_words;
+    qint64 m_size;
+};
+
+
+template <typename Bool>
+BitMask BitMask::fromBools( const Bool* values, qint64 count ){
+    BitMask mask( count, false );
+    qint64 wordCount = mask.m_words.size();
+    for ( qint64 w = 0; w < wordCount; w++ ){
+        qint64 first = w * WORD_BITS;
+        int bitCount = qMin<qint64>( WORD_BITS, count - first );
+        Word word = 0;
+        for ( int b = 0; b < bitCount; b++ ){
+            if ( values[first + b] ){
+                word |= Word( 1 ) << b;
+            }
+        }
+        mask.m_words[w] = word;
+    }
+    return mask;
+}
+
+template <typename Func>
+void BitMask::forEachRun( Func func ) const {
+    qint64 runStart = 0;
+    bool runValid = true;
+    qint64 wordCount = m_words.size();
+    for ( qint64 w = 0; w < wordCount; w++ ){
+        Word word = m_words[w];
+        qint64 first = w * WORD_BITS;
+        int bitCount = qMin<qint64>( WORD_BITS, m_size - first );
+        Word full = bitCount == WORD_BITS ? FULL_WORD : ( Word( 1 ) << bitCount ) - 1;
+        //A word of all valid or all masked pixels extends or starts a run as a whole.
+        if ( word == full || word == 0 ){
+            bool valid = word != 0;
+            if ( valid != runValid ){
+                if ( first > runStart ){
+                    func( runStart, first - runStart, runValid );
+                }
+                runStart = first;
+                runValid = valid;
+            }
+            continue;
+        }
+        for ( int b = 0; b < bitCount; b++ ){
+            bool valid = ( word >> b ) & 1;
+            if ( valid != runValid ){
+                qint64 index = first + b;
+                if ( index > runStart ){
+                    func( runStart, index - runStart, runValid );
+                }
+                runStart = index;
+                runValid = valid;
+            }
+        }
+    }
+    if ( m_size > runStart ){
+        func( runStart, m_size - runStart, runValid );
+    }
+}
+
+template <typename T>
+void BitMask::blankMasked( T* values ) const {
+    if ( !std::numeric_limits<T>::has_quiet_NaN ){
+        return;
+    }
+    const T blank = std::numeric_limits<T>::quiet_NaN();
+    forEachRun( [values, blank] ( qint64 first, qint64 count, bool valid ){
+        if ( !valid ){
+            std::fill( values + first, values + first + count, blank );
+        }
+    });
+}
+
+}
+}
@@ -13,9 +13,11 @@ SOURCES += \
     CartaLib.cpp \
     HtmlString.cpp \
     LinearMap.cpp \
+    UnitConversionPlan.cpp \
     Hooks/ColormapsScalar.cpp \
     Hooks/ConversionIntensityHook.cpp \
     Hooks/ConversionSpectralHook.cpp \
+    Hooks/ConversionInfoHook.cpp \
     Hooks/Histogram.cpp \
     Hooks/HistogramResult.cpp \
     Hooks/ProfileHook.cpp \
@@ -37,23 +39,35 @@ SOURCES += \
     PWLinear.cpp \
     StatInfo.cpp \
     VectorGraphics/VGList.cpp \
+    VectorGraphics/VGStream.cpp \
     VectorGraphics/BetterQPainter.cpp \
     Algorithms/ContourConrec.cpp \
     IWcsGridRenderService.cpp \
     ContourSet.cpp \
+    CurveBuffer.cpp \
+    BitMask.cpp \
+    Trace.cpp \
     Algorithms/LineCombiner.cpp \
+    Algorithms/PlusCompositor.cpp \
+    Algorithms/RegionStatistics.cpp \
+    Algorithms/CurveDecimation.cpp \
+    Algorithms/FrameDelta.cpp \
     IImageRenderService.cpp \
     IRemoteVGView.cpp \
-    RegionInfo.cpp
+    RegionInfo.cpp \
+    RegionIndex.cpp \
+    RegionMask.cpp
 
 HEADERS += \
     CartaLib.h\
     cartalib_global.h \
     HtmlString.h \
     LinearMap.h \
+    UnitConversionPlan.h \
     Hooks/ColormapsScalar.h \
     Hooks/ConversionIntensityHook.h \
     Hooks/ConversionSpectralHook.h \
+    Hooks/ConversionInfoHook.h \
     Hooks/Histogram.h \
     Hooks/HistogramResult.h \
     Hooks/ProfileHook.h \
@@ -73,6 +87,7 @@ HEADERS += \
     ICoordinateFormatter.h \
     IPlotLabelGenerator.h \
     Hooks/LoadAstroImage.h \
+    Hooks/PreRenderRaw.h \
     TPixelPipeline/IScalar2Scalar.h \
     PixelPipeline/IPixelPipeline.h \
     PixelPipeline/CustomizablePixelPipeline.h \
@@ -80,6 +95,7 @@ HEADERS += \
     PWLinear.h \
     StatInfo.h \
     VectorGraphics/VGList.h \
+    VectorGraphics/VGStream.h \
     Hooks/GetWcsGridRenderer.h \
     Hooks/LoadPlugin.h \
     VectorGraphics/BetterQPainter.h \
@@ -87,13 +103,23 @@ HEADERS += \
     IWcsGridRenderService.h \
     IContourGeneratorService.h \
     ContourSet.h \
+    CurveBuffer.h \
+    BitMask.h \
+    Trace.h \
+    LruCache.h \
     Algorithms/LineCombiner.h \
+    Algorithms/PlusCompositor.h \
+    Algorithms/RegionStatistics.h \
+    Algorithms/CurveDecimation.h \
+    Algorithms/FrameDelta.h \
     Hooks/GetInitialFileList.h \
     Hooks/Initialize.h \
     IImageRenderService.h \
     Hooks/GetImageRenderService.h \
     IRemoteVGView.h \
-    RegionInfo.h
+    RegionInfo.h \
+    RegionIndex.h \
+    RegionMask.h
 
 unix {
     target.path = /usr/lib
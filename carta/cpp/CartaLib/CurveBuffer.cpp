@@ -0,0 +1,161 @@
+#include "CurveBuffer.h"
+#include <QSysInfo>
+
+namespace Carta {
+namespace Lib {
+
+namespace {
+
+//True if doubles are written to the stream as they are laid out in memory, so
+//whole columns can be copied in one go.
+bool isNativeStream( const QDataStream& stream ){
+    bool littleEndian = QSysInfo::ByteOrder == QSysInfo::LittleEndian;
+    bool streamLittleEndian = stream.byteOrder() == QDataStream::LittleEndian;
+    return littleEndian == streamLittleEndian &&
+            stream.floatingPointPrecision() == QDataStream::DoublePrecision;
+}
+
+void writeColumn( QDataStream& out, const CurveBuffer::Column& column, bool raw ){
+    if ( raw ){
+        out.writeRawData( reinterpret_cast<const char*>( column.data() ),
+                column.size() * sizeof( double ) );
+    }
+    else {
+        for ( double value : column ){
+            out << value;
+        }
+    }
+}
+
+void readColumn( QDataStream& in, CurveBuffer::Column& column, bool raw ){
+    if ( raw ){
+        int bytes = column.size() * sizeof( double );
+        if ( in.readRawData( reinterpret_cast<char*>( column.data() ), bytes ) != bytes ){
+            in.setStatus( QDataStream::ReadPastEnd );
+        }
+    }
+    else {
+        for ( double& value : column ){
+            in >> value;
+        }
+    }
+}
+}
+
+CurveBuffer::CurveBuffer() :
+    m_xs( _empty() ),
+    m_ys( _empty() ){
+}
+
+CurveBuffer::CurveBuffer( Column xs, Column ys ) :
+    m_xs( std::make_shared<const Column>( std::move( xs ) ) ),
+    m_ys( std::make_shared<const Column>( std::move( ys ) ) ){
+    Q_ASSERT( m_xs->size() == m_ys->size() );
+}
+
+CurveBuffer::Column& CurveBuffer::_detach( std::shared_ptr<const Column>& column ){
+    if ( column.use_count() > 1 ){
+        column = std::make_shared<const Column>( *column );
+    }
+    //The column was created non-const and is not shared, so it may be written.
+    return const_cast<Column&>( *column );
+}
+
+const std::shared_ptr<const CurveBuffer::Column>& CurveBuffer::_empty(){
+    static const std::shared_ptr<const Column> empty = std::make_shared<const Column>();
+    return empty;
+}
+
+CurveBuffer CurveBuffer::fromPairs( const std::vector<std::pair<double,double> >& data ){
+    int dataCount = data.size();
+    Column xs( dataCount );
+    Column ys( dataCount );
+    for ( int i = 0; i < dataCount; i++ ){
+        xs[i] = data[i].first;
+        ys[i] = data[i].second;
+    }
+    return CurveBuffer( std::move( xs ), std::move( ys ) );
+}
+
+const CurveBuffer::Column& CurveBuffer::getX() const {
+    return *m_xs;
+}
+
+CurveBuffer::Column& CurveBuffer::getXForWrite(){
+    return _detach( m_xs );
+}
+
+const CurveBuffer::Column& CurveBuffer::getY() const {
+    return *m_ys;
+}
+
+CurveBuffer::Column& CurveBuffer::getYForWrite(){
+    return _detach( m_ys );
+}
+
+bool CurveBuffer::isEmpty() const {
+    return m_xs->empty();
+}
+
+bool CurveBuffer::isSharedWith( const CurveBuffer& other ) const {
+    return m_xs == other.m_xs && m_ys == other.m_ys;
+}
+
+void CurveBuffer::setX( Column xs ){
+    Q_ASSERT( xs.size() == m_ys->size() );
+    m_xs = std::make_shared<const Column>( std::move( xs ) );
+}
+
+void CurveBuffer::setY( Column ys ){
+    Q_ASSERT( ys.size() == m_xs->size() );
+    m_ys = std::make_shared<const Column>( std::move( ys ) );
+}
+
+int CurveBuffer::size() const {
+    return m_xs->size();
+}
+
+std::vector<std::pair<double,double> > CurveBuffer::toPairs() const {
+    int dataCount = size();
+    std::vector<std::pair<double,double> > data( dataCount );
+    for ( int i = 0; i < dataCount; i++ ){
+        data[i] = std::pair<double,double>( (*m_xs)[i], (*m_ys)[i] );
+    }
+    return data;
+}
+
+QDataStream &operator<<(QDataStream& out, const CurveBuffer& curve ){
+    bool raw = isNativeStream( out );
+    out << curve.size();
+    writeColumn( out, curve.getX(), raw );
+    writeColumn( out, curve.getY(), raw );
+    return out;
+}
+
+QDataStream &operator>>(QDataStream& in, CurveBuffer& curve ){
+    int dataCount = 0;
+    in >> dataCount;
+    if ( in.status() != QDataStream::Ok || dataCount < 0 ){
+        curve = CurveBuffer();
+        return in;
+    }
+    bool raw = isNativeStream( in );
+    CurveBuffer::Column xs( dataCount );
+    CurveBuffer::Column ys( dataCount );
+    readColumn( in, xs, raw );
+    readColumn( in, ys, raw );
+    curve = CurveBuffer( std::move( xs ), std::move( ys ) );
+    return in;
+}
+
+void setNativeByteOrder( QDataStream& stream ){
+    if ( QSysInfo::ByteOrder == QSysInfo::LittleEndian ){
+        stream.setByteOrder( QDataStream::LittleEndian );
+    }
+    else {
+        stream.setByteOrder( QDataStream::BigEndian );
+    }
+}
+
+}
+}
@@ -0,0 +1,125 @@
+/**
+ * The points of a curve, stored as one column of x-values and one of y-values.
+ *
+ * The columns are shared and immutable: copying a buffer only copies two reference
+ * counted pointers, so a curve can be handed from the profile or histogram code to
+ * the plot and on to an export without its points being copied.  A column is copied
+ * only when it is written to while somebody else still uses it, and replacing one
+ * column keeps sharing the other one.
+ **/
+
+#pragma once
+
+#include <QDataStream>
+#include <memory>
+#include <vector>
+
+namespace Carta {
+namespace Lib {
+
+class CurveBuffer {
+public:
+
+    typedef std::vector<double> Column;
+
+    /**
+     * Constructs an empty curve.
+     */
+    CurveBuffer();
+
+    /**
+     * Constructs a curve from its columns, which should be the same size.
+     * @param xs - the x-values of the points.
+     * @param ys - the y-values of the points.
+     */
+    CurveBuffer( Column xs, Column ys );
+
+    /**
+     * Constructs a curve from (x,y) pairs.
+     * @param data - the points of the curve.
+     * @return - a curve with the same points.
+     */
+    static CurveBuffer fromPairs( const std::vector<std::pair<double,double> >& data );
+
+    /**
+     * Return the number of points in the curve.
+     * @return - the number of points.
+     */
+    int size() const;
+
+    /**
+     * Returns true if the curve has no points.
+     * @return - true if the curve is empty; false otherwise.
+     */
+    bool isEmpty() const;
+
+    /**
+     * Return the x-values of the points.
+     * @return - the x-values, valid as long as this buffer is not written to.
+     */
+    const Column& getX() const;
+
+    /**
+     * Return the y-values of the points.
+     * @return - the y-values, valid as long as this buffer is not written to.
+     */
+    const Column& getY() const;
+
+    /**
+     * Return the x-values for writing; they are copied first if they are shared.
+     * @return - the x-values of this buffer alone.
+     */
+    Column& getXForWrite();
+
+    /**
+     * Return the y-values for writing; they are copied first if they are shared.
+     * @return - the y-values of this buffer alone.
+     */
+    Column& getYForWrite();
+
+    /**
+     * Replace the x-values, the y-values stay shared.
+     * @param xs - the new x-values, the same size as the y-values.
+     */
+    void setX( Column xs );
+
+    /**
+     * Replace the y-values, the x-values stay shared.
+     * @param ys - the new y-values, the same size as the x-values.
+     */
+    void setY( Column ys );
+
+    /**
+     * Returns true if both columns are shared with the other buffer.
+     * @param other - another curve.
+     * @return - true if the buffers use the same storage; false otherwise.
+     */
+    bool isSharedWith( const CurveBuffer& other ) const;
+
+    /**
+     * Return the points as (x,y) pairs.  This copies the points; it is meant for
+     * code that has not been converted to columns.
+     * @return - the points of the curve.
+     */
+    std::vector<std::pair<double,double> > toPairs() const;
+
+private:
+
+    static Column& _detach( std::shared_ptr<const Column>& column );
+    static const std::shared_ptr<const Column>& _empty();
+
+    std::shared_ptr<const Column> m_xs;
+    std::shared_ptr<const Column> m_ys;
+};
+
+//Serialization so that a curve can be computed in a separate process.  The columns
+//are copied as whole blocks when the stream uses the byte order of this machine.
+QDataStream &operator<<(QDataStream& out, const Carta::Lib::CurveBuffer& curve );
+QDataStream &operator>>(QDataStream& in, Carta::Lib::CurveBuffer& curve );
+
+//Use the byte order of this machine for a stream that does not leave it, such as a
+//pipe to a forked process.
+void setNativeByteOrder( QDataStream& stream );
+
+}
+}
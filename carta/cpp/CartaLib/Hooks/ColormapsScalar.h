@@ -30,7 +30,9 @@ public:
     /**
      * @brief No input
      */
-    struct Params { };
+    struct Params {
+        bool operator==( const Params & ) const { return true; }
+    };
 
     /**
      * @brief constructor
@@ -46,6 +48,10 @@ public:
     ResultType result;
     Params * paramsPtr;
 };
+
+/// the list of colormaps offered by the plugins does not change
+template < >
+struct IsIdempotentHook < ColormapsScalarHook > : std::true_type { };
 }
 }
 }
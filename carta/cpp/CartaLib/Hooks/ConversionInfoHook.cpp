@@ -0,0 +1,7 @@
+/**
+ *
+ **/
+
+
+#include "ConversionInfoHook.h"
+
@@ -0,0 +1,60 @@
+/**
+ * Hook for getting what the unit conversion plans need to know about an image.
+ *
+ **/
+
+#pragma once
+
+#include "CartaLib/CartaLib.h"
+#include "CartaLib/IPlugin.h"
+#include "CartaLib/UnitConversionPlan.h"
+
+namespace Carta
+{
+namespace Lib
+{
+namespace Image {
+class ImageInterface;
+}
+namespace Hooks
+{
+class ConversionInfoHook : public BaseHook
+{
+    CARTA_HOOK_BOILER1( ConversionInfoHook );
+
+public:
+
+    /**
+     * @brief Result is the part of the information the plugin knows about, with
+     * the valid flags for the rest left unset; the results of all plugins are merged.
+     */
+    typedef UnitConversionInfo ResultType;
+
+    /**
+     * @brief Params
+     */
+    struct Params {
+        Params( std::shared_ptr<Image::ImageInterface> dataSource ){
+            m_dataSource = dataSource;
+        }
+
+        std::shared_ptr<Image::ImageInterface> m_dataSource;
+    };
+
+    /**
+     * @brief PreRender
+     * @param pptr
+     *
+     * @todo make hook constructors protected, so that only hook helper can create them
+     */
+    ConversionInfoHook( Params * pptr ) : BaseHook( staticId ), paramsPtr( pptr )
+    {
+        CARTA_ASSERT( is < Me > () );
+    }
+
+    ResultType result;
+    Params * paramsPtr;
+};
+}
+}
+}
@@ -13,6 +13,13 @@ HistogramResult::HistogramResult( const QString histogramName,
 	m_frequencyMax = -1;
 }
 
+HistogramResult::HistogramResult( const QString& histogramName,
+        const QString& unitsX, const QString& unitsY, const CurveBuffer& curve ):
+	    Plot2DResult( histogramName, unitsX, unitsY, curve ){
+	m_frequencyMin = -1;
+	m_frequencyMax = -1;
+}
+
 
 double HistogramResult::getFrequencyMin() const {
     return m_frequencyMin;
@@ -32,12 +39,7 @@ void HistogramResult::setFrequencyBounds( double minFreq, double maxFreq ){
 
 QDataStream &operator<<(QDataStream& out, const HistogramResult& result ){
     out << result.getName()<< result.getUnitsX() << result.getUnitsY();
-    std::vector<std::pair<double,double>> data = result.getData();
-    int dataCount = data.size();
-    out << dataCount;
-    for ( int i = 0; i < dataCount; i++ ){
-        out << data[i].first << data[i].second;
-    }
+    out << result.getCurve();
     return out;
 }
 
@@ -46,17 +48,10 @@ QDataStream &operator>>(QDataStream& in, HistogramResult& result ){
     QString name;
     QString unitsX;
     QString unitsY;
-    int dataCount;
+    CurveBuffer curve;
     in >> name >> unitsX >> unitsY;
-    in >> dataCount;
-    std::vector<std::pair<double,double> > data( dataCount );
-    for ( int i = 0; i < dataCount; i++ ){
-        double firstEle;
-        double secondEle;
-        in >> firstEle >> secondEle;
-        data[i] = std::pair<double,double>( firstEle, secondEle );
-    }
-    result = HistogramResult( name, unitsX, unitsY, data );
+    in >> curve;
+    result = HistogramResult( name, unitsX, unitsY, curve );
     return in;
 }
 
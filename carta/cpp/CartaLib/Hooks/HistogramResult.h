@@ -19,6 +19,8 @@ class HistogramResult : public Plot2DResult {
   public:
   	HistogramResult( const QString name="", const QString unitsX="", const QString unitsY="",
   		std::vector<std::pair<double,double>> data = std::vector<std::pair<double,double>>());
+  	HistogramResult( const QString& name, const QString& unitsX, const QString& unitsY,
+  		const Carta::Lib::CurveBuffer& curve );
 
     /**
      * Returns the minimum frequency for a range selection.
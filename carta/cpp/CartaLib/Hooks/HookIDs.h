@@ -7,6 +7,7 @@
 #pragma once
 
 #include <cstdint>
+#include <type_traits>
 
 namespace Carta
 {
@@ -30,13 +31,52 @@ enum class UniqueHookIDs {
     GetImageRenderService_ID,
     ProfileHook_ID,
     ImageStatisticsHook_ID,
+    PreRenderRawHook_ID,
+    ConversionInfoHook_ID,
 
 
     /// experimental, soon to be removed:
     PreRender_ID,
-    LoadImage_ID
+    LoadImage_ID,
 
+    /// not a hook, number of the hook IDs above (they are numbered consecutively
+    /// so that the plugin manager can keep per-hook tables in vectors)
+    HookCount
 };
+
+/// readable name of a hook, for debugging output
+inline const char *
+hookName( UniqueHookIDs id )
+{
+    switch ( id ) {
+    case UniqueHookIDs::Initialize_ID : return "Initialize";
+    case UniqueHookIDs::LoadAstroImage_ID : return "LoadAstroImage";
+    case UniqueHookIDs::HistogramHook_ID : return "HistogramHook";
+    case UniqueHookIDs::ColormapsScalarHook_ID : return "ColormapsScalarHook";
+    case UniqueHookIDs::ConversionIntensityHook_ID : return "ConversionIntensityHook";
+    case UniqueHookIDs::ConversionSpectralHook_ID : return "ConversionSpectralHook";
+    case UniqueHookIDs::LoadPlugin_ID : return "LoadPlugin";
+    case UniqueHookIDs::LoadRegion_ID : return "LoadRegion";
+    case UniqueHookIDs::GetWcsGridRendererHook_ID : return "GetWcsGridRendererHook";
+    case UniqueHookIDs::GetInitialFileList_ID : return "GetInitialFileList";
+    case UniqueHookIDs::GetImageRenderService_ID : return "GetImageRenderService";
+    case UniqueHookIDs::ProfileHook_ID : return "ProfileHook";
+    case UniqueHookIDs::ImageStatisticsHook_ID : return "ImageStatisticsHook";
+    case UniqueHookIDs::PreRenderRawHook_ID : return "PreRenderRawHook";
+    case UniqueHookIDs::ConversionInfoHook_ID : return "ConversionInfoHook";
+    case UniqueHookIDs::PreRender_ID : return "PreRender";
+    case UniqueHookIDs::LoadImage_ID : return "LoadImage";
+    case UniqueHookIDs::HookCount : break;
+    }
+    return "Unknown";
+}
+
+/// Hooks whose results depend only on their parameters (and not on any other
+/// state) can specialize this to true. The plugin manager will then remember the
+/// results per Params value and call the plugins only once. The Params of such
+/// hooks must be comparable with ==.
+template < typename HookType >
+struct IsIdempotentHook : std::false_type { };
 }
 }
 }
@@ -8,17 +8,29 @@ Plot2DResult::Plot2DResult( const QString plotTitle,
 	std::vector<std::pair<double,double>> plotData){
 
 	m_name = plotTitle;
-	m_data = plotData;
+	m_curve = CurveBuffer::fromPairs( plotData );
 	m_unitsX = unitsX;
 	m_unitsY = unitsY;
 }
 
+Plot2DResult::Plot2DResult( const QString& plotTitle,
+        const QString& unitsX, const QString& unitsY, const CurveBuffer& curve ){
+    m_name = plotTitle;
+    m_curve = curve;
+    m_unitsX = unitsX;
+    m_unitsY = unitsY;
+}
+
+CurveBuffer Plot2DResult::getCurve() const {
+    return m_curve;
+}
+
 QString Plot2DResult::getName() const{
 	return m_name;
 }
 
 std::vector<std::pair<double,double>> Plot2DResult::getData() const{
-	return m_data;
+	return m_curve.toPairs();
 }
 
 QString Plot2DResult::getUnitsX() const {
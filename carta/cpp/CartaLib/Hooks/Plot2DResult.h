@@ -4,6 +4,7 @@
 #pragma once
 #include <QString>
 #include <vector>
+#include "CartaLib/CurveBuffer.h"
 
 namespace Carta{
 namespace Lib{
@@ -25,8 +26,25 @@ class Plot2DResult {
   	Plot2DResult( const QString name="", const QString unitsX="", const QString unitsY="",
   		std::vector<std::pair<double,double>> data = std::vector<std::pair<double,double>>());
 
+    /**
+     * Constructor.
+     * @param name - the name of the plot.
+     * @param unitsX - units for the x-axis.
+     * @param unitsY - units for the y-axis.
+     * @param curve - the points to be plotted, their storage is shared.
+     */
+    Plot2DResult( const QString& name, const QString& unitsX, const QString& unitsY,
+        const Carta::Lib::CurveBuffer& curve );
+
+    /**
+     * Returns the points of the plot, sharing their storage.
+     * @return - the plot data.
+     */
+    Carta::Lib::CurveBuffer getCurve() const;
+
   	/**
-     * Returns the (x,y) pairs representing the plot data.
+     * Returns the (x,y) pairs representing the plot data.  The points are copied; use
+     * getCurve() to avoid that.
      * @return a vector containing (x,y) pairs.
      */
     std::vector<std::pair<double,double>> getData() const;
@@ -61,7 +79,7 @@ class Plot2DResult {
       QString m_name;
       QString m_unitsX;
       QString m_unitsY;
-      std::vector<std::pair<double,double>> m_data;
+      Carta::Lib::CurveBuffer m_curve;
 };
 }
 }
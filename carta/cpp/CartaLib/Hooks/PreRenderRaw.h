@@ -0,0 +1,61 @@
+/**
+ * Hook for filtering the raw data of a frame before it is color mapped.
+ *
+ **/
+
+#pragma once
+
+#include "CartaLib/CartaLib.h"
+#include "CartaLib/IPlugin.h"
+
+namespace Carta
+{
+namespace Lib
+{
+namespace Hooks
+{
+/// just before a frame is run through the pixel pipeline, plugins are given a chance
+/// to modify the raw values (e.g. smoothing, denoising)
+///
+/// The frame is handed over as one contiguous float32 buffer, so that plugins can
+/// process the whole frame in one call (e.g. as a numpy array) instead of pixel by
+/// pixel. Plugins modify the buffer in place.
+class PreRenderRawHook : public BaseHook
+{
+    CARTA_HOOK_BOILER1( PreRenderRawHook );
+
+public:
+
+    typedef FakeVoid ResultType;
+
+    struct Params {
+        Params( QString p_viewId, int p_width, int p_height, float * p_data )
+        {
+            viewId = p_viewId;
+            width = p_width;
+            height = p_height;
+            data = p_data;
+        }
+
+        /// cache id of the view the frame came from
+        QString viewId;
+
+        /// size of the frame
+        int width, height;
+
+        /// width * height values in row-major order, starting with the bottom row
+        float * data;
+    };
+
+    PreRenderRawHook( Params * pptr ) : BaseHook( staticId ), paramsPtr( pptr )
+    {
+        // force instantiation of templates
+        CARTA_ASSERT( is < Me > () );
+    }
+
+    ResultType result;
+    Params * paramsPtr;
+};
+}
+}
+}
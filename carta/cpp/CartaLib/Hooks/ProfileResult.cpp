@@ -7,13 +7,17 @@ namespace Carta {
 
 ProfileResult::ProfileResult( double restFrequency, const QString& restUnits,
       const std::vector< std::pair<double,double> > data){
-	m_data = data;
+	m_curve = CurveBuffer::fromPairs( data );
 	m_restUnits = restUnits;
 	m_restFrequency = restFrequency;
 }
 
+CurveBuffer ProfileResult::getCurve() const {
+    return m_curve;
+}
+
 std::vector< std::pair<double,double> > ProfileResult::getData() const {
-    return m_data;
+    return m_curve.toPairs();
 }
 
 QString ProfileResult::getError() const {
@@ -29,8 +33,12 @@ double ProfileResult::getRestFrequency() const {
 }
 
 
+void ProfileResult::setCurve( const CurveBuffer& curve ){
+    m_curve = curve;
+}
+
 void ProfileResult::setData( const std::vector< std::pair<double,double> >& data ){
-    m_data = data;
+    m_curve = CurveBuffer::fromPairs( data );
 }
 
 void ProfileResult::setRestFrequency( double restFreq ){
@@ -47,34 +55,19 @@ void ProfileResult::setError( const QString& errorMsg ){
 
 QDataStream &operator<<(QDataStream& out, const ProfileResult& result ){
     out << result.getRestUnits()<< result.getRestFrequency();
-    std::vector<std::pair<double,double>> data = result.getData();
-    int dataCount = data.size();
-    out << dataCount;
-    for ( int i = 0; i < dataCount; i++ ){
-        out << data[i].first << data[i].second;
-    }
+    out << result.getCurve();
     return out;
 }
 
 
 QDataStream &operator>>(QDataStream& in, ProfileResult& result ){
-    QString name;
-    QString unitsX;
-    QString unitsY;
-
     double restFrequency;
     QString restUnits;
-    int dataCount;
+    CurveBuffer curve;
     in >> restUnits >> restFrequency;
-    in >> dataCount;
-    std::vector<std::pair<double,double> > data( dataCount );
-    for ( int i = 0; i < dataCount; i++ ){
-        double firstEle;
-        double secondEle;
-        in >> firstEle >> secondEle;
-        data[i] = std::pair<double,double>( firstEle, secondEle );
-    }
-    result = ProfileResult( restFrequency, restUnits, data );
+    in >> curve;
+    result = ProfileResult( restFrequency, restUnits );
+    result.setCurve( curve );
     return in;
 }
 
@@ -6,6 +6,7 @@
 #include <QString>
 #include <vector>
 #include "CartaLib/ProfileInfo.h"
+#include "CartaLib/CurveBuffer.h"
 
 namespace Carta{
 namespace Lib{
@@ -20,7 +21,14 @@ class ProfileResult {
   		const std::vector< std::pair<double, double> > data = std::vector< std::pair<double,double> >());
 
   	/**
-  	 * Return (x,y) data pairs that comprise a profile.
+  	 * Return the points of the profile, sharing their storage.
+  	 * @return - the profile curve.
+  	 */
+  	Carta::Lib::CurveBuffer getCurve() const;
+
+  	/**
+  	 * Return (x,y) data pairs that comprise a profile.  The points are copied; use
+  	 * getCurve() to avoid that.
   	 * @return - (x,y) data pairs that comprise a profile curve.
   	 */
   	std::vector< std::pair<double,double> > getData() const;
@@ -43,6 +51,12 @@ class ProfileResult {
   	 */
   	double getRestFrequency() const;
 
+  	/**
+  	 * Store the points of the profile.
+  	 * @param curve - the profile curve.
+  	 */
+  	void setCurve( const Carta::Lib::CurveBuffer& curve );
+
   	/**
   	 * Store the (x,y) data pairs that comprise a profile.
   	 * @param data - the (x,y) data pairs that make up a profile.
@@ -70,7 +84,7 @@ class ProfileResult {
     virtual ~ProfileResult(){}
 
   private:
-      std::vector< std::pair<double,double> > m_data;
+      Carta::Lib::CurveBuffer m_curve;
       double m_restFrequency;
       QString m_restUnits;
       QString m_errorMessage;
@@ -4,4 +4,62 @@
 
 
 #include "ICoordinateFormatter.h"
+#include <algorithm>
 
+
+namespace
+{
+/// run a single point conversion over all points
+template < typename Convert >
+int
+convertBatch( int nAxes, const CoordinateFormatterInterface::VD & input,
+              CoordinateFormatterInterface::VD & output, std::vector < bool > * valid,
+              Convert convert )
+{
+    int count = nAxes > 0 ? input.size() / nAxes : 0;
+    output.resize( size_t( count ) * nAxes );
+    if ( valid ) {
+        valid-> assign( count, false );
+    }
+    int good = 0;
+    CoordinateFormatterInterface::VD in( nAxes ), out;
+    for ( int i = 0 ; i < count ; i++ ) {
+        std::copy( input.begin() + i * nAxes, input.begin() + ( i + 1 ) * nAxes, in.begin() );
+        bool ok = convert( in, out ) && int ( out.size() ) >= nAxes;
+        if ( ok ) {
+            std::copy( out.begin(), out.begin() + nAxes, output.begin() + i * nAxes );
+            good++;
+        }
+        if ( valid ) {
+            ( * valid )[i] = ok;
+        }
+    }
+    return good;
+}
+}
+
+QStringList
+CoordinateFormatterInterface::formatFromWorldCoordinate( const VD & world )
+{
+    VD pixel;
+    if ( ! toPixel( world, pixel ) ) {
+        return QStringList();
+    }
+    return formatFromPixelCoordinate( pixel );
+}
+
+int
+CoordinateFormatterInterface::toWorldBatch( const VD & pixels, VD & worlds,
+                                            std::vector < bool > * valid ) const
+{
+    return convertBatch( nAxes(), pixels, worlds, valid,
+                         [this] ( const VD & in, VD & out ) { return toWorld( in, out ); } );
+}
+
+int
+CoordinateFormatterInterface::toPixelBatch( const VD & worlds, VD & pixels,
+                                            std::vector < bool > * valid ) const
+{
+    return convertBatch( nAxes(), worlds, pixels, valid,
+                         [this] ( const VD & in, VD & out ) { return toPixel( in, out ); } );
+}
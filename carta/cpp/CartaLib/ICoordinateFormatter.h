@@ -41,6 +41,11 @@ public:
     /// format them using current settings, with units appended where appropriate
     virtual QStringList formatFromPixelCoordinate(const VD& pix) = 0;
 
+    /// format world coordinates using current settings, e.g. the results of toWorldBatch()
+    /// \note the default implementation converts back to pixel coordinates and calls
+    /// formatFromPixelCoordinate()
+    virtual QStringList formatFromWorldCoordinate( const VD & world );
+
     /// calculate and format distance between two pixels
     virtual QString calculateFormatDistance( const VD & p1, const VD & p2) = 0;
 
@@ -87,6 +92,20 @@ public:
     /// convert world coordinates to pixel coordinates
     virtual bool toPixel(const VD& world, VD& pixel) const = 0;
 
+    /// convert many points from pixel to world coordinates in one call
+    /// \param pixels nAxes() values per point, one point after another
+    /// \param worlds results, in the same layout as pixels
+    /// \param valid if not null, set to whether each point was converted
+    /// \return number of points converted successfully
+    /// \note the default implementation calls toWorld() for each point, implementations
+    /// should override this with something faster
+    virtual int toWorldBatch( const VD & pixels, VD & worlds,
+                              std::vector < bool > * valid = nullptr ) const;
+
+    /// convert many points from world to pixel coordinates in one call, see toWorldBatch()
+    virtual int toPixelBatch( const VD & worlds, VD & pixels,
+                              std::vector < bool > * valid = nullptr ) const;
+
     /// virtual destructor
     virtual ~CoordinateFormatterInterface() {}
 
@@ -52,6 +52,14 @@ NdArray::Byte * Image::ImageInterface::getMaskSlice(const SliceND & sliceInfo)
 }
 
 
+BitMask Image::ImageInterface::getMaskBits(const SliceND & sliceInfo)
+{
+    // images without a mask have nothing masked
+    Q_UNUSED( sliceInfo);
+    return BitMask();
+}
+
+
 NdArray::RawViewInterface * Image::ImageInterface::getErrorSlice(const SliceND & sliceInfo)
 {
     Q_UNUSED( sliceInfo);
@@ -20,6 +20,7 @@
 #pragma once
 
 #include "PixelType.h"
+#include "BitMask.h"
 #include "Nullable.h"
 #include "Slice.h"
 #include "ICoordinateFormatter.h"
@@ -368,11 +369,18 @@ public:
     getDataSlice( const SliceND & sliceInfo ) = 0;
 
     /// get the mask
-    /// \todo booleans as bytes is wasting resources, we should specialize
-    /// the NdArray::TypedView for bools
+    /// \note booleans as bytes is wasting resources, prefer getMaskBits()
     virtual NdArray::Byte *
     getMaskSlice( const SliceND & sliceInfo) = 0;
 
+    /// get the mask packed into bits, one per pixel of the slice in the order in
+    /// which the data view visits them, set for valid pixels
+    /// \return an empty mask if no pixel of the slice is masked
+    /// \note data views of images with a mask already return NaN for masked
+    /// pixels, this is for code that needs the mask itself
+    virtual BitMask
+    getMaskBits( const SliceND & sliceInfo);
+
     /// get the errors
     virtual NdArray::RawViewInterface  *
     getErrorSlice( const SliceND & sliceInfo) = 0;
@@ -3,6 +3,7 @@
 #include "CartaLib.h"
 #include "core/IView.h"
 #include "VectorGraphics/VGList.h"
+#include "Algorithms/PlusCompositor.h"
 
 #include <QObject>
 #include <QString>
@@ -513,6 +514,13 @@ public:
     virtual void
     combine( QImage & src1dst, const QImage & src2 ) override
     {
+        // plus mode has a fused implementation that needs no temporary copies
+        if ( m_compositionMode == QPainter::CompositionMode_Plus ) {
+            Algorithms::PlusCompositor::composite(
+                src1dst, { Algorithms::PlusCompositor::Layer( src2, m_mask, m_alpha ) } );
+            return;
+        }
+
         // otherwise we need to
         QImage src22 = src2;
         if ( src22.format() != QImage::Format_ARGB32 ) {
@@ -0,0 +1,92 @@
+/**
+ * Small least recently used cache with a fixed number of entries.
+ *
+ * Meant for values that are expensive to compute but cheap to keep, such as region
+ * records. The cache is not thread safe, callers hold their own lock.
+ **/
+
+#pragma once
+
+#include <QHash>
+#include <list>
+
+namespace Carta
+{
+namespace Lib
+{
+template < typename Key, typename Value >
+class LruCache
+{
+public:
+
+    /// construct a cache holding at most capacity entries
+    explicit
+    LruCache( int capacity )
+        : m_capacity( capacity > 0 ? capacity : 1 )
+    { }
+
+    /// look up a value and mark it as most recently used
+    /// \return true if found, value is set to the cached value
+    bool
+    find( const Key & key, Value & value )
+    {
+        auto iter = m_entries.find( key );
+        if ( iter == m_entries.end() ) {
+            return false;
+        }
+        m_lru.splice( m_lru.begin(), m_lru, iter.value().lruPos );
+        value = iter.value().value;
+        return true;
+    }
+
+    /// insert (or replace) a value, evicts the least recently used entry when full
+    void
+    insert( const Key & key, const Value & value )
+    {
+        auto iter = m_entries.find( key );
+        if ( iter != m_entries.end() ) {
+            iter.value().value = value;
+            m_lru.splice( m_lru.begin(), m_lru, iter.value().lruPos );
+            return;
+        }
+        while ( m_entries.size() >= m_capacity ) {
+            m_entries.remove( m_lru.back() );
+            m_lru.pop_back();
+        }
+        m_lru.push_front( key );
+        Entry & entry = m_entries[key];
+        entry.value = value;
+        entry.lruPos = m_lru.begin();
+    }
+
+    /// number of cached entries
+    int
+    size() const
+    {
+        return m_entries.size();
+    }
+
+    /// drop all entries
+    void
+    clear()
+    {
+        m_entries.clear();
+        m_lru.clear();
+    }
+
+private:
+
+    struct Entry
+    {
+        Value value;
+        typename std::list < Key >::iterator lruPos;
+    };
+
+    int m_capacity;
+
+    /// most recently used at the front
+    std::list < Key > m_lru;
+    QHash < Key, Entry > m_entries;
+};
+}
+}
@@ -0,0 +1,127 @@
+#include "RegionIndex.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Carta {
+namespace Lib {
+
+const int RegionIndex::MAX_CELLS = 256;
+
+RegionIndex::RegionIndex( int cellSize ){
+    m_cellSize = std::max( cellSize, 1 );
+}
+
+int RegionIndex::add( std::shared_ptr<const RegionMask> mask ){
+    int index = m_masks.size();
+    m_masks.push_back( mask );
+    if ( !mask || mask->isEmpty() ){
+        return index;
+    }
+    QRect box = mask->getBoundingBox();
+    int cellLeft = _getCell( box.left() );
+    int cellRight = _getCell( box.right() );
+    int cellTop = _getCell( box.top() );
+    int cellBottom = _getCell( box.bottom() );
+    qint64 cellCount = qint64( cellRight - cellLeft + 1 ) * ( cellBottom - cellTop + 1 );
+    if ( cellCount > MAX_CELLS ){
+        m_large.push_back( index );
+    }
+    else {
+        for ( int cellY = cellTop; cellY <= cellBottom; cellY++ ){
+            for ( int cellX = cellLeft; cellX <= cellRight; cellX++ ){
+                m_cells[_getCellKey( cellX, cellY )].push_back( index );
+            }
+        }
+    }
+    return index;
+}
+
+void RegionIndex::clear(){
+    m_masks.clear();
+    m_cells.clear();
+    m_large.clear();
+}
+
+int RegionIndex::_getCell( int pixel ) const {
+    //Round towards minus infinity so negative pixels get their own cells.
+    return static_cast<int>( std::floor( static_cast<double>( pixel ) / m_cellSize ) );
+}
+
+qint64 RegionIndex::_getCellKey( int cellX, int cellY ) const {
+    return ( static_cast<qint64>( cellY ) << 32 ) | static_cast<quint32>( cellX );
+}
+
+std::shared_ptr<const RegionMask> RegionIndex::getMask( int index ) const {
+    std::shared_ptr<const RegionMask> mask;
+    if ( 0 <= index && index < static_cast<int>( m_masks.size() ) ){
+        mask = m_masks[index];
+    }
+    return mask;
+}
+
+int RegionIndex::getRegionCount() const {
+    return m_masks.size();
+}
+
+std::vector<int> RegionIndex::getRegionsAt( double x, double y ) const {
+    std::vector<int> regions;
+    int pixelX = std::floor( x + 0.5 );
+    int pixelY = std::floor( y + 0.5 );
+    auto iter = m_cells.find( _getCellKey( _getCell( pixelX ), _getCell( pixelY ) ) );
+    if ( iter != m_cells.end() ){
+        for ( int index : iter->second ){
+            if ( m_masks[index]->contains( x, y ) ){
+                regions.push_back( index );
+            }
+        }
+    }
+    for ( int index : m_large ){
+        if ( m_masks[index]->contains( x, y ) ){
+            regions.push_back( index );
+        }
+    }
+    std::sort( regions.begin(), regions.end() );
+    return regions;
+}
+
+std::vector<int> RegionIndex::getRegionsIntersecting( const QRect& rect ) const {
+    std::vector<int> regions;
+    if ( rect.isEmpty() ){
+        return regions;
+    }
+    int cellLeft = _getCell( rect.left() );
+    int cellRight = _getCell( rect.right() );
+    int cellTop = _getCell( rect.top() );
+    int cellBottom = _getCell( rect.bottom() );
+    qint64 cellCount = qint64( cellRight - cellLeft + 1 ) * ( cellBottom - cellTop + 1 );
+    if ( cellCount > static_cast<qint64>( m_cells.size() ) ){
+        //Cheaper to look at every cell that has something in it.
+        for ( const auto& cell : m_cells ){
+            regions.insert( regions.end(), cell.second.begin(), cell.second.end() );
+        }
+    }
+    else {
+        for ( int cellY = cellTop; cellY <= cellBottom; cellY++ ){
+            for ( int cellX = cellLeft; cellX <= cellRight; cellX++ ){
+                auto iter = m_cells.find( _getCellKey( cellX, cellY ) );
+                if ( iter != m_cells.end() ){
+                    regions.insert( regions.end(), iter->second.begin(), iter->second.end() );
+                }
+            }
+        }
+    }
+    regions.insert( regions.end(), m_large.begin(), m_large.end() );
+    std::sort( regions.begin(), regions.end() );
+    regions.erase( std::unique( regions.begin(), regions.end() ), regions.end() );
+    regions.erase( std::remove_if( regions.begin(), regions.end(), [this, &rect] ( int index ) {
+        return !m_masks[index]->getBoundingBox().intersects( rect );
+    } ), regions.end() );
+    return regions;
+}
+
+RegionIndex::~RegionIndex(){
+
+}
+
+}
+}
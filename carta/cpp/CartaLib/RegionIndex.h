@@ -0,0 +1,84 @@
+/**
+ * A spatial index over the masks of many regions, for finding the regions
+ * under a point or overlapping a rectangle without testing all of them.
+ **/
+
+#pragma once
+
+#include "CartaLib/RegionMask.h"
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace Carta {
+namespace Lib {
+
+class RegionIndex {
+public:
+
+    /**
+     * Constructor.
+     * @param cellSize - the width and height in pixels of the cells of the index.
+     */
+    RegionIndex( int cellSize = 64 );
+
+    /**
+     * Add a region to the index.
+     * @param mask - the pixels of the region.
+     * @return - the index of the region, regions are numbered in the order they
+     *      are added.
+     */
+    int add( std::shared_ptr<const RegionMask> mask );
+
+    /**
+     * Remove all regions.
+     */
+    void clear();
+
+    /**
+     * Return the mask of a region.
+     * @param index - the index of a region.
+     * @return - the pixels of the region.
+     */
+    std::shared_ptr<const RegionMask> getMask( int index ) const;
+
+    /**
+     * Return the number of regions in the index.
+     * @return - the number of regions.
+     */
+    int getRegionCount() const;
+
+    /**
+     * Return the regions containing a point.
+     * @param x - the x-coordinate of the point in pixels.
+     * @param y - the y-coordinate of the point in pixels.
+     * @return - the indices of the regions containing the point, in increasing order.
+     */
+    std::vector<int> getRegionsAt( double x, double y ) const;
+
+    /**
+     * Return the regions whose bounding box overlaps a rectangle.
+     * @param rect - a rectangle in pixels.
+     * @return - the indices of the regions, in increasing order.
+     */
+    std::vector<int> getRegionsIntersecting( const QRect& rect ) const;
+
+    virtual ~RegionIndex();
+
+private:
+
+    //Regions covering more cells than this are not put into the cells, they are
+    //always tested instead.
+    static const int MAX_CELLS;
+
+    qint64 _getCellKey( int cellX, int cellY ) const;
+    int _getCell( int pixel ) const;
+
+    int m_cellSize;
+    std::vector<std::shared_ptr<const RegionMask> > m_masks;
+    std::unordered_map<qint64, std::vector<int> > m_cells;
+    std::vector<int> m_large;
+};
+
+}
+}
@@ -53,6 +53,14 @@ void RegionInfo::setCorners( const std::vector< std::pair<double,double> > & cor
     m_corners = corners;
 }
 
+QString RegionInfo::toString() const {
+    QString str = QString::number( static_cast<int>( m_regionType ) );
+    for ( std::pair<double,double> corner : m_corners ){
+        str = str + ";" + QString::number( corner.first, 'g', 12 ) + "," +
+                QString::number( corner.second, 'g', 12 );
+    }
+    return str;
+}
 
 RegionInfo::~RegionInfo(){
 
@@ -56,6 +56,13 @@ public:
      */
     bool isCorner( std::pair<double,double> pt ) const;
 
+    /**
+     * Returns a string describing the region type and corners, which can be used
+     * as a key when caching things computed from the region.
+     * @return - a string representation of the region.
+     */
+    QString toString() const;
+
     /**
      * Equality operator.
      * @param rhs - the other RegionInfo to compare to.
@@ -0,0 +1,212 @@
+#include "RegionMask.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Carta {
+namespace Lib {
+
+RegionMask::RegionMask(){
+    m_pixelCount = 0;
+}
+
+void RegionMask::_addRun( int y, int xMin, int xMax, int width, int height ){
+    if ( width > 0 && height > 0 ){
+        if ( y < 0 || y >= height ){
+            return;
+        }
+        xMin = std::max( xMin, 0 );
+        xMax = std::min( xMax, width - 1 );
+    }
+    if ( xMin > xMax ){
+        return;
+    }
+    //Merge with the previous run if they touch.
+    if ( !m_runs.empty() ){
+        Run& last = m_runs.back();
+        if ( last.y == y && xMin <= last.xMax + 1 ){
+            last.xMax = std::max( last.xMax, xMax );
+            return;
+        }
+    }
+    Run run = { y, xMin, xMax };
+    m_runs.push_back( run );
+}
+
+void RegionMask::_finish(){
+    m_pixelCount = 0;
+    m_rowStarts.clear();
+    if ( m_runs.empty() ){
+        m_box = QRect();
+        return;
+    }
+    int yMin = m_runs.front().y;
+    int yMax = m_runs.back().y;
+    int xMin = m_runs.front().xMin;
+    int xMax = m_runs.front().xMax;
+    m_rowStarts.resize( yMax - yMin + 2 );
+    int runCount = m_runs.size();
+    int row = 0;
+    for ( int i = 0; i < runCount; i++ ){
+        const Run& run = m_runs[i];
+        while ( row <= run.y - yMin ){
+            m_rowStarts[row] = i;
+            row++;
+        }
+        xMin = std::min( xMin, run.xMin );
+        xMax = std::max( xMax, run.xMax );
+        m_pixelCount += run.xMax - run.xMin + 1;
+    }
+    m_rowStarts[row] = runCount;
+    m_box = QRect( QPoint( xMin, yMin ), QPoint( xMax, yMax ) );
+}
+
+RegionMask RegionMask::rasterize( const RegionInfo& info, int width, int height ){
+    RegionMask mask;
+    std::vector<std::pair<double,double> > corners = info.getCorners();
+    int cornerCount = corners.size();
+    RegionInfo::RegionType regionType = info.getRegionType();
+    if ( regionType == RegionInfo::RegionType::Polygon ){
+        if ( cornerCount == 1 || cornerCount == 4 ){
+            mask._rasterizeBox( corners, width, height );
+        }
+        else if ( cornerCount >= 3 ){
+            mask._rasterizePolygon( corners, width, height );
+        }
+    }
+    else if ( regionType == RegionInfo::RegionType::Ellipse ){
+        if ( cornerCount == 2 ){
+            mask._rasterizeEllipse( corners, width, height );
+        }
+    }
+    mask._finish();
+    return mask;
+}
+
+void RegionMask::_rasterizeBox( const std::vector<std::pair<double,double> >& corners,
+        int width, int height ){
+    double minX = corners[0].first;
+    double maxX = minX;
+    double minY = corners[0].second;
+    double maxY = minY;
+    for ( const std::pair<double,double>& corner : corners ){
+        minX = std::min( minX, corner.first );
+        maxX = std::max( maxX, corner.first );
+        minY = std::min( minY, corner.second );
+        maxY = std::max( maxY, corner.second );
+    }
+    int xMin = std::lround( minX );
+    int xMax = std::lround( maxX );
+    int yFirst = std::lround( minY );
+    int yLast = std::lround( maxY );
+    if ( height > 0 ){
+        yFirst = std::max( yFirst, 0 );
+        yLast = std::min( yLast, height - 1 );
+    }
+    for ( int y = yFirst; y <= yLast; y++ ){
+        _addRun( y, xMin, xMax, width, height );
+    }
+}
+
+void RegionMask::_rasterizeEllipse( const std::vector<std::pair<double,double> >& corners,
+        int width, int height ){
+    double centerX = ( corners[0].first + corners[1].first ) / 2;
+    double centerY = ( corners[0].second + corners[1].second ) / 2;
+    double radiusX = std::abs( corners[0].first - corners[1].first ) / 2;
+    double radiusY = std::abs( corners[0].second - corners[1].second ) / 2;
+    if ( radiusX <= 0 || radiusY <= 0 ){
+        return;
+    }
+    int yFirst = std::ceil( centerY - radiusY );
+    int yLast = std::floor( centerY + radiusY );
+    if ( height > 0 ){
+        yFirst = std::max( yFirst, 0 );
+        yLast = std::min( yLast, height - 1 );
+    }
+    for ( int y = yFirst; y <= yLast; y++ ){
+        double dy = ( y - centerY ) / radiusY;
+        double dx = radiusX * std::sqrt( std::max( 0.0, 1 - dy * dy ) );
+        _addRun( y, std::ceil( centerX - dx ), std::floor( centerX + dx ), width, height );
+    }
+}
+
+void RegionMask::_rasterizePolygon( const std::vector<std::pair<double,double> >& corners,
+        int width, int height ){
+    double minY = corners[0].second;
+    double maxY = minY;
+    for ( const std::pair<double,double>& corner : corners ){
+        minY = std::min( minY, corner.second );
+        maxY = std::max( maxY, corner.second );
+    }
+    int yFirst = std::ceil( minY );
+    int yLast = std::floor( maxY );
+    if ( height > 0 ){
+        yFirst = std::max( yFirst, 0 );
+        yLast = std::min( yLast, height - 1 );
+    }
+    int cornerCount = corners.size();
+    std::vector<double> crossings;
+    for ( int y = yFirst; y <= yLast; y++ ){
+        //Even-odd rule: find where the row crosses the edges, each edge
+        //includes its lower end point but not its upper one.
+        crossings.clear();
+        for ( int i = 0; i < cornerCount; i++ ){
+            const std::pair<double,double>& p0 = corners[i];
+            const std::pair<double,double>& p1 = corners[( i + 1 ) % cornerCount];
+            if ( ( p0.second <= y && y < p1.second ) || ( p1.second <= y && y < p0.second ) ){
+                double t = ( y - p0.second ) / ( p1.second - p0.second );
+                crossings.push_back( p0.first + t * ( p1.first - p0.first ) );
+            }
+        }
+        std::sort( crossings.begin(), crossings.end() );
+        int crossingCount = crossings.size();
+        for ( int i = 0; i + 1 < crossingCount; i += 2 ){
+            _addRun( y, std::ceil( crossings[i] ), std::floor( crossings[i+1] ), width, height );
+        }
+    }
+}
+
+QRect RegionMask::getBoundingBox() const {
+    return m_box;
+}
+
+qint64 RegionMask::getPixelCount() const {
+    return m_pixelCount;
+}
+
+const std::vector<RegionMask::Run>& RegionMask::getRuns() const {
+    return m_runs;
+}
+
+bool RegionMask::contains( double x, double y ) const {
+    if ( m_runs.empty() ){
+        return false;
+    }
+    int pixelX = std::floor( x + 0.5 );
+    int pixelY = std::floor( y + 0.5 );
+    if ( !m_box.contains( pixelX, pixelY ) ){
+        return false;
+    }
+    int row = pixelY - m_box.top();
+    std::vector<Run>::const_iterator first = m_runs.begin() + m_rowStarts[row];
+    std::vector<Run>::const_iterator last = m_runs.begin() + m_rowStarts[row + 1];
+    //First run that starts to the right of the pixel, the pixel can only be
+    //in the one before it.
+    std::vector<Run>::const_iterator iter = std::upper_bound( first, last, pixelX,
+            [] ( int value, const Run& run ) { return value < run.xMin; } );
+    if ( iter == first ){
+        return false;
+    }
+    --iter;
+    return pixelX <= iter->xMax;
+}
+
+bool RegionMask::isEmpty() const {
+    return m_runs.empty();
+}
+
+RegionMask::~RegionMask(){
+
+}
+
+}
+}
@@ -0,0 +1,100 @@
+/**
+ * A region rasterised onto the pixel grid of an image.
+ *
+ * The pixels of a region are stored as runs, one or more per row, so that the
+ * mask of a large region stays small and the pixels can be visited row by row.
+ * A pixel belongs to the region if its center lies inside the region shape.
+ **/
+
+#pragma once
+
+#include "CartaLib/RegionInfo.h"
+#include <QRect>
+#include <vector>
+
+namespace Carta {
+namespace Lib {
+
+class RegionMask {
+public:
+
+    /// the pixels xMin, xMin+1, ... xMax of row y
+    struct Run {
+        int y;
+        int xMin;
+        int xMax;
+    };
+
+    /**
+     * Constructs an empty mask.
+     */
+    RegionMask();
+
+    /**
+     * Rasterise a region.  Polygonal regions with one or four corners are treated
+     * as boxes, ellipses are given by two opposite corners of their bounding box;
+     * this matches the way regions are handed to casacore.
+     * @param info - the region.
+     * @param width - the width of the image, pixels to the left or right of the image
+     *      are left out. Use zero to keep all pixels.
+     * @param height - the height of the image.
+     * @return - the pixels of the region.
+     */
+    static RegionMask rasterize( const RegionInfo& info, int width = 0, int height = 0 );
+
+    /**
+     * Return the smallest rectangle containing all pixels of the region.
+     * @return - the bounding box of the region, a null rectangle if it is empty.
+     */
+    QRect getBoundingBox() const;
+
+    /**
+     * Return the number of pixels in the region.
+     * @return - the number of pixels in the region.
+     */
+    qint64 getPixelCount() const;
+
+    /**
+     * Return the runs of the region, sorted by row and then by column.
+     * @return - the runs of pixels making up the region.
+     */
+    const std::vector<Run>& getRuns() const;
+
+    /**
+     * Returns true if the pixel containing the given point belongs to the region.
+     * @param x - the x-coordinate of a point in pixels.
+     * @param y - the y-coordinate of a point in pixels.
+     * @return - true if the point is in the region; false otherwise.
+     */
+    bool contains( double x, double y ) const;
+
+    /**
+     * Returns true if the region has no pixels.
+     * @return true - if there are no pixels in the region; false otherwise.
+     */
+    bool isEmpty() const;
+
+    virtual ~RegionMask();
+
+private:
+
+    void _addRun( int y, int xMin, int xMax, int width, int height );
+    void _finish();
+
+    void _rasterizeBox( const std::vector<std::pair<double,double> >& corners,
+            int width, int height );
+    void _rasterizeEllipse( const std::vector<std::pair<double,double> >& corners,
+            int width, int height );
+    void _rasterizePolygon( const std::vector<std::pair<double,double> >& corners,
+            int width, int height );
+
+    std::vector<Run> m_runs;
+    //Index of the first run of each row in the bounding box, with one extra
+    //entry at the end.
+    std::vector<int> m_rowStarts;
+    QRect m_box;
+    qint64 m_pixelCount;
+};
+
+}
+}
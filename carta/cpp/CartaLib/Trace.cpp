@@ -0,0 +1,431 @@
+#include "Trace.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <set>
+
+namespace Carta {
+namespace Lib {
+namespace Trace {
+
+namespace Internal {
+std::atomic<bool> enabled( false );
+}
+
+namespace {
+
+//Events kept per thread; the oldest are overwritten.
+const int EVENT_CAPACITY = 16384;
+
+//Buffers of finished threads that are kept until the next reset.  Pool threads come
+//and go, so without a limit their buffers would pile up.
+const int RETIRED_BUFFER_MAX = 16;
+
+//One recorded call.  The fields are atomics so that a slot can be read while its
+//thread overwrites it; seq is odd while the slot is written and tells the reader
+//which event the slot holds.
+struct Slot {
+    std::atomic<quint64> seq { 0 };
+    std::atomic<const Site*> site { nullptr };
+    std::atomic<qint64> start { 0 };
+    std::atomic<qint64> duration { 0 };
+};
+
+struct Event {
+    const Site* site;
+    qint64 start;
+    qint64 duration;
+};
+
+//Ring buffer of the events of one thread, written only by that thread.
+class ThreadBuffer {
+public:
+    ThreadBuffer( int threadId, const QString& threadName ) :
+        m_slots( new Slot[EVENT_CAPACITY] ),
+        m_threadId( threadId ),
+        m_threadName( threadName ){
+    }
+
+    void push( const Site* site, qint64 start, qint64 duration ){
+        quint64 index = m_written.load( std::memory_order_relaxed );
+        Slot& slot = m_slots[index % EVENT_CAPACITY];
+        slot.seq.store( 2 * index + 1, std::memory_order_relaxed );
+        std::atomic_thread_fence( std::memory_order_release );
+        slot.site.store( site, std::memory_order_relaxed );
+        slot.start.store( start, std::memory_order_relaxed );
+        slot.duration.store( duration, std::memory_order_relaxed );
+        slot.seq.store( 2 * index + 2, std::memory_order_release );
+        m_written.store( index + 1, std::memory_order_release );
+    }
+
+    //Copies the events that started at or after since; slots that are being
+    //overwritten while they are read are skipped.
+    void read( qint64 since, std::vector<Event>& events ) const {
+        quint64 written = m_written.load( std::memory_order_acquire );
+        quint64 first = written > quint64( EVENT_CAPACITY ) ? written - EVENT_CAPACITY : 0;
+        for ( quint64 index = first; index < written; index++ ){
+            const Slot& slot = m_slots[index % EVENT_CAPACITY];
+            quint64 seq = slot.seq.load( std::memory_order_acquire );
+            if ( seq != 2 * index + 2 ){
+                continue;
+            }
+            Event event;
+            event.site = slot.site.load( std::memory_order_relaxed );
+            event.start = slot.start.load( std::memory_order_relaxed );
+            event.duration = slot.duration.load( std::memory_order_relaxed );
+            std::atomic_thread_fence( std::memory_order_acquire );
+            if ( slot.seq.load( std::memory_order_relaxed ) != seq || event.start < since ){
+                continue;
+            }
+            events.push_back( event );
+        }
+    }
+
+    int getThreadId() const {
+        return m_threadId;
+    }
+
+    const QString& getThreadName() const {
+        return m_threadName;
+    }
+
+    std::atomic<bool> retired { false };
+
+private:
+    std::unique_ptr<Slot[]> m_slots;
+    std::atomic<quint64> m_written { 0 };
+    const int m_threadId;
+    const QString m_threadName;
+};
+
+//Everything registered with the tracer.  Only registration, export and reset lock
+//the mutex, recording does not.
+struct Registry {
+    QMutex mutex;
+    std::vector<Site*> sites;
+    std::vector<Counter*> counters;
+    std::vector<std::shared_ptr<ThreadBuffer> > buffers;
+    int nextThreadId = 1;
+    //Events that started before this time stamp were recorded before the last reset.
+    std::atomic<qint64> resetTime { 0 };
+};
+
+//Never destroyed: static sites and thread buffers may outlive the other statics.
+Registry& registry(){
+    static Registry* reg = new Registry();
+    return *reg;
+}
+
+//Hands out the buffer of the calling thread and retires it when the thread ends.
+class ThreadHandle {
+public:
+    ThreadBuffer& buffer(){
+        if ( !m_buffer ){
+            m_buffer = _makeBuffer();
+        }
+        return *m_buffer;
+    }
+
+    ~ThreadHandle(){
+        if ( m_buffer ){
+            m_buffer->retired = true;
+        }
+    }
+
+private:
+    static std::shared_ptr<ThreadBuffer> _makeBuffer(){
+        QThread* thread = QThread::currentThread();
+        QString name = thread ? thread->objectName() : QString();
+        QCoreApplication* app = QCoreApplication::instance();
+        if ( app && thread == app->thread() ){
+            name = "main";
+        }
+        Registry& reg = registry();
+        QMutexLocker locker( &reg.mutex );
+        int threadId = reg.nextThreadId++;
+        if ( name.isEmpty() ){
+            name = QString( "thread %1" ).arg( threadId );
+        }
+        int retiredCount = std::count_if( reg.buffers.begin(), reg.buffers.end(),
+                []( const std::shared_ptr<ThreadBuffer>& buf ){ return buf->retired.load(); } );
+        for ( auto iter = reg.buffers.begin(); iter != reg.buffers.end() && retiredCount >= RETIRED_BUFFER_MAX; ){
+            if ( (*iter)->retired ){
+                iter = reg.buffers.erase( iter );
+                retiredCount--;
+            }
+            else {
+                ++iter;
+            }
+        }
+        std::shared_ptr<ThreadBuffer> buffer = std::make_shared<ThreadBuffer>( threadId, name );
+        reg.buffers.push_back( buffer );
+        return buffer;
+    }
+
+    std::shared_ptr<ThreadBuffer> m_buffer;
+};
+
+thread_local ThreadHandle threadHandle;
+
+const std::chrono::steady_clock::time_point& epoch(){
+    static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    return start;
+}
+
+}
+
+
+void setEnabled( bool enabled ){
+    epoch();
+    Internal::enabled = enabled;
+}
+
+qint64 now(){
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - epoch() ).count();
+}
+
+
+Site::Site( const char* category, const char* name ) :
+    m_category( category ),
+    m_name( name ),
+    m_calls( 0 ),
+    m_totalNs( 0 ),
+    m_maxNs( 0 ){
+    Registry& reg = registry();
+    QMutexLocker locker( &reg.mutex );
+    reg.sites.push_back( this );
+}
+
+void Site::record( qint64 start, qint64 duration ){
+    m_calls.fetch_add( 1, std::memory_order_relaxed );
+    m_totalNs.fetch_add( duration, std::memory_order_relaxed );
+    qint64 oldMax = m_maxNs.load( std::memory_order_relaxed );
+    while ( duration > oldMax && !m_maxNs.compare_exchange_weak( oldMax, duration ) ){
+    }
+    threadHandle.buffer().push( this, start, duration );
+}
+
+SiteStats Site::getStats() const {
+    SiteStats stats;
+    stats.category = m_category;
+    stats.name = m_name;
+    stats.calls = m_calls.load();
+    stats.totalMs = m_totalNs.load() / 1e6;
+    stats.maxMs = m_maxNs.load() / 1e6;
+    return stats;
+}
+
+void Site::clear(){
+    m_calls = 0;
+    m_totalNs = 0;
+    m_maxNs = 0;
+}
+
+Site::~Site(){
+    Registry& reg = registry();
+    QMutexLocker locker( &reg.mutex );
+    reg.sites.erase( std::remove( reg.sites.begin(), reg.sites.end(), this ), reg.sites.end() );
+}
+
+
+Counter::Counter( const char* name ) :
+    m_name( name ),
+    m_value( 0 ){
+    Registry& reg = registry();
+    QMutexLocker locker( &reg.mutex );
+    reg.counters.push_back( this );
+}
+
+CounterStats Counter::getStats() const {
+    CounterStats stats;
+    stats.name = m_name;
+    stats.value = m_value.load();
+    return stats;
+}
+
+void Counter::clear(){
+    m_value = 0;
+}
+
+Counter::~Counter(){
+    Registry& reg = registry();
+    QMutexLocker locker( &reg.mutex );
+    reg.counters.erase( std::remove( reg.counters.begin(), reg.counters.end(), this ),
+            reg.counters.end() );
+}
+
+
+//A scope in a header is a separate site in every translation unit that uses it, so
+//sites and counters of the same name are added up.
+std::vector<SiteStats> getSiteStats(){
+    std::vector<SiteStats> list;
+    {
+        Registry& reg = registry();
+        QMutexLocker locker( &reg.mutex );
+        for ( const Site* site : reg.sites ){
+            SiteStats stats = site->getStats();
+            if ( stats.calls > 0 ){
+                list.push_back( stats );
+            }
+        }
+    }
+    std::sort( list.begin(), list.end(), []( const SiteStats& a, const SiteStats& b ){
+        return a.category != b.category ? a.category < b.category : a.name < b.name;
+    });
+    std::vector<SiteStats> merged;
+    for ( const SiteStats& stats : list ){
+        if ( !merged.empty() && merged.back().category == stats.category &&
+                merged.back().name == stats.name ){
+            SiteStats& total = merged.back();
+            total.calls += stats.calls;
+            total.totalMs += stats.totalMs;
+            total.maxMs = std::max( total.maxMs, stats.maxMs );
+        }
+        else {
+            merged.push_back( stats );
+        }
+    }
+    return merged;
+}
+
+std::vector<CounterStats> getCounterStats(){
+    std::vector<CounterStats> list;
+    {
+        Registry& reg = registry();
+        QMutexLocker locker( &reg.mutex );
+        for ( const Counter* counter : reg.counters ){
+            CounterStats stats = counter->getStats();
+            if ( stats.value != 0 ){
+                list.push_back( stats );
+            }
+        }
+    }
+    std::sort( list.begin(), list.end(), []( const CounterStats& a, const CounterStats& b ){
+        return a.name < b.name;
+    });
+    std::vector<CounterStats> merged;
+    for ( const CounterStats& stats : list ){
+        if ( !merged.empty() && merged.back().name == stats.name ){
+            merged.back().value += stats.value;
+        }
+        else {
+            merged.push_back( stats );
+        }
+    }
+    return merged;
+}
+
+namespace {
+
+QByteArray makeChromeTrace( int& eventCount ){
+    eventCount = 0;
+    std::vector<CounterStats> counters = getCounterStats();
+    Registry& reg = registry();
+    QMutexLocker locker( &reg.mutex );
+    qint64 pid = QCoreApplication::applicationPid();
+    qint64 since = reg.resetTime.load();
+    //Events of sites that were unloaded since they were recorded are dropped.
+    std::set<const Site*> sites( reg.sites.begin(), reg.sites.end() );
+    QJsonArray traceEvents;
+    std::vector<Event> events;
+    for ( const std::shared_ptr<ThreadBuffer>& buffer : reg.buffers ){
+        events.clear();
+        buffer->read( since, events );
+        if ( events.empty() ){
+            continue;
+        }
+        QJsonObject threadName;
+        threadName["name"] = QString( "thread_name" );
+        threadName["ph"] = QString( "M" );
+        threadName["pid"] = pid;
+        threadName["tid"] = buffer->getThreadId();
+        QJsonObject args;
+        args["name"] = buffer->getThreadName();
+        threadName["args"] = args;
+        traceEvents.append( threadName );
+        for ( const Event& event : events ){
+            if ( sites.find( event.site ) == sites.end() ){
+                continue;
+            }
+            SiteStats stats = event.site->getStats();
+            QJsonObject obj;
+            obj["name"] = stats.name;
+            obj["cat"] = stats.category;
+            obj["ph"] = QString( "X" );
+            obj["ts"] = event.start / 1e3;
+            obj["dur"] = event.duration / 1e3;
+            obj["pid"] = pid;
+            obj["tid"] = buffer->getThreadId();
+            traceEvents.append( obj );
+            eventCount++;
+        }
+    }
+    double timeStamp = now() / 1e3;
+    for ( const CounterStats& stats : counters ){
+        QJsonObject obj;
+        obj["name"] = stats.name;
+        obj["ph"] = QString( "C" );
+        obj["ts"] = timeStamp;
+        obj["pid"] = pid;
+        QJsonObject args;
+        args["value"] = double( stats.value );
+        obj["args"] = args;
+        traceEvents.append( obj );
+    }
+    QJsonObject doc;
+    doc["traceEvents"] = traceEvents;
+    doc["displayTimeUnit"] = QString( "ms" );
+    return QJsonDocument( doc ).toJson( QJsonDocument::Compact );
+}
+
+}
+
+QByteArray toChromeTrace(){
+    int eventCount = 0;
+    return makeChromeTrace( eventCount );
+}
+
+int writeChromeTrace( const QString& path ){
+    int eventCount = 0;
+    QByteArray json = makeChromeTrace( eventCount );
+    QFile file( path );
+    if ( !file.open( QIODevice::WriteOnly | QIODevice::Truncate ) ){
+        return -1;
+    }
+    if ( file.write( json ) != json.size() ){
+        return -1;
+    }
+    return eventCount;
+}
+
+void reset(){
+    Registry& reg = registry();
+    QMutexLocker locker( &reg.mutex );
+    reg.resetTime = now();
+    for ( Site* site : reg.sites ){
+        site->clear();
+    }
+    for ( Counter* counter : reg.counters ){
+        counter->clear();
+    }
+    reg.buffers.erase( std::remove_if( reg.buffers.begin(), reg.buffers.end(),
+            []( const std::shared_ptr<ThreadBuffer>& buffer ){ return buffer->retired.load(); } ),
+            reg.buffers.end() );
+}
+
+int getEventCapacity(){
+    return EVENT_CAPACITY;
+}
+
+}
+}
+}
@@ -0,0 +1,253 @@
+/**
+ * Low overhead tracing of hot paths.
+ *
+ * An instrumented scope is a Site, a static object that keeps the number of calls
+ * and the total and longest time spent in it.  Every call is also recorded as an
+ * event in a ring buffer owned by the calling thread, so recording never takes a
+ * lock; the most recent events of all threads can be exported in the Chrome trace
+ * format (chrome://tracing, Perfetto).  Counters are named totals for things that
+ * are not timed, such as cache hits.
+ *
+ * Tracing is off until setEnabled( true ).  While it is off an instrumented scope
+ * costs one relaxed atomic load, and building with CARTA_TRACE=0 removes it.
+ *
+ *     void render() {
+ *         CARTA_TRACE_SCOPE( "render", "render" );
+ *         ...
+ *         CARTA_TRACE_COUNT( "render.cacheMiss", 1 );
+ *     }
+ **/
+
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <atomic>
+#include <vector>
+
+#ifndef CARTA_TRACE
+#define CARTA_TRACE 1
+#endif
+
+namespace Carta {
+namespace Lib {
+namespace Trace {
+
+namespace Internal {
+extern std::atomic<bool> enabled;
+}
+
+/**
+ * Returns true if events are being recorded.
+ * @return - true if tracing is on; false otherwise.
+ */
+inline bool isEnabled(){
+    return Internal::enabled.load( std::memory_order_relaxed );
+}
+
+/**
+ * Start or stop recording events.
+ * @param enabled - true to start recording; false to stop.
+ */
+void setEnabled( bool enabled );
+
+/**
+ * Returns a monotonic time stamp.
+ * @return - nanoseconds since the first call.
+ */
+qint64 now();
+
+/// statistics of a site since the last reset
+struct SiteStats {
+    QString category;
+    QString name;
+    quint64 calls = 0;
+    double totalMs = 0;
+    double maxMs = 0;
+};
+
+/// value of a counter since the last reset
+struct CounterStats {
+    QString name;
+    qint64 value = 0;
+};
+
+/**
+ * An instrumented scope: its name and the statistics of its calls.
+ */
+class Site {
+public:
+
+    /**
+     * Constructs and registers a site; sites are meant to be static.
+     * @param category - the group of the site, e.g. "render".
+     * @param name - the name of the site within its category.
+     */
+    Site( const char* category, const char* name );
+
+    /**
+     * Records a call of the site.
+     * @param start - the time stamp at the start of the call.
+     * @param duration - the length of the call in nanoseconds.
+     */
+    void record( qint64 start, qint64 duration );
+
+    /**
+     * Return the statistics of the calls since the last reset.
+     * @return - the number of calls, their total and longest time.
+     */
+    SiteStats getStats() const;
+
+    /**
+     * Clears the statistics.
+     */
+    void clear();
+
+    ~Site();
+
+private:
+
+    Site( const Site& other ) = delete;
+    Site& operator=( const Site& other ) = delete;
+
+    const char* m_category;
+    const char* m_name;
+    std::atomic<quint64> m_calls;
+    std::atomic<qint64> m_totalNs;
+    std::atomic<qint64> m_maxNs;
+};
+
+/**
+ * Times the enclosing scope and records it with its site, if tracing is on.
+ */
+class ScopedTimer {
+public:
+
+    explicit ScopedTimer( Site& site ) :
+        m_site( isEnabled() ? &site : nullptr ),
+        m_start( m_site ? now() : 0 ){
+    }
+
+    ~ScopedTimer(){
+        if ( m_site ){
+            m_site->record( m_start, now() - m_start );
+        }
+    }
+
+private:
+
+    ScopedTimer( const ScopedTimer& other ) = delete;
+    ScopedTimer& operator=( const ScopedTimer& other ) = delete;
+
+    Site* m_site;
+    qint64 m_start;
+};
+
+/**
+ * A named total that is only updated while tracing is on.
+ */
+class Counter {
+public:
+
+    /**
+     * Constructs and registers a counter; counters are meant to be static.
+     * @param name - the name of the counter.
+     */
+    explicit Counter( const char* name );
+
+    /**
+     * Adds to the counter.
+     * @param value - the amount to add.
+     */
+    void add( qint64 value ){
+        if ( isEnabled() ){
+            m_value.fetch_add( value, std::memory_order_relaxed );
+        }
+    }
+
+    /**
+     * Return the value of the counter since the last reset.
+     * @return - the name and value of the counter.
+     */
+    CounterStats getStats() const;
+
+    /**
+     * Sets the counter back to zero.
+     */
+    void clear();
+
+    ~Counter();
+
+private:
+
+    Counter( const Counter& other ) = delete;
+    Counter& operator=( const Counter& other ) = delete;
+
+    const char* m_name;
+    std::atomic<qint64> m_value;
+};
+
+/**
+ * Returns the statistics of the sites that were called since the last reset.
+ * @return - one entry per site, sorted by category and name.
+ */
+std::vector<SiteStats> getSiteStats();
+
+/**
+ * Returns the counters that changed since the last reset.
+ * @return - one entry per counter, sorted by name.
+ */
+std::vector<CounterStats> getCounterStats();
+
+/**
+ * Returns the recorded events of all threads in the Chrome trace event format.
+ * @return - a JSON document with a "traceEvents" array.
+ */
+QByteArray toChromeTrace();
+
+/**
+ * Writes the recorded events in the Chrome trace event format.
+ * @param path - the file to write.
+ * @return - the number of events written, or -1 if the file could not be written.
+ */
+int writeChromeTrace( const QString& path );
+
+/**
+ * Clears the statistics, counters and recorded events.
+ */
+void reset();
+
+/**
+ * Returns the number of events each thread keeps.
+ * @return - the capacity of the per thread ring buffers.
+ */
+int getEventCapacity();
+
+}
+}
+}
+
+#define CARTA_TRACE_CONCAT_( a, b ) a ## b
+#define CARTA_TRACE_CONCAT( a, b ) CARTA_TRACE_CONCAT_( a, b )
+
+#if CARTA_TRACE
+
+/// time the rest of the enclosing scope
+#define CARTA_TRACE_SCOPE( category, name ) \
+    static Carta::Lib::Trace::Site CARTA_TRACE_CONCAT( traceSite_, __LINE__ )( category, name ); \
+    Carta::Lib::Trace::ScopedTimer CARTA_TRACE_CONCAT( traceTimer_, __LINE__ )( \
+        CARTA_TRACE_CONCAT( traceSite_, __LINE__ ) )
+
+/// add to a named counter
+#define CARTA_TRACE_COUNT( name, value ) \
+    do { \
+        static Carta::Lib::Trace::Counter traceCounter_( name ); \
+        traceCounter_.add( value ); \
+    } while ( 0 )
+
+#else
+
+#define CARTA_TRACE_SCOPE( category, name ) do { } while ( 0 )
+#define CARTA_TRACE_COUNT( name, value ) do { } while ( 0 )
+
+#endif
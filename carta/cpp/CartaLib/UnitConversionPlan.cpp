@@ -0,0 +1,599 @@
+/**
+ *
+ **/
+
+#include "UnitConversionPlan.h"
+#include "CartaLib/CartaLib.h"
+#include <QDebug>
+#include <QStringList>
+#include <cmath>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace Carta
+{
+namespace Lib
+{
+namespace
+{
+const double SPEED_OF_LIGHT = 299792458.0;
+
+/// spectral units, each a factor of 10 from the previous one
+const QStringList FREQUENCY_UNITS = {
+    "Hz", "10Hz", "100Hz", "KHz", "10KHz", "100KHz", "MHz", "10MHz", "100MHz", "GHz"
+};
+const QStringList WAVELENGTH_UNITS = {
+    "Angstrom", "nm", "10nm", "100nm", "um", "10um", "100um", "mm", "cm", "dm", "m"
+};
+const QStringList VELOCITY_UNITS = {
+    "m/s", "10m/s", "100m/s", "km/s"
+};
+
+/// exponent of the first entry of the lists above in Hz, m and m/s
+const int FREQUENCY_EXP0 = 0;
+const int WAVELENGTH_EXP0 = - 10;
+const int VELOCITY_EXP0 = 0;
+
+/// intensity units
+const QString FRACTION_OF_PEAK = "Fraction of Peak";
+const QString JY_BEAM = "Jy/beam";
+const QString JY_SR = "MJy/sr";
+const QString JY_ARCSEC = "Jy/arcsec^2";
+const QString JY = "Jy";
+const QString KELVIN = "Kelvin";
+const QString TIMES_PIXELS = "*pixels";
+const double SPEED_LIGHT_FACTOR = 0.0000000009;
+const double FREQUENCY_FACTOR = 2 * 0.0000000000000000000000138;
+const double ARCSECONDS_PER_STERADIAN = 206.265 * 206.265;
+
+/// intensity prefixes, each a factor of 10 from the previous one
+QStringList
+prefixedUnits( const QString & base )
+{
+    QStringList result;
+    for ( const char * prefix : { "p", "n", "u", "m", "", "k", "M", "G" } ) {
+        result << QString( prefix ) + base;
+        if ( result.size() < 22 ) {
+            result << "10" + QString( prefix ) + base << "100" + QString( prefix ) + base;
+        }
+    }
+    return result;
+}
+
+const QStringList BEAM_UNITS = prefixedUnits( JY_BEAM );
+const QStringList JY_UNITS = prefixedUnits( JY_ARCSEC );
+const QStringList JY_SR_UNITS = prefixedUnits( JY_SR );
+const QStringList KELVIN_UNITS = prefixedUnits( KELVIN );
+
+/// factor between two units of a list of decades, 1 if either is not in the list
+double
+decadeFactor( const QStringList & units, const QString & oldUnits, const QString & newUnits )
+{
+    int sourceIndex = units.indexOf( oldUnits );
+    int destIndex = units.indexOf( newUnits );
+    if ( sourceIndex < 0 || destIndex < 0 ) {
+        return 1;
+    }
+    return std::pow( 10.0, sourceIndex - destIndex );
+}
+
+enum class SpectralKind
+{
+    Frequency, Wavelength, Velocity, Channel, Unknown
+};
+
+/// kind of a spectral unit, and the factor to Hz, m or m/s
+SpectralKind
+spectralKind( const QString & unit, double * factor )
+{
+    * factor = 1;
+    int index = FREQUENCY_UNITS.indexOf( unit );
+    if ( index >= 0 ) {
+        * factor = std::pow( 10.0, FREQUENCY_EXP0 + index );
+        return SpectralKind::Frequency;
+    }
+    index = WAVELENGTH_UNITS.indexOf( unit );
+    if ( index >= 0 ) {
+        * factor = std::pow( 10.0, WAVELENGTH_EXP0 + index );
+        return SpectralKind::Wavelength;
+    }
+    index = VELOCITY_UNITS.indexOf( unit );
+    if ( index >= 0 ) {
+        * factor = std::pow( 10.0, VELOCITY_EXP0 + index );
+        return SpectralKind::Velocity;
+    }
+    if ( unit.isEmpty() || unit == "pixel" || unit == "Channel" ) {
+        return SpectralKind::Channel;
+    }
+    return SpectralKind::Unknown;
+}
+
+/// append the conversion to Hz, returns false if it is not possible
+bool
+toHertz( UnitConversionPlan & plan, SpectralKind kind, double factor,
+         const UnitConversionInfo & info )
+{
+    switch ( kind ) {
+    case SpectralKind::Frequency :
+        plan.affine( factor );
+        return true;
+    case SpectralKind::Wavelength :
+        plan.affine( factor ).reciprocal( SPEED_OF_LIGHT );
+        return true;
+    case SpectralKind::Velocity :
+        // radio convention, as used by casacore's SpectralCoordinate::setVelocity()
+        if ( info.restFrequency <= 0 ) {
+            return false;
+        }
+        plan.affine( factor ).affine( - info.restFrequency / SPEED_OF_LIGHT, info.restFrequency );
+        return true;
+    case SpectralKind::Channel :
+        if ( ! info.spectralLinear ) {
+            return false;
+        }
+        plan.affine( info.increment, info.refValue - info.refPixel * info.increment );
+        return true;
+    case SpectralKind::Unknown :
+        break;
+    }
+    return false;
+}
+
+/// append the conversion from Hz, returns false if it is not possible
+bool
+fromHertz( UnitConversionPlan & plan, SpectralKind kind, double factor,
+           const UnitConversionInfo & info )
+{
+    switch ( kind ) {
+    case SpectralKind::Frequency :
+        plan.affine( 1 / factor );
+        return true;
+    case SpectralKind::Wavelength :
+        plan.reciprocal( SPEED_OF_LIGHT ).affine( 1 / factor );
+        return true;
+    case SpectralKind::Velocity :
+        if ( info.restFrequency <= 0 ) {
+            return false;
+        }
+        plan.affine( - SPEED_OF_LIGHT / info.restFrequency, SPEED_OF_LIGHT ).affine( 1 / factor );
+        return true;
+    case SpectralKind::Channel :
+        if ( ! info.spectralLinear || info.increment == 0 ) {
+            return false;
+        }
+        plan.affine( 1 / info.increment, info.refPixel - info.refValue / info.increment );
+        return true;
+    case SpectralKind::Unknown :
+        break;
+    }
+    return false;
+}
+
+bool
+isSupportedIntensity( const QString & units )
+{
+    return units.contains( JY ) || units.contains( KELVIN ) || units.contains( FRACTION_OF_PEAK );
+}
+
+QString
+stripPixels( const QString & units )
+{
+    int pixelIndex = units.indexOf( TIMES_PIXELS );
+    return pixelIndex > 0 ? units.left( pixelIndex ) : units;
+}
+
+bool
+isJansky( const QString & units )
+{
+    return units.indexOf( JY ) >= 0;
+}
+
+bool
+isKelvin( const QString & units )
+{
+    return units.indexOf( KELVIN ) >= 0;
+}
+
+QString
+janskyBaseUnits( const QString & units )
+{
+    int mJyIndex = units.indexOf( JY_SR );
+    if ( mJyIndex >= 0 ) {
+        return units.mid( mJyIndex );
+    }
+    int jyIndex = units.indexOf( JY );
+    return jyIndex >= 0 ? units.mid( jyIndex ) : units;
+}
+
+QString
+kelvinBaseUnits( const QString & units )
+{
+    int kelvinIndex = units.indexOf( KELVIN );
+    return kelvinIndex > 0 ? units.mid( kelvinIndex ) : units;
+}
+
+/// factor for changing the prefix of Jansky or Kelvin units, e.g. mJy/beam -> Jy/beam
+double
+prefixFactor( const QString & oldUnits, const QString & newUnits )
+{
+    if ( isJansky( oldUnits ) ) {
+        if ( oldUnits.contains( JY_BEAM ) && newUnits.contains( JY_BEAM ) ) {
+            return decadeFactor( BEAM_UNITS, oldUnits, newUnits );
+        }
+        if ( oldUnits.contains( JY_SR ) && newUnits.contains( JY_SR ) ) {
+            return decadeFactor( JY_SR_UNITS, oldUnits, newUnits );
+        }
+        return decadeFactor( JY_UNITS, oldUnits, newUnits );
+    }
+    if ( isKelvin( oldUnits ) && isKelvin( newUnits ) ) {
+        return decadeFactor( KELVIN_UNITS, oldUnits, newUnits );
+    }
+    return 1;
+}
+
+/// factor between Jy/beam, MJy/sr and Jy/arcsec^2
+double
+nonKelvinFactor( const QString & oldUnits, const QString & newUnits, double beamArea )
+{
+    double factor = 1;
+    if ( oldUnits == newUnits ) {
+        return factor;
+    }
+    if ( oldUnits == JY_BEAM ) {
+        if ( beamArea != 0 ) {
+            factor /= beamArea;
+        }
+        if ( newUnits == JY_SR ) {
+            factor *= ARCSECONDS_PER_STERADIAN;
+        }
+    }
+    else if ( oldUnits == JY_SR ) {
+        factor /= ARCSECONDS_PER_STERADIAN;
+        if ( newUnits == JY_BEAM && beamArea != 0 ) {
+            factor *= beamArea;
+        }
+    }
+    else if ( oldUnits == JY_ARCSEC ) {
+        if ( newUnits == JY_SR ) {
+            factor *= ARCSECONDS_PER_STERADIAN;
+        }
+        else if ( newUnits == JY_BEAM ) {
+            if ( beamArea != 0 ) {
+                factor *= beamArea;
+            }
+        }
+        else {
+            qDebug() << "Unsupported units: " << newUnits;
+        }
+    }
+    return factor;
+}
+
+void
+affineKernel( double * values, size_t count, double a, double b )
+{
+    size_t i = 0;
+#ifdef __SSE2__
+    const __m128d av = _mm_set1_pd( a );
+    const __m128d bv = _mm_set1_pd( b );
+    for ( ; i + 2 <= count ; i += 2 ) {
+        __m128d x = _mm_loadu_pd( values + i );
+        _mm_storeu_pd( values + i, _mm_add_pd( _mm_mul_pd( x, av ), bv ) );
+    }
+#endif
+    for ( ; i < count ; i++ ) {
+        values[i] = values[i] * a + b;
+    }
+}
+
+void
+reciprocalKernel( double * values, size_t count, double a )
+{
+    size_t i = 0;
+#ifdef __SSE2__
+    const __m128d av = _mm_set1_pd( a );
+    for ( ; i + 2 <= count ; i += 2 ) {
+        __m128d x = _mm_loadu_pd( values + i );
+        _mm_storeu_pd( values + i, _mm_div_pd( av, x ) );
+    }
+#endif
+    for ( ; i < count ; i++ ) {
+        values[i] = a / values[i];
+    }
+}
+
+/// values * a * aux^2, or values * a / aux^2
+template < bool Multiply >
+void
+scaleByAuxKernel( double * values, size_t count, const double * aux, double a )
+{
+    size_t i = 0;
+#ifdef __SSE2__
+    const __m128d av = _mm_set1_pd( a );
+    for ( ; i + 2 <= count ; i += 2 ) {
+        __m128d x = _mm_mul_pd( _mm_loadu_pd( values + i ), av );
+        __m128d f = _mm_loadu_pd( aux + i );
+        f = _mm_mul_pd( f, f );
+        _mm_storeu_pd( values + i, Multiply ? _mm_mul_pd( x, f ) : _mm_div_pd( x, f ) );
+    }
+#endif
+    for ( ; i < count ; i++ ) {
+        double f = aux[i] * aux[i];
+        values[i] = Multiply ? values[i] * a * f : values[i] * a / f;
+    }
+}
+}
+
+void
+UnitConversionInfo::merge( const UnitConversionInfo & other )
+{
+    if ( ! spectralValid && other.spectralValid ) {
+        spectralValid = true;
+        restFrequency = other.restFrequency;
+        spectralLinear = other.spectralLinear;
+        refPixel = other.refPixel;
+        refValue = other.refValue;
+        increment = other.increment;
+    }
+    if ( ! beamValid && other.beamValid ) {
+        beamValid = true;
+        beamAngle = other.beamAngle;
+        beamArea = other.beamArea;
+    }
+}
+
+UnitConversionPlan::UnitConversionPlan()
+{ }
+
+bool
+UnitConversionPlan::needsAux() const
+{
+    for ( const Step & step : m_steps ) {
+        if ( step.type == StepType::ScaleByAux ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+UnitConversionPlan &
+UnitConversionPlan::affine( double a, double b )
+{
+    _push( { StepType::Affine, a, b, 0 } );
+    return * this;
+}
+
+UnitConversionPlan &
+UnitConversionPlan::reciprocal( double a )
+{
+    _push( { StepType::Reciprocal, a, 0, 0 } );
+    return * this;
+}
+
+UnitConversionPlan &
+UnitConversionPlan::scaleByAux( double a, int power )
+{
+    CARTA_ASSERT( power == 2 || power == - 2 );
+    _push( { StepType::ScaleByAux, a, 0, power } );
+    return * this;
+}
+
+UnitConversionPlan &
+UnitConversionPlan::then( const UnitConversionPlan & other )
+{
+    m_valid = m_valid && other.m_valid;
+    for ( const Step & step : other.m_steps ) {
+        _push( step );
+    }
+    return * this;
+}
+
+void
+UnitConversionPlan::_push( const Step & step )
+{
+    // fold pure scaling into the neighbouring step where the result is the same
+    if ( ! m_steps.empty() ) {
+        Step & last = m_steps.back();
+        if ( last.type == StepType::Affine && step.type == StepType::Affine ) {
+            last.b = last.b * step.a + step.b;
+            last.a *= step.a;
+            if ( last.a == 1 && last.b == 0 ) {
+                m_steps.pop_back();
+            }
+            return;
+        }
+        if ( step.type == StepType::Affine && step.b == 0 && last.type != StepType::Affine ) {
+            // a * f( x ) * s
+            last.a *= step.a;
+            return;
+        }
+        if ( last.type == StepType::Affine && last.b == 0 ) {
+            if ( step.type == StepType::ScaleByAux ) {
+                Step merged = step;
+                merged.a *= last.a;
+                last = merged;
+                return;
+            }
+            if ( step.type == StepType::Reciprocal ) {
+                Step merged = step;
+                merged.a /= last.a;
+                last = merged;
+                return;
+            }
+        }
+    }
+    if ( step.type == StepType::Affine && step.a == 1 && step.b == 0 ) {
+        return;
+    }
+    m_steps.push_back( step );
+}
+
+void
+UnitConversionPlan::apply( double * values, size_t count, const double * aux ) const
+{
+    if ( ! m_valid ) {
+        return;
+    }
+    if ( ! aux && needsAux() ) {
+        qWarning() << "Unit conversion needs frequencies, values left unchanged";
+        return;
+    }
+    for ( const Step & step : m_steps ) {
+        switch ( step.type ) {
+        case StepType::Affine :
+            affineKernel( values, count, step.a, step.b );
+            break;
+        case StepType::Reciprocal :
+            reciprocalKernel( values, count, step.a );
+            break;
+        case StepType::ScaleByAux :
+            if ( step.power > 0 ) {
+                scaleByAuxKernel < true > ( values, count, aux, step.a );
+            }
+            else {
+                scaleByAuxKernel < false > ( values, count, aux, step.a );
+            }
+            break;
+        }
+    }
+}
+
+void
+UnitConversionPlan::apply( std::vector < double > & values, const std::vector < double > & aux ) const
+{
+    if ( needsAux() && aux.size() < values.size() ) {
+        qWarning() << "Unit conversion needs a frequency for every value, values left unchanged";
+        return;
+    }
+    apply( values.data(), values.size(), aux.empty() ? nullptr : aux.data() );
+}
+
+UnitConversionPlan
+UnitConversionPlan::invalid()
+{
+    UnitConversionPlan plan;
+    plan.m_valid = false;
+    return plan;
+}
+
+UnitConversionPlan
+UnitConversionPlan::spectral( const QString & oldUnits,
+                              const QString & newUnits,
+                              const UnitConversionInfo & info )
+{
+    double oldFactor, newFactor;
+    SpectralKind oldKind = spectralKind( oldUnits, & oldFactor );
+    SpectralKind newKind = spectralKind( newUnits, & newFactor );
+    if ( oldKind == SpectralKind::Unknown || newKind == SpectralKind::Unknown ) {
+        return invalid();
+    }
+
+    // within a kind it is just a change of prefix, no need for the coordinate system
+    UnitConversionPlan plan;
+    if ( oldKind == newKind ) {
+        if ( oldKind != SpectralKind::Channel ) {
+            plan.affine( oldFactor / newFactor );
+        }
+        return plan;
+    }
+    if ( ! info.spectralValid ) {
+        return invalid();
+    }
+    if ( ! toHertz( plan, oldKind, oldFactor, info ) ||
+         ! fromHertz( plan, newKind, newFactor, info ) ) {
+        return invalid();
+    }
+    return plan;
+}
+
+UnitConversionPlan
+UnitConversionPlan::intensity( const QString & oldUnits,
+                               const QString & newUnits,
+                               double maxValue,
+                               const QString & maxUnits,
+                               const UnitConversionInfo & info )
+{
+    if ( ! info.beamValid ) {
+        return invalid();
+    }
+    return intensity( oldUnits, newUnits, maxValue, maxUnits, info.beamAngle, info.beamArea );
+}
+
+UnitConversionPlan
+UnitConversionPlan::intensity( const QString & oldUnits,
+                               const QString & newUnits,
+                               double maxValue,
+                               const QString & maxUnits,
+                               double beamAngle,
+                               double beamArea )
+{
+    if ( ! isSupportedIntensity( oldUnits ) || ! isSupportedIntensity( newUnits ) ) {
+        return invalid();
+    }
+
+    QString newUnitsBase = stripPixels( newUnits );
+    QString oldUnitsBase = stripPixels( oldUnits );
+
+    // fraction of peak goes back to the units of the peak first
+    UnitConversionPlan plan;
+    QString baseConvertUnits = oldUnitsBase;
+    if ( oldUnitsBase == FRACTION_OF_PEAK && newUnitsBase != FRACTION_OF_PEAK ) {
+        plan.affine( maxValue );
+        baseConvertUnits = stripPixels( maxUnits );
+    }
+    if ( baseConvertUnits == newUnitsBase ) {
+        return plan;
+    }
+    if ( newUnitsBase == FRACTION_OF_PEAK ) {
+        return plan.affine( 1 / maxValue );
+    }
+
+    // strip prefixes such as m or k, convert the base units, and add the new prefix
+    QString strippedBase = baseConvertUnits;
+    if ( isJansky( baseConvertUnits ) ) {
+        strippedBase = janskyBaseUnits( baseConvertUnits );
+    }
+    else if ( isKelvin( baseConvertUnits ) ) {
+        strippedBase = kelvinBaseUnits( baseConvertUnits );
+    }
+    plan.affine( prefixFactor( baseConvertUnits, strippedBase ) );
+
+    QString strippedNew = newUnitsBase;
+    if ( isJansky( newUnitsBase ) ) {
+        strippedNew = janskyBaseUnits( newUnitsBase );
+    }
+    else if ( isKelvin( newUnitsBase ) ) {
+        strippedNew = kelvinBaseUnits( newUnitsBase );
+    }
+
+    if ( strippedBase != KELVIN && strippedNew != KELVIN ) {
+        plan.affine( nonKelvinFactor( strippedBase, strippedNew, beamArea ) );
+    }
+    else if ( strippedBase == KELVIN && strippedNew != KELVIN ) {
+        //kelvin * solidAngle * 2 * 1.38 x 10^-23 * freq^2 / (10^-32 x (3 x 10^8)^2)
+        if ( beamAngle > 0 ) {
+            plan.scaleByAux( beamAngle * FREQUENCY_FACTOR / SPEED_LIGHT_FACTOR, 2 );
+            plan.affine( nonKelvinFactor( JY_BEAM, strippedNew, beamArea ) );
+        }
+        else {
+            qDebug() << "Could not convert from Kelvin because the beam solid angle was 0";
+        }
+    }
+    else if ( strippedBase != KELVIN && strippedNew == KELVIN ) {
+        //Jy/beam x 10^(-32) x (3 x 10^8)^2 / ( solidAngle x 2 x 1.38 x 10^-23 x (xvalueinHz)^2 ).
+        if ( beamAngle > 0 ) {
+            plan.affine( nonKelvinFactor( strippedBase, JY_BEAM, beamArea ) );
+            plan.scaleByAux( SPEED_LIGHT_FACTOR / ( beamAngle * FREQUENCY_FACTOR ), - 2 );
+        }
+        else {
+            qDebug() << "Could not convert to Kelvin because the beamSolidAngle was 0";
+        }
+    }
+
+    plan.affine( prefixFactor( strippedNew, newUnitsBase ) );
+    return plan;
+}
+}
+}
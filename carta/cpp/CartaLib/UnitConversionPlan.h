@@ -0,0 +1,165 @@
+/**
+ * Precompiled conversions between spectral and intensity units.
+ *
+ * Parsing the unit strings and deciding what to do happens once, when a plan is
+ * built. The result is a short chain of steps (scale and offset, reciprocal, scaling by
+ * a power of a per-point auxiliary value) that is then applied to whole arrays with
+ * tight loops, without looking at the units again.
+ *
+ * The rules follow the ConversionSpectral and ConversionIntensity plugins, so the core
+ * can convert profiles directly, and only needs to ask the plugins (once per image)
+ * for the few numbers that come from the coordinate system, see UnitConversionInfo.
+ **/
+
+#pragma once
+
+#include <QString>
+#include <vector>
+
+namespace Carta
+{
+namespace Lib
+{
+/// what the conversion plans need to know about an image
+struct UnitConversionInfo
+{
+    /// whether the spectral fields below were filled in
+    bool spectralValid = false;
+
+    /// rest frequency in Hz, 0 if unknown (no velocity conversions then)
+    double restFrequency = 0;
+
+    /// whether the spectral axis is linear in frequency, the pixel <-> world
+    /// conversions are only possible then
+    bool spectralLinear = false;
+
+    /// frequency (Hz) = refValue + ( pixel - refPixel ) * increment
+    double refPixel = 0;
+    double refValue = 0;
+    double increment = 0;
+
+    /// whether the beam fields below were filled in
+    bool beamValid = false;
+
+    /// beam solid angle in steradians, 0 if there is no beam
+    double beamAngle = 0;
+
+    /// beam area in square arcseconds
+    double beamArea = 0;
+
+    /// fill in whatever other has and this doesn't
+    void
+    merge( const UnitConversionInfo & other );
+};
+
+class UnitConversionPlan
+{
+public:
+
+    /// identity
+    UnitConversionPlan();
+
+    /// whether the units were understood, an invalid plan leaves values alone
+    bool
+    isValid() const
+    {
+        return m_valid;
+    }
+
+    /// whether applying the plan would not change anything
+    bool
+    isIdentity() const
+    {
+        return m_steps.empty();
+    }
+
+    /// whether apply() needs the auxiliary values (frequencies in Hz for intensity
+    /// conversions to and from Kelvin)
+    bool
+    needsAux() const;
+
+    /// number of steps, after merging consecutive linear ones
+    size_t
+    stepCount() const
+    {
+        return m_steps.size();
+    }
+
+    /// y = a * x + b
+    UnitConversionPlan &
+    affine( double a, double b = 0 );
+
+    /// y = a / x
+    UnitConversionPlan &
+    reciprocal( double a );
+
+    /// y = a * x * aux^power, power is 2 or -2
+    UnitConversionPlan &
+    scaleByAux( double a, int power );
+
+    /// append all steps of another plan
+    UnitConversionPlan &
+    then( const UnitConversionPlan & other );
+
+    /// convert values in place
+    /// \param aux one auxiliary value per value, only read if needsAux()
+    void
+    apply( double * values, size_t count, const double * aux = nullptr ) const;
+
+    /// convenience for vectors, values are left alone if aux is too short
+    void
+    apply( std::vector < double > & values,
+           const std::vector < double > & aux = std::vector < double > () ) const;
+
+    /// spectral units as used by the profiler, e.g. "GHz", "mm" or "km/s"; empty,
+    /// "pixel" or "Channel" stand for channels
+    static UnitConversionPlan
+    spectral( const QString & oldUnits,
+              const QString & newUnits,
+              const UnitConversionInfo & info );
+
+    /// intensity units, e.g. "mJy/beam", "Kelvin" or "Fraction of Peak"; frequencies
+    /// (in Hz) have to be passed as aux values if needsAux()
+    /// \param maxValue, maxUnits the peak used for "Fraction of Peak"
+    static UnitConversionPlan
+    intensity( const QString & oldUnits,
+               const QString & newUnits,
+               double maxValue,
+               const QString & maxUnits,
+               const UnitConversionInfo & info );
+
+    /// same, with the beam given directly
+    static UnitConversionPlan
+    intensity( const QString & oldUnits,
+               const QString & newUnits,
+               double maxValue,
+               const QString & maxUnits,
+               double beamAngle,
+               double beamArea );
+
+    /// a plan that does nothing and reports itself as invalid
+    static UnitConversionPlan
+    invalid();
+
+private:
+
+    enum class StepType
+    {
+        Affine, Reciprocal, ScaleByAux
+    };
+
+    struct Step {
+        StepType type;
+        double a;
+        double b;
+        int power;
+    };
+
+    void
+    _push( const Step & step );
+
+    std::vector < Step > m_steps;
+    bool m_valid = true;
+};
+}
+}
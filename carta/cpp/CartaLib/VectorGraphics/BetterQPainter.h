@@ -161,6 +161,13 @@ public:
         m_qPainter.setTransform( t, combine );
     }
 
+    /// restrict drawing to the given rectangle
+    void
+    setClipRect( const QRectF & rect )
+    {
+        m_qPainter.setClipRect( rect );
+    }
+
     /// draw a rectangle filled with the given color, no outline
     void
     fillRect( const QRectF & rect, const QColor & color )
@@ -35,6 +35,16 @@ VGList::~VGList()
 //    return m_qImage;
 //}
 
+void
+Entries::DrawPacked::binary( VGStreamWriter & w )
+{
+    // re-encode the commands, the outer stream has its own tables and scale
+    VGList list = VGStream::decode( m_stream );
+    for ( auto & entry : list.entries() ) {
+        entry-> binary( w );
+    }
+}
+
 bool
 VGListQPainterRenderer::render( const VGList & vgList, QPainter & qPainter )
 {
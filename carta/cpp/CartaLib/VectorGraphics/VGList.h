@@ -4,6 +4,7 @@
 
 #include "../CartaLib.h"
 #include "BetterQPainter.h"
+#include "VGStream.h"
 #include <QMetaType>
 #include <QImage>
 #include <QStringList>
@@ -33,6 +34,10 @@ public:
     virtual QStringList
     javascript() = 0;
 
+    /// an entry needs to be able to write itself into a packed VG stream
+    virtual void
+    binary( VGStreamWriter & writer ) = 0;
+
     virtual
     ~IVGListEntry() { }
 };
@@ -48,6 +53,10 @@ public:
     {
         painter.reset();
     }
+    virtual void binary( VGStreamWriter & w ) override
+    {
+        w.op( VGOp::Reset );
+    }
     virtual QStringList javascript() override
     {
         return QStringList()
@@ -74,6 +83,14 @@ public:
         painter.drawLine( m_p1, m_p2 );
     }
 
+    virtual void
+    binary( VGStreamWriter & w ) override
+    {
+        w.op( VGOp::DrawLine );
+        w.point( m_p1 );
+        w.point( m_p2 );
+    }
+
     virtual QStringList
     javascript() override
     {
@@ -105,6 +122,13 @@ public:
         painter.drawPolyline( m_poly );
     }
 
+    virtual void
+    binary( VGStreamWriter & w ) override
+    {
+        w.op( VGOp::DrawPolyline );
+        w.polyline( m_poly );
+    }
+
     virtual QStringList
     javascript() override
     {
@@ -135,6 +159,13 @@ public:
         painter.setPenWidth( m_width );
     }
 
+    virtual void
+    binary( VGStreamWriter & w ) override
+    {
+        w.op( VGOp::SetPenWidth );
+        w.real( m_width );
+    }
+
     virtual QStringList
     javascript() override
     {
@@ -166,6 +197,13 @@ public:
         painter.setPenColor( m_color );
     }
 
+    virtual void
+    binary( VGStreamWriter & w ) override
+    {
+        w.op( VGOp::SetPenColor );
+        w.color( m_color );
+    }
+
     virtual QStringList
     javascript() override
     {
@@ -197,6 +235,13 @@ public:
         painter.setPen( m_pen );
     }
 
+    virtual void
+    binary( VGStreamWriter & w ) override
+    {
+        w.op( VGOp::SetPen );
+        w.pen( m_pen );
+    }
+
     virtual QStringList
     javascript() override
     {
@@ -230,6 +275,13 @@ public:
         painter.setFontIndex( m_fontIndex );
     }
 
+    virtual void
+    binary( VGStreamWriter & w ) override
+    {
+        w.op( VGOp::SetFontIndex );
+        w.index( m_fontIndex );
+    }
+
     virtual QStringList
     javascript() override
     {
@@ -261,6 +313,13 @@ public:
         painter.setFontSize( m_size );
     }
 
+    virtual void
+    binary( VGStreamWriter & w ) override
+    {
+        w.op( VGOp::SetFontSize );
+        w.real( m_size );
+    }
+
     virtual QStringList
     javascript() override
     {
@@ -290,6 +349,12 @@ public:
         painter.save();
     }
 
+    virtual void
+    binary( VGStreamWriter & w ) override
+    {
+        w.op( VGOp::Save );
+    }
+
     virtual QStringList
     javascript() override
     {
@@ -316,6 +381,12 @@ public:
         painter.restore();
     }
 
+    virtual void
+    binary( VGStreamWriter & w ) override
+    {
+        w.op( VGOp::Restore );
+    }
+
     virtual QStringList
     javascript() override
     {
@@ -345,6 +416,14 @@ public:
         painter.setTransform( m_transform, m_combine );
     }
 
+    virtual void
+    binary( VGStreamWriter & w ) override
+    {
+        w.op( VGOp::SetTransform );
+        w.transform( m_transform );
+        w.index( m_combine );
+    }
+
     virtual QStringList
     javascript() override
     {
@@ -360,6 +439,47 @@ private:
     bool m_combine = false;
 };
 
+/// set a clip rectangle
+class SetClipRect : public IVGListEntry
+{
+    CLASS_BOILERPLATE( SetClipRect );
+
+public:
+
+    SetClipRect( const QRectF & rect )
+    {
+        m_rect = rect;
+    }
+
+    virtual void
+    cplusplus( BetterQPainter & painter ) override
+    {
+        painter.setClipRect( m_rect );
+    }
+
+    virtual void
+    binary( VGStreamWriter & w ) override
+    {
+        w.op( VGOp::SetClipRect );
+        w.rect( m_rect );
+    }
+
+    virtual QStringList
+    javascript() override
+    {
+        return QStringList()
+               << QString( "p.beginPath();" )
+               << QString( "p.rect(%1,%2,%3,%4);" )
+                   .arg( m_rect.x() ).arg( m_rect.y() )
+                   .arg( m_rect.width() ).arg( m_rect.height() )
+               << QString( "p.clip();" );
+    }
+
+private:
+
+    QRectF m_rect;
+};
+
 /// draw a filled rectangle
 class FillRect : public IVGListEntry
 {
@@ -379,6 +499,14 @@ public:
         painter.fillRect( m_rect, m_color );
     }
 
+    virtual void
+    binary( VGStreamWriter & w ) override
+    {
+        w.op( VGOp::FillRect );
+        w.rect( m_rect );
+        w.color( m_color );
+    }
+
     virtual QStringList
     javascript() override
     {
@@ -415,6 +543,13 @@ public:
         painter.drawRect( m_rect);
     }
 
+    virtual void
+    binary( VGStreamWriter & w ) override
+    {
+        w.op( VGOp::DrawRect );
+        w.rect( m_rect );
+    }
+
     virtual QStringList
     javascript() override
     {
@@ -450,6 +585,14 @@ public:
         painter.drawText( m_text, m_pos );
     }
 
+    virtual void
+    binary( VGStreamWriter & w ) override
+    {
+        w.op( VGOp::DrawText );
+        w.text( m_text );
+        w.point( m_pos );
+    }
+
     virtual QStringList
     javascript() override
     {
@@ -489,6 +632,14 @@ public:
         painter.storeIndexedPen( m_ind, m_pen );
     }
 
+    virtual void
+    binary( VGStreamWriter & w ) override
+    {
+        w.op( VGOp::StoreIndexedPen );
+        w.index( m_ind );
+        w.pen( m_pen );
+    }
+
     virtual QStringList
     javascript() override
     {
@@ -523,6 +674,13 @@ public:
         painter.setIndexedPen( m_ind );
     }
 
+    virtual void
+    binary( VGStreamWriter & w ) override
+    {
+        w.op( VGOp::SetIndexedPen );
+        w.index( m_ind );
+    }
+
     virtual QStringList
     javascript() override
     {
@@ -555,6 +713,14 @@ public:
         painter.storeIndexedBrush( m_ind, m_brush );
     }
 
+    virtual void
+    binary( VGStreamWriter & w ) override
+    {
+        w.op( VGOp::StoreIndexedBrush );
+        w.index( m_ind );
+        w.brush( m_brush );
+    }
+
     virtual QStringList
     javascript() override
     {
@@ -588,6 +754,13 @@ public:
         painter.setIndexedBrush( m_ind );
     }
 
+    virtual void
+    binary( VGStreamWriter & w ) override
+    {
+        w.op( VGOp::SetIndexedBrush );
+        w.index( m_ind );
+    }
+
     virtual QStringList
     javascript() override
     {
@@ -619,6 +792,13 @@ public:
         painter.setBrush( m_brush );
     }
 
+    virtual void
+    binary( VGStreamWriter & w ) override
+    {
+        w.op( VGOp::SetBrush );
+        w.brush( m_brush );
+    }
+
     virtual QStringList
     javascript() override
     {
@@ -631,6 +811,41 @@ private:
 
     QBrush m_brush { "black" };
 };
+
+/// many commands packed into a single VG stream, which avoids an entry object for
+/// each of them, e.g. for contours
+class DrawPacked : public IVGListEntry
+{
+    CLASS_BOILERPLATE( DrawPacked );
+
+public:
+
+    DrawPacked( const QByteArray & stream )
+    {
+        m_stream = stream;
+    }
+
+    virtual void
+    cplusplus( BetterQPainter & painter ) override
+    {
+        VGStream::render( m_stream, painter );
+    }
+
+    virtual void
+    binary( VGStreamWriter & w ) override;
+
+    virtual QStringList
+    javascript() override
+    {
+        return QStringList()
+               << QString( "p.drawPacked('%1');" )
+                   .arg( QString( m_stream.toBase64() ) );
+    }
+
+private:
+
+    QByteArray m_stream;
+};
 }
 
 
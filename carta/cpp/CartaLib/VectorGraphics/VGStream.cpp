@@ -0,0 +1,732 @@
+/**
+ *
+ **/
+
+#include "VGStream.h"
+#include "VGList.h"
+#include <QtEndian>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Carta
+{
+namespace Lib
+{
+namespace VectorGraphics
+{
+namespace
+{
+const char Magic[] = "VGS1";
+const int MagicSize = 4;
+const quint8 FlagQuantised = 1;
+
+/// never quantise finer than this, 1/32 of a pixel is plenty for drawing and keeps
+/// deltas between neighbouring points of a contour within a single byte
+const double MaxScale = 32;
+
+quint64
+zigzag( qint64 value )
+{
+    return ( quint64( value ) << 1 ) ^ quint64( value >> 63 );
+}
+
+qint64
+unzigzag( quint64 value )
+{
+    return qint64( value >> 1 ) ^ - qint64( value & 1 );
+}
+
+void
+putVarint( QByteArray & out, quint64 value )
+{
+    while ( value >= 0x80 ) {
+        out.append( char ( ( value & 0x7f ) | 0x80 ) );
+        value >>= 7;
+    }
+    out.append( char ( value ) );
+}
+
+void
+putU8( QByteArray & out, quint8 value )
+{
+    out.append( char ( value ) );
+}
+
+void
+putU32( QByteArray & out, quint32 value )
+{
+    char buff[4];
+    qToLittleEndian( value, reinterpret_cast < uchar * > ( buff ) );
+    out.append( buff, 4 );
+}
+
+void
+putF32( QByteArray & out, double value )
+{
+    float f = value;
+    quint32 bits;
+    std::memcpy( & bits, & f, 4 );
+    putU32( out, bits );
+}
+
+void
+putPen( QByteArray & out, const QPen & pen )
+{
+    putU32( out, pen.color().rgba() );
+    putF32( out, pen.widthF() );
+    putU8( out, pen.style() );
+    putU8( out, pen.capStyle() >> 4 );
+    putU8( out, pen.joinStyle() >> 6 );
+    putU8( out, pen.isCosmetic() );
+}
+
+void
+putBrush( QByteArray & out, const QBrush & brush )
+{
+    // gradients and textures are sent as their color
+    Qt::BrushStyle style = brush.style();
+    if ( style > Qt::DiagCrossPattern ) {
+        style = Qt::SolidPattern;
+    }
+    putU32( out, brush.color().rgba() );
+    putU8( out, style );
+}
+
+/// parses a stream, marks it as bad on the first error after which everything
+/// reads as zero
+class Reader
+{
+public:
+
+    Reader( const QByteArray & data )
+        : m_ptr( reinterpret_cast < const uchar * > ( data.constData() ) )
+          , m_end( m_ptr + data.size() )
+    {
+        if ( data.size() < MagicSize + 1 || std::memcmp( m_ptr, Magic, MagicSize ) != 0 ) {
+            fail();
+            return;
+        }
+        m_ptr += MagicSize;
+        quint8 flags = u8();
+        if ( flags & FlagQuantised ) {
+            m_scale = real();
+            if ( ! ( m_scale > 0 ) ) {
+                fail();
+            }
+        }
+        quint64 nPens = _count( 8 );
+        for ( quint64 i = 0 ; i < nPens && m_ok ; i++ ) {
+            QColor color = QColor::fromRgba( u32() );
+            QPen pen( color, real() );
+            pen.setStyle( Qt::PenStyle( u8() ) );
+            pen.setCapStyle( Qt::PenCapStyle( u8() << 4 ) );
+            pen.setJoinStyle( Qt::PenJoinStyle( u8() << 6 ) );
+            pen.setCosmetic( u8() );
+            m_pens.push_back( pen );
+        }
+        quint64 nBrushes = _count( 5 );
+        for ( quint64 i = 0 ; i < nBrushes && m_ok ; i++ ) {
+            QColor color = QColor::fromRgba( u32() );
+            m_brushes.push_back( QBrush( color, Qt::BrushStyle( u8() ) ) );
+        }
+    }
+
+    bool
+    ok() const
+    {
+        return m_ok;
+    }
+
+    bool
+    atEnd() const
+    {
+        return m_ptr >= m_end;
+    }
+
+    void
+    fail()
+    {
+        m_ok = false;
+        m_ptr = m_end;
+    }
+
+    quint8
+    u8()
+    {
+        if ( m_end - m_ptr < 1 ) {
+            fail();
+            return 0;
+        }
+        return * m_ptr++;
+    }
+
+    quint32
+    u32()
+    {
+        if ( m_end - m_ptr < 4 ) {
+            fail();
+            return 0;
+        }
+        quint32 value = qFromLittleEndian < quint32 > ( m_ptr );
+        m_ptr += 4;
+        return value;
+    }
+
+    quint64
+    index()
+    {
+        quint64 value = 0;
+        for ( int shift = 0 ; shift < 64 ; shift += 7 ) {
+            quint8 byte = u8();
+            value |= quint64( byte & 0x7f ) << shift;
+            if ( ! ( byte & 0x80 ) ) {
+                return value;
+            }
+        }
+        fail();
+        return 0;
+    }
+
+    qint64
+    integer()
+    {
+        return unzigzag( index() );
+    }
+
+    double
+    real()
+    {
+        quint32 bits = u32();
+        float f;
+        std::memcpy( & f, & bits, 4 );
+        return f;
+    }
+
+    qint16
+    i16()
+    {
+        quint16 lo = u8();
+        quint16 hi = u8();
+        return qint16( lo | ( hi << 8 ) );
+    }
+
+    QColor
+    color()
+    {
+        return QColor::fromRgba( u32() );
+    }
+
+    double
+    coordinate()
+    {
+        if ( m_scale > 0 ) {
+            return i16() / m_scale;
+        }
+        return real();
+    }
+
+    QPointF
+    point()
+    {
+        double x = coordinate();
+        return QPointF( x, coordinate() );
+    }
+
+    QRectF
+    rect()
+    {
+        QPointF pos = point();
+        QPointF size = point();
+        return QRectF( pos.x(), pos.y(), size.x(), size.y() );
+    }
+
+    QPolygonF
+    polyline()
+    {
+        // every point takes at least two bytes
+        quint64 count = _count( 2 );
+        QPolygonF poly;
+        if ( count == 0 || ! m_ok ) {
+            return poly;
+        }
+        poly.reserve( count );
+        if ( m_scale > 0 ) {
+            qint64 x = i16();
+            qint64 y = i16();
+            poly.append( QPointF( x / m_scale, y / m_scale ) );
+            for ( quint64 i = 1 ; i < count && m_ok ; i++ ) {
+                x += integer();
+                y += integer();
+                poly.append( QPointF( x / m_scale, y / m_scale ) );
+            }
+        }
+        else {
+            for ( quint64 i = 0 ; i < count && m_ok ; i++ ) {
+                poly.append( point() );
+            }
+        }
+        return poly;
+    }
+
+    QPen
+    pen()
+    {
+        quint64 ind = index();
+        if ( ind >= m_pens.size() ) {
+            fail();
+            return QPen();
+        }
+        return m_pens[ind];
+    }
+
+    QBrush
+    brush()
+    {
+        quint64 ind = index();
+        if ( ind >= m_brushes.size() ) {
+            fail();
+            return QBrush();
+        }
+        return m_brushes[ind];
+    }
+
+    QString
+    text()
+    {
+        quint64 size = _count( 1 );
+        QString result = QString::fromUtf8( reinterpret_cast < const char * > ( m_ptr ), size );
+        m_ptr += size;
+        return result;
+    }
+
+    QTransform
+    transform()
+    {
+        double m[6];
+        for ( double & v : m ) {
+            v = real();
+        }
+        return QTransform( m[0], m[1], m[2], m[3], m[4], m[5] );
+    }
+
+private:
+
+    /// read a count of items taking at least minSize bytes each, making sure the
+    /// stream is long enough for them
+    quint64
+    _count( int minSize )
+    {
+        quint64 count = index();
+        if ( count > quint64( m_end - m_ptr ) / minSize ) {
+            fail();
+            return 0;
+        }
+        return count;
+    }
+
+    const uchar * m_ptr;
+    const uchar * m_end;
+    bool m_ok = true;
+    double m_scale = 0;
+    std::vector < QPen > m_pens;
+    std::vector < QBrush > m_brushes;
+};
+
+/// parse a stream and hand each command to the sink, which has the same API as
+/// BetterQPainter
+template < typename Sink >
+bool
+replay( const QByteArray & data, Sink & sink )
+{
+    Reader r( data );
+    while ( r.ok() && ! r.atEnd() ) {
+        switch ( VGOp( r.u8() ) ) {
+        case VGOp::Reset:
+            sink.reset();
+            break;
+        case VGOp::DrawLine: {
+            QPointF p1 = r.point();
+            QPointF p2 = r.point();
+            if ( r.ok() ) {
+                sink.drawLine( p1, p2 );
+            }
+            break;
+        }
+        case VGOp::DrawPolyline: {
+            QPolygonF poly = r.polyline();
+            if ( r.ok() ) {
+                sink.drawPolyline( poly );
+            }
+            break;
+        }
+        case VGOp::SetPenWidth: {
+            double width = r.real();
+            if ( r.ok() ) {
+                sink.setPenWidth( width );
+            }
+            break;
+        }
+        case VGOp::SetPenColor: {
+            QColor color = r.color();
+            if ( r.ok() ) {
+                sink.setPenColor( color );
+            }
+            break;
+        }
+        case VGOp::SetPen: {
+            QPen pen = r.pen();
+            if ( r.ok() ) {
+                sink.setPen( pen );
+            }
+            break;
+        }
+        case VGOp::SetFontIndex: {
+            int ind = r.index();
+            if ( r.ok() ) {
+                sink.setFontIndex( ind );
+            }
+            break;
+        }
+        case VGOp::SetFontSize: {
+            double size = r.real();
+            if ( r.ok() ) {
+                sink.setFontSize( size );
+            }
+            break;
+        }
+        case VGOp::Save:
+            sink.save();
+            break;
+        case VGOp::Restore:
+            sink.restore();
+            break;
+        case VGOp::SetTransform: {
+            QTransform tr = r.transform();
+            bool combine = r.u8();
+            if ( r.ok() ) {
+                sink.setTransform( tr, combine );
+            }
+            break;
+        }
+        case VGOp::FillRect: {
+            QRectF rect = r.rect();
+            QColor color = r.color();
+            if ( r.ok() ) {
+                sink.fillRect( rect, color );
+            }
+            break;
+        }
+        case VGOp::DrawRect: {
+            QRectF rect = r.rect();
+            if ( r.ok() ) {
+                sink.drawRect( rect );
+            }
+            break;
+        }
+        case VGOp::DrawText: {
+            QString text = r.text();
+            QPointF pos = r.point();
+            if ( r.ok() ) {
+                sink.drawText( text, pos );
+            }
+            break;
+        }
+        case VGOp::StoreIndexedPen: {
+            int ind = r.index();
+            QPen pen = r.pen();
+            if ( r.ok() ) {
+                sink.storeIndexedPen( ind, pen );
+            }
+            break;
+        }
+        case VGOp::SetIndexedPen: {
+            int ind = r.index();
+            if ( r.ok() ) {
+                sink.setIndexedPen( ind );
+            }
+            break;
+        }
+        case VGOp::StoreIndexedBrush: {
+            int ind = r.index();
+            QBrush brush = r.brush();
+            if ( r.ok() ) {
+                sink.storeIndexedBrush( ind, brush );
+            }
+            break;
+        }
+        case VGOp::SetIndexedBrush: {
+            int ind = r.index();
+            if ( r.ok() ) {
+                sink.setIndexedBrush( ind );
+            }
+            break;
+        }
+        case VGOp::SetBrush: {
+            QBrush brush = r.brush();
+            if ( r.ok() ) {
+                sink.setBrush( brush );
+            }
+            break;
+        }
+        case VGOp::SetClipRect: {
+            QRectF rect = r.rect();
+            if ( r.ok() ) {
+                sink.setClipRect( rect );
+            }
+            break;
+        }
+        default:
+            qWarning() << "Unknown VG stream opcode";
+            r.fail();
+        } // switch
+    }
+    return r.ok();
+} // replay
+
+/// sink that turns the stream back into VGList entries
+class ComposerSink
+{
+public:
+
+    VGComposer vgc;
+
+    void reset() { vgc.append < Entries::Reset > (); }
+    void drawLine( const QPointF & p1, const QPointF & p2 ) { vgc.append < Entries::DrawLine > ( p1, p2 ); }
+    void drawPolyline( const QPolygonF & poly ) { vgc.append < Entries::DrawPolyline > ( poly ); }
+    void setPenWidth( double width ) { vgc.append < Entries::SetPenWidth > ( width ); }
+    void setPenColor( const QColor & color ) { vgc.append < Entries::SetPenColor > ( color ); }
+    void setPen( const QPen & pen ) { vgc.append < Entries::SetPen > ( pen ); }
+    void setFontIndex( int ind ) { vgc.append < Entries::SetFontIndex > ( ind ); }
+    void setFontSize( double size ) { vgc.append < Entries::SetFontSize > ( size ); }
+    void save() { vgc.append < Entries::Save > (); }
+    void restore() { vgc.append < Entries::Restore > (); }
+    void setTransform( const QTransform & tr, bool combine ) { vgc.append < Entries::SetTransform > ( tr, combine ); }
+    void fillRect( const QRectF & rect, const QColor & color ) { vgc.append < Entries::FillRect > ( rect, color ); }
+    void drawRect( const QRectF & rect ) { vgc.append < Entries::DrawRect > ( rect ); }
+    void drawText( const QString & text, const QPointF & pos ) { vgc.append < Entries::DrawText > ( text, pos ); }
+    void storeIndexedPen( int ind, const QPen & pen ) { vgc.append < Entries::StoreIndexedPen > ( ind, pen ); }
+    void setIndexedPen( int ind ) { vgc.append < Entries::SetIndexedPen > ( ind ); }
+    void storeIndexedBrush( int ind, const QBrush & brush ) { vgc.append < Entries::StoreIndexedBrush > ( ind, brush ); }
+    void setIndexedBrush( int ind ) { vgc.append < Entries::SetIndexedBrush > ( ind ); }
+    void setBrush( const QBrush & brush ) { vgc.append < Entries::SetBrush > ( brush ); }
+    void setClipRect( const QRectF & rect ) { vgc.append < Entries::SetClipRect > ( rect ); }
+};
+}
+
+VGStreamWriter::VGStreamWriter( double scale )
+    : m_scale( scale )
+{ }
+
+void
+VGStreamWriter::op( VGOp op )
+{
+    putU8( m_body, quint8( op ) );
+}
+
+void
+VGStreamWriter::index( quint64 value )
+{
+    putVarint( m_body, value );
+}
+
+void
+VGStreamWriter::integer( qint64 value )
+{
+    putVarint( m_body, zigzag( value ) );
+}
+
+void
+VGStreamWriter::real( double value )
+{
+    putF32( m_body, value );
+}
+
+void
+VGStreamWriter::color( const QColor & color )
+{
+    putU32( m_body, color.rgba() );
+}
+
+void
+VGStreamWriter::point( const QPointF & pt )
+{
+    _coordinate( pt.x() );
+    _coordinate( pt.y() );
+}
+
+void
+VGStreamWriter::rect( const QRectF & rect )
+{
+    _coordinate( rect.x() );
+    _coordinate( rect.y() );
+    _coordinate( rect.width() );
+    _coordinate( rect.height() );
+}
+
+void
+VGStreamWriter::polyline( const QPolygonF & poly )
+{
+    index( poly.size() );
+    if ( m_scale <= 0 || poly.isEmpty() ) {
+        for ( const QPointF & pt : poly ) {
+            point( pt );
+        }
+        return;
+    }
+
+    // deltas are taken between quantised values, so errors don't accumulate
+    point( poly[0] );
+    qint64 x = qRound( qBound( - 32768.0, poly[0].x() * m_scale, 32767.0 ) );
+    qint64 y = qRound( qBound( - 32768.0, poly[0].y() * m_scale, 32767.0 ) );
+    for ( int i = 1 ; i < poly.size() ; i++ ) {
+        qint64 nx = qRound( qBound( - 32768.0, poly[i].x() * m_scale, 32767.0 ) );
+        qint64 ny = qRound( qBound( - 32768.0, poly[i].y() * m_scale, 32767.0 ) );
+        integer( nx - x );
+        integer( ny - y );
+        x = nx;
+        y = ny;
+        m_maxAbs = std::max( m_maxAbs, std::max( std::abs( poly[i].x() ), std::abs( poly[i].y() ) ) );
+    }
+} // polyline
+
+void
+VGStreamWriter::pen( const QPen & pen )
+{
+    size_t ind = std::find( m_pens.begin(), m_pens.end(), pen ) - m_pens.begin();
+    if ( ind == m_pens.size() ) {
+        m_pens.push_back( pen );
+    }
+    index( ind );
+}
+
+void
+VGStreamWriter::brush( const QBrush & brush )
+{
+    size_t ind = std::find( m_brushes.begin(), m_brushes.end(), brush ) - m_brushes.begin();
+    if ( ind == m_brushes.size() ) {
+        m_brushes.push_back( brush );
+    }
+    index( ind );
+}
+
+void
+VGStreamWriter::text( const QString & text )
+{
+    QByteArray utf8 = text.toUtf8();
+    index( utf8.size() );
+    m_body.append( utf8 );
+}
+
+void
+VGStreamWriter::transform( const QTransform & tr )
+{
+    if ( tr.isAffine() ) {
+        real( tr.m11() );
+        real( tr.m12() );
+        real( tr.m21() );
+        real( tr.m22() );
+        real( tr.dx() );
+        real( tr.dy() );
+    }
+    else {
+        qWarning() << "VG stream only supports affine transforms";
+        for ( double v : { 1, 0, 0, 1, 0, 0 } ) {
+            real( v );
+        }
+    }
+}
+
+QByteArray
+VGStreamWriter::finish() const
+{
+    QByteArray out;
+    out.reserve( m_body.size() + 64 );
+    out.append( Magic, MagicSize );
+    if ( m_scale > 0 ) {
+        putU8( out, FlagQuantised );
+        putF32( out, m_scale );
+    }
+    else {
+        putU8( out, 0 );
+    }
+    putVarint( out, m_pens.size() );
+    for ( const QPen & pen : m_pens ) {
+        putPen( out, pen );
+    }
+    putVarint( out, m_brushes.size() );
+    for ( const QBrush & brush : m_brushes ) {
+        putBrush( out, brush );
+    }
+    out.append( m_body );
+    return out;
+}
+
+double
+VGStreamWriter::quantisationScale( double maxAbs )
+{
+    double scale = MaxScale;
+    while ( scale >= 1 && maxAbs * scale > 32767 ) {
+        scale /= 2;
+    }
+    return scale >= 1 ? scale : 0;
+}
+
+void
+VGStreamWriter::_coordinate( double value )
+{
+    m_maxAbs = std::max( m_maxAbs, std::abs( value ) );
+    if ( m_scale > 0 ) {
+        qint16 q = qRound( qBound( - 32768.0, value * m_scale, 32767.0 ) );
+        putU8( m_body, quint16( q ) & 0xff );
+        putU8( m_body, quint16( q ) >> 8 );
+    }
+    else {
+        putF32( m_body, value );
+    }
+}
+
+QByteArray
+VGStream::encode( const VGList & list, bool quantise )
+{
+    VGStreamWriter floats;
+    for ( const IVGListEntry::SharedPtr & entry : list.entries() ) {
+        entry-> binary( floats );
+    }
+    double scale = quantise ? VGStreamWriter::quantisationScale( floats.maxAbs() ) : 0;
+    if ( scale <= 0 ) {
+        return floats.finish();
+    }
+    VGStreamWriter quantised( scale );
+    for ( const IVGListEntry::SharedPtr & entry : list.entries() ) {
+        entry-> binary( quantised );
+    }
+    return quantised.finish();
+}
+
+VGList
+VGStream::decode( const QByteArray & data, bool * ok )
+{
+    ComposerSink sink;
+    bool result = replay( data, sink );
+    if ( ok ) {
+        * ok = result;
+    }
+    return sink.vgc.vgList();
+}
+
+bool
+VGStream::render( const QByteArray & data, QPainter & painter )
+{
+    BetterQPainter bp( painter );
+    return render( data, bp );
+}
+
+bool
+VGStream::render( const QByteArray & data, BetterQPainter & painter )
+{
+    return replay( data, painter );
+}
+}
+}
+}
@@ -0,0 +1,171 @@
+/**
+ * Packed binary representation of vector graphics.
+ *
+ * A VG stream is a flat byte array that can be sent to clients, stored or replayed
+ * onto a painter without creating an entry object for every command. Layout:
+ *
+ *   "VGS1"            magic
+ *   u8                flags, bit 0 = coordinates are quantised
+ *   f32               quantisation scale (only if quantised)
+ *   varint n, n pens  pen table: u32 argb, f32 width, u8 style, u8 cap, u8 join, u8 cosmetic
+ *   varint n, n brushes brush table: u32 argb, u8 style
+ *   ops until the end of the stream, each an opcode byte followed by its arguments
+ *
+ * Integers are LEB128 varints, signed ones zigzag encoded, reals are little endian
+ * float32. Coordinates are either float32, or int16 multiples of 1/scale when
+ * quantised. Polylines are a point count followed by the points; when quantised, only
+ * the first point is stored in full and the rest as zigzag varint deltas, which for
+ * contours and grid lines are mostly a single byte each. Pens and brushes are stored
+ * once in the tables and referenced by index.
+ *
+ * The HTML5 client decodes the same format in skel.boundWidgets.View.VGStream.
+ **/
+
+#pragma once
+
+#include "CartaLib/CartaLib.h"
+#include <QByteArray>
+#include <QBrush>
+#include <QPen>
+#include <QPolygonF>
+#include <QRectF>
+#include <QTransform>
+#include <vector>
+
+class QPainter;
+
+namespace Carta
+{
+namespace Lib
+{
+namespace VectorGraphics
+{
+class VGList;
+class BetterQPainter;
+
+/// opcodes of the stream, one per VGList entry type
+enum class VGOp : quint8
+{
+    Reset = 1,
+    DrawLine,
+    DrawPolyline,
+    SetPenWidth,
+    SetPenColor,
+    SetPen,
+    SetFontIndex,
+    SetFontSize,
+    Save,
+    Restore,
+    SetTransform,
+    FillRect,
+    DrawRect,
+    DrawText,
+    StoreIndexedPen,
+    SetIndexedPen,
+    StoreIndexedBrush,
+    SetIndexedBrush,
+    SetBrush,
+    SetClipRect
+};
+
+/// builds a VG stream, VGList entries write themselves into it
+class VGStreamWriter
+{
+public:
+
+    /// \param scale quantisation scale for coordinates, 0 stores them as float32
+    VGStreamWriter( double scale = 0 );
+
+    void
+    op( VGOp op );
+
+    /// unsigned integer
+    void
+    index( quint64 value );
+
+    /// signed integer
+    void
+    integer( qint64 value );
+
+    void
+    real( double value );
+
+    void
+    color( const QColor & color );
+
+    void
+    point( const QPointF & pt );
+
+    void
+    rect( const QRectF & rect );
+
+    void
+    polyline( const QPolygonF & poly );
+
+    void
+    pen( const QPen & pen );
+
+    void
+    brush( const QBrush & brush );
+
+    void
+    text( const QString & text );
+
+    void
+    transform( const QTransform & tr );
+
+    /// the complete stream
+    QByteArray
+    finish() const;
+
+    /// finest power of two scale that fits coordinates up to maxAbs into int16,
+    /// or 0 if they don't fit even at scale 1
+    static double
+    quantisationScale( double maxAbs );
+
+    /// largest absolute coordinate written so far
+    double
+    maxAbs() const
+    {
+        return m_maxAbs;
+    }
+
+private:
+
+    void
+    _coordinate( double value );
+
+    double m_scale;
+    double m_maxAbs = 0;
+    QByteArray m_body;
+    std::vector < QPen > m_pens;
+    std::vector < QBrush > m_brushes;
+};
+
+/// encoding, decoding and replaying of VG streams
+class VGStream
+{
+public:
+
+    /// encode a list
+    /// \param quantise store coordinates as int16, the scale is picked from the largest
+    /// coordinate in the list, falls back to float32 if they don't fit
+    static QByteArray
+    encode( const VGList & list, bool quantise = true );
+
+    /// decode a stream into a list
+    /// \param ok if not null, set to whether the whole stream was valid
+    static VGList
+    decode( const QByteArray & data, bool * ok = nullptr );
+
+    /// draw a stream without decoding it into a list first
+    static bool
+    render( const QByteArray & data, QPainter & painter );
+
+    /// draw a stream onto an existing painter, sharing its indexed pens and brushes
+    static bool
+    render( const QByteArray & data, BetterQPainter & painter );
+};
+}
+}
+}
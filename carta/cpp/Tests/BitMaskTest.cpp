@@ -0,0 +1,92 @@
+#include "catch.h"
+#include "CartaLib/BitMask.h"
+#include <cmath>
+
+using Carta::Lib::BitMask;
+
+namespace
+{
+// the runs of a mask as (first, count, valid) triples
+std::vector < std::vector < qint64 > >
+runsOf( const BitMask & mask )
+{
+    std::vector < std::vector < qint64 > > runs;
+    mask.forEachRun( [&runs] ( qint64 first, qint64 count, bool valid ) {
+                         runs.push_back( { first, count, valid ? 1 : 0 } );
+                     } );
+    return runs;
+}
+}
+
+TEST_CASE( "Bit mask testing", "[mask]" ) {
+
+    SECTION( "Packing and counting") {
+        std::vector < char > bools( 200, 1 );
+        bools[3] = 0;
+        bools[64] = 0;
+        bools[199] = 0;
+        BitMask mask = BitMask::fromBools( bools.data(), bools.size() );
+        REQUIRE( mask.size() == 200 );
+        REQUIRE( mask.getWords().size() == 4 );
+        REQUIRE( mask.countValid() == 197 );
+        REQUIRE( ! mask.isAllValid() );
+        for ( int i = 0 ; i < 200 ; i++ ) {
+            REQUIRE( mask.get( i ) == ( bools[i] != 0 ) );
+        }
+        // the bits past the end are clear, so they are never counted
+        REQUIRE( BitMask( 70 ).countValid() == 70 );
+        REQUIRE( BitMask( 70 ).isAllValid() );
+        REQUIRE( BitMask( 70, false ).countValid() == 0 );
+
+        mask.set( 3, true );
+        mask.set( 5, false );
+        REQUIRE( mask.get( 3 ) );
+        REQUIRE( ! mask.get( 5 ) );
+
+        BitMask other( 200 );
+        other.set( 100, false );
+        mask &= other;
+        REQUIRE( mask.countValid() == 196 );
+        REQUIRE( ! mask.get( 100 ) );
+    }
+
+    SECTION( "Runs") {
+        BitMask mask( 300 );
+        for ( int i = 64 ; i < 192 ; i++ ) {
+            mask.set( i, false );
+        }
+        mask.set( 10, false );
+        mask.set( 299, false );
+        std::vector < std::vector < qint64 > > runs = {
+            { 0, 10, 1 }, { 10, 1, 0 }, { 11, 53, 1 }, { 64, 128, 0 }, { 192, 107, 1 },
+            { 299, 1, 0 }
+        };
+        REQUIRE( runsOf( mask ) == runs );
+        REQUIRE( runsOf( BitMask( 130 ) ) == std::vector < std::vector < qint64 > > ( { { 0, 130, 1 } } ) );
+        REQUIRE( runsOf( BitMask( 64, false ) ) == std::vector < std::vector < qint64 > > ( { { 0, 64, 0 } } ) );
+        REQUIRE( runsOf( BitMask() ).empty() );
+    }
+
+    SECTION( "Blanking masked values") {
+        std::vector < float > values( 100, 1 );
+        BitMask mask( 100 );
+        mask.set( 0, false );
+        mask.set( 70, false );
+        mask.set( 71, false );
+        mask.blankMasked( values.data() );
+        int nans = 0;
+        for ( float val : values ) {
+            if ( std::isnan( val ) ) {
+                nans++;
+            }
+        }
+        REQUIRE( nans == 3 );
+        REQUIRE( std::isnan( values[71] ) );
+        REQUIRE( values[72] == 1 );
+
+        // integers cannot be blanked
+        std::vector < int > ints( 100, 1 );
+        mask.blankMasked( ints.data() );
+        REQUIRE( ints[0] == 1 );
+    }
+}
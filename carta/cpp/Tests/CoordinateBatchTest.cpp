@@ -0,0 +1,166 @@
+/**
+ *
+ **/
+
+#include "catch.h"
+#include "CartaLib/ICoordinateFormatter.h"
+#include <cmath>
+
+namespace
+{
+const double Deg = M_PI / 180;
+
+/// gnomonic (TAN) projection of ra/dec plus a linear third axis
+class TanFormatter : public CoordinateFormatterInterface
+{
+public:
+
+    TanFormatter( double ra0, double dec0, double crpix, double cdelt )
+        : m_ra0( ra0 ), m_dec0( dec0 ), m_crpix( crpix ), m_cdelt( cdelt )
+    { }
+
+    virtual CoordinateFormatterInterface *
+    clone() const override
+    {
+        return new TanFormatter( * this );
+    }
+
+    virtual int
+    nAxes() const override
+    {
+        return 3;
+    }
+
+    virtual QStringList
+    formatFromPixelCoordinate( const VD & ) override
+    {
+        return QStringList();
+    }
+
+    virtual QString
+    calculateFormatDistance( const VD &, const VD & ) override
+    {
+        return QString();
+    }
+
+    virtual void
+    setTextOutputFormat( TextFormat ) override
+    { }
+
+    virtual const Carta::Lib::AxisInfo &
+    axisInfo( int ) const override
+    {
+        return m_axisInfo;
+    }
+
+    virtual Me &
+    disableAxis( int ) override
+    {
+        return * this;
+    }
+
+    virtual Me &
+    enableAxis( int ) override
+    {
+        return * this;
+    }
+
+    virtual KnownSkyCS
+    skyCS() override
+    {
+        return KnownSkyCS::J2000;
+    }
+
+    virtual Me &
+    setSkyCS( const KnownSkyCS & ) override
+    {
+        return * this;
+    }
+
+    virtual SkyFormatting
+    skyFormatting() override
+    {
+        return SkyFormatting::Degrees;
+    }
+
+    virtual Me &
+    setSkyFormatting( SkyFormatting ) override
+    {
+        return * this;
+    }
+
+    virtual int
+    axisPrecision( int ) override
+    {
+        return 3;
+    }
+
+    virtual Me &
+    setAxisPrecision( int, int ) override
+    {
+        return * this;
+    }
+
+    virtual bool
+    toWorld( const VD & pixel, VD & world ) const override
+    {
+        double x = ( pixel[0] - m_crpix ) * m_cdelt * Deg;
+        double y = ( pixel[1] - m_crpix ) * m_cdelt * Deg;
+        double rho = std::hypot( x, y );
+        double dec0 = m_dec0 * Deg;
+        double ra, dec;
+        if ( rho == 0 ) {
+            ra = 0;
+            dec = dec0;
+        }
+        else {
+            double c = std::atan( rho );
+            dec = std::asin( std::cos( c ) * std::sin( dec0 )
+                             + y * std::sin( c ) * std::cos( dec0 ) / rho );
+            ra = std::atan2( x * std::sin( c ),
+                             rho * std::cos( dec0 ) * std::cos( c )
+                             - y * std::sin( dec0 ) * std::sin( c ) );
+        }
+        ra = std::fmod( m_ra0 + ra / Deg + 360, 360 );
+        world = { ra, dec / Deg, 1e9 + pixel[2] * 1e6 };
+        return true;
+    }
+
+    virtual bool
+    toPixel( const VD &, VD & ) const override
+    {
+        return false;
+    }
+
+private:
+
+    double m_ra0, m_dec0, m_crpix, m_cdelt;
+    Carta::Lib::AxisInfo m_axisInfo;
+};
+}
+
+TEST_CASE( "Batch coordinate conversion testing", "[coordinates]" ) {
+
+    const double cdelt = 0.05;
+    CoordinateFormatterInterface::SharedPtr cf =
+        std::make_shared < TanFormatter > ( 2.0, 60.0, 100.0, cdelt );
+
+    SECTION( "Default batch conversion matches single point conversion") {
+        CoordinateFormatterInterface::VD pixels = { 0, 0, 0, 10, 20, 1, 150, 199, 2 };
+        CoordinateFormatterInterface::VD worlds, single;
+        std::vector < bool > valid;
+        REQUIRE( cf-> toWorldBatch( pixels, worlds, & valid ) == 3 );
+        REQUIRE( worlds.size() == 9 );
+        for ( int i = 0 ; i < 3 ; i++ ) {
+            REQUIRE( valid[i] );
+            cf-> toWorld( { pixels[i * 3], pixels[i * 3 + 1], pixels[i * 3 + 2] }, single );
+            for ( int j = 0 ; j < 3 ; j++ ) {
+                REQUIRE( worlds[i * 3 + j] == single[j] );
+            }
+        }
+
+        // failures are reported per point
+        REQUIRE( cf-> toPixelBatch( worlds, pixels, & valid ) == 0 );
+        REQUIRE( ! valid[0] );
+    }
+}
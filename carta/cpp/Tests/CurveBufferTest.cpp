@@ -0,0 +1,71 @@
+#include "catch.h"
+#include "CartaLib/CurveBuffer.h"
+#include <QByteArray>
+
+using Carta::Lib::CurveBuffer;
+
+TEST_CASE( "Curve buffer testing", "[curvebuffer]" ) {
+
+    SECTION( "Copies share their columns") {
+        CurveBuffer curve( { 1, 2, 3 }, { 4, 5, 6 } );
+        CurveBuffer copy = curve;
+        REQUIRE( copy.isSharedWith( curve ) );
+        REQUIRE( copy.getX().data() == curve.getX().data() );
+
+        // writing detaches only the column that is written
+        copy.getYForWrite()[0] = 10;
+        REQUIRE( curve.getY()[0] == 4 );
+        REQUIRE( copy.getY()[0] == 10 );
+        REQUIRE( copy.getX().data() == curve.getX().data() );
+        REQUIRE( ! copy.isSharedWith( curve ) );
+
+        // a column nobody else uses is written in place
+        const double * ys = copy.getY().data();
+        copy.getYForWrite()[1] = 11;
+        REQUIRE( copy.getY().data() == ys );
+
+        copy.setX( { 7, 8, 9 } );
+        REQUIRE( copy.getX()[2] == 9 );
+        REQUIRE( curve.getX()[2] == 3 );
+    }
+
+    SECTION( "Empty curves and pairs") {
+        CurveBuffer empty;
+        REQUIRE( empty.isEmpty() );
+        REQUIRE( empty.size() == 0 );
+        empty.getXForWrite().push_back( 1 );
+        empty.getYForWrite().push_back( 2 );
+        REQUIRE( CurveBuffer().isEmpty() );
+        REQUIRE( empty.size() == 1 );
+
+        std::vector < std::pair < double, double > > pairs = { { 1, 2 }, { 3, 4 } };
+        CurveBuffer curve = CurveBuffer::fromPairs( pairs );
+        REQUIRE( curve.getX() == std::vector < double > ( { 1, 3 } ) );
+        REQUIRE( curve.getY() == std::vector < double > ( { 2, 4 } ) );
+        REQUIRE( curve.toPairs() == pairs );
+    }
+
+    SECTION( "Serialization") {
+        CurveBuffer curve( { 1.5, - 2, 1e300 }, { 0, 3.25, - 1e-300 } );
+        for ( bool native : { true, false } ) {
+            QByteArray bytes;
+            {
+                QDataStream out( & bytes, QIODevice::WriteOnly );
+                if ( native ) {
+                    Carta::Lib::setNativeByteOrder( out );
+                }
+                out << curve << 42;
+            }
+            QDataStream in( bytes );
+            if ( native ) {
+                Carta::Lib::setNativeByteOrder( in );
+            }
+            CurveBuffer read;
+            int marker = 0;
+            in >> read >> marker;
+            REQUIRE( read.getX() == curve.getX() );
+            REQUIRE( read.getY() == curve.getY() );
+            REQUIRE( marker == 42 );
+        }
+    }
+}
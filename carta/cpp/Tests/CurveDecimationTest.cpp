@@ -0,0 +1,88 @@
+/**
+ *
+ **/
+
+#include "catch.h"
+#include "CartaLib/Algorithms/CurveDecimation.h"
+#include <cmath>
+#include <limits>
+
+using namespace Carta::Lib::Algorithms;
+
+namespace
+{
+// the y range of the points falling into each column
+void
+columnRanges( const std::vector < double > & xs, const std::vector < double > & ys,
+              const std::vector < int > & indices, int columns,
+              std::vector < double > & mins, std::vector < double > & maxs )
+{
+    mins.assign( columns, std::numeric_limits < double >::max() );
+    maxs.assign( columns, - std::numeric_limits < double >::max() );
+    for ( int index : indices ) {
+        int col = std::min( static_cast < int > ( xs[index] * columns / xs.size() ), columns - 1 );
+        mins[col] = std::min( mins[col], ys[index] );
+        maxs[col] = std::max( maxs[col], ys[index] );
+    }
+}
+}
+
+TEST_CASE( "Curve decimation", "[plot]" ) {
+
+    SECTION( "M4 keeps the envelope of every column") {
+        const int count = 100000;
+        const int columns = 300;
+        std::vector < double > xs( count );
+        std::vector < double > ys( count );
+        for ( int i = 0 ; i < count ; i++ ) {
+            xs[i] = i;
+            ys[i] = std::sin( i * 0.01 ) + ( i % 7 == 0 ? 0.5 : 0 );
+        }
+        std::vector < int > kept = m4Decimate( xs.data(), ys.data(), count, 0, count, columns );
+        REQUIRE( kept.size() <= static_cast < size_t > ( 4 * columns ) );
+        REQUIRE( kept.front() == 0 );
+        REQUIRE( kept.back() == count - 1 );
+        REQUIRE( std::is_sorted( kept.begin(), kept.end() ) );
+
+        std::vector < int > all( count );
+        for ( int i = 0 ; i < count ; i++ ) {
+            all[i] = i;
+        }
+        std::vector < double > keptMin, keptMax, allMin, allMax;
+        columnRanges( xs, ys, kept, columns, keptMin, keptMax );
+        columnRanges( xs, ys, all, columns, allMin, allMax );
+        REQUIRE( keptMin == allMin );
+        REQUIRE( keptMax == allMax );
+    }
+
+    SECTION( "Points outside the range and non-finite values") {
+        std::vector < double > xs = { -3, -2, -1, 0, 1, 2, 3, 4, 5, 6 };
+        std::vector < double > ys = { 5, 1, 2, 0, 0, std::nan( "" ), 0, 0, 9, 8 };
+        std::vector < int > kept = m4Decimate( xs.data(), ys.data(), xs.size(), 0, 4, 1 );
+        // the runs are short enough to be kept whole; the NaN splits a run
+        REQUIRE( kept == std::vector < int > ( { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 } ) );
+
+        std::vector < double > flat = { 1, 1, 1, 1, 1, 1 };
+        std::vector < double > line = { 0, 1, 2, 3, 4, 5 };
+        REQUIRE( m4Decimate( line.data(), flat.data(), 6, 0, 6, 1 ) == std::vector < int > ( { 0, 5 } ) );
+        REQUIRE( m4Decimate( line.data(), flat.data(), 6, 0, 0, 1 ).size() == 6 );
+    }
+
+    SECTION( "Reversed axes and unsorted points") {
+        std::vector < double > xs = { 0.1, 0.2, 0.4, 0.6, 3, 3.2, 3.4, 1.1 };
+        std::vector < double > ys = { 1, 5, 2, 3, 4, 9, 0, 7 };
+        // two columns over [4,0]: x > 2 is the first column, and the last point
+        // goes back to the second one
+        std::vector < int > kept = m4Decimate( xs.data(), ys.data(), xs.size(), 4, 0, 2 );
+        REQUIRE( kept == std::vector < int > ( { 0, 1, 3, 4, 5, 6, 7 } ) );
+    }
+
+    SECTION( "Largest value per column") {
+        std::vector < double > xs = { 0, 1, 2, 3, 4, 5, 6, 7 };
+        std::vector < double > ys = { 3, 9, 1, 1, 0, 2, 8, 8 };
+        REQUIRE( maxPerColumn( xs.data(), ys.data(), xs.size(), 0, 8, 4 ) ==
+                 std::vector < int > ( { 1, 2, 5, 6 } ) );
+        REQUIRE( maxPerColumn( xs.data(), ys.data(), xs.size(), 0, 8, 1 ) ==
+                 std::vector < int > ( { 1 } ) );
+    }
+}
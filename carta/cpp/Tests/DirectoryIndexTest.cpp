@@ -0,0 +1,138 @@
+#include "catch.h"
+#include "core/Data/DirectoryIndex.h"
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+using Carta::Data::DirectoryIndex;
+
+namespace
+{
+// write a minimal FITS header, one card per string
+void
+writeFits( const QString & fileName, const QStringList & cards )
+{
+    QByteArray header;
+    for ( const QString & card : cards ) {
+        header.append( card.leftJustified( 80, ' ', true ).toLatin1() );
+    }
+    header.append( QString( "END" ).leftJustified( 80 ).toLatin1() );
+    while ( header.size() % 2880 != 0 ) {
+        header.append( ' ' );
+    }
+    QFile file( fileName );
+    file.open( QIODevice::WriteOnly );
+    file.write( header );
+}
+
+void
+touch( const QString & fileName )
+{
+    QFile file( fileName );
+    file.open( QIODevice::WriteOnly );
+}
+
+const DirectoryIndex::Entry *
+find( const DirectoryIndex::Page & page, const QString & name )
+{
+    for ( const DirectoryIndex::Entry & entry : page.entries ) {
+        if ( entry.name == name ) {
+            return & entry;
+        }
+    }
+    return nullptr;
+}
+
+QStringList
+testHeader()
+{
+    return {
+        "SIMPLE  =                    T",
+        "BITPIX  =                  -32",
+        "NAXIS   =                    3 / number of axes",
+        "NAXIS1  =                   10",
+        "NAXIS2  =                   20",
+        "NAXIS3  =                    4",
+        "OBJECT  = 'NGC 253 '           / target",
+        "BUNIT   = 'Jy/beam '"
+    };
+}
+}
+
+TEST_CASE( "Directory index", "[directoryindex]" ) {
+
+    QTemporaryDir tmp;
+    REQUIRE( tmp.isValid() );
+    QDir dir( tmp.path() );
+    writeFits( dir.filePath( "a.fits" ), testHeader() );
+    touch( dir.filePath( "b.reg" ) );
+    touch( dir.filePath( "notes.txt" ) );
+    dir.mkdir( "sub" );
+    dir.mkdir( "x.image" );
+
+    SECTION( "FITS header summary") {
+        DirectoryIndex::Entry entry;
+        REQUIRE( DirectoryIndex::readFitsSummary( dir.filePath( "a.fits" ), entry ) );
+        REQUIRE( entry.hasMetadata );
+        REQUIRE( entry.shape == "10x20x4" );
+        REQUIRE( entry.object == "NGC 253" );
+        REQUIRE( entry.unit == "Jy/beam" );
+
+        DirectoryIndex::Entry other;
+        REQUIRE( ! DirectoryIndex::readFitsSummary( dir.filePath( "b.reg" ), other ) );
+        REQUIRE( ! DirectoryIndex::readFitsSummary( dir.filePath( "missing.fits" ), other ) );
+        REQUIRE( ! other.hasMetadata );
+    }
+
+    SECTION( "Listing, paging and header summaries") {
+        DirectoryIndex index;
+        REQUIRE( ! index.list( dir.filePath( "missing" ) ).exists );
+
+        index.list( tmp.path() );
+        index.waitForDone();
+        DirectoryIndex::Page page = index.list( tmp.path() );
+        REQUIRE( page.exists );
+        REQUIRE( page.complete );
+        REQUIRE( page.total == 4 );
+        REQUIRE( page.entries.size() == 4 );
+        REQUIRE( find( page, "notes.txt" ) == nullptr );
+        REQUIRE( find( page, "sub" )->isDir );
+        REQUIRE( ! find( page, "sub" )->loadable );
+        REQUIRE( find( page, "x.image" )->loadable );
+        REQUIRE( find( page, "b.reg" )->loadable );
+
+        DirectoryIndex::Page part = index.list( tmp.path(), 1, 2 );
+        REQUIRE( part.total == 4 );
+        REQUIRE( part.entries.size() == 2 );
+        REQUIRE( part.entries[0].name == page.entries[1].name );
+        REQUIRE( index.list( tmp.path(), 10, 2 ).entries.empty() );
+
+        // headers are read in the background once an entry has been handed out
+        REQUIRE( ! find( page, "a.fits" )->hasMetadata );
+        index.waitForDone();
+        page = index.list( tmp.path() );
+        REQUIRE( find( page, "a.fits" )->hasMetadata );
+        REQUIRE( find( page, "a.fits" )->shape == "10x20x4" );
+        REQUIRE( ! find( page, "b.reg" )->hasMetadata );
+    }
+
+    SECTION( "Listings can be invalidated") {
+        DirectoryIndex index;
+        index.list( tmp.path() );
+        index.waitForDone();
+        index.list( tmp.path() );
+        index.waitForDone();
+        DirectoryIndex::Page page;
+
+        touch( dir.filePath( "c.crtf" ) );
+        REQUIRE( index.list( tmp.path() ).total == 4 );
+        index.invalidate( tmp.path() );
+        index.list( tmp.path() );
+        index.waitForDone();
+        page = index.list( tmp.path() );
+        REQUIRE( page.total == 5 );
+
+        // the new listing reuses the summary of the unchanged file
+        REQUIRE( find( page, "a.fits" )->hasMetadata );
+    }
+}
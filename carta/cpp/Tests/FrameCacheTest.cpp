@@ -0,0 +1,74 @@
+#include "catch.h"
+#include "core/FrameCache.h"
+#include <QImage>
+
+using namespace Carta;
+
+namespace
+{
+Core::FrameCacheKey
+makeKey( qint64 id )
+{
+    return Core::FrameCacheKey().add( id );
+}
+
+// 100x100 ARGB32 image = 40000 bytes
+QImage
+makeImage()
+{
+    return QImage( 100, 100, QImage::Format_ARGB32 );
+}
+}
+
+TEST_CASE( "Frame cache testing", "[framecache]" ) {
+
+    typedef Core::FrameCache::Tier Tier;
+
+    SECTION( "Keys") {
+        Core::FrameCacheKey a = Core::FrameCacheKey().add( QString( "file//h1" ) );
+        Core::FrameCacheKey b = Core::FrameCacheKey().add( QString( "file//h2" ) );
+        REQUIRE( Core::FrameCacheKey().isNull() );
+        REQUIRE( ! a.isNull() );
+        REQUIRE( a != b );
+        REQUIRE( a == Core::FrameCacheKey().add( QString( "file//h1" ) ) );
+    }
+
+    SECTION( "Least recently used frames are evicted") {
+        Core::FrameCache cache( 5 * 40000 );
+        for ( int i = 0 ; i < 5 ; i++ ) {
+            cache.insert( Tier::Mapped, makeKey( i ), makeImage() );
+        }
+        // frame 0 becomes the most recently used one
+        QImage image;
+        REQUIRE( cache.find( Tier::Mapped, makeKey( 0 ), image ) );
+        cache.insert( Tier::Mapped, makeKey( 5 ), makeImage() );
+        REQUIRE( cache.bytesUsed() <= cache.budget() );
+        REQUIRE( cache.touch( Tier::Mapped, makeKey( 0 ) ) );
+        REQUIRE( ! cache.touch( Tier::Mapped, makeKey( 1 ) ) );
+
+        auto stats = cache.stats();
+        REQUIRE( stats[int( Tier::Mapped )].hits == 1 );
+        REQUIRE( stats[int( Tier::Mapped )].entries == 5 );
+    }
+
+    SECTION( "Composited frames are trimmed first") {
+        Core::FrameCache cache( 8 * 40000 );
+        for ( int i = 0 ; i < 4 ; i++ ) {
+            cache.insert( Tier::Composited, makeKey( 100 + i ), makeImage() );
+        }
+        for ( int i = 0 ; i < 6 ; i++ ) {
+            cache.insert( Tier::Mapped, makeKey( i ), makeImage() );
+        }
+        auto stats = cache.stats();
+        REQUIRE( stats[int( Tier::Mapped )].entries == 6 );
+        REQUIRE( stats[int( Tier::Composited )].entries == 2 );
+    }
+
+    SECTION( "Frames larger than the budget are not cached") {
+        Core::FrameCache cache( 1000 );
+        cache.insert( Tier::Mapped, makeKey( 1 ), makeImage() );
+        QImage image;
+        REQUIRE( ! cache.find( Tier::Mapped, makeKey( 1 ), image ) );
+        REQUIRE( cache.bytesUsed() == 0 );
+    }
+}
@@ -0,0 +1,92 @@
+/**
+ *
+ **/
+
+#include "catch.h"
+#include "CartaLib/Algorithms/FrameDelta.h"
+
+using namespace Carta::Lib::Algorithms;
+
+namespace
+{
+// a frame with a gradient and a moving square
+QImage
+makeFrame( int width, int height, int step )
+{
+    QImage frame( width, height, QImage::Format_ARGB32_Premultiplied );
+    for ( int y = 0 ; y < height ; y++ ) {
+        for ( int x = 0 ; x < width ; x++ ) {
+            QRgb pixel = 0xff000000 | ( ( x * 255 / width ) << 16 ) | ( y * 255 / height );
+            if ( x >= step && x < step + 5 && y >= 10 && y < 15 ) {
+                pixel = 0xffffffff;
+            }
+            frame.setPixel( x, y, pixel );
+        }
+    }
+    return frame;
+}
+}
+
+TEST_CASE( "Frame delta encoding", "[animation]" ) {
+
+    SECTION( "Deltas reproduce every frame") {
+        FrameDeltaEncoder encoder( 16, 10 );
+        FrameDeltaDecoder decoder;
+        int keyframeSize = 0;
+        for ( int step = 0 ; step < 25 ; step++ ) {
+            QImage frame = makeFrame( 100, 70, step );
+            QByteArray packet = encoder.encode( frame );
+            REQUIRE( decoder.decode( packet ) );
+            REQUIRE( decoder.frame() == frame );
+            REQUIRE( decoder.frameNumber() == step );
+            REQUIRE( encoder.lastWasKeyframe() == ( step % 10 == 0 ) );
+            if ( step == 0 ) {
+                // 7 x 5 tiles, the last column and row are partial
+                REQUIRE( encoder.lastTileCount() == 35 );
+                keyframeSize = packet.size();
+            }
+            else if ( ! encoder.lastWasKeyframe() ) {
+                // the square touches at most two tile columns
+                REQUIRE( encoder.lastTileCount() <= 2 );
+                int deltaSize = packet.size() * 20;
+                REQUIRE( deltaSize <= keyframeSize );
+            }
+        }
+    }
+
+    SECTION( "Unchanged frames and new sizes") {
+        FrameDeltaEncoder encoder( 32, 0 );
+        FrameDeltaDecoder decoder;
+        QImage frame = makeFrame( 40, 40, 3 );
+        REQUIRE( decoder.decode( encoder.encode( frame ) ) );
+        REQUIRE( decoder.decode( encoder.encode( frame ) ) );
+        REQUIRE( encoder.lastTileCount() == 0 );
+        REQUIRE( ! encoder.lastWasKeyframe() );
+
+        QImage bigger = makeFrame( 50, 40, 3 );
+        REQUIRE( decoder.decode( encoder.encode( bigger ) ) );
+        REQUIRE( encoder.lastWasKeyframe() );
+        REQUIRE( decoder.frame() == bigger );
+
+        encoder.requestKeyframe();
+        encoder.encode( bigger );
+        REQUIRE( encoder.lastWasKeyframe() );
+    }
+
+    SECTION( "Lost packets need a keyframe") {
+        FrameDeltaEncoder encoder( 16, 0 );
+        FrameDeltaDecoder decoder;
+        REQUIRE( decoder.decode( encoder.encode( makeFrame( 30, 30, 0 ) ) ) );
+        encoder.encode( makeFrame( 30, 30, 1 ) );
+        QByteArray late = encoder.encode( makeFrame( 30, 30, 2 ) );
+        REQUIRE( ! decoder.decode( late ) );
+
+        // a truncated or foreign packet is rejected
+        encoder.requestKeyframe();
+        QByteArray keyframe = encoder.encode( makeFrame( 30, 30, 3 ) );
+        REQUIRE( ! decoder.decode( QByteArray( keyframe.constData(), keyframe.size() - 3 ) ) );
+        REQUIRE( ! decoder.decode( QByteArray( "XYZ", 3 ) ) );
+        REQUIRE( decoder.decode( keyframe ) );
+        REQUIRE( decoder.frame() == makeFrame( 30, 30, 3 ) );
+    }
+}
@@ -0,0 +1,35 @@
+#include "catch.h"
+#include "CartaLib/LruCache.h"
+#include <QString>
+
+using Cache = Carta::Lib::LruCache < QString, int >;
+
+TEST_CASE( "LRU cache testing", "[lrucache]" ) {
+
+    SECTION( "Find and replace") {
+        Cache cache( 4 );
+        int value = 0;
+        REQUIRE( ! cache.find( "a", value ) );
+        cache.insert( "a", 1 );
+        cache.insert( "a", 2 );
+        REQUIRE( cache.size() == 1 );
+        REQUIRE( cache.find( "a", value ) );
+        REQUIRE( value == 2 );
+    }
+
+    SECTION( "The least recently used entry is evicted") {
+        Cache cache( 2 );
+        int value = 0;
+        cache.insert( "a", 1 );
+        cache.insert( "b", 2 );
+        REQUIRE( cache.find( "a", value ) );
+        cache.insert( "c", 3 );
+        REQUIRE( cache.size() == 2 );
+        REQUIRE( cache.find( "a", value ) );
+        REQUIRE( ! cache.find( "b", value ) );
+        REQUIRE( cache.find( "c", value ) );
+        cache.clear();
+        REQUIRE( cache.size() == 0 );
+        REQUIRE( ! cache.find( "a", value ) );
+    }
+}
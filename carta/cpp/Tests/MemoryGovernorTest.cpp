@@ -0,0 +1,122 @@
+#include "catch.h"
+#include "core/MemoryGovernor.h"
+#include "core/FrameCache.h"
+#include <QImage>
+
+using namespace Carta;
+
+namespace
+{
+// 100x100 ARGB32 image = 40000 bytes
+QImage
+makeImage()
+{
+    return QImage( 100, 100, QImage::Format_ARGB32 );
+}
+}
+
+TEST_CASE( "Memory governor testing", "[memorygovernor]" ) {
+
+    SECTION( "Accounting") {
+        Core::MemoryGovernor governor( 1000 );
+        int a = governor.addConsumer( "a" );
+        int b = governor.addConsumer( "b" );
+        governor.setBytes( a, 300 );
+        governor.setBytes( b, 200 );
+        governor.setBytes( b, 100 );
+        REQUIRE( governor.bytesUsed() == 400 );
+        std::vector < Core::MemoryGovernor::ConsumerStats > stats = governor.stats();
+        REQUIRE( stats.size() == 2 );
+        REQUIRE( stats[0].name == "a" );
+        REQUIRE( stats[1].peakBytes == 200 );
+        REQUIRE( ! stats[1].evictable );
+        governor.removeConsumer( a );
+        REQUIRE( governor.bytesUsed() == 100 );
+    }
+
+    SECTION( "Reserving evicts the largest cache first") {
+        Core::MemoryGovernor governor( 1000 );
+        qint64 smallBytes = 200;
+        qint64 bigBytes = 600;
+        int small = - 1;
+        int big = - 1;
+        small = governor.addConsumer( "small", [&] ( qint64 bytes ) {
+            qint64 freed = std::min( bytes, smallBytes );
+            smallBytes -= freed;
+            governor.setBytes( small, smallBytes );
+            return freed;
+        } );
+        big = governor.addConsumer( "big", [&] ( qint64 bytes ) {
+            qint64 freed = std::min( bytes, bigBytes );
+            bigBytes -= freed;
+            governor.setBytes( big, bigBytes );
+            return freed;
+        } );
+        governor.setBytes( small, smallBytes );
+        governor.setBytes( big, bigBytes );
+
+        REQUIRE( governor.reserve( 100 ) );
+        REQUIRE( governor.evictionCount() == 0 );
+
+        REQUIRE( governor.reserve( 500 ) );
+        REQUIRE( bigBytes == 300 );
+        REQUIRE( smallBytes == 200 );
+
+        // cannot be met even after evicting everything
+        REQUIRE( ! governor.reserve( 2000 ) );
+        REQUIRE( governor.bytesUsed() == 0 );
+    }
+
+    SECTION( "No budget") {
+        Core::MemoryGovernor governor( 0 );
+        bool evicted = false;
+        int cache = governor.addConsumer( "cache", [&] ( qint64 ) {
+            evicted = true;
+            return qint64( 400 );
+        } );
+        governor.setBytes( cache, 400 );
+        REQUIRE( governor.reserve( qint64( 1 ) << 40 ) );
+        REQUIRE( ! evicted );
+    }
+
+    SECTION( "Reservations") {
+        Core::MemoryGovernor governor( 1000 );
+        {
+            Core::MemoryGovernor::Reservation reservation( & governor, "buffer", 600 );
+            REQUIRE( reservation.fits() );
+            REQUIRE( governor.bytesUsed() == 600 );
+            Core::MemoryGovernor::Reservation second( & governor, "buffer", 600 );
+            REQUIRE( ! second.fits() );
+        }
+        REQUIRE( governor.bytesUsed() == 0 );
+        Core::MemoryGovernor::Reservation none( nullptr, "buffer", 600 );
+        REQUIRE( none.fits() );
+    }
+
+    SECTION( "Frame cache gives memory back") {
+        Core::MemoryGovernor governor( 4 * 40000 );
+        Core::FrameCache cache( 10 * 40000 );
+        cache.setGovernor( & governor );
+        for ( int i = 0 ; i < 3 ; i++ ) {
+            cache.insert( Core::FrameCache::Tier::Mapped, Core::FrameCacheKey().add( qint64( i ) ),
+                          makeImage() );
+        }
+        REQUIRE( governor.bytesUsed() == 3 * 40000 );
+
+        // a large allocation pushes frames out
+        REQUIRE( governor.reserve( 2 * 40000 ) );
+        REQUIRE( cache.bytesUsed() == 2 * 40000 );
+        REQUIRE( ! cache.touch( Core::FrameCache::Tier::Mapped, Core::FrameCacheKey().add( qint64( 0 ) ) ) );
+        REQUIRE( cache.touch( Core::FrameCache::Tier::Mapped, Core::FrameCacheKey().add( qint64( 2 ) ) ) );
+
+        // the cache keeps itself within the global budget as well as its own
+        for ( int i = 3 ; i < 8 ; i++ ) {
+            cache.insert( Core::FrameCache::Tier::Mapped, Core::FrameCacheKey().add( qint64( i ) ),
+                          makeImage() );
+        }
+        REQUIRE( cache.bytesUsed() == 4 * 40000 );
+        REQUIRE( governor.bytesUsed() == 4 * 40000 );
+        cache.setGovernor( nullptr );
+        REQUIRE( governor.bytesUsed() == 0 );
+    }
+}
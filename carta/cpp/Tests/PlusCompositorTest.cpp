@@ -0,0 +1,159 @@
+/**
+ *
+ **/
+
+#include "catch.h"
+#include "CartaLib/Algorithms/PlusCompositor.h"
+#include <QImage>
+#include <QPainter>
+#include <QElapsedTimer>
+#include <random>
+
+typedef Carta::Lib::Algorithms::PlusCompositor PlusCompositor;
+
+namespace
+{
+QImage
+randomImage( int width, int height, QImage::Format format, unsigned seed )
+{
+    std::mt19937 rng( seed );
+    QImage img( width, height, format );
+    for ( int y = 0 ; y < height ; y++ ) {
+        QRgb * row = reinterpret_cast < QRgb * > ( img.scanLine( y ) );
+        for ( int x = 0 ; x < width ; x++ ) {
+            row[x] = rng() | 0xff000000;
+        }
+    }
+    return img;
+}
+
+std::vector < PlusCompositor::Layer >
+rgbLayers( int width, int height )
+{
+    return {
+        PlusCompositor::Layer( randomImage( width, height, QImage::Format_ARGB32, 1 ), 0xffff0000, 1.0 ),
+        PlusCompositor::Layer( randomImage( width, height, QImage::Format_ARGB32, 2 ), 0xff00ff00, 0.5 ),
+        PlusCompositor::Layer( randomImage( width, height, QImage::Format_ARGB32, 3 ), 0xff0000ff, 0.75 )
+    };
+}
+
+/// the way layers used to be composited: mask a copy of each layer and paint it
+QImage
+compositeWithPainter( QSize size, const std::vector < PlusCompositor::Layer > & layers )
+{
+    QImage dst( size, QImage::Format_ARGB32_Premultiplied );
+    dst.fill( 0 );
+    for ( const PlusCompositor::Layer & layer : layers ) {
+        QImage src = layer.image.convertToFormat( QImage::Format_ARGB32 );
+        for ( int y = 0 ; y < src.height() ; y++ ) {
+            QRgb * ptr = reinterpret_cast < QRgb * > ( src.scanLine( y ) );
+            for ( int x = 0 ; x < src.width() ; x++ ) {
+                ptr[x] &= layer.mask;
+            }
+        }
+        QPainter p( & dst );
+        p.setCompositionMode( QPainter::CompositionMode_Plus );
+        p.setOpacity( layer.alpha );
+        p.drawImage( 0, 0, src );
+    }
+    return dst;
+}
+
+int
+maxChannelDiff( const QImage & a, const QImage & b )
+{
+    int diff = 0;
+    for ( int y = 0 ; y < a.height() ; y++ ) {
+        const QRgb * ra = reinterpret_cast < const QRgb * > ( a.constScanLine( y ) );
+        const QRgb * rb = reinterpret_cast < const QRgb * > ( b.constScanLine( y ) );
+        for ( int x = 0 ; x < a.width() ; x++ ) {
+            diff = std::max( diff, std::abs( qRed( ra[x] ) - qRed( rb[x] ) ) );
+            diff = std::max( diff, std::abs( qGreen( ra[x] ) - qGreen( rb[x] ) ) );
+            diff = std::max( diff, std::abs( qBlue( ra[x] ) - qBlue( rb[x] ) ) );
+            diff = std::max( diff, std::abs( qAlpha( ra[x] ) - qAlpha( rb[x] ) ) );
+        }
+    }
+    return diff;
+}
+}
+
+TEST_CASE( "Plus compositor testing", "[compositor]" ) {
+
+    SECTION( "Vector and scalar code agree") {
+        // odd width to exercise the scalar tail of the vector code
+        for ( QImage::Format format : { QImage::Format_RGB32, QImage::Format_ARGB32,
+                                        QImage::Format_ARGB32_Premultiplied } ) {
+            std::vector < PlusCompositor::Layer > layers = rgbLayers( 37, 11 );
+            for ( PlusCompositor::Layer & layer : layers ) {
+                layer.image = layer.image.convertToFormat( format );
+            }
+            QImage a( 37, 11, QImage::Format_ARGB32_Premultiplied );
+            a.fill( 0 );
+            QImage b = a.copy();
+            PlusCompositor::composite( a, layers );
+            PlusCompositor::compositeScalar( b, layers );
+            REQUIRE( a == b );
+        }
+    }
+
+    SECTION( "Same result as painting with CompositionMode_Plus") {
+        std::vector < PlusCompositor::Layer > layers = rgbLayers( 64, 16 );
+        QImage a( 64, 16, QImage::Format_ARGB32_Premultiplied );
+        a.fill( 0 );
+        PlusCompositor::composite( a, layers );
+        QImage b = compositeWithPainter( a.size(), layers );
+        REQUIRE( maxChannelDiff( a, b ) <= 2 );
+    }
+
+    SECTION( "Channels saturate") {
+        QImage white( 4, 1, QImage::Format_ARGB32 );
+        white.fill( 0xff808080 );
+        QImage dst( 4, 1, QImage::Format_ARGB32_Premultiplied );
+        dst.fill( 0 );
+        PlusCompositor::composite( dst, { PlusCompositor::Layer( white ),
+                                          PlusCompositor::Layer( white ),
+                                          PlusCompositor::Layer( white ) } );
+        REQUIRE( dst.pixel( 0, 0 ) == 0xffffffff );
+    }
+
+    SECTION( "Layers are clipped to the destination") {
+        QImage big = randomImage( 10, 10, QImage::Format_ARGB32, 4 );
+        QImage dst( 4, 3, QImage::Format_ARGB32_Premultiplied );
+        dst.fill( 0 );
+        PlusCompositor::composite( dst, { PlusCompositor::Layer( big ) } );
+        REQUIRE( dst.pixel( 3, 2 ) == big.pixel( 3, 2 ) );
+    }
+}
+
+// microbenchmark, hidden by default, run with: Tests "[.benchmark]"
+TEST_CASE( "Plus compositor benchmark", "[.benchmark]" ) {
+    const int width = 3840, height = 2160, reps = 10;
+    std::vector < PlusCompositor::Layer > layers = rgbLayers( width, height );
+    layers.push_back( PlusCompositor::Layer( layers[0].image, 0xffffffff, 0.25 ) );
+    QImage dst( width, height, QImage::Format_ARGB32_Premultiplied );
+
+    QElapsedTimer timer;
+    timer.start();
+    for ( int i = 0 ; i < reps ; i++ ) {
+        compositeWithPainter( dst.size(), layers );
+    }
+    double painterMs = timer.elapsed() / double (reps);
+
+    timer.restart();
+    for ( int i = 0 ; i < reps ; i++ ) {
+        dst.fill( 0 );
+        PlusCompositor::compositeScalar( dst, layers );
+    }
+    double scalarMs = timer.elapsed() / double (reps);
+
+    timer.restart();
+    for ( int i = 0 ; i < reps ; i++ ) {
+        dst.fill( 0 );
+        PlusCompositor::composite( dst, layers );
+    }
+    double fusedMs = timer.elapsed() / double (reps);
+
+    WARN( "4 layers " << width << "x" << height << ": painter " << painterMs
+          << " ms, scalar " << scalarMs << " ms, fused " << fusedMs << " ms" );
+    REQUIRE( fusedMs <= painterMs );
+}
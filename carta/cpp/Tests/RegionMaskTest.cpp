@@ -0,0 +1,144 @@
+/**
+ *
+ **/
+
+#include "catch.h"
+#include "CartaLib/RegionMask.h"
+#include "CartaLib/RegionIndex.h"
+#include <memory>
+
+using Carta::Lib::RegionInfo;
+using Carta::Lib::RegionMask;
+using Carta::Lib::RegionIndex;
+
+namespace
+{
+RegionInfo
+makeRegion( RegionInfo::RegionType type, const std::vector < std::pair < double, double > > & corners )
+{
+    RegionInfo info;
+    info.setRegionType( type );
+    info.setCorners( corners );
+    return info;
+}
+
+// brute force count of the pixels inside the mask
+qint64
+countContained( const RegionMask & mask, int x0, int y0, int x1, int y1 )
+{
+    qint64 count = 0;
+    for ( int y = y0 ; y <= y1 ; y++ ) {
+        for ( int x = x0 ; x <= x1 ; x++ ) {
+            if ( mask.contains( x, y ) ) {
+                count++;
+            }
+        }
+    }
+    return count;
+}
+}
+
+TEST_CASE( "Region masks", "[regions]" ) {
+
+    SECTION( "Boxes and points") {
+        RegionMask box = RegionMask::rasterize(
+            makeRegion( RegionInfo::RegionType::Polygon, { { 2, 3 }, { 6, 3 }, { 6, 5 }, { 2, 5 } } ) );
+        REQUIRE( box.getPixelCount() == 15 );
+        REQUIRE( box.getRuns().size() == 3 );
+        REQUIRE( box.getBoundingBox() == QRect( 2, 3, 5, 3 ) );
+        REQUIRE( box.contains( 2, 3 ) );
+        REQUIRE( box.contains( 6.4, 5.4 ) );
+        REQUIRE( ! box.contains( 6.6, 5 ) );
+        REQUIRE( ! box.contains( 1, 4 ) );
+
+        RegionMask point = RegionMask::rasterize(
+            makeRegion( RegionInfo::RegionType::Polygon, { { 7.2, 8.7 } } ) );
+        REQUIRE( point.getPixelCount() == 1 );
+        REQUIRE( point.contains( 7, 9 ) );
+
+        REQUIRE( RegionMask::rasterize( makeRegion( RegionInfo::RegionType::Polygon, { { 1, 1 }, { 2, 2 } } ) )
+                 .isEmpty() );
+        REQUIRE( RegionMask::rasterize( RegionInfo() ).isEmpty() );
+    }
+
+    SECTION( "Polygons") {
+        // right triangle with the right angle at the origin
+        RegionMask triangle = RegionMask::rasterize(
+            makeRegion( RegionInfo::RegionType::Polygon, { { 0, 0 }, { 10, 0 }, { 0, 10 } } ) );
+        for ( const RegionMask::Run & run : triangle.getRuns() ) {
+            REQUIRE( run.xMin == 0 );
+            REQUIRE( run.xMax == 10 - run.y );
+        }
+        REQUIRE( triangle.getPixelCount() == countContained( triangle, -5, -5, 15, 15 ) );
+
+        // concave polygon: a "U" shape has two runs in its upper rows
+        RegionMask u = RegionMask::rasterize(
+            makeRegion( RegionInfo::RegionType::Polygon,
+                        { { 0, 0 }, { 9.5, 0 }, { 9.5, 9.5 }, { 6.5, 9.5 }, { 6.5, 3.5 }, { 3.5, 3.5 },
+                          { 3.5, 9.5 }, { 0, 9.5 } } ) );
+        REQUIRE( u.contains( 1, 8 ) );
+        REQUIRE( ! u.contains( 5, 8 ) );
+        REQUIRE( u.contains( 5, 2 ) );
+        REQUIRE( u.contains( 8, 8 ) );
+        REQUIRE( u.getPixelCount() == countContained( u, -1, -1, 11, 11 ) );
+    }
+
+    SECTION( "Ellipses and clipping") {
+        RegionMask ellipse = RegionMask::rasterize(
+            makeRegion( RegionInfo::RegionType::Ellipse, { { 0, 0 }, { 20, 10 } } ) );
+        REQUIRE( ellipse.contains( 10, 5 ) );
+        REQUIRE( ellipse.contains( 0, 5 ) );
+        REQUIRE( ! ellipse.contains( 1, 1 ) );
+        REQUIRE( ellipse.getBoundingBox() == QRect( QPoint( 0, 0 ), QPoint( 20, 10 ) ) );
+        REQUIRE( ellipse.getPixelCount() == countContained( ellipse, -1, -1, 21, 11 ) );
+
+        RegionMask clipped = RegionMask::rasterize(
+            makeRegion( RegionInfo::RegionType::Ellipse, { { 0, 0 }, { 20, 10 } } ), 8, 6 );
+        REQUIRE( clipped.getBoundingBox().right() <= 7 );
+        REQUIRE( clipped.getBoundingBox().bottom() <= 5 );
+        REQUIRE( clipped.getPixelCount() == countContained( ellipse, 0, 0, 7, 5 ) );
+
+        REQUIRE( RegionMask::rasterize( makeRegion( RegionInfo::RegionType::Polygon,
+                                                    { { -9, -9 }, { -3, -9 }, { -3, -3 }, { -9, -3 } } ), 8, 6 )
+                 .isEmpty() );
+    }
+}
+
+TEST_CASE( "Region index", "[regions]" ) {
+    RegionIndex index( 16 );
+
+    // a grid of small boxes, plus one region covering everything
+    int boxCount = 0;
+    for ( double y = 0 ; y < 400 ; y += 10 ) {
+        for ( double x = 0 ; x < 400 ; x += 10 ) {
+            std::shared_ptr < RegionMask > mask( new RegionMask( RegionMask::rasterize(
+                makeRegion( RegionInfo::RegionType::Polygon,
+                            { { x, y }, { x + 4, y }, { x + 4, y + 4 }, { x, y + 4 } } ) ) ) );
+            REQUIRE( index.add( mask ) == boxCount );
+            boxCount++;
+        }
+    }
+    std::shared_ptr < RegionMask > big( new RegionMask( RegionMask::rasterize(
+        makeRegion( RegionInfo::RegionType::Ellipse, { { -10, -10 }, { 410, 410 } } ) ) ) );
+    int bigIndex = index.add( big );
+    REQUIRE( index.getRegionCount() == boxCount + 1 );
+    REQUIRE( index.getMask( bigIndex ) == big );
+    REQUIRE( ! index.getMask( -1 ) );
+
+    std::vector < int > hits = index.getRegionsAt( 202, 201 );
+    REQUIRE( hits.size() == 2 );
+    REQUIRE( hits[0] == 20 * 40 + 20 );
+    REQUIRE( hits[1] == bigIndex );
+    REQUIRE( index.getRegionsAt( 206, 201 ) == std::vector < int > ( { bigIndex } ) );
+    REQUIRE( index.getRegionsAt( 22, 31 ) == std::vector < int > ( { 3 * 40 + 2 } ) );
+    REQUIRE( index.getRegionsAt( -50, -50 ).empty() );
+
+    std::vector < int > overlapping = index.getRegionsIntersecting( QRect( 12, 12, 10, 10 ) );
+    REQUIRE( overlapping == std::vector < int > ( { 41, 42, 81, 82, bigIndex } ) );
+    REQUIRE( index.getRegionsIntersecting( QRect( -1000, -1000, 5000, 5000 ) ).size() ==
+             static_cast < size_t > ( index.getRegionCount() ) );
+
+    index.clear();
+    REQUIRE( index.getRegionCount() == 0 );
+    REQUIRE( index.getRegionsAt( 22, 31 ).empty() );
+}
@@ -0,0 +1,76 @@
+/**
+ *
+ **/
+
+#include "catch.h"
+#include "CartaLib/Algorithms/RegionStatistics.h"
+#include <cmath>
+#include <limits>
+
+using Carta::Lib::RegionInfo;
+using Carta::Lib::RegionMask;
+using Carta::Lib::Algorithms::RegionMoments;
+using Carta::Lib::Algorithms::accumulateRegion;
+
+namespace
+{
+RegionMask
+makeBox( double x0, double y0, double x1, double y1 )
+{
+    RegionInfo info;
+    info.setRegionType( RegionInfo::RegionType::Polygon );
+    info.setCorners( { { x0, y0 }, { x1, y0 }, { x1, y1 }, { x0, y1 } } );
+    return RegionMask::rasterize( info );
+}
+}
+
+TEST_CASE( "Region statistics", "[regions]" ) {
+    const int width = 10;
+    const int height = 8;
+    std::vector < float > plane( width * height );
+    for ( int y = 0 ; y < height ; y++ ) {
+        for ( int x = 0 ; x < width ; x++ ) {
+            plane[y * width + x] = y * width + x;
+        }
+    }
+
+    SECTION( "Moments of a box") {
+        RegionMoments moments = accumulateRegion( makeBox( 1, 2, 3, 3 ), plane.data(), width, height );
+        REQUIRE( moments.count == 6 );
+        REQUIRE( moments.sum == Approx( 21 + 22 + 23 + 31 + 32 + 33 ) );
+        REQUIRE( moments.mean() == Approx( 27 ) );
+        REQUIRE( moments.min == 21 );
+        REQUIRE( moments.minX == 1 );
+        REQUIRE( moments.minY == 2 );
+        REQUIRE( moments.max == 33 );
+        REQUIRE( moments.maxX == 3 );
+        REQUIRE( moments.maxY == 3 );
+        REQUIRE( moments.sigma() == Approx( std::sqrt( 154.0 / 5 ) ) );
+    }
+
+    SECTION( "NaNs and clipping") {
+        plane[0] = std::numeric_limits < float >::quiet_NaN();
+        RegionMoments moments = accumulateRegion( makeBox( -5, -5, 1, 0 ), plane.data(), width, height );
+        REQUIRE( moments.count == 1 );
+        REQUIRE( moments.sum == 1 );
+        REQUIRE( moments.sigma() == 0 );
+
+        RegionMoments outside = accumulateRegion( makeBox( 20, 20, 30, 30 ), plane.data(), width, height );
+        REQUIRE( outside.count == 0 );
+        REQUIRE( std::isnan( outside.mean() ) );
+    }
+
+    SECTION( "Merging") {
+        RegionMoments top = accumulateRegion( makeBox( 0, 0, 9, 3 ), plane.data(), width, height );
+        RegionMoments bottom = accumulateRegion( makeBox( 0, 4, 9, 7 ), plane.data(), width, height );
+        RegionMoments all = accumulateRegion( makeBox( 0, 0, 9, 7 ), plane.data(), width, height );
+        top.merge( bottom );
+        REQUIRE( top.count == all.count );
+        REQUIRE( top.sum == Approx( all.sum ) );
+        REQUIRE( top.sumSq == Approx( all.sumSq ) );
+        REQUIRE( top.min == all.min );
+        REQUIRE( top.maxX == all.maxX );
+        REQUIRE( top.maxY == all.maxY );
+        REQUIRE( top.rms() == Approx( all.rms() ) );
+    }
+}
@@ -11,6 +11,21 @@ SOURCES += \
     SliceTester.cpp \
     StateTester.cpp \
     pixelPipelineTest.cpp \
+    FrameCacheTest.cpp \
+    MemoryGovernorTest.cpp \
+    PlusCompositorTest.cpp \
+    VGStreamTest.cpp \
+    UnitConversionPlanTest.cpp \
+    DirectoryIndexTest.cpp \
+    RegionMaskTest.cpp \
+    RegionStatisticsTest.cpp \
+    CurveDecimationTest.cpp \
+    CurveBufferTest.cpp \
+    BitMaskTest.cpp \
+    FrameDeltaTest.cpp \
+    TraceTest.cpp \
+    LruCacheTest.cpp \
+    CoordinateBatchTest.cpp \
     LineCombinerTest.cpp
 
 #CONFIG += precompile_header
@@ -0,0 +1,104 @@
+#include "catch.h"
+#include "CartaLib/Trace.h"
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+#include <thread>
+
+namespace Trace = Carta::Lib::Trace;
+
+namespace
+{
+void
+tracedCall()
+{
+    CARTA_TRACE_SCOPE( "test", "tracedCall" );
+    CARTA_TRACE_COUNT( "test.calls", 2 );
+}
+
+// number of complete events of a site in a trace, and the threads they ran in
+int
+countEvents( const QByteArray & json, const QString & name, std::vector < int > * threads = nullptr )
+{
+    QJsonArray events = QJsonDocument::fromJson( json ).object()["traceEvents"].toArray();
+    int count = 0;
+    for ( const QJsonValue & value : events ) {
+        QJsonObject event = value.toObject();
+        if ( event["ph"].toString() == "X" && event["name"].toString() == name ) {
+            count++;
+            if ( threads ) {
+                threads->push_back( event["tid"].toInt() );
+            }
+        }
+    }
+    return count;
+}
+}
+
+TEST_CASE( "Tracing", "[trace]" ) {
+
+    SECTION( "Nothing is recorded while disabled") {
+        Trace::setEnabled( false );
+        Trace::reset();
+        for ( int i = 0 ; i < 10 ; i++ ) {
+            tracedCall();
+        }
+        REQUIRE( Trace::getSiteStats().empty() );
+        REQUIRE( Trace::getCounterStats().empty() );
+        REQUIRE( countEvents( Trace::toChromeTrace(), "tracedCall" ) == 0 );
+    }
+
+    SECTION( "Scopes and counters") {
+        Trace::setEnabled( true );
+        Trace::reset();
+        for ( int i = 0 ; i < 5 ; i++ ) {
+            tracedCall();
+        }
+        Trace::setEnabled( false );
+        std::vector < Trace::SiteStats > sites = Trace::getSiteStats();
+        REQUIRE( sites.size() == 1 );
+        REQUIRE( sites[0].category == "test" );
+        REQUIRE( sites[0].name == "tracedCall" );
+        REQUIRE( sites[0].calls == 5 );
+        REQUIRE( sites[0].maxMs <= sites[0].totalMs );
+        std::vector < Trace::CounterStats > counters = Trace::getCounterStats();
+        REQUIRE( counters.size() == 1 );
+        REQUIRE( counters[0].name == "test.calls" );
+        REQUIRE( counters[0].value == 10 );
+
+        Trace::reset();
+        REQUIRE( Trace::getSiteStats().empty() );
+        REQUIRE( countEvents( Trace::toChromeTrace(), "tracedCall" ) == 0 );
+    }
+
+    SECTION( "Every thread has its own events") {
+        Trace::setEnabled( true );
+        Trace::reset();
+        tracedCall();
+        std::thread worker( [] () {
+                                for ( int i = 0 ; i < 3 ; i++ ) {
+                                    tracedCall();
+                                }
+                            } );
+        worker.join();
+        Trace::setEnabled( false );
+        std::vector < int > threads;
+        REQUIRE( countEvents( Trace::toChromeTrace(), "tracedCall", & threads ) == 4 );
+        int workerEvents = std::count( threads.begin(), threads.end(), threads.back() );
+        REQUIRE( threads.front() != threads.back() );
+        REQUIRE( workerEvents == 3 );
+    }
+
+    SECTION( "Only the newest events are kept") {
+        Trace::setEnabled( true );
+        Trace::reset();
+        int calls = Trace::getEventCapacity() + 100;
+        for ( int i = 0 ; i < calls ; i++ ) {
+            tracedCall();
+        }
+        Trace::setEnabled( false );
+        REQUIRE( countEvents( Trace::toChromeTrace(), "tracedCall" ) == Trace::getEventCapacity() );
+        REQUIRE( Trace::getSiteStats()[0].calls == quint64( calls ) );
+    }
+}
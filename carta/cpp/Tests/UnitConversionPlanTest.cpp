@@ -0,0 +1,133 @@
+/**
+ *
+ **/
+
+#include "catch.h"
+#include "CartaLib/UnitConversionPlan.h"
+#include <cmath>
+
+using Carta::Lib::UnitConversionPlan;
+using Carta::Lib::UnitConversionInfo;
+
+namespace
+{
+const double C = 299792458.0;
+
+/// spectral axis starting at 100 GHz, 1 MHz per channel
+UnitConversionInfo
+testInfo()
+{
+    UnitConversionInfo info;
+    info.spectralValid = true;
+    info.restFrequency = 100e9;
+    info.spectralLinear = true;
+    info.refPixel = 10;
+    info.refValue = 100.01e9;
+    info.increment = 1e6;
+    info.beamValid = true;
+    info.beamAngle = 3e-10;
+    info.beamArea = 2.5;
+    return info;
+}
+
+std::vector < double >
+convert( const UnitConversionPlan & plan, std::vector < double > values,
+         const std::vector < double > & aux = std::vector < double > () )
+{
+    plan.apply( values, aux );
+    return values;
+}
+}
+
+TEST_CASE( "Unit conversion plans", "[units]" ) {
+
+    UnitConversionInfo info = testInfo();
+
+    SECTION( "Prefixes only need a scale") {
+        auto plan = UnitConversionPlan::spectral( "GHz", "MHz", UnitConversionInfo() );
+        REQUIRE( plan.isValid() );
+        REQUIRE( plan.stepCount() == 1 );
+        REQUIRE( convert( plan, { 1.5, -2 } ) == std::vector < double > ( { 1500, -2000 } ) );
+        REQUIRE( convert( UnitConversionPlan::spectral( "mm", "um", info ), { 3 } )[0] == Approx( 3000 ) );
+        REQUIRE( convert( UnitConversionPlan::spectral( "m/s", "km/s", info ), { 250 } )[0] == Approx( 0.25 ) );
+        REQUIRE( UnitConversionPlan::spectral( "GHz", "GHz", info ).isIdentity() );
+        REQUIRE( UnitConversionPlan::spectral( "pixel", "", info ).isIdentity() );
+    }
+
+    SECTION( "Frequency, wavelength, velocity and channels") {
+        auto toMm = UnitConversionPlan::spectral( "GHz", "mm", info );
+        REQUIRE( convert( toMm, { 100 } )[0] == Approx( C / 100e9 * 1e3 ) );
+        auto back = UnitConversionPlan::spectral( "mm", "GHz", info );
+        REQUIRE( convert( back, convert( toMm, { 90, 110 } ) )[1] == Approx( 110 ) );
+
+        auto toVelocity = UnitConversionPlan::spectral( "Hz", "km/s", info );
+        double f = 100e9 * ( 1 - 1e3 / C );
+        REQUIRE( convert( toVelocity, { f } )[0] == Approx( 1 ) );
+        REQUIRE( convert( UnitConversionPlan::spectral( "km/s", "Hz", info ), { 1 } )[0] == Approx( f ) );
+        REQUIRE( convert( UnitConversionPlan::spectral( "km/s", "mm", info ), { 0 } )[0] ==
+                 Approx( C / 100e9 * 1e3 ) );
+
+        auto channels = UnitConversionPlan::spectral( "pixel", "GHz", info );
+        REQUIRE( channels.stepCount() == 1 );
+        REQUIRE( convert( channels, { 0, 10 } )[1] == Approx( 100.01 ) );
+        REQUIRE( convert( channels, { 0 } )[0] == Approx( 100 ) );
+        REQUIRE( convert( UnitConversionPlan::spectral( "GHz", "", info ), { 100.005 } )[0] == Approx( 5 ) );
+    }
+
+    SECTION( "Conversions that need the coordinate system") {
+        REQUIRE( ! UnitConversionPlan::spectral( "GHz", "mm", UnitConversionInfo() ).isValid() );
+        UnitConversionInfo noRest = info;
+        noRest.restFrequency = 0;
+        REQUIRE( ! UnitConversionPlan::spectral( "GHz", "km/s", noRest ).isValid() );
+        REQUIRE( UnitConversionPlan::spectral( "GHz", "mm", noRest ).isValid() );
+        UnitConversionInfo tabular = info;
+        tabular.spectralLinear = false;
+        REQUIRE( ! UnitConversionPlan::spectral( "pixel", "GHz", tabular ).isValid() );
+        REQUIRE( ! UnitConversionPlan::spectral( "GHz", "parsec", info ).isValid() );
+
+        // invalid plans leave the values alone
+        REQUIRE( convert( UnitConversionPlan::invalid(), { 1, 2 } ) == std::vector < double > ( { 1, 2 } ) );
+    }
+
+    SECTION( "Intensity") {
+        auto plan = UnitConversionPlan::intensity( "mJy/beam", "Jy/beam", 0, "", info );
+        REQUIRE( plan.stepCount() == 1 );
+        REQUIRE( ! plan.needsAux() );
+        REQUIRE( convert( plan, { 5 } )[0] == Approx( 0.005 ) );
+        REQUIRE( convert( UnitConversionPlan::intensity( "Jy/beam", "Jy/arcsec^2", 0, "", info ), { 5 } )[0]
+                 == Approx( 2 ) );
+        REQUIRE( convert( UnitConversionPlan::intensity( "Jy/beam", "Fraction of Peak", 8, "Jy/beam", info ),
+                          { 4 } )[0] == Approx( 0.5 ) );
+        REQUIRE( convert( UnitConversionPlan::intensity( "Fraction of Peak", "mJy/beam", 8, "Jy/beam", info ),
+                          { 0.5 } )[0] == Approx( 4000 ) );
+
+        // Kelvin depends on the frequency of each point
+        std::vector < double > hz = { 100e9, 200e9 };
+        auto toKelvin = UnitConversionPlan::intensity( "Jy/beam", "mKelvin", 0, "", info );
+        REQUIRE( toKelvin.needsAux() );
+        std::vector < double > kelvin = convert( toKelvin, { 1, 1 }, hz );
+        REQUIRE( kelvin[0] == Approx( 4 * kelvin[1] ) );
+        auto fromKelvin = UnitConversionPlan::intensity( "mKelvin", "Jy/beam", 0, "", info );
+        std::vector < double > jy = convert( fromKelvin, kelvin, hz );
+        REQUIRE( jy[0] == Approx( 1 ) );
+        REQUIRE( jy[1] == Approx( 1 ) );
+
+        // without frequencies nothing happens
+        REQUIRE( convert( toKelvin, { 1, 1 } ) == std::vector < double > ( { 1, 1 } ) );
+
+        REQUIRE( ! UnitConversionPlan::intensity( "adu", "Jy/beam", 0, "", info ).isValid() );
+        REQUIRE( ! UnitConversionPlan::intensity( "Jy/beam", "Kelvin", 0, "", UnitConversionInfo() ).isValid() );
+    }
+
+    SECTION( "Long arrays") {
+        std::vector < double > channels( 10001 );
+        for ( size_t i = 0 ; i < channels.size() ; i++ ) {
+            channels[i] = i;
+        }
+        std::vector < double > velocities = convert( UnitConversionPlan::spectral( "", "km/s", info ), channels );
+        for ( size_t i = 0 ; i < channels.size() ; i += 997 ) {
+            double hz = info.refValue + ( i - info.refPixel ) * info.increment;
+            REQUIRE( velocities[i] == Approx( C * ( 1 - hz / info.restFrequency ) / 1e3 ) );
+        }
+    }
+}
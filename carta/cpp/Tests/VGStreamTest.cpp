@@ -0,0 +1,142 @@
+/**
+ *
+ **/
+
+#include "catch.h"
+#include "CartaLib/VectorGraphics/VGList.h"
+#include <cmath>
+
+namespace VG = Carta::Lib::VectorGraphics;
+namespace VGE = VG::Entries;
+
+namespace
+{
+/// concentric wobbly rings, similar to what contouring a source produces
+VG::VGList
+contourLikeList( int levels, int pointsPerLevel, size_t * nPoints = nullptr )
+{
+    VG::VGComposer vgc;
+    size_t count = 0;
+    for ( int k = 0 ; k < levels ; k++ ) {
+        vgc.append < VGE::SetPen > ( QPen( QColor::fromHsv( k * 17, 255, 255 ), 1 ) );
+        QPolygonF poly;
+        for ( int i = 0 ; i <= pointsPerLevel ; i++ ) {
+            double a = 2 * M_PI * i / pointsPerLevel;
+            double r = 20 + 15 * k + 3 * std::sin( 7 * a );
+            poly.append( QPointF( 400 + r * std::cos( a ), 300 + r * std::sin( a ) ) );
+        }
+        vgc.append < VGE::DrawPolyline > ( poly );
+        count += poly.size();
+    }
+    if ( nPoints ) {
+        * nPoints = count;
+    }
+    return vgc.vgList();
+}
+
+QImage
+renderList( const VG::VGList & list )
+{
+    QImage img( 800, 600, QImage::Format_ARGB32_Premultiplied );
+    img.fill( 0 );
+    QPainter painter( & img );
+    VG::VGListQPainterRenderer().render( list, painter );
+    return img;
+}
+}
+
+TEST_CASE( "VG stream testing", "[vgstream]" ) {
+
+    SECTION( "Every entry type survives a round trip") {
+        VG::VGComposer vgc;
+        vgc.append < VGE::Reset > ();
+        vgc.append < VGE::Save > ();
+        vgc.append < VGE::SetTransform > ( QTransform().translate( 3, 4 ).rotate( 30 ), true );
+        vgc.append < VGE::SetClipRect > ( QRectF( 1, 2, 300, 200 ) );
+        vgc.append < VGE::StoreIndexedPen > ( 2, QPen( QColor( 1, 2, 3, 4 ), 1.5, Qt::DashLine ) );
+        vgc.append < VGE::SetIndexedPen > ( 2 );
+        vgc.append < VGE::StoreIndexedBrush > ( 0, QBrush( QColor( "blue" ) ) );
+        vgc.append < VGE::SetIndexedBrush > ( 0 );
+        vgc.append < VGE::SetBrush > ( QBrush( QColor( "green" ) ) );
+        vgc.append < VGE::SetPen > ( QPen( QColor( "red" ), 2 ) );
+        vgc.append < VGE::SetPenWidth > ( 3 );
+        vgc.append < VGE::SetPenColor > ( QColor( "yellow" ) );
+        vgc.append < VGE::SetFontIndex > ( 1 );
+        vgc.append < VGE::SetFontSize > ( 12 );
+        vgc.append < VGE::DrawLine > ( QPointF( 0.5, 1.5 ), QPointF( 100.25, 50 ) );
+        vgc.append < VGE::DrawPolyline > ( QPolygonF( { QPointF( 1, 1 ), QPointF( 2, 5 ), QPointF( -3, 7 ) } ) );
+        vgc.append < VGE::FillRect > ( QRectF( 5, 5, 10, 10 ), QColor( 255, 0, 0, 128 ) );
+        vgc.append < VGE::DrawRect > ( QRectF( 20, 20, 30, 40 ) );
+        vgc.append < VGE::DrawText > ( QString::fromUtf8( "RA \xce\xb1" ), QPointF( 7, 8 ) );
+        vgc.append < VGE::Restore > ();
+
+        for ( bool quantise : { false, true } ) {
+            QByteArray data = VG::VGStream::encode( vgc.vgList(), quantise );
+            bool ok = false;
+            VG::VGList decoded = VG::VGStream::decode( data, & ok );
+            REQUIRE( ok );
+            REQUIRE( decoded.entries().size() == vgc.vgList().entries().size() );
+            REQUIRE( VG::VGStream::encode( decoded, quantise ) == data );
+        }
+    }
+
+    SECTION( "Rendering a stream matches rendering the list") {
+        VG::VGList list = contourLikeList( 5, 100 );
+        QByteArray data = VG::VGStream::encode( list, false );
+        QImage a = renderList( list );
+        QImage b( a.size(), a.format() );
+        b.fill( 0 );
+        QPainter painter( & b );
+        REQUIRE( VG::VGStream::render( data, painter ) );
+        painter.end();
+        REQUIRE( a == b );
+
+        // the same, through a packed entry
+        VG::VGComposer vgc;
+        vgc.append < VGE::DrawPacked > ( data );
+        REQUIRE( renderList( vgc.vgList() ) == a );
+    }
+
+    SECTION( "Quantised coordinates are accurate and compact") {
+        QPolygonF poly( { QPointF( 10.01, 20.02 ), QPointF( 10.5, 19.3 ), QPointF( 700.3, -2.7 ) } );
+        double scale = VG::VGStreamWriter::quantisationScale( 700.3 );
+        REQUIRE( scale == 32 );
+        QPolygonF rounded;
+        for ( const QPointF & pt : poly ) {
+            rounded.append( QPointF( qRound( pt.x() * scale ) / scale, qRound( pt.y() * scale ) / scale ) );
+        }
+        VG::VGComposer vgc, expected;
+        vgc.append < VGE::DrawPolyline > ( poly );
+        expected.append < VGE::DrawPolyline > ( rounded );
+        VG::VGList decoded = VG::VGStream::decode( VG::VGStream::encode( vgc.vgList(), true ) );
+        REQUIRE( VG::VGStream::encode( decoded, false ) == VG::VGStream::encode( expected.vgList(), false ) );
+
+        // 20 contour levels, mostly two bytes per point
+        size_t nPoints = 0;
+        QByteArray data = VG::VGStream::encode( contourLikeList( 20, 2000, & nPoints ), true );
+        REQUIRE( size_t( data.size() ) * 6 < nPoints * sizeof( QPointF ) );
+
+        // pens are stored once in the table
+        VG::VGComposer pens;
+        for ( int i = 0 ; i < 100 ; i++ ) {
+            pens.append < VGE::SetPen > ( QPen( QColor( "red" ), 2 ) );
+        }
+        REQUIRE( VG::VGStream::encode( pens.vgList() ).size() <= 4 + 1 + 4 + 1 + 12 + 1 + 100 * 2 );
+    }
+
+    SECTION( "Bad streams are rejected") {
+        bool ok = true;
+        VG::VGStream::decode( QByteArray( "nonsense" ), & ok );
+        REQUIRE( ! ok );
+
+        QByteArray data = VG::VGStream::encode( contourLikeList( 2, 10 ) );
+        VG::VGStream::decode( data.left( data.size() - 3 ), & ok );
+        REQUIRE( ! ok );
+
+        // a huge point count must not allocate anything
+        QByteArray bogus = data.left( 5 + 4 );
+        bogus.append( QByteArray( "\x00\x00\x03\xff\xff\xff\xff\x0f", 8 ) );
+        VG::VGStream::decode( bogus, & ok );
+        REQUIRE( ! ok );
+    }
+}
@@ -65,6 +65,13 @@ contains( CARTA_CONFIG, runtimeChecks) {
     CONFIG -= debug
     message( "- NO extra runtime checks")
 }
+contains( CARTA_CONFIG, noTrace) {
+    QMAKE_CXXFLAGS += -DCARTA_TRACE=0
+    QMAKE_CFLAGS += -DCARTA_TRACE=0
+    message( "- NO tracing")
+} else {
+    message( "+ tracing")
+}
 contains( CARTA_CONFIG, noOpt) {
     message( "- NO full optimization")
     QMAKE_CXXFLAGS += -O0
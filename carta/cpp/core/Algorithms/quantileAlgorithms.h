@@ -6,6 +6,7 @@
 
 #include "CartaLib/CartaLib.h"
 #include "CartaLib/IImage.h"
+#include "CartaLib/Trace.h"
 #include <QDebug>
 #include <limits>
 #include <algorithm>
@@ -18,31 +19,20 @@ namespace Core
 {
 namespace Algorithms
 {
-/// compute requested quantiles
-/// \param view the input dataset
+/// compute requested quantiles of values that are already in memory
+/// \param values the finite values of the dataset, they are reordered
 /// \param quant which quantiles to compute
-/// \return the computed quantiles. If all inputs are nans, the result will also be nans.
-///
-/// Example: [0.1] will compute a value such that 10% of all values are smaller than the returned
-/// value.
-///
-/// \note this is a dumb algorithm using quickselect. It really only works on datasets that
-/// are small enough to store in memory. For really big datasets we need a lot more sophisticated
-/// algorithm.
-///
-/// \note NANs are treated as if they did not exist
+/// \return the computed quantiles. If there are no values, the result will be nans.
 ///
 /// \note for best performance, the supplied list of quantiles should be sorted small->large
 template < typename Scalar >
 static
 typename std::vector < Scalar >
-quantiles2pixels(
-    Carta::Lib::NdArray::TypedView < Scalar > & view,
+quantilesInPlace(
+    std::vector < Scalar > & allValues,
     std::vector < double > quant
     )
 {
-    qDebug() << "computeClips" << view.dims();
-
     // basic preconditions
     if ( CARTA_RUNTIME_CHECKS ) {
         for ( auto q : quant ) {
@@ -51,16 +41,6 @@ quantiles2pixels(
         }
     }
 
-    // read in all values from the view into memory so that we can do quickselect on it
-    std::vector < Scalar > allValues;
-    view.forEach(
-        [& allValues] ( const Scalar & val ) {
-            if ( ! std::isnan( val ) ) {
-                allValues.push_back( val );
-            }
-        }
-        );
-
     // indicate bad clip if no finite numbers were found
     if ( allValues.size() == 0 ) {
         return std::vector < Scalar > ( std::numeric_limits < Scalar >::quiet_NaN(), quant.size() );
@@ -94,6 +74,45 @@ quantiles2pixels(
     }
 
     return result;
+} // quantilesInPlace
+
+/// compute requested quantiles
+/// \param view the input dataset
+/// \param quant which quantiles to compute
+/// \return the computed quantiles. If all inputs are nans, the result will also be nans.
+///
+/// Example: [0.1] will compute a value such that 10% of all values are smaller than the returned
+/// value.
+///
+/// \note this is a dumb algorithm using quickselect. It really only works on datasets that
+/// are small enough to store in memory. For really big datasets we need a lot more sophisticated
+/// algorithm.
+///
+/// \note NANs are treated as if they did not exist
+///
+/// \note for best performance, the supplied list of quantiles should be sorted small->large
+template < typename Scalar >
+static
+typename std::vector < Scalar >
+quantiles2pixels(
+    Carta::Lib::NdArray::TypedView < Scalar > & view,
+    std::vector < double > quant
+    )
+{
+    qDebug() << "computeClips" << view.dims();
+    CARTA_TRACE_SCOPE( "clips", "quantiles2pixels" );
+
+    // read in all values from the view into memory so that we can do quickselect on it
+    std::vector < Scalar > allValues;
+    view.forEach(
+        [& allValues] ( const Scalar & val ) {
+            if ( ! std::isnan( val ) ) {
+                allValues.push_back( val );
+            }
+        }
+        );
+
+    return quantilesInPlace( allValues, quant );
 } // computeClips
 
 /// algorithm for finding quantile from pixel value
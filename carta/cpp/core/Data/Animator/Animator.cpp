@@ -30,6 +30,7 @@ public:
 const QString Animator::CLASS_NAME = "Animator";
 const QString Animator::NAME = "name";
 const QString Animator::VALUE = "value";
+const int Animator::PREFETCH_COUNT = 8;
 bool Animator::m_registered =
         Carta::State::ObjectManager::objectManager()->registerClass (CLASS_NAME,
                                                    new Animator::Factory());
@@ -207,6 +208,7 @@ void Animator::clear(){
 
 void Animator::_frameChanged( int index, const QString& axisName ){
     changeFrame( index, axisName );
+    _prefetchFrames( axisName );
 }
 
 AnimatorType* Animator::getAnimator( const QString& type ){
@@ -472,6 +474,25 @@ QString Animator::removeLink( CartaObject* cartaObject ){
 }
 
 
+void Animator::_prefetchFrames( const QString& axisName ){
+    //Switching images is cheap; only the hidden image axes need reading ahead.
+    if ( axisName == Selection::IMAGE || !m_animators.contains( axisName ) ){
+        return;
+    }
+    AxisInfo::KnownType axisType = AxisMapper::getType( axisName );
+    if ( axisType == AxisInfo::KnownType::OTHER ){
+        return;
+    }
+    QList<int> upcoming = m_animators[axisName]->getUpcomingFrames( PREFETCH_COUNT );
+    int linkCount = m_linkImpl->getLinkCount();
+    for( int i = 0; i < linkCount; i++ ){
+        Controller* controller = dynamic_cast<Controller*>( m_linkImpl->getLink(i));
+        if ( controller != nullptr ){
+            controller->_prefetchFrames( axisType, upcoming );
+        }
+    }
+}
+
 void Animator::_resetAnimationParameters( int selectedImage ){
     _addRemoveImageAnimator();
     if ( m_animators.contains( Selection::IMAGE) ){
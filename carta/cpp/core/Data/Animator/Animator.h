@@ -165,6 +165,9 @@ private:
     void _initializeCallbacks();
     QString _initAnimator( const QString& type, bool* newAnimator );
 
+    //Ask the linked controllers to read ahead the frames the animation will show next.
+    void _prefetchFrames( const QString& axisName );
+
     void _resetAnimationParameters( int selectedImage );
 
     //Reset the preferences state of an individual animator.
@@ -187,6 +190,9 @@ private:
     const static QString NAME;
     const static QString VALUE;
 
+    //Number of frames to read ahead of an animation.
+    const static int PREFETCH_COUNT;
+
     Animator( const Animator& other);
     Animator& operator=( const Animator& other );
 };
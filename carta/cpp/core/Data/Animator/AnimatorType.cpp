@@ -2,6 +2,7 @@
 #include "Data/Selection.h"
 #include "Data/Util.h"
 #include "State/UtilState.h"
+#include "CartaLib/CartaLib.h"
 
 #include <set>
 
@@ -43,6 +44,8 @@ AnimatorType::AnimatorType(const QString& path, const QString& id ):
         m_select = nullptr;
         m_removed = false;
         m_visible = true;
+        m_lastFrame = 0;
+        m_direction = 1;
         _initializeState();
         _makeSelection();
 
@@ -70,6 +73,55 @@ QString AnimatorType::getType() const {
     return m_type;
 }
 
+int AnimatorType::_getNextFrame( int frame, int* direction ) const {
+    //Mirrors the stepping done by the client when it is playing.
+    int step = m_state.getValue<int>( STEP );
+    QString endBehavior = m_state.getValue<QString>( END_BEHAVIOR );
+    int lowerBound = m_select->getLowerBoundUser();
+    int upperBound = m_select->getUpperBoundUser();
+    int nextFrame = frame + (*direction) * step;
+    if ( endBehavior == END_BEHAVIOR_JUMP ){
+        if ( *direction > 0 ){
+            nextFrame = frame < upperBound ? upperBound : lowerBound;
+        }
+        else {
+            nextFrame = frame > lowerBound ? lowerBound : upperBound;
+        }
+    }
+    else if ( nextFrame > upperBound || nextFrame < lowerBound ){
+        if ( endBehavior == END_BEHAVIOR_REVERSE ){
+            *direction = -(*direction);
+            nextFrame = frame + (*direction) * step;
+            nextFrame = Carta::Lib::clamp( nextFrame, lowerBound, upperBound );
+        }
+        else if ( nextFrame > upperBound ){
+            nextFrame = lowerBound;
+        }
+        else {
+            nextFrame = upperBound;
+        }
+    }
+    return nextFrame;
+}
+
+QList<int> AnimatorType::getUpcomingFrames( int count ) const {
+    QList<int> upcoming;
+    if ( m_select != nullptr && m_select->getLowerBoundUser() < m_select->getUpperBoundUser() ){
+        int currentFrame = m_select->getIndex();
+        int frame = currentFrame;
+        int direction = m_direction;
+        for ( int i = 0; i < count; i++ ){
+            frame = _getNextFrame( frame, &direction );
+            //Stop once the animation starts repeating frames.
+            if ( frame == currentFrame || upcoming.contains( frame ) ){
+                break;
+            }
+            upcoming.append( frame );
+        }
+    }
+    return upcoming;
+}
+
 void AnimatorType::_initializeState( ){
     m_state.insertValue<int>( STEP, 1 );
     m_state.insertValue<int>( RATE, 100 );
@@ -233,7 +285,9 @@ void AnimatorType::resetStateData( const QString& state ){
 }
 
 void AnimatorType::_selectionChanged(){
-    emit indexChanged( m_select->getIndex(), m_type );
+    int frame = m_select->getIndex();
+    _updateDirection( frame );
+    emit indexChanged( frame, m_type );
 }
 
 void AnimatorType::_setType( const QString& type ){
@@ -332,6 +386,37 @@ void AnimatorType::setUpperBound( int value ){
 }
 
 
+void AnimatorType::_updateDirection( int frame ){
+    if ( frame != m_lastFrame ){
+        QString endBehavior = m_state.getValue<QString>( END_BEHAVIOR );
+        int step = m_state.getValue<int>( STEP );
+        int lowerBound = m_select->getLowerBoundUser();
+        int upperBound = m_select->getUpperBoundUser();
+        //A jump back to the start of the range is a step forward when wrapping or
+        //jumping, and vice versa.
+        bool forwardOverEnd = false;
+        bool backwardOverEnd = false;
+        if ( endBehavior == END_BEHAVIOR_WRAP ){
+            forwardOverEnd = m_lastFrame + step > upperBound && frame == lowerBound;
+            backwardOverEnd = m_lastFrame - step < lowerBound && frame == upperBound;
+        }
+        else if ( endBehavior == END_BEHAVIOR_JUMP ){
+            forwardOverEnd = m_lastFrame == upperBound && frame == lowerBound;
+            backwardOverEnd = m_lastFrame == lowerBound && frame == upperBound;
+        }
+        if ( forwardOverEnd ){
+            m_direction = 1;
+        }
+        else if ( backwardOverEnd ){
+            m_direction = -1;
+        }
+        else {
+            m_direction = frame > m_lastFrame ? 1 : -1;
+        }
+        m_lastFrame = frame;
+    }
+}
+
 AnimatorType::~AnimatorType(){
     if ( m_select != nullptr ){
         Carta::State::ObjectManager* objMan = Carta::State::ObjectManager::objectManager();
@@ -7,6 +7,7 @@
 
 #include <memory>
 #include <QObject>
+#include <QList>
 #include <State/StateInterface.h>
 #include <State/ObjectManager.h>
 
@@ -44,6 +45,15 @@ public:
 
     QString getType() const;
 
+    /**
+     * Predict the frames an animation will show after the current one.
+     * @param count - the maximum number of frames to predict.
+     * @return frame indices in the order they are expected to be shown.  The
+     *      prediction follows the last observed direction of movement, the step size,
+     *      the user bounds, and the end behavior.
+     */
+    QList<int> getUpcomingFrames( int count ) const;
+
     /**
      * Returns true if the animator is no longer visually available; false otherwise.
      * @return true if the animator is hidden; false otherwise.
@@ -149,6 +159,13 @@ private:
 
     QString _makeSelection();
 
+    //Return the frame that follows the given one when moving in the given direction,
+    //possibly reversing the direction at the ends of the range.
+    int _getNextFrame( int frame, int* direction ) const;
+
+    //Update the direction of movement based on the newly selected frame.
+    void _updateDirection( int frame );
+
     //Set state variables involving the animator
     void _saveState();
 
@@ -167,6 +184,10 @@ private:
 
     bool m_visible;
     bool m_removed;
+
+    //Last frame selected and the direction (1 or -1) the animation is moving in.
+    int m_lastFrame;
+    int m_direction;
     AnimatorType( const AnimatorType& other);
     AnimatorType& operator=( const AnimatorType& other );
 };
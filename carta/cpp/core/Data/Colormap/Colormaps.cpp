@@ -10,6 +10,7 @@
 
 #include <QDebug>
 #include <QColor>
+#include <QHash>
 #include <set>
 
 namespace Carta {
@@ -39,73 +40,89 @@ bool Colormaps::m_registered =
         Carta::State::ObjectManager::objectManager()->registerClass ( CLASS_NAME, new Colormaps::Factory());
 
 
+//The colormaps of the core and of the plugins, shared by every Colormaps object.
+struct Colormaps::ColormapList {
+    std::vector < std::shared_ptr<Carta::Lib::PixelPipeline::IColormapNamed> > maps;
+    QStringList names;
+    //Index of the first map with a given name.
+    QHash<QString,int> indices;
+};
+
 Colormaps::Colormaps( const QString& path, const QString& id):
-    CartaObject( CLASS_NAME, path, id ){
+    CartaObject( CLASS_NAME, path, id ),
+    m_colormaps( _getColormapList() ){
     _initializeDefaultState();
 }
 
 
-
-
 QStringList Colormaps::getColorMaps() const {
-    QStringList buff;
-    int colormapCount = m_colormaps.size();
-    for ( int i = 0; i < colormapCount; i++ ){
-        buff << m_colormaps[i]->name();
-    }
-    return buff;
+    return m_colormaps->names;
 }
 
-void Colormaps::_initializeDefaultState(){
+std::shared_ptr<const Colormaps::ColormapList> Colormaps::_getColormapList(){
+    //Initialization of a function local static is thread safe, so a session that
+    //needs the list while it is being prewarmed waits for it.
+    static const std::shared_ptr<const ColormapList> colormaps = _makeColormapList();
+    return colormaps;
+}
+
+std::shared_ptr<const Colormaps::ColormapList> Colormaps::_makeColormapList(){
+    std::shared_ptr<ColormapList> colormaps = std::make_shared<ColormapList>();
+
     // get all colormaps provided by core
-    m_colormaps.push_back( std::make_shared < Carta::Core::GrayColormap > () );
+    colormaps->maps.push_back( std::make_shared < Carta::Core::GrayColormap > () );
 
     // ask plugins for colormaps
     auto hh = Globals::instance()-> pluginManager()-> prepare < Carta::Lib::Hooks::
                                                               ColormapsScalarHook > ();
 
     auto lam = [=] ( const Carta::Lib::Hooks::ColormapsScalarHook::ResultType &cmaps ) {
-        m_colormaps.insert( m_colormaps.end(), cmaps.begin(), cmaps.end() );
+        colormaps->maps.insert( colormaps->maps.end(), cmaps.begin(), cmaps.end() );
     };
     hh.forEach( lam );
 
-    int colorMapCount = m_colormaps.size();
+    int colorMapCount = colormaps->maps.size();
+    for ( int i = 0; i < colorMapCount; i++ ){
+        QString name = colormaps->maps[i]->name();
+        colormaps->names.append( name );
+        if ( !colormaps->indices.contains( name ) ){
+            colormaps->indices.insert( name, i );
+        }
+    }
+    return colormaps;
+}
+
+void Colormaps::_initializeDefaultState(){
+    int colorMapCount = m_colormaps->names.size();
     m_state.insertValue<int>( COLOR_MAP_COUNT, colorMapCount );
     m_state.insertArray( COLOR_MAPS, colorMapCount );
     for ( int i = 0; i < colorMapCount; i++ ){
         QString arrayIndexStr = Carta::State::UtilState::getLookup( COLOR_MAPS, QString::number(i));
-        m_state.setValue<QString>(arrayIndexStr, m_colormaps[i]->name());
+        m_state.setValue<QString>(arrayIndexStr, m_colormaps->names[i]);
 
     }
     m_state.flushState();
 }
 
 std::shared_ptr<Carta::Lib::PixelPipeline::IColormapNamed>  Colormaps::getColorMap( const QString& mapName ) const {
-    int mapCount = m_colormaps.size();
     std::shared_ptr<Carta::Lib::PixelPipeline::IColormapNamed> map = nullptr;
-    for ( int i = 0; i < mapCount; i++ ){
-        if ( m_colormaps[i]->name() == mapName ){
-            map = m_colormaps[i];
-            break;
-        }
+    QHash<QString,int>::const_iterator iter = m_colormaps->indices.find( mapName );
+    if ( iter != m_colormaps->indices.end() ){
+        map = m_colormaps->maps[iter.value()];
     }
     return map;
 }
 
 
 bool Colormaps::isMap( const QString& name ) const {
-    int colorMapCount = m_colormaps.size();
-    bool colorMap = false;
-    for ( int i = 0; i < colorMapCount; i++ ){
-        if ( name == m_colormaps[i]->name()){
-           colorMap = true;
-           break;
-        }
-    }
-    return colorMap;
+    return m_colormaps->indices.contains( name );
 }
 
 
+void Colormaps::prewarm(){
+    _getColormapList();
+}
+
 
 Colormaps::~Colormaps(){
 
@@ -7,7 +7,7 @@
 
 #include "State/ObjectManager.h"
 #include "State/StateInterface.h"
-#include <vector>
+#include <memory>
 
 namespace Carta {
 namespace Lib {
@@ -45,15 +45,27 @@ public:
      */
     QStringList getColorMaps() const;
 
+    /**
+     * Builds the list of colormaps offered by the core and the plugins.  The list
+     * does not change while the process runs, so it is built once and shared; calling
+     * this early (from any thread) takes the work off the creation of the first session.
+     */
+    static void prewarm();
+
     virtual ~Colormaps();
 
     const static QString COLOR_LIST;
     const static QString CLASS_NAME;
 private:
 
+    struct ColormapList;
+
     void _initializeDefaultState();
 
-    std::vector < std::shared_ptr<Carta::Lib::PixelPipeline::IColormapNamed> > m_colormaps;
+    static std::shared_ptr<const ColormapList> _getColormapList();
+    static std::shared_ptr<const ColormapList> _makeColormapList();
+
+    std::shared_ptr<const ColormapList> m_colormaps;
 
     static bool m_registered;
     const static QString COLOR_MAPS;
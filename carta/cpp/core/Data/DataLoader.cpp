@@ -1,11 +1,11 @@
 #include <unistd.h>
 
 #include <QDebug>
-#include <QDirIterator>
 #include <QJsonDocument>
 #include <QJsonObject>
 
 #include "DataLoader.h"
+#include "DirectoryIndex.h"
 #include "Util.h"
 #include "Globals.h"
 #include "IPlatform.h"
@@ -34,6 +34,11 @@ public:
 QString DataLoader::fakeRootDirName = "RootDirectory";
 const QString DataLoader::CLASS_NAME = "DataLoader";
 const QString DataLoader::DIR = "dir";
+const QString DataLoader::COMPLETE = "complete";
+const QString DataLoader::COUNT = "count";
+const QString DataLoader::OFFSET = "offset";
+const QString DataLoader::TOTAL = "total";
+const QString DataLoader::METADATA_PENDING = "metadataPending";
 const QString DataLoader::CRTF = ".crtf";
 const QString DataLoader::REG = ".reg";
 
@@ -43,12 +48,18 @@ bool DataLoader::m_registered =
 
 
 DataLoader::DataLoader( const QString& path, const QString& id ):
-    CartaObject( CLASS_NAME, path, id ){
+    CartaObject( CLASS_NAME, path, id ),
+    m_index( new DirectoryIndex() ){
     _initCallbacks();
 }
 
 
 QString DataLoader::getData(const QString& dirName, const QString& sessionId) {
+    return getDataPage( dirName, 0, 0, sessionId );
+}
+
+QString DataLoader::getDataPage(const QString& dirName, int offset, int count,
+        const QString& sessionId) {
     QString rootDirName = dirName;
     bool securityRestricted = isSecurityRestricted();
     //Just get the default if the user is trying for a directory elsewhere and
@@ -66,7 +77,7 @@ QString DataLoader::getData(const QString& dirName, const QString& sessionId) {
     QDir rootDir(rootDirName);
     QJsonObject rootObj;
 
-    _processDirectory(rootDir, rootObj);
+    _processDirectory(rootDir, offset, count, rootObj);
 
     if ( securityRestricted ){
         QString baseName = getRootDir( sessionId );
@@ -143,6 +154,27 @@ void DataLoader::_initCallbacks(){
         return xml;
     });
 
+    //Callback for returning part of the list of data files in a large directory.
+    addCommandCallback( "getDataPage", [=] (const QString & /*cmd*/,
+            const QString & params, const QString & sessionId) -> QString {
+        std::set<QString> keys = { "path", OFFSET, COUNT };
+        std::map<QString,QString> dataValues = Carta::State::UtilState::parseParamMap( params, keys );
+        QString dir = dataValues["path"];
+        bool validOffset = false;
+        int offset = dataValues[OFFSET].toInt( &validOffset );
+        bool validCount = false;
+        int count = dataValues[COUNT].toInt( &validCount );
+        QString xml;
+        if ( validOffset && validCount && offset >= 0 && count >= 0 ){
+            xml = getDataPage( dir, offset, count, sessionId );
+        }
+        else {
+            xml = "Invalid page of data files: "+params;
+            Util::commandPostProcess( xml );
+        }
+        return xml;
+    });
+
     addCommandCallback( "isSecurityRestricted", [=] (const QString & /*cmd*/,
                 const QString & /*params*/, const QString & /*sessionId*/) -> QString {
             bool securityRestricted = isSecurityRestricted();
@@ -159,7 +191,7 @@ bool DataLoader::isSecurityRestricted() const {
     return securityRestricted;
 }
 
-void DataLoader::_processDirectory(const QDir& rootDir, QJsonObject& rootObj) const {
+void DataLoader::_processDirectory(const QDir& rootDir, int offset, int count, QJsonObject& rootObj) const {
 
     if (!rootDir.exists()) {
         QString errorMsg = "Please check that "+rootDir.absolutePath()+" is a valid directory.";
@@ -170,32 +202,28 @@ void DataLoader::_processDirectory(const QDir& rootDir, QJsonObject& rootObj) co
     QString lastPart = rootDir.absolutePath();
     rootObj.insert( Util::NAME, lastPart );
 
+    DirectoryIndex::Page page = m_index->list( lastPart, offset, count );
     QJsonArray dirArray;
-    QDirIterator dit(rootDir.absolutePath(), QDir::NoFilter);
-    while (dit.hasNext()) {
-        dit.next();
-        // skip "." and ".." entries
-        if (dit.fileName() == "." || dit.fileName() == "..") {
-            continue;
+    for ( const DirectoryIndex::Entry& entry : page.entries ){
+        if ( entry.isDir && !entry.loadable ){
+            _makeFolderNode( dirArray, entry.name );
         }
-
-        QString fileName = dit.fileInfo().fileName();
-        if (dit.fileInfo().isDir()) {
-            if (fileName.endsWith(".image")) {
-                _makeFileNode(dirArray, fileName);
-            }
-            else {
-                _makeFolderNode( dirArray, fileName );
-            }
+        else if ( entry.hasMetadata ){
+            _makeFileNode( dirArray, entry.name, entry.size, entry.shape, entry.object, entry.unit );
         }
-        else if (dit.fileInfo().isFile()) {
-            if (fileName.endsWith(".fits") || fileName.endsWith( CRTF ) || fileName.endsWith( REG )) {
-                _makeFileNode(dirArray, fileName);
-            }
+        else if ( entry.isDir ){
+            _makeFileNode( dirArray, entry.name );
+        }
+        else {
+            _makeFileNode( dirArray, entry.name, entry.size, "", "", "" );
         }
     }
 
     rootObj.insert( DIR, dirArray);
+    rootObj.insert( COMPLETE, page.complete );
+    rootObj.insert( TOTAL, page.total );
+    rootObj.insert( METADATA_PENDING, page.metadataPending );
+    rootObj.insert( OFFSET, offset );
 }
 
 void DataLoader::_makeFileNode(QJsonArray& parentArray, const QString& fileName) const {
@@ -205,6 +233,23 @@ void DataLoader::_makeFileNode(QJsonArray& parentArray, const QString& fileName)
     parentArray.append(obj);
 }
 
+void DataLoader::_makeFileNode(QJsonArray& parentArray, const QString& fileName, qint64 size,
+        const QString& shape, const QString& object, const QString& unit ) const {
+    QJsonObject obj;
+    obj.insert( Util::NAME, fileName );
+    obj.insert( "size", static_cast<double>( size ) );
+    if ( !shape.isEmpty() ){
+        obj.insert( "shape", shape );
+    }
+    if ( !object.isEmpty() ){
+        obj.insert( "object", object );
+    }
+    if ( !unit.isEmpty() ){
+        obj.insert( "unit", unit );
+    }
+    parentArray.append(obj);
+}
+
 void DataLoader::_makeFolderNode( QJsonArray& parentArray, const QString& fileName ) const {
     QJsonObject obj;
     QJsonValue fileValue(fileName);
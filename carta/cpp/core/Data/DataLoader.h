@@ -1,6 +1,8 @@
 /***
  * Returns Json representing a directory tree of eligible data that can be loaded
- * from a root directory.
+ * from a root directory.  Directories are indexed in the background (see DirectoryIndex),
+ * so a listing may be partial; it then has "complete" set to false and should be
+ * requested again.
  */
 
 #pragma once
@@ -15,6 +17,8 @@ namespace Carta {
 
 namespace Data {
 
+class DirectoryIndex;
+
 class DataLoader : public Carta::State::CartaObject {
 
 public:
@@ -29,6 +33,16 @@ public:
     QString getData(const QString& selectionParams,
                     const QString& sessionId);
 
+    /**
+     * Returns part of the listing of data files that can be loaded.
+     * @param selectionParams a filter for choosing specific types of data files.
+     * @param offset the index of the first entry to return.
+     * @param count the maximum number of entries to return or 0 for all of them.
+     * @param sessionId the user's session identifier.
+     */
+    QString getDataPage( const QString& selectionParams, int offset, int count,
+                    const QString& sessionId );
+
     /**
      * Returns the name of the file corresponding to the doctored path and session identifier.
      * @param fakePath a QString identifying a file.
@@ -88,17 +102,28 @@ private:
     class Factory;
 
     const static QString DIR;
+    const static QString COMPLETE;
+    const static QString COUNT;
+    const static QString METADATA_PENDING;
+    const static QString OFFSET;
+    const static QString TOTAL;
 
     void _initCallbacks();
 
-    //Look for eligible data files in a specific directory (recursive).
-    void _processDirectory(const QDir& rootDir, QJsonObject& rootArray) const;
+    //Look for eligible data files in a specific directory.
+    void _processDirectory(const QDir& rootDir, int offset, int count, QJsonObject& rootArray) const;
 
     //Add a file to the list of those available in a given directory.
     void _makeFileNode(QJsonArray& parentArray, const QString& fileName) const;
+    void _makeFileNode(QJsonArray& parentArray, const QString& fileName, qint64 size,
+            const QString& shape, const QString& object, const QString& unit ) const;
     //Add a subdirectory to the list of available files.
     void _makeFolderNode( QJsonArray& parentArray, const QString& fileName ) const;
     DataLoader( const QString& path, const QString& id);
+
+    //Cached directory listings.
+    std::unique_ptr<DirectoryIndex> m_index;
+
     DataLoader( const DataLoader& other);
     DataLoader& operator=( const DataLoader& other );
 };
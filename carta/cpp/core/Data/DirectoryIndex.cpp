@@ -0,0 +1,353 @@
+#include "DirectoryIndex.h"
+#include "DataLoader.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QStringList>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <atomic>
+
+namespace Carta {
+
+namespace Data {
+
+namespace {
+
+//Entries are published to readers in batches of this size.
+const int BATCH_SIZE = 256;
+
+//Upper limit on the number of remembered FITS summaries.
+const int METADATA_LIMIT = 100000;
+
+//Progress of reading the header of an entry.
+const char METADATA_NONE = 0;
+const char METADATA_QUEUED = 1;
+const char METADATA_READ = 2;
+
+const QString FITS = ".fits";
+const QString CASA_IMAGE = ".image";
+
+//The value of a FITS string keyword, without the quotes.
+QString fitsString( const QByteArray& value ){
+    QByteArray trimmed = value.trimmed();
+    if ( !trimmed.startsWith( '\'' ) ){
+        return QString();
+    }
+    QByteArray result;
+    for ( int i = 1; i < trimmed.size(); i++ ){
+        if ( trimmed[i] == '\'' ){
+            //Two quotes are an escaped quote.
+            if ( i + 1 < trimmed.size() && trimmed[i+1] == '\'' ){
+                result.append( '\'' );
+                i++;
+            }
+            else {
+                break;
+            }
+        }
+        else {
+            result.append( trimmed[i] );
+        }
+    }
+    return QString::fromLatin1( result ).trimmed();
+}
+
+//The value of a FITS integer keyword.
+qint64 fitsInt( const QByteArray& value ){
+    int commentIndex = value.indexOf( '/' );
+    QByteArray number = commentIndex >= 0 ? value.left( commentIndex ) : value;
+    return number.trimmed().toLongLong();
+}
+}
+
+struct DirectoryIndex::Listing {
+    QString path;
+    std::vector<Entry> entries;
+    //Whether the header of an entry is waiting to be read (METADATA_QUEUED) or
+    //has been read, successfully or not (METADATA_READ).
+    std::vector<char> metadataState;
+    bool complete = false;
+    std::atomic<bool> cancelled { false };
+};
+
+const int DirectoryIndex::CACHE_SIZE = 32;
+
+DirectoryIndex::DirectoryIndex( QObject* parent ) :
+    QObject( parent ),
+    m_watcher( nullptr ){
+    //Reading directories over network storage is IO bound, a couple of threads
+    //are enough and leave the rest of the machine alone.
+    m_pool.setMaxThreadCount( 2 );
+}
+
+DirectoryIndex::Page DirectoryIndex::list( const QString& path, int offset, int count ){
+    Page page;
+    QDir dir( path );
+    if ( !dir.exists() ){
+        return page;
+    }
+    page.exists = true;
+    QString absPath = dir.absolutePath();
+    _watch( absPath );
+    std::shared_ptr<Listing> listing = _getListing( absPath );
+
+    std::vector<int> toRead;
+    {
+        QMutexLocker locker( &m_mutex );
+        page.complete = listing->complete;
+        page.total = listing->entries.size();
+        int first = qBound( 0, offset, page.total );
+        int last = page.total;
+        if ( count > 0 ){
+            last = qMin( page.total, first + count );
+        }
+        page.entries.reserve( last - first );
+        for ( int i = first; i < last; i++ ){
+            Entry& entry = listing->entries[i];
+            if ( listing->metadataState[i] == METADATA_QUEUED ){
+                page.metadataPending++;
+            }
+            else if ( !entry.isDir && !entry.hasMetadata && listing->metadataState[i] == METADATA_NONE &&
+                    entry.name.endsWith( FITS ) ){
+                QHash<QString,Entry>::const_iterator cached =
+                        m_metadata.constFind( absPath + QDir::separator() + entry.name );
+                if ( cached != m_metadata.constEnd() && cached->size == entry.size &&
+                        cached->modified == entry.modified ){
+                    entry.hasMetadata = true;
+                    entry.shape = cached->shape;
+                    entry.object = cached->object;
+                    entry.unit = cached->unit;
+                }
+                else {
+                    listing->metadataState[i] = METADATA_QUEUED;
+                    page.metadataPending++;
+                    toRead.push_back( i );
+                }
+            }
+            page.entries.push_back( entry );
+        }
+    }
+    if ( !toRead.empty() ){
+        QtConcurrent::run( &m_pool, this, &DirectoryIndex::_readMetadata, listing, toRead );
+    }
+    return page;
+}
+
+void DirectoryIndex::invalidate( const QString& path ){
+    QString absPath = QDir( path ).absolutePath();
+    {
+        QMutexLocker locker( &m_mutex );
+        for ( auto iter = m_listings.begin(); iter != m_listings.end(); iter++ ){
+            if ( (*iter)->path == absPath ){
+                (*iter)->cancelled = true;
+                m_listings.erase( iter );
+                break;
+            }
+        }
+    }
+    if ( m_watcher ){
+        m_watcher->removePath( absPath );
+    }
+}
+
+void DirectoryIndex::waitForDone(){
+    m_pool.waitForDone();
+}
+
+bool DirectoryIndex::readFitsSummary( const QString& fileName, Entry& entry ){
+    const int CARD_SIZE = 80;
+    const int BLOCK_SIZE = 2880;
+    //Give up on headers that are longer than this.
+    const int MAX_BLOCKS = 64;
+
+    QFile file( fileName );
+    if ( !file.open( QIODevice::ReadOnly ) ){
+        return false;
+    }
+    std::vector<qint64> axes;
+    QString object;
+    QString unit;
+    for ( int block = 0; block < MAX_BLOCKS; block++ ){
+        QByteArray data = file.read( BLOCK_SIZE );
+        if ( data.size() < BLOCK_SIZE ){
+            return false;
+        }
+        for ( int pos = 0; pos < BLOCK_SIZE; pos += CARD_SIZE ){
+            QByteArray card = data.mid( pos, CARD_SIZE );
+            QByteArray key = card.left( 8 ).trimmed();
+            if ( block == 0 && pos == 0 ){
+                if ( key != "SIMPLE" ){
+                    return false;
+                }
+                continue;
+            }
+            if ( key == "END" ){
+                QStringList dims;
+                for ( qint64 axis : axes ){
+                    dims.append( QString::number( axis ) );
+                }
+                entry.shape = dims.join( "x" );
+                entry.object = object;
+                entry.unit = unit;
+                entry.hasMetadata = true;
+                return true;
+            }
+            if ( card.mid( 8, 2 ) != "= " ){
+                continue;
+            }
+            QByteArray value = card.mid( 10 );
+            if ( key == "NAXIS" ){
+                axes.assign( qBound( 0LL, fitsInt( value ), 999LL ), 0 );
+            }
+            else if ( key.startsWith( "NAXIS" ) ){
+                int axis = key.mid( 5 ).toInt();
+                if ( axis >= 1 && axis <= static_cast<int>( axes.size() ) ){
+                    axes[axis - 1] = fitsInt( value );
+                }
+            }
+            else if ( key == "OBJECT" ){
+                object = fitsString( value );
+            }
+            else if ( key == "BUNIT" ){
+                unit = fitsString( value );
+            }
+        }
+    }
+    return false;
+}
+
+void DirectoryIndex::_directoryChanged( const QString& path ){
+    invalidate( path );
+}
+
+std::shared_ptr<DirectoryIndex::Listing> DirectoryIndex::_getListing( const QString& path ){
+    std::shared_ptr<Listing> listing;
+    QStringList evicted;
+    {
+        QMutexLocker locker( &m_mutex );
+        for ( auto iter = m_listings.begin(); iter != m_listings.end(); iter++ ){
+            if ( (*iter)->path == path ){
+                m_listings.splice( m_listings.begin(), m_listings, iter );
+                return m_listings.front();
+            }
+        }
+        listing = std::make_shared<Listing>();
+        listing->path = path;
+        m_listings.push_front( listing );
+        while ( static_cast<int>( m_listings.size() ) > CACHE_SIZE ){
+            m_listings.back()->cancelled = true;
+            evicted.append( m_listings.back()->path );
+            m_listings.pop_back();
+        }
+    }
+    if ( m_watcher && !evicted.isEmpty() ){
+        m_watcher->removePaths( evicted );
+    }
+    QtConcurrent::run( &m_pool, this, &DirectoryIndex::_index, listing );
+    return listing;
+}
+
+void DirectoryIndex::_index( std::shared_ptr<Listing> listing ){
+    std::vector<Entry> batch;
+    auto publish = [this, &listing, &batch] (){
+        QMutexLocker locker( &m_mutex );
+        listing->entries.insert( listing->entries.end(), batch.begin(), batch.end() );
+        listing->metadataState.resize( listing->entries.size(), METADATA_NONE );
+        batch.clear();
+    };
+
+    QDirIterator dit( listing->path, QDir::NoFilter );
+    while ( dit.hasNext() && !listing->cancelled ){
+        dit.next();
+        QString fileName = dit.fileName();
+        // skip "." and ".." entries
+        if ( fileName == "." || fileName == ".." ){
+            continue;
+        }
+        QFileInfo info = dit.fileInfo();
+        Entry entry;
+        entry.name = fileName;
+        if ( info.isDir() ){
+            entry.isDir = true;
+            entry.loadable = fileName.endsWith( CASA_IMAGE );
+        }
+        else if ( info.isFile() ){
+            if ( !fileName.endsWith( FITS ) && !fileName.endsWith( DataLoader::CRTF ) &&
+                    !fileName.endsWith( DataLoader::REG ) ){
+                continue;
+            }
+            entry.loadable = true;
+            entry.size = info.size();
+            entry.modified = info.lastModified().toMSecsSinceEpoch();
+        }
+        else {
+            continue;
+        }
+        batch.push_back( entry );
+        if ( static_cast<int>( batch.size() ) >= BATCH_SIZE ){
+            publish();
+        }
+    }
+    publish();
+    QMutexLocker locker( &m_mutex );
+    listing->complete = !listing->cancelled;
+}
+
+void DirectoryIndex::_readMetadata( std::shared_ptr<Listing> listing, std::vector<int> indices ){
+    for ( int index : indices ){
+        if ( listing->cancelled ){
+            break;
+        }
+        Entry entry;
+        {
+            QMutexLocker locker( &m_mutex );
+            entry = listing->entries[index];
+        }
+        QString fileName = listing->path + QDir::separator() + entry.name;
+        bool read = readFitsSummary( fileName, entry );
+        QMutexLocker locker( &m_mutex );
+        listing->metadataState[index] = METADATA_READ;
+        if ( !read ){
+            continue;
+        }
+        listing->entries[index] = entry;
+        if ( m_metadata.size() >= METADATA_LIMIT ){
+            m_metadata.clear();
+        }
+        m_metadata.insert( fileName, entry );
+    }
+}
+
+void DirectoryIndex::_watch( const QString& path ){
+    //The watcher needs an event loop.
+    if ( !QCoreApplication::instance() ){
+        return;
+    }
+    if ( !m_watcher ){
+        m_watcher = new QFileSystemWatcher( this );
+        connect( m_watcher, SIGNAL(directoryChanged(const QString&)),
+                 this, SLOT(_directoryChanged(const QString&)) );
+    }
+    if ( !m_watcher->directories().contains( path ) ){
+        m_watcher->addPath( path );
+    }
+}
+
+DirectoryIndex::~DirectoryIndex(){
+    {
+        QMutexLocker locker( &m_mutex );
+        for ( auto& listing : m_listings ){
+            listing->cancelled = true;
+        }
+    }
+    m_pool.clear();
+    m_pool.waitForDone();
+}
+}
+}
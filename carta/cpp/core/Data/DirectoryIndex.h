@@ -0,0 +1,137 @@
+/***
+ * Cached, asynchronous listings of the directories shown in the file browser.
+ *
+ * Directories are read on a background thread, so asking for one never waits on the
+ * file system: the caller gets the entries found so far, together with a flag saying
+ * whether the listing is complete, and asks again later. Listings stay cached until
+ * the directory changes (the cached directories are watched, which uses inotify on
+ * Linux) or until they are pushed out by more recently used ones.
+ *
+ * For FITS files the header is summarized (dimensions, object, units). This is also
+ * done in the background, and only for entries that have been handed out.
+ */
+
+#pragma once
+
+#include <QMutex>
+#include <QObject>
+#include <QHash>
+#include <QString>
+#include <QThreadPool>
+
+#include <list>
+#include <memory>
+#include <vector>
+
+class QFileSystemWatcher;
+
+namespace Carta {
+
+namespace Data {
+
+class DirectoryIndex : public QObject {
+
+    Q_OBJECT
+
+public:
+
+    //A file or subdirectory.
+    struct Entry {
+        QString name;
+        bool isDir = false;
+        //Whether this is something that can be loaded (an image or region file),
+        //rather than a folder to browse.
+        bool loadable = false;
+        qint64 size = 0;
+        qint64 modified = 0;
+        //Header summary, only for FITS files and only once it has been read.
+        bool hasMetadata = false;
+        QString shape;
+        QString object;
+        QString unit;
+    };
+
+    //Part of a directory listing.
+    struct Page {
+        bool exists = false;
+        bool complete = false;
+        //Number of entries found so far.
+        int total = 0;
+        //Number of returned entries whose FITS header is still being read; the
+        //page should be asked for again until this drops to zero.
+        int metadataPending = 0;
+        std::vector<Entry> entries;
+    };
+
+    DirectoryIndex( QObject* parent = nullptr );
+
+    /**
+     * Returns entries of a directory, starting to index it if it isn't cached.
+     * @param path the directory.
+     * @param offset index of the first entry to return.
+     * @param count the maximum number of entries to return, or 0 for all of them.
+     * @return the entries found so far.
+     */
+    Page list( const QString& path, int offset = 0, int count = 0 );
+
+    /**
+     * Forget the cached listing of a directory.
+     * @param path the directory.
+     */
+    void invalidate( const QString& path );
+
+    /**
+     * Wait for all background work to finish.
+     */
+    void waitForDone();
+
+    /**
+     * Summarize a FITS header.
+     * @param fileName the FITS file.
+     * @param entry the shape, object and unit are filled in.
+     * @return false if the file could not be read or is not a FITS file.
+     */
+    static bool readFitsSummary( const QString& fileName, Entry& entry );
+
+    //Number of directory listings kept.
+    static const int CACHE_SIZE;
+
+    virtual ~DirectoryIndex();
+
+private slots:
+
+    void _directoryChanged( const QString& path );
+
+private:
+
+    struct Listing;
+
+    //Return the listing for a directory, starting a new one if needed.
+    std::shared_ptr<Listing> _getListing( const QString& path );
+
+    //Read a directory (background thread).
+    void _index( std::shared_ptr<Listing> listing );
+
+    //Read the FITS headers of some entries (background thread).
+    void _readMetadata( std::shared_ptr<Listing> listing, std::vector<int> indices );
+
+    //Watch a directory for changes.
+    void _watch( const QString& path );
+
+    QMutex m_mutex;
+
+    //Most recently used first.
+    std::list< std::shared_ptr<Listing> > m_listings;
+
+    //FITS summaries by file name, they are reused as long as the size and
+    //modification time of the file stay the same.
+    QHash<QString,Entry> m_metadata;
+
+    QThreadPool m_pool;
+    QFileSystemWatcher* m_watcher;
+
+    DirectoryIndex( const DirectoryIndex& other);
+    DirectoryIndex& operator=( const DirectoryIndex& other );
+};
+}
+}
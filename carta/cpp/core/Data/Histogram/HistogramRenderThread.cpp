@@ -1,6 +1,7 @@
 #include "HistogramRenderThread.h"
 #include "Data/Util.h"
 #include "CartaLib/Hooks/HistogramResult.h"
+#include "CartaLib/Trace.h"
 #include <QFile>
 #include <QDataStream>
 #include <QDebug>
@@ -21,6 +22,8 @@ Carta::Lib::Hooks::HistogramResult HistogramRenderThread::getResult() const {
 
 
 void HistogramRenderThread::run(){
+   // waits for the forked worker and reads its result
+   CARTA_TRACE_SCOPE( "histogram", "HistogramRenderThread::run" );
    QFile file;
    if ( !file.open( m_fileDescriptor, QIODevice::ReadOnly, QFileDevice::AutoCloseHandle ) ){
        QString errorStr(Util::ERROR + ": Could not read histogram results");
@@ -29,6 +32,7 @@ void HistogramRenderThread::run(){
    }
    else {
        QDataStream dataStream( & file );
+       Carta::Lib::setNativeByteOrder( dataStream );
        dataStream >> m_result;
        file.close();
    }
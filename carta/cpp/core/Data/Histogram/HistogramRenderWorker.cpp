@@ -2,6 +2,7 @@
 #include "Data/Util.h"
 #include "Globals.h"
 #include "PluginManager.h"
+#include "CartaLib/Trace.h"
 #include "CartaLib/Hooks/Histogram.h"
 #include "CartaLib/Hooks/HistogramResult.h"
 #include <QFile>
@@ -75,7 +76,12 @@ int HistogramRenderWorker::computeHist(){
         return -1;
     }
 
-    int pid = fork ();
+    // forking copies the page tables of the whole process
+    int pid = -1;
+    {
+        CARTA_TRACE_SCOPE( "histogram", "fork" );
+        pid = fork ();
+    }
     if (pid == -1){
         // Failure
         qDebug() << "*** HistogramRenderWorker::run: fork failed: " << strerror (errno);
@@ -110,6 +116,7 @@ int HistogramRenderWorker::computeHist(){
         return 0;
     }
     QDataStream dataStream( &file );
+    Carta::Lib::setNativeByteOrder( dataStream );
     dataStream << m_result;
     file.close();
     exit(0);
@@ -24,6 +24,7 @@
 #include <QtCore/QDebug>
 #include <QtCore/QList>
 #include <QtCore/QDir>
+#include <QtConcurrent/QtConcurrentRun>
 #include <memory>
 #include <set>
 
@@ -52,6 +53,13 @@ const QString Controller::DATA_PATH = "dataPath";
 const QString Controller::CURSOR = "formattedCursorCoordinates";
 const QString Controller::CENTER = "center";
 const QString Controller::IMAGE = "image";
+const QString Controller::LOAD = "load";
+const QString Controller::LOAD_DONE = "done";
+const QString Controller::LOAD_FAILED = "failed";
+const QString Controller::LOAD_FILE = "file";
+const QString Controller::LOAD_OPENING = "opening";
+const QString Controller::LOAD_PREVIEW = "preview";
+const QString Controller::LOAD_STAGE = "stage";
 const QString Controller::PAN_ZOOM_ALL = "panZoomAll";
 const QString Controller::ZOOM = "zoom";
 
@@ -70,7 +78,8 @@ using Carta::Lib::AxisInfo;
 
 Controller::Controller( const QString& path, const QString& id ) :
         CartaObject( CLASS_NAME, path, id),
-        m_stateMouse(UtilState::getLookup(path, Util::VIEW)){
+        m_stateMouse(UtilState::getLookup(path, Util::VIEW)),
+        m_stateLoad(UtilState::getLookup(path, LOAD)){
 
      _initializeState();
 
@@ -89,6 +98,8 @@ Controller::Controller( const QString& path, const QString& id ) :
      connect( m_stack.get(), SIGNAL(contourSetRemoved(const QString&)),
                              this, SLOT(_contourSetRemoved(const QString&)));
      connect( m_stack.get(), SIGNAL(colorStateChanged()), this, SLOT( _loadViewQueued() ));
+     connect( m_stack.get(), SIGNAL(clipsChanged()), this, SLOT( _clipsChanged() ));
+     connect( &m_openWatcher, SIGNAL(finished()), this, SLOT(_imageOpened()));
      connect( m_stack.get(), SIGNAL(saveImageResult( bool)), this, SIGNAL(saveImageResult(bool)));
 
      GridControls* gridObj = objMan->createObject<GridControls>();
@@ -121,8 +132,31 @@ QString Controller::addData(const QString& fileName, bool* success) {
 }
 
 
-QString Controller::_addDataImage(const QString& fileName, bool* success ) {
-    QString result = m_stack->_addDataImage( fileName, success );
+void Controller::addDataAsync( const QString& fileName ){
+    //Region files are read right away; only images are opened in the background.
+    if ( DataFactory::isRegionFile( fileName ) ){
+        bool success = false;
+        QString result = addData( fileName, &success );
+        if ( !success ){
+            Util::commandPostProcess( result );
+        }
+        return;
+    }
+    //The watcher only reports the latest file, so an earlier one that is still
+    //being opened is dropped when it finishes.
+    m_openFile = fileName;
+    _setLoadStage( fileName, LOAD_OPENING );
+    m_openWatcher.setFuture( QtConcurrent::run( Globals::instance()->renderPool(), [fileName] () {
+        QString errorMsg;
+        std::shared_ptr<Carta::Lib::Image::ImageInterface> image = DataSource::openImage( fileName, &errorMsg );
+        return std::make_pair( image, errorMsg );
+    }));
+}
+
+
+QString Controller::_addDataImage(const QString& fileName, bool* success,
+        std::shared_ptr<Carta::Lib::Image::ImageInterface> image ) {
+    QString result = m_stack->_addDataImage( fileName, success, image );
     if ( *success ){
         if ( isStackSelectAuto() ){
             QStringList selectedLayers;
@@ -388,6 +422,11 @@ QString Controller::_getPreferencesId() const {
     return id;
 }
 
+std::vector<std::shared_ptr<const Carta::Lib::RegionMask> > Controller::getRegionMasks() const {
+    return m_stack->_getRegionMasks();
+}
+
+
 std::vector<Carta::Lib::RegionInfo> Controller::getRegions() const {
     std::vector<Carta::Lib::RegionInfo> regionInfos = m_stack->_getRegions();
     return regionInfos;
@@ -852,8 +891,42 @@ void Controller::_initializeState(){
     m_stateMouse.insertValue<int>(ImageView::MOUSE_X, 0 );
     m_stateMouse.insertValue<int>(ImageView::MOUSE_Y, 0 );
     m_stateMouse.flushState();
+
+    m_stateLoad.insertValue<QString>( LOAD_FILE, "" );
+    m_stateLoad.insertValue<QString>( LOAD_STAGE, "" );
+    m_stateLoad.flushState();
+}
+
+
+void Controller::_clipsChanged(){
+    _loadViewQueued();
+}
+
+
+void Controller::_imageOpened(){
+    std::pair< std::shared_ptr<Carta::Lib::Image::ImageInterface>, QString > opened = m_openWatcher.result();
+    QString fileName = m_openFile;
+    m_openFile = "";
+    bool success = false;
+    QString result = opened.second;
+    if ( opened.first ){
+        result = _addDataImage( fileName, &success, opened.first );
+    }
+    if ( success ){
+        //The first view is drawn with estimated clips.
+        _setLoadStage( fileName, LOAD_PREVIEW );
+        _loadViewQueued();
+    }
+    else {
+        _setLoadStage( fileName, LOAD_FAILED );
+        if ( result.isEmpty() ){
+            result = "Could not load "+fileName;
+        }
+        Util::commandPostProcess( result );
+    }
 }
 
+
 bool Controller::isStackSelectAuto() const {
     return m_state.getValue<bool>( STACK_SELECT_AUTO );
 }
@@ -869,6 +942,11 @@ void Controller::_loadView(){
     double clipValueMin = m_state.getValue<double>(CLIP_VALUE_MIN);
     double clipValueMax = m_state.getValue<double>(CLIP_VALUE_MAX);
     m_stack->_load( autoClip, clipValueMin, clipValueMax );
+
+    //A new image is done loading once it is shown with exact clips.
+    if ( m_stateLoad.getValue<QString>( LOAD_STAGE ) == LOAD_PREVIEW && !m_stack->_isClipPending() ){
+        _setLoadStage( m_stateLoad.getValue<QString>( LOAD_FILE ), LOAD_DONE );
+    }
 }
 
 QString Controller::moveSelectedLayers( bool moveDown ){
@@ -1006,6 +1084,22 @@ QString Controller::setClipValue( double clipVal  ) {
 }
 
 
+void Controller::_prefetchFrames( AxisInfo::KnownType axisType, const QList<int>& upcoming ){
+    //Clips recomputed on every frame change a pixel pipeline the prefetched frames
+    //would not match, so there is nothing to gain from reading ahead.
+    bool autoClip = m_state.getValue<bool>(AUTO_CLIP);
+    if ( !autoClip && !upcoming.isEmpty() ){
+        m_stack->_prefetchFrames( axisType, upcoming );
+    }
+}
+
+void Controller::_setLoadStage( const QString& fileName, const QString& stage ){
+    m_stateLoad.setValue<QString>( LOAD_FILE, fileName );
+    m_stateLoad.setValue<QString>( LOAD_STAGE, stage );
+    m_stateLoad.flushState();
+}
+
+
 void Controller::_setFrameAxis(int value, AxisInfo::KnownType axisType ) {
     m_stack->_setFrameAxis( value, axisType );
     _updateCursorText( true );
@@ -10,10 +10,12 @@
 #include "CartaLib/CartaLib.h"
 #include "CartaLib/AxisInfo.h"
 #include "CartaLib/RegionInfo.h"
+#include "CartaLib/RegionMask.h"
 
 #include <QString>
 #include <QList>
 #include <QObject>
+#include <QFutureWatcher>
 
 #include <set>
 
@@ -77,6 +79,15 @@ public:
      */
     QString addData(const QString& fileName, bool* success);
 
+    /**
+     * Add data to this controller without waiting for it to load.  Images are opened
+     * in the background and shown first with estimated clips; the progress is
+     * published in the load state.  Adding another file before an image has been
+     * opened abandons the earlier one.
+     * @param fileName the location of the data.
+     */
+    void addDataAsync( const QString& fileName );
+
     /**
      * Apply the indicated clips to managed images.
      * @param minIntensityPercentile the minimum clip percentile [0,1].
@@ -282,6 +293,12 @@ public:
      */
     std::vector<Carta::Lib::RegionInfo> getRegions() const;
 
+    /**
+     * Return the rasterised pixels of the loaded regions, in the same order as getRegions().
+     * @return - the masks of the loaded regions.
+     */
+    std::vector<std::shared_ptr<const Carta::Lib::RegionMask> > getRegionMasks() const;
+
     /**
      * Return the index of the image that is currently at the top of the stack.
      * @return the index of the current image.
@@ -570,6 +587,12 @@ private slots:
 
     void _gridChanged( const Carta::State::StateInterface& state, bool applyAll );
 
+    //Exact clips are ready for one of the layers.
+    void _clipsChanged();
+
+    //An image being loaded in the background has been opened.
+    void _imageOpened();
+
     //Refresh the view based on the latest data selection information.
     void _loadView(  );
     void _loadViewQueued( );
@@ -592,7 +615,8 @@ private:
     void _addDataRegions( std::vector<std::shared_ptr<Region> > regions );
 
     /// Add an image to the stack from a file.
-    QString _addDataImage( const QString& fileName, bool* success );
+    QString _addDataImage( const QString& fileName, bool* success,
+            std::shared_ptr<Carta::Lib::Image::ImageInterface> image = nullptr );
 
     //Clear the color map.
     void _clearColorMap();
@@ -611,6 +635,12 @@ private:
     void _initializeState();
     void _initializeCallbacks();
 
+    /**
+     * Start reading frames that an animation is expected to show next.
+     * @param axisType - the axis that is being animated.
+     * @param upcoming - frame indices along the animated axis, most urgent first.
+     */
+    void _prefetchFrames( Carta::Lib::AxisInfo::KnownType axisType, const QList<int>& upcoming );
 
     /**
      * Make a frame selection.
@@ -618,6 +648,9 @@ private:
      * @param frameIndex  a frame index for the axis.
      */
     void _setFrameAxis(int frameIndex, Carta::Lib::AxisInfo::KnownType axisType );
+
+    //Publish how far the loading of a file has progressed.
+    void _setLoadStage( const QString& fileName, const QString& stage );
     QString _setLayersSelected( const QStringList indices);
 
 
@@ -634,6 +667,13 @@ private:
     static const QString DATA;
     static const QString DATA_PATH;
     static const QString IMAGE;
+    static const QString LOAD;
+    static const QString LOAD_DONE;
+    static const QString LOAD_FAILED;
+    static const QString LOAD_FILE;
+    static const QString LOAD_OPENING;
+    static const QString LOAD_PREVIEW;
+    static const QString LOAD_STAGE;
     static const QString PAN_ZOOM_ALL;
     static const QString CENTER;
     static const QString STACK_SELECT_AUTO;
@@ -652,6 +692,13 @@ private:
     //everyone wants to listen to them.
     Carta::State::StateInterface m_stateMouse;
 
+    //Progress of the file being loaded.
+    Carta::State::StateInterface m_stateLoad;
+
+    //Image being opened in the background and any error opening it.
+    QFutureWatcher< std::pair< std::shared_ptr<Carta::Lib::Image::ImageInterface>, QString > > m_openWatcher;
+    QString m_openFile;
+
     Controller(const Controller& other);
     Controller& operator=(const Controller& other);
 
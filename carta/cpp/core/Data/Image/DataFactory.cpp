@@ -19,6 +19,12 @@ DataFactory::DataFactory(){
 }
 
 
+bool DataFactory::isRegionFile( const QString& fileName ){
+    QFileInfo fileInfo( fileName );
+    return fileInfo.isFile() && _isRegion( fileName );
+}
+
+
 QString DataFactory::addData( Controller* controller, const QString& fileName, bool* success ){
     QString result;
     *success = false;
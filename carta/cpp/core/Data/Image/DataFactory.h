@@ -31,6 +31,13 @@ public:
     static QString
     addData( Controller* controller, const QString& fileName, bool* success );
 
+    /**
+     * Returns true if the file holds regions rather than an image.
+     * @param fileName - the absolute path to a file or directory containing the data.
+     * @return - true if the file is a recognized region file; false otherwise.
+     */
+    static bool isRegionFile( const QString& fileName );
+
 
     virtual ~DataFactory();
 
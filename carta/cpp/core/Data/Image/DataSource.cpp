@@ -1,17 +1,22 @@
 #include "DataSource.h"
+#include "ImageRegistry.h"
 #include "CoordinateSystems.h"
 #include "Data/Colormap/Colormaps.h"
 #include "Globals.h"
+#include "MemoryGovernor.h"
 #include "PluginManager.h"
 #include "GrayColormap.h"
 #include "CartaLib/IImage.h"
 #include "Data/Util.h"
 #include "Data/Colormap/TransformsData.h"
-#include "CartaLib/Hooks/LoadAstroImage.h"
 #include "CartaLib/PixelPipeline/CustomizablePixelPipeline.h"
 #include "../../ImageRenderService.h"
 #include "../../Algorithms/quantileAlgorithms.h"
 #include <QDebug>
+#include <QSet>
+#include <QtConcurrent/QtConcurrentRun>
+#include <algorithm>
+#include <cmath>
 
 using Carta::Lib::AxisInfo;
 using Carta::Lib::AxisDisplayInfo;
@@ -23,12 +28,21 @@ namespace Data {
 const QString DataSource::DATA_PATH = "file";
 const QString DataSource::CLASS_NAME = "DataSource";
 const double DataSource::ZOOM_DEFAULT = 1.0;
+const qint64 DataSource::CLIP_SAMPLE_SIZE = 512 * 512;
+const qint64 DataSource::CLIP_CHUNK_SIZE = 1024 * 1024;
 
 CoordinateSystems* DataSource::m_coords = nullptr;
 
 DataSource::DataSource() :
     m_image( nullptr ),
     m_permuteImage( nullptr),
+    m_clipPending( false ),
+    m_clipPendingIndex( -1 ),
+    m_clipCurrentIndex( -1 ),
+    m_clipPendingMin( 0 ),
+    m_clipPendingMax( 1 ),
+    m_clipGeneration( 0 ),
+    m_clipPendingGeneration( 0 ),
     m_axisIndexX( 0 ),
     m_axisIndexY( 1 ){
         m_cmapUseCaching = true;
@@ -39,6 +53,8 @@ DataSource::DataSource() :
 
         //Initialize the rendering service
         m_renderService.reset( new Carta::Core::ImageRenderService::Service() );
+        m_readLock = ImageRegistry::instance()->getReadLock( nullptr );
+        m_renderService->setReadLock( m_readLock );
 
         // assign a default colormap to the view
         auto rawCmap = std::make_shared < Carta::Core::GrayColormap > ();
@@ -50,6 +66,94 @@ DataSource::DataSource() :
         m_pixelPipeline-> setColormap( std::make_shared < Carta::Core::GrayColormap > () );
         m_pixelPipeline-> setMinMax( 0, 1 );
         m_renderService-> setPixelPipeline( m_pixelPipeline, m_pixelPipeline-> cacheId());
+
+        connect( & m_clipWatcher, & QFutureWatcher < std::vector<double> >::finished,
+                this, & DataSource::_clipsComputed );
+        connect( m_renderService.get(), & Carta::Core::ImageRenderService::Service::done,
+                this, & DataSource::_previewRendered );
+}
+
+
+void DataSource::_clipsComputed(){
+    if ( !m_clipPending ){
+        return;
+    }
+    m_clipPending = false;
+    if ( m_clipPendingGeneration != m_clipGeneration ){
+        return;
+    }
+    std::vector<double> clips = m_clipWatcher.result();
+    if ( clips.size() < 2 ){
+        return;
+    }
+    ImageRegistry::instance()->setClips( m_image.get(), _getClipKey( m_clipPendingIndex ),
+            m_clipPendingMin, m_clipPendingMax, clips );
+    //Only redraw if the frame is still on display; otherwise the clips are
+    //ready for when it is shown again.
+    if ( m_clipPendingIndex == m_clipCurrentIndex ){
+        emit clipsChanged();
+    }
+}
+
+
+std::vector<double> DataSource::_computeClipsChunked(
+        std::shared_ptr<Carta::Lib::NdArray::RawViewInterface> view, std::shared_ptr<QMutex> readLock,
+        double minClipPercentile, double maxClipPercentile ){
+    std::vector<int> dims = view->dims();
+    qint64 pixelCount = 1;
+    for ( int dim : dims ){
+        pixelCount = pixelCount * dim;
+    }
+    Carta::Core::MemoryGovernor::Reservation reservation( Globals::instance()->memoryGovernor(),
+            "clip quantiles", pixelCount * static_cast<qint64>( sizeof( double ) ) );
+    if ( !reservation.fits() ){
+        qWarning() << "Computing clips exceeds the memory budget";
+    }
+
+    //Copy the values a band of rows at a time, releasing the read lock in between
+    //so renders and cursor readouts of the same image are not held up.
+    std::vector<double> values;
+    values.reserve( pixelCount );
+    int width = dims.size() > 0 ? std::max( dims[0], 1 ) : 1;
+    int rows = dims.size() > 1 ? dims[1] : 1;
+    int bandRows = static_cast<int>( std::max<qint64>( 1, CLIP_CHUNK_SIZE / width ) );
+    for ( int row = 0; row < rows; row = row + bandRows ){
+        SliceND band;
+        band.next().start( row ).end( std::min( row + bandRows, rows ) );
+        QMutexLocker locker( readLock.get() );
+        std::unique_ptr<Carta::Lib::NdArray::RawViewInterface> bandView( view->getView( band ) );
+        if ( !bandView ){
+            continue;
+        }
+        Carta::Lib::NdArray::Double doubleView( bandView.get(), false );
+        doubleView.forEach( [&values] ( const double& val ) {
+            if ( !std::isnan( val ) ){
+                values.push_back( val );
+            }
+        });
+    }
+
+    //The selection itself does not need the image.
+    return Carta::Core::Algorithms::quantilesInPlace( values, {minClipPercentile, maxClipPercentile} );
+}
+
+
+std::vector<double> DataSource::_computeClips( Carta::Lib::NdArray::RawViewInterface* view,
+        double minClipPercentile, double maxClipPercentile ){
+    //The quantile computation keeps a copy of every pixel value.
+    qint64 pixelCount = 1;
+    for ( int dim : view->dims() ){
+        pixelCount = pixelCount * dim;
+    }
+    Carta::Core::MemoryGovernor::Reservation reservation( Globals::instance()->memoryGovernor(),
+            "clip quantiles", pixelCount * static_cast<qint64>( sizeof( double ) ) );
+    if ( !reservation.fits() ){
+        qWarning() << "Computing clips exceeds the memory budget";
+    }
+    Carta::Lib::NdArray::Double doubleView( view, false );
+    std::vector<double> clips = Carta::Core::Algorithms::quantiles2pixels(
+            doubleView, {minClipPercentile, maxClipPercentile });
+    return clips;
 }
 
 
@@ -249,6 +353,7 @@ QString DataSource::_getPixelValue( double x, double y, const std::vector<int>&
     if ( valX >= 0 && valX < m_image->dims()[m_axisIndexX] && valY >= 0 && valY < m_image->dims()[m_axisIndexY] ) {
         Carta::Lib::NdArray::RawViewInterface* rawData = _getRawData( frames );
         if ( rawData != nullptr ){
+            QMutexLocker locker( m_readLock.get() );
             Carta::Lib::NdArray::TypedView<double> view( rawData, true );
             double val =  view.get( { valX, valY } );
             pixelValue = QString::number( val );
@@ -320,6 +425,10 @@ std::shared_ptr<Carta::Lib::Image::ImageInterface> DataSource::_getImage(){
     return m_image;
 }
 
+std::shared_ptr<QMutex> DataSource::_getReadLock() const {
+    return m_readLock;
+}
+
 
 
 std::shared_ptr<Carta::Lib::PixelPipeline::CustomizablePixelPipeline> DataSource::_getPipeline() const {
@@ -336,6 +445,7 @@ bool DataSource::_getIntensity( int frameLow, int frameHigh, double percentile,
     int spectralIndex = Util::getAxisIndex( m_image, AxisInfo::KnownType::SPECTRAL );
     Carta::Lib::NdArray::RawViewInterface* rawData = _getRawData( frameLow, frameHigh, spectralIndex );
     if ( rawData != nullptr ){
+        QMutexLocker locker( m_readLock.get() );
         Carta::Lib::NdArray::TypedView<double> view( rawData, false );
         // read in all values from the view into an array
         // we need our own copy because we'll do quickselect on it...
@@ -384,6 +494,7 @@ double DataSource::_getPercentile( int frameLow, int frameHigh, double intensity
     if ( rawData != nullptr ){
         u_int64_t totalCount = 0;
         u_int64_t countBelow = 0;
+        QMutexLocker locker( m_readLock.get() );
         Carta::Lib::NdArray::TypedView<double> view( rawData, false );
         view.forEach([&](const double& val) {
             if( Q_UNLIKELY( std::isnan(val))){
@@ -451,6 +562,7 @@ Carta::Lib::NdArray::RawViewInterface* DataSource::_getRawData( int frameStart,
                 slice.step( 1 );
             }
         }
+        QMutexLocker locker( m_readLock.get() );
         rawData = m_image->getDataSlice( frameSlice );
     }
     return rawData;
@@ -479,6 +591,12 @@ int DataSource::_getQuantileCacheIndex( const std::vector<int>& frames) const {
     return cacheIndex;
 }
 
+QString DataSource::_getClipKey( int quantileIndex ) const {
+    //The frame index depends on which axes are displayed.
+    return QString::number( m_axisIndexX ) + "," + QString::number( m_axisIndexY ) +
+            ":" + QString::number( quantileIndex );
+}
+
 std::shared_ptr<Carta::Lib::Image::ImageInterface> DataSource::_getPermutedImage() const {
     std::shared_ptr<Carta::Lib::Image::ImageInterface> permuteImage(nullptr);
     if ( m_image ){
@@ -494,7 +612,7 @@ std::shared_ptr<Carta::Lib::Image::ImageInterface> DataSource::_getPermutedImage
                 vectorIndex++;
             }
         }
-        permuteImage = m_image->getPermuted( indices );
+        permuteImage = ImageRegistry::instance()->getPermuted( m_image, indices );
     }
     return permuteImage;
 }
@@ -524,6 +642,7 @@ Carta::Lib::NdArray::RawViewInterface* DataSource::_getRawData( const std::vecto
                 slice.next();
             }
         }
+        QMutexLocker locker( m_readLock.get() );
         rawData = m_permuteImage->getDataSlice( nextSlice );
     }
     return rawData;
@@ -604,6 +723,31 @@ void DataSource::_load(std::vector<int> frames, bool recomputeClipsOnNewFrame,
 }
 
 
+void DataSource::_prefetchFrames( const std::vector<int>& frames, AxisInfo::KnownType axisType,
+        const QList<int>& upcoming ){
+    //Nothing to do if the image does not have the animated axis.
+    if ( !m_permuteImage || Util::getAxisIndex( m_image, axisType ) < 0 ){
+        return;
+    }
+    int axisIndex = static_cast<int>( axisType );
+    std::vector<int> upcomingFrames = frames;
+    std::vector< std::pair< QString, Carta::Lib::NdArray::RawViewInterface::SharedPtr > > views;
+    QSet<QString> viewIds;
+    for ( int frame : upcoming ){
+        upcomingFrames[axisIndex] = frame;
+        std::vector<int> mFrames = _fitFramesToImage( upcomingFrames );
+        QString viewId = _getViewIdCurrent( mFrames );
+        if ( !viewIds.contains( viewId ) ){
+            viewIds.insert( viewId );
+            Carta::Lib::NdArray::RawViewInterface::SharedPtr view( _getRawData( mFrames ) );
+            if ( view ){
+                views.push_back( std::make_pair( viewId, view ) );
+            }
+        }
+    }
+    m_renderService->prefetch( views );
+}
+
 void DataSource::_resetZoom(){
     m_renderService-> setZoom( ZOOM_DEFAULT );
 }
@@ -616,16 +760,19 @@ void DataSource::_resetPan(){
     }
 }
 
-void DataSource::_resizeQuantileCache(){
-    m_quantileCache.resize(0);
-    int nf = 1;
-    int imageSize = m_image->dims().size();
-    for ( int i = 0; i < imageSize; i++ ){
-        if ( i != m_axisIndexX && i != m_axisIndexY ){
-            nf = nf * m_image->dims()[i];
-        }
-    }
-    m_quantileCache.resize( nf);
+std::shared_ptr<Carta::Lib::Image::ImageInterface> DataSource::openImage( const QString& fileName,
+        QString* errorMsg ){
+    //Images already open elsewhere are shared rather than loaded again.
+    return ImageRegistry::instance()->acquire( fileName, errorMsg );
+}
+
+
+void DataSource::_resetQuantileCache(){
+    //Clips still being computed belong to the previous image or display axes.
+    m_clipGeneration++;
+    m_clipPending = false;
+    m_clipJobView.reset();
+    m_clipCurrentIndex = -1;
 }
 
 QString DataSource::_setFileName( const QString& fileName, bool* success ){
@@ -634,31 +781,11 @@ QString DataSource::_setFileName( const QString& fileName, bool* success ){
     QString result;
     if (file.length() > 0) {
         if ( file != m_fileName ){
-            try {
-                auto res = Globals::instance()-> pluginManager()
-                                      -> prepare <Carta::Lib::Hooks::LoadAstroImage>( file )
-                                      .first();
-                if (!res.isNull()){
-                    m_image = res.val();
-                    m_permuteImage = m_image;
-                    // reset zoom/pan
-                    _resetZoom();
-                    _resetPan();
-
-                    // clear quantile cache
-                    _resizeQuantileCache();
-                    m_fileName = file;
-                }
-                else {
-                    result = "Could not find any plugin to load image";
-                    qWarning() << result;
-                    *success = false;
-                }
-
+            std::shared_ptr<Carta::Lib::Image::ImageInterface> image = openImage( file, &result );
+            if ( image ){
+                result = _setImage( file, image, success );
             }
-            catch( std::logic_error& err ){
-                result = "Failed to load image "+fileName;
-                qDebug() << result;
+            else {
                 *success = false;
             }
         }
@@ -671,6 +798,31 @@ QString DataSource::_setFileName( const QString& fileName, bool* success ){
 }
 
 
+QString DataSource::_setImage( const QString& fileName,
+        std::shared_ptr<Carta::Lib::Image::ImageInterface> image, bool* success ){
+    QString result;
+    *success = false;
+    if ( image ){
+        m_image = image;
+        m_permuteImage = m_image;
+        m_readLock = ImageRegistry::instance()->getReadLock( m_image.get() );
+        m_renderService->setReadLock( m_readLock );
+        // reset zoom/pan
+        _resetZoom();
+        _resetPan();
+
+        // clear quantile cache
+        _resetQuantileCache();
+        m_fileName = fileName.trimmed();
+        *success = true;
+    }
+    else {
+        result = "Could not load image "+fileName;
+    }
+    return result;
+}
+
+
 void DataSource::_setColorMap( const QString& name ){
     Carta::State::ObjectManager* objManager = Carta::State::ObjectManager::objectManager();
     Carta::State::CartaObject* obj = objManager->getObject( Colormaps::CLASS_NAME );
@@ -744,7 +896,7 @@ void DataSource::_setDisplayAxes(std::vector<AxisInfo::KnownType> displayAxisTyp
     if ( axisXChanged || axisYChanged ){
         m_permuteImage = _getPermutedImage();
         _resetPan();
-        _resizeQuantileCache();
+        _resetQuantileCache();
 
     }
     std::vector<int> mFrames = _fitFramesToImage( frames );
@@ -779,35 +931,84 @@ void DataSource::_setGamma( double gamma ){
 }
 
 
+void DataSource::_setClips( const std::vector<double>& clips ){
+    if ( clips.size() >= 2 && clips[0] != clips[1] &&
+            !std::isnan( clips[0] ) && !std::isnan( clips[1] ) ){
+        m_pixelPipeline-> setMinMax( clips[0], clips[1] );
+    }
+}
+
+
 void DataSource::_updateClips( std::shared_ptr<Carta::Lib::NdArray::RawViewInterface>& view,
         double minClipPercentile, double maxClipPercentile, const std::vector<int>& frames ){
     std::vector<int> mFrames = _fitFramesToImage( frames );
     int quantileIndex = _getQuantileCacheIndex( mFrames );
-    std::vector<double> clips = m_quantileCache[ quantileIndex];
-    Carta::Lib::NdArray::Double doubleView( view.get(), false );
-    std::vector<double> newClips = Carta::Core::Algorithms::quantiles2pixels(
-            doubleView, {minClipPercentile, maxClipPercentile });
-    bool clipsChanged = false;
-    int clipSize = newClips.size();
-    if ( clipSize >= 2 ){
-        if ( clips.size() >= 2 ){
-            double ERROR_MARGIN = 0.000001;
-            if ( qAbs( newClips[0] - clips[0]) > ERROR_MARGIN ||
-                qAbs( newClips[1] - clips[1]) > ERROR_MARGIN ){
-                clipsChanged = true;
-            }
-        }
-        else {
-            clipsChanged = true;
-        }
+    m_clipCurrentIndex = quantileIndex;
+    QString clipKey = _getClipKey( quantileIndex );
+    ImageRegistry* registry = ImageRegistry::instance();
+    std::vector<double> cachedClips;
+    if ( registry->getClips( m_image.get(), clipKey, minClipPercentile, maxClipPercentile, &cachedClips ) &&
+            cachedClips.size() >= 2 ){
+        _setClips( cachedClips );
+        return;
     }
 
-    if ( clipsChanged ){
-        if ( newClips.size() >= 2 && newClips[0] != newClips[1] ){
-            m_quantileCache[ quantileIndex ] = newClips;
-            m_pixelPipeline-> setMinMax( newClips[0], newClips[1] );
+    //Exact clips need every pixel of the frame. Small frames are done right away;
+    //large ones are shown first with clips estimated from a decimated sample while
+    //the exact clips are computed in the background.
+    qint64 pixelCount = 1;
+    for ( int dim : view->dims() ){
+        pixelCount = pixelCount * dim;
+    }
+    int step = static_cast<int>( std::ceil( std::sqrt( pixelCount / double( CLIP_SAMPLE_SIZE ) ) ) );
+    if ( step <= 1 ){
+        QMutexLocker locker( m_readLock.get() );
+        std::vector<double> newClips = _computeClips( view.get(), minClipPercentile, maxClipPercentile );
+        registry->setClips( m_image.get(), clipKey, minClipPercentile, maxClipPercentile, newClips );
+        _setClips( newClips );
+        return;
+    }
+
+    //The display axes are the first two axes of the view.
+    SliceND sample;
+    sample.step( step ).next().step( step );
+    {
+        QMutexLocker locker( m_readLock.get() );
+        std::unique_ptr<Carta::Lib::NdArray::RawViewInterface> sampleView( view->getView( sample ) );
+        if ( sampleView ){
+            _setClips( _computeClips( sampleView.get(), minClipPercentile, maxClipPercentile ) );
         }
     }
+
+    //Nothing to do if the same clips are already on their way.
+    if ( m_clipPending && m_clipPendingIndex == quantileIndex &&
+            m_clipPendingMin == minClipPercentile && m_clipPendingMax == maxClipPercentile ){
+        return;
+    }
+    m_clipPending = true;
+    m_clipPendingIndex = quantileIndex;
+    m_clipPendingMin = minClipPercentile;
+    m_clipPendingMax = maxClipPercentile;
+    m_clipPendingGeneration = m_clipGeneration;
+    //The rendered view is in use on this thread, so the job gets a view of its own.
+    //It is started once the preview frame has been drawn, see _previewRendered().
+    m_clipJobView.reset( _getRawData( mFrames ) );
+}
+
+void DataSource::_previewRendered( QImage /*image*/, int64_t /*jobId*/ ){
+    if ( !m_clipPending || !m_clipJobView ){
+        return;
+    }
+    std::shared_ptr<Carta::Lib::NdArray::RawViewInterface> exactView = m_clipJobView;
+    m_clipJobView.reset();
+    std::shared_ptr<QMutex> readLock = m_readLock;
+    double minClipPercentile = m_clipPendingMin;
+    double maxClipPercentile = m_clipPendingMax;
+    m_clipWatcher.setFuture( QtConcurrent::run( Globals::instance()-> renderPool(),
+            [exactView, readLock, minClipPercentile, maxClipPercentile] () {
+        return DataSource::_computeClipsChunked( exactView, readLock,
+                minClipPercentile, maxClipPercentile );
+    }));
 }
 
 std::shared_ptr<Carta::Lib::NdArray::RawViewInterface> DataSource::_updateRenderedView( const std::vector<int>& frames ){
@@ -824,6 +1025,11 @@ void DataSource::_viewResize( const QSize& newSize ){
 }
 
 
+bool DataSource::_isClipPending() const {
+    return m_clipPending;
+}
+
+
 DataSource::~DataSource() {
 
 }
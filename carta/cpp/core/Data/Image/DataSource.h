@@ -10,6 +10,10 @@
 #include "CartaLib/AxisInfo.h"
 
 #include <memory>
+#include <QList>
+#include <QFutureWatcher>
+#include <QImage>
+#include <QMutex>
 
 class CoordinateFormatterInterface;
 class SliceND;
@@ -56,8 +60,36 @@ public:
        static const double ZOOM_DEFAULT;
        static const QString DATA_PATH;
 
+    /**
+     * Open an image file using the image loading plugins, or share it if it is
+     * already open.  This does not touch any data source so it can be called from
+     * a background thread.
+     * @param fileName - an identifier for the location of the image.
+     * @param errorMsg - set to a description of the problem if the image could not be opened.
+     * @return - the image or a null pointer if it could not be opened.
+     */
+    static std::shared_ptr<Carta::Lib::Image::ImageInterface> openImage( const QString& fileName,
+            QString* errorMsg );
+
     virtual ~DataSource();
 
+signals:
+
+    /**
+     * Notification that exact clips computed in the background are available for
+     * the frame that is being displayed.
+     */
+    void clipsChanged();
+
+private slots:
+
+    //Exact clips have been computed in the background.
+    void _clipsComputed();
+
+    //A frame has been rendered; starts the pending exact clip computation so
+    //that it does not hold up the preview.
+    void _previewRendered( QImage image, int64_t jobId );
+
 
 private:
 
@@ -156,6 +188,12 @@ private:
      */
     std::shared_ptr<Carta::Lib::Image::ImageInterface> _getImage();
 
+    /**
+     * Returns the lock to hold while reading pixels of the image.
+     * @return - the read lock of the image, shared with its other users.
+     */
+    std::shared_ptr<QMutex> _getReadLock() const;
+
     /**
      * Returns the image's file name.
      * @return the path to the image.
@@ -295,6 +333,9 @@ private:
     QString _getViewIdCurrent( const std::vector<int>& frames ) const;
     int _getQuantileCacheIndex( const std::vector<int>& frames ) const;
 
+    //Key of a frame in the clip cache shared through the image registry.
+    QString _getClipKey( int quantileIndex ) const;
+
     //Initialize static objects.
     void _initializeSingletons( );
 
@@ -309,6 +350,15 @@ private:
     void _load( std::vector<int> frames, bool recomputeClipsOnNewFrame,
             double clipMinPercentile, double clipMaxPercentile );
 
+    /**
+     * Ask the render service to read and color map upcoming frames in the background.
+     * @param frames - the current frames, one for each of the known axis types.
+     * @param axisType - the axis that is being animated.
+     * @param upcoming - frame indices along the animated axis, most urgent first.
+     */
+    void _prefetchFrames( const std::vector<int>& frames, Carta::Lib::AxisInfo::KnownType axisType,
+            const QList<int>& upcoming );
+
     /**
      * Center the image.
      */
@@ -319,7 +369,10 @@ private:
      */
     void _resetZoom();
 
-    void _resizeQuantileCache();
+    /**
+     * Forget clips being computed for the previous image or display axes.
+     */
+    void _resetQuantileCache();
 
     /**
     * Sets a new color map.
@@ -411,6 +464,22 @@ private:
      */
     QString _setFileName( const QString& fileName, bool* success );
 
+    /**
+     * Use an image that has already been opened.
+     * @param fileName - an identifier for the location of the image.
+     * @param image - the opened image.
+     * @param success - set to true if the image could be used; false otherwise.
+     * @return - an error message if the image could not be used; otherwise, an empty string.
+     */
+    QString _setImage( const QString& fileName,
+            std::shared_ptr<Carta::Lib::Image::ImageInterface> image, bool* success );
+
+    /**
+     * Returns true if exact clips are still being computed in the background.
+     * @return - true if the displayed clips are only estimates; false otherwise.
+     */
+    bool _isClipPending() const;
+
 
     /**
      * Set the data transform.
@@ -434,6 +503,25 @@ private:
     void _updateClips( std::shared_ptr<Carta::Lib::NdArray::RawViewInterface>& view,
             double minClipPercentile, double maxClipPercentile, const std::vector<int>& frames );
 
+    //Compute clips from all of the values in a view.
+    static std::vector<double> _computeClips( Carta::Lib::NdArray::RawViewInterface* view,
+            double minClipPercentile, double maxClipPercentile );
+
+    //Compute clips from all of the values in a view, holding the read lock only
+    //while copying a band of rows at a time.
+    static std::vector<double> _computeClipsChunked(
+            std::shared_ptr<Carta::Lib::NdArray::RawViewInterface> view, std::shared_ptr<QMutex> readLock,
+            double minClipPercentile, double maxClipPercentile );
+
+    //Set the pipeline clips, if they are usable.
+    void _setClips( const std::vector<double>& clips );
+
+    //Frames with more pixels than this are first shown with clips estimated
+    //from a decimated sample.
+    static const qint64 CLIP_SAMPLE_SIZE;
+    //Number of pixels copied per read lock when computing exact clips.
+    static const qint64 CLIP_CHUNK_SIZE;
+
     /**
      *  Constructor.
      */
@@ -450,12 +538,26 @@ private:
     //Pointer to image interface.
     std::shared_ptr<Carta::Lib::Image::ImageInterface> m_image;
     std::shared_ptr<Carta::Lib::Image::ImageInterface> m_permuteImage;
+    //Held while reading pixels of the image; other views and sessions may be
+    //reading the same image on other threads.
+    std::shared_ptr<QMutex> m_readLock;
 
     /// coordinate formatter
     std::shared_ptr<CoordinateFormatterInterface> m_coordinateFormatter;
 
-    /// clip cache, hard-coded to single quantile
-    std::vector< std::vector<double> > m_quantileCache;
+    //Background computation of exact clips.
+    QFutureWatcher< std::vector<double> > m_clipWatcher;
+    bool m_clipPending;
+    //Cache entry of the pending clips and the one being displayed.
+    int m_clipPendingIndex;
+    int m_clipCurrentIndex;
+    double m_clipPendingMin;
+    double m_clipPendingMax;
+    //Incremented when a new image is set so results for the old one are dropped.
+    int m_clipGeneration;
+    int m_clipPendingGeneration;
+    //View for the pending exact clips, until the job is started.
+    std::shared_ptr<Carta::Lib::NdArray::RawViewInterface> m_clipJobView;
 
     /// the rendering service
     std::shared_ptr<Carta::Core::ImageRenderService::Service> m_renderService;
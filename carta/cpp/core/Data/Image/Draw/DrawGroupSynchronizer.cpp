@@ -1,7 +1,7 @@
 #include "Data/Image/Draw/DrawGroupSynchronizer.h"
 #include "Data/Image/Layer.h"
 #include "Data/Image/LayerCompositionModes.h"
-#include "CartaLib/IRemoteVGView.h"
+#include "CartaLib/Algorithms/PlusCompositor.h"
 #include "Data/Image/RenderRequest.h"
 #include "Data/Image/RenderResponse.h"
 
@@ -28,8 +28,23 @@ void DrawGroupSynchronizer::render(
     if ( dataCount > 0 ){
         m_repaintFrameQueued = true;
 
-        m_renderCount = 0;
-        m_redrawCount = dataCount;
+        //Find out which layers we will be waiting for before starting any of
+        //them, as a layer may answer right away from the frame cache.
+        m_pending.clear();
+        for ( int i = 0; i < dataCount; i++ ){
+            if ( m_layers[i]->_isVisible() ){
+                m_pending.insert( m_layers[i]->_getLayerId() );
+            }
+        }
+        if ( m_pending.isEmpty() ){
+            m_repaintFrameQueued = false;
+            QImage img;
+            emit done( img );
+            return;
+        }
+
+        //The layers render in parallel on the shared render pool, each one
+        //reports back with renderingDone().
         int stackIndex = 0;
         for ( int i = 0; i < dataCount; i++ ){
             if ( m_layers[i]->_isVisible() ){
@@ -58,34 +73,35 @@ void DrawGroupSynchronizer::render(
 }
 
 void DrawGroupSynchronizer::_scheduleFrameRepaint( const std::shared_ptr<RenderResponse>& response){
-    m_renderCount++;
-    m_images[response->getLayerName()] = response;
+    QString layerName = response->getLayerName();
+    if ( !m_pending.remove( layerName ) ){
+        return;
+    }
+    m_images[layerName] = response;
     //If we are still waiting for other layers to finish, do nothing.
-    if ( m_renderCount != m_redrawCount ) {
+    if ( !m_pending.isEmpty() ) {
         return;
     }
     int dataCount = m_layers.size();
     QImage image;
     if ( m_imageSize.height() > 0 && m_imageSize.width() > 0 ){
         if ( m_combineMode == LayerCompositionModes::PLUS ){
-            std::shared_ptr<Carta::Lib::PixelMaskCombiner> pmc =
-                    std::make_shared < Carta::Lib::PixelMaskCombiner > ();
-            image = QImage(m_imageSize, QImage::Format_ARGB32 );
-            image.fill( QColor(0,0,0,0));
+            //Mask, scale and add all the layers in a single pass.
+            std::vector<Carta::Lib::Algorithms::PlusCompositor::Layer> layers;
             for ( int i = 0; i < dataCount; i++ ){
                 m_layers[i]->disconnect( this );
 
                 QString layerName = m_layers[i]->_getLayerId();
                 if ( m_images.contains( layerName ) ){
                     std::shared_ptr<RenderResponse> response = m_images[layerName];
-                    QImage layerImage = response->getImage();
-                    float alphaVal = m_layers[i]->_getMaskAlpha();
-                    pmc-> setAlpha( alphaVal );
-                    qint32 maskColor = m_layers[i]->_getMaskColor();
-                    pmc-> setMask( maskColor );
-                    pmc->combine( image, layerImage );
+                    layers.push_back( Carta::Lib::Algorithms::PlusCompositor::Layer(
+                            response->getImage(), m_layers[i]->_getMaskColor(),
+                            m_layers[i]->_getMaskAlpha() ) );
                 }
             }
+            image = QImage(m_imageSize, QImage::Format_ARGB32_Premultiplied );
+            image.fill( 0 );
+            Carta::Lib::Algorithms::PlusCompositor::composite( image, layers );
         }
         else {
             if ( dataCount > 0 ){
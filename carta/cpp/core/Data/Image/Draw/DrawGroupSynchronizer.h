@@ -13,6 +13,7 @@
 #include <QObject>
 #include <QImage>
 #include <QMap>
+#include <QSet>
 
 #include <memory>
 
@@ -85,8 +86,8 @@ private:
     QMap<QString, std::shared_ptr<RenderResponse> > m_images;
     QString m_combineMode;
     QSize m_imageSize;
-    int m_renderCount;
-    int m_redrawCount;
+    //Layers that have not finished rendering yet.
+    QSet<QString> m_pending;
 
     DrawGroupSynchronizer(const DrawGroupSynchronizer& other);
     DrawGroupSynchronizer& operator=(const DrawGroupSynchronizer& other);
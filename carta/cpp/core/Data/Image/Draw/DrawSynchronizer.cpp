@@ -57,17 +57,22 @@ void DrawSynchronizer::_contourDone( const Result & result,
             return;
         }
 
-        // convert the raw contours into VG
-        Carta::Lib::VectorGraphics::VGComposer vgc;
+        // convert the raw contours into a single packed VG entry, there can be
+        // many thousands of polylines
+        namespace VG = Carta::Lib::VectorGraphics;
+        VG::VGStreamWriter writer;
         const auto & contourSet = result.contours();
         for ( size_t k = 0 ; k < contourSet.size() ; ++k ) {
             const auto & con = contourSet[k].polylines();
-            vgc.append< Carta::Lib::VectorGraphics::Entries::SetPen >( m_pens[k]);
+            writer.op( VG::VGOp::SetPen );
+            writer.pen( m_pens[k] );
             for ( size_t i = 0 ; i < con.size() ; ++i ) {
-                const QPolygonF & poly = con[i];
-                vgc.append < Carta::Lib::VectorGraphics::Entries::DrawPolyline > ( poly );
+                writer.op( VG::VGOp::DrawPolyline );
+                writer.polyline( con[i] );
             }
         }
+        VG::VGComposer vgc;
+        vgc.append < VG::Entries::DrawPacked > ( writer.finish() );
         m_cecVGList = vgc.vgList();
         m_cecDone = true;
         _checkAndEmit();
@@ -83,8 +88,9 @@ void DrawSynchronizer::_irsDone( QImage img, int64_t jobId ){
     }
 }
 
-void DrawSynchronizer::setInput( std::shared_ptr<Carta::Lib::NdArray::RawViewInterface> rawView ){
-    m_cec->setInput( rawView );
+void DrawSynchronizer::setInput( std::shared_ptr<Carta::Lib::NdArray::RawViewInterface> rawView,
+        std::shared_ptr<QMutex> readLock ){
+    m_cec->setInput( rawView, readLock );
 }
 
 
@@ -4,6 +4,7 @@
 
 #pragma once
 #include <CartaLib/VectorGraphics/VGList.h>
+#include <QMutex>
 #include <set>
 
 
@@ -42,8 +43,10 @@ public:
     /**
      * Sets the data to be used in calculating contours.
      * @param rawView - the data for calculating contours.
+     * @param readLock - the read lock of the image the data comes from.
      */
-    void setInput( std::shared_ptr<Carta::Lib::NdArray::RawViewInterface> rawView );
+    void setInput( std::shared_ptr<Carta::Lib::NdArray::RawViewInterface> rawView,
+            std::shared_ptr<QMutex> readLock );
 
     /**
      * Sets the contour set(s) to be drawn.
@@ -0,0 +1,326 @@
+#include "ImageRegistry.h"
+#include "CartaLib/Hooks/LoadAstroImage.h"
+#include "CartaLib/IImage.h"
+#include "CartaLib/PixelType.h"
+#include "Globals.h"
+#include "MemoryGovernor.h"
+#include "PluginManager.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QStringList>
+
+namespace Carta {
+
+namespace Data {
+
+const int ImageRegistry::CLIP_CACHE_SIZE = 10000;
+
+ImageRegistry::ImageRegistry() :
+    m_defaultReadLock( new QMutex( QMutex::Recursive ) ),
+    m_serial( 0 ){
+    m_governorId = Globals::instance()->memoryGovernor()->addConsumer( "permuted images",
+            [this] ( qint64 bytes ) {
+        return _releasePermuted( bytes );
+    });
+}
+
+ImageRegistry* ImageRegistry::instance(){
+    static ImageRegistry registry;
+    return &registry;
+}
+
+std::shared_ptr<Carta::Lib::Image::ImageInterface> ImageRegistry::acquire( const QString& fileName,
+        QString* errorMsg ){
+    std::shared_ptr<Carta::Lib::Image::ImageInterface> image;
+    QFileInfo fileInfo( fileName );
+    QString key = fileInfo.canonicalFilePath();
+    if ( key.isEmpty() ){
+        key = fileName;
+    }
+    qint64 modified = fileInfo.lastModified().toMSecsSinceEpoch();
+
+    //Only one thread opens a given image; the others wait for it and share the result.
+    std::shared_ptr<QMutex> openMutex;
+    {
+        QMutexLocker locker( &m_mutex );
+        Entry& entry = m_entries[key];
+        if ( entry.modified == modified ){
+            image = entry.handle.lock();
+        }
+        if ( image ){
+            return image;
+        }
+        if ( !entry.openMutex ){
+            entry.openMutex.reset( new QMutex() );
+        }
+        openMutex = entry.openMutex;
+    }
+    QMutexLocker openLocker( openMutex.get() );
+    {
+        QMutexLocker locker( &m_mutex );
+        Entry& entry = m_entries[key];
+        if ( entry.modified == modified ){
+            image = entry.handle.lock();
+        }
+        if ( image ){
+            return image;
+        }
+    }
+
+    std::shared_ptr<Carta::Lib::Image::ImageInterface> opened;
+    try {
+        auto res = Globals::instance()-> pluginManager()
+                              -> prepare <Carta::Lib::Hooks::LoadAstroImage>( fileName )
+                              .first();
+        if (!res.isNull()){
+            opened = res.val();
+        }
+        else {
+            *errorMsg = "Could not find any plugin to load image";
+            qWarning() << *errorMsg;
+        }
+    }
+    catch( std::logic_error& err ){
+        *errorMsg = "Failed to load image "+fileName;
+        qDebug() << *errorMsg;
+    }
+
+    //Declared before the lock so that, if it turns out to be the last handle of
+    //an image, it is released after the lock.
+    std::shared_ptr<Carta::Lib::Image::ImageInterface> oldImage;
+    QMutexLocker locker( &m_mutex );
+    Entry& entry = m_entries[key];
+    if ( !opened ){
+        if ( entry.handle.expired() ){
+            m_entries.remove( key );
+        }
+        return image;
+    }
+    //A changed file gets a new entry; handles to the old image keep it alive
+    //but it is no longer shared.
+    oldImage = entry.handle.lock();
+    if ( oldImage ){
+        m_paths.remove( oldImage.get() );
+    }
+    m_serial++;
+    qint64 serial = m_serial;
+    entry.serial = serial;
+    entry.modified = modified;
+    entry.permuted.clear();
+    entry.clips.clear();
+    _reportPermuted();
+    //The handle keeps the plugin's image alive and tells the registry when the
+    //last user lets go of it.
+    image.reset( opened.get(), [opened, key, serial] ( Carta::Lib::Image::ImageInterface* ptr ) {
+        ImageRegistry::instance()->_release( ptr, key, serial );
+    });
+    entry.handle = image;
+    m_paths[opened.get()] = key;
+    m_readLocks[opened.get()] = std::shared_ptr<QMutex>( new QMutex( QMutex::Recursive ) );
+    return image;
+}
+
+ImageRegistry::Entry* ImageRegistry::_findEntry( const Carta::Lib::Image::ImageInterface* image ){
+    Entry* entry = nullptr;
+    auto pathIter = m_paths.find( image );
+    if ( pathIter != m_paths.end() ){
+        auto iter = m_entries.find( pathIter.value() );
+        if ( iter != m_entries.end() ){
+            entry = &iter.value();
+        }
+    }
+    return entry;
+}
+
+const ImageRegistry::Entry* ImageRegistry::_findEntry( const Carta::Lib::Image::ImageInterface* image ) const {
+    const Entry* entry = nullptr;
+    auto pathIter = m_paths.find( image );
+    if ( pathIter != m_paths.end() ){
+        auto iter = m_entries.find( pathIter.value() );
+        if ( iter != m_entries.end() ){
+            entry = &iter.value();
+        }
+    }
+    return entry;
+}
+
+bool ImageRegistry::getClips( const Carta::Lib::Image::ImageInterface* image, const QString& frameKey,
+        double minPercentile, double maxPercentile, std::vector<double>* clips ) const {
+    bool found = false;
+    QMutexLocker locker( &m_mutex );
+    const Entry* entry = _findEntry( image );
+    if ( entry ){
+        auto iter = entry->clips.find( frameKey );
+        if ( iter != entry->clips.end() && iter->minPercentile == minPercentile &&
+                iter->maxPercentile == maxPercentile ){
+            *clips = iter->clips;
+            found = true;
+        }
+    }
+    return found;
+}
+
+std::shared_ptr<QMutex> ImageRegistry::getReadLock( const Carta::Lib::Image::ImageInterface* image ) const {
+    QMutexLocker locker( &m_mutex );
+    return m_readLocks.value( image, m_defaultReadLock );
+}
+
+std::shared_ptr<Carta::Lib::Image::ImageInterface> ImageRegistry::getPermuted(
+        std::shared_ptr<Carta::Lib::Image::ImageInterface> image, const std::vector<int>& indices ){
+    std::shared_ptr<Carta::Lib::Image::ImageInterface> permuted;
+    if ( !image ){
+        return permuted;
+    }
+    QStringList keyParts;
+    bool identity = true;
+    int indexCount = indices.size();
+    for ( int i = 0; i < indexCount; i++ ){
+        keyParts.append( QString::number( indices[i] ) );
+        if ( indices[i] != i ){
+            identity = false;
+        }
+    }
+    //The image itself is shared; its readers serialize on its read lock.
+    if ( identity ){
+        return image;
+    }
+    QString permuteKey = keyParts.join( "," );
+    {
+        QMutexLocker locker( &m_mutex );
+        Entry* entry = _findEntry( image.get() );
+        if ( entry ){
+            permuted = entry->permuted.value( permuteKey );
+        }
+    }
+    if ( !permuted ){
+        //Permuting may copy the whole image; make room for it first.
+        Carta::Core::MemoryGovernor::Reservation reservation( Globals::instance()->memoryGovernor(),
+                "permuting image", _getDataBytes( image ) );
+        if ( !reservation.fits() ){
+            qWarning() << "Permuting an image exceeds the memory budget";
+        }
+        std::shared_ptr<QMutex> readLock = getReadLock( image.get() );
+        QMutexLocker readLocker( readLock.get() );
+        permuted = image->getPermuted( indices );
+        QMutexLocker locker( &m_mutex );
+        Entry* entry = _findEntry( image.get() );
+        if ( entry && permuted ){
+            entry->permuted.insert( permuteKey, permuted );
+            _reportPermuted();
+        }
+    }
+    return permuted;
+}
+
+std::vector<ImageRegistry::Usage> ImageRegistry::getUsage() const {
+    std::vector<Usage> usages;
+    //Handles are kept until the lock is released, in case one of them is the last.
+    std::vector<std::shared_ptr<Carta::Lib::Image::ImageInterface> > images;
+    QMutexLocker locker( &m_mutex );
+    for ( auto iter = m_entries.begin(); iter != m_entries.end(); ++iter ){
+        std::shared_ptr<Carta::Lib::Image::ImageInterface> image = iter->handle.lock();
+        if ( !image ){
+            continue;
+        }
+        images.push_back( image );
+        Usage usage;
+        usage.path = iter.key();
+        //Do not count the handles made for this report.
+        usage.handles = image.use_count() - 2;
+        usage.dataBytes = _getDataBytes( image );
+        usage.permutedViews = iter->permuted.size();
+        usage.clipEntries = iter->clips.size();
+        usages.push_back( usage );
+    }
+    return usages;
+}
+
+qint64 ImageRegistry::_getDataBytes( const std::shared_ptr<Carta::Lib::Image::ImageInterface>& image ){
+    qint64 pixelCount = 1;
+    for ( int dim : image->dims() ){
+        pixelCount = pixelCount * dim;
+    }
+    return pixelCount * Carta::Lib::Image::pixelType2size( image->pixelType() );
+}
+
+void ImageRegistry::_release( const Carta::Lib::Image::ImageInterface* image,
+        const QString& key, qint64 serial ){
+    QMutexLocker locker( &m_mutex );
+    auto iter = m_entries.find( key );
+    if ( iter != m_entries.end() && iter->serial == serial ){
+        //Keep the entry if someone is waiting to open the same file.
+        QMutex* openMutex = iter->openMutex.get();
+        bool opening = openMutex && !openMutex->tryLock();
+        if ( !opening ){
+            if ( openMutex ){
+                openMutex->unlock();
+            }
+            m_entries.erase( iter );
+        }
+        else {
+            iter->permuted.clear();
+            iter->clips.clear();
+            iter->handle.reset();
+        }
+        _reportPermuted();
+    }
+    auto pathIter = m_paths.find( image );
+    if ( pathIter != m_paths.end() && pathIter.value() == key ){
+        m_paths.erase( pathIter );
+    }
+    m_readLocks.remove( image );
+}
+
+qint64 ImageRegistry::_releasePermuted( qint64 bytes ){
+    qint64 freed = 0;
+    //Views are destroyed after the lock is released.
+    std::vector<std::shared_ptr<Carta::Lib::Image::ImageInterface> > released;
+    QMutexLocker locker( &m_mutex );
+    for ( auto iter = m_entries.begin(); iter != m_entries.end() && freed < bytes; ++iter ){
+        for ( auto permIter = iter->permuted.begin(); permIter != iter->permuted.end() && freed < bytes; ){
+            if ( permIter.value().use_count() == 1 ){
+                freed = freed + _getDataBytes( permIter.value() );
+                released.push_back( permIter.value() );
+                permIter = iter->permuted.erase( permIter );
+            }
+            else {
+                ++permIter;
+            }
+        }
+    }
+    _reportPermuted();
+    return freed;
+}
+
+void ImageRegistry::_reportPermuted(){
+    qint64 bytes = 0;
+    for ( auto iter = m_entries.begin(); iter != m_entries.end(); ++iter ){
+        for ( auto permIter = iter->permuted.begin(); permIter != iter->permuted.end(); ++permIter ){
+            bytes = bytes + _getDataBytes( permIter.value() );
+        }
+    }
+    Globals::instance()->memoryGovernor()->setBytes( m_governorId, bytes );
+}
+
+void ImageRegistry::setClips( const Carta::Lib::Image::ImageInterface* image, const QString& frameKey,
+        double minPercentile, double maxPercentile, const std::vector<double>& clips ){
+    QMutexLocker locker( &m_mutex );
+    Entry* entry = _findEntry( image );
+    if ( entry ){
+        if ( entry->clips.size() >= CLIP_CACHE_SIZE && !entry->clips.contains( frameKey ) ){
+            entry->clips.clear();
+        }
+        Clips& frameClips = entry->clips[frameKey];
+        frameClips.minPercentile = minPercentile;
+        frameClips.maxPercentile = maxPercentile;
+        frameClips.clips = clips;
+    }
+}
+
+ImageRegistry::~ImageRegistry(){
+}
+}
+}
@@ -0,0 +1,180 @@
+/***
+ * Process-wide registry of open images.
+ *
+ * Images are keyed by their canonical path and modification time, so the same cube
+ * shown in several image views or sessions is opened once.  Everybody gets a handle
+ * to the same ImageInterface, together with the permuted views and exact clips that
+ * have been computed for it.  An image and everything cached for it is dropped when
+ * the last handle is released.
+ *
+ * Permuted views may be full copies of the image, so they are accounted with the
+ * memory governor, which can ask for the ones nobody is using to be dropped.
+ *
+ * Image plugins do not promise that one image can be read from several threads at
+ * once, and a shared image is read by every view, render job and statistics job that
+ * shows it.  Each registered image therefore has a read lock that must be held while
+ * its pixels, or the pixels of a permuted view of it, are read.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+#include <memory>
+#include <vector>
+
+namespace Carta {
+namespace Lib {
+namespace Image {
+class ImageInterface;
+}
+}
+}
+
+namespace Carta {
+
+namespace Data {
+
+class ImageRegistry {
+
+public:
+
+    //Memory used by one registered image.
+    struct Usage {
+        QString path;
+        //Number of handles to the image.
+        long handles = 0;
+        //Size of the pixel data.
+        qint64 dataBytes = 0;
+        int permutedViews = 0;
+        int clipEntries = 0;
+    };
+
+    /**
+     * Returns the registry.
+     * @return - the registry shared by all sessions.
+     */
+    static ImageRegistry* instance();
+
+    /**
+     * Return a handle to an image, opening it if it is not open already.  This may
+     * be called from any thread.
+     * @param fileName - the location of the image.
+     * @param errorMsg - set to a description of the problem if the image could not be opened.
+     * @return - the image or a null pointer if it could not be opened.
+     */
+    std::shared_ptr<Carta::Lib::Image::ImageInterface> acquire( const QString& fileName,
+            QString* errorMsg );
+
+    /**
+     * Return a permuted view of an image, shared with other users of the image.  An
+     * identity permutation returns the image itself.  Reads from the view must hold
+     * the read lock of the image.
+     * @param image - an image handed out by the registry.
+     * @param indices - the permutation, as in ImageInterface::getPermuted.
+     * @return - the permuted image.
+     */
+    std::shared_ptr<Carta::Lib::Image::ImageInterface> getPermuted(
+            std::shared_ptr<Carta::Lib::Image::ImageInterface> image, const std::vector<int>& indices );
+
+    /**
+     * Return the lock that serializes reads of an image and of its permuted views.
+     * The lock is recursive and stays valid as long as the caller holds it, even after
+     * the image was released.
+     * @param image - an image handed out by the registry.
+     * @return - the read lock of the image; images that did not come from the registry
+     *      share one lock.
+     */
+    std::shared_ptr<QMutex> getReadLock( const Carta::Lib::Image::ImageInterface* image ) const;
+
+    /**
+     * Look up the exact clips of a frame.
+     * @param image - an image handed out by the registry.
+     * @param frameKey - identifies the frame and display axes.
+     * @param minPercentile - the lower clip percentile.
+     * @param maxPercentile - the upper clip percentile.
+     * @param clips - set to the clips if they are known.
+     * @return - true if the clips are known; false otherwise.
+     */
+    bool getClips( const Carta::Lib::Image::ImageInterface* image, const QString& frameKey,
+            double minPercentile, double maxPercentile, std::vector<double>* clips ) const;
+
+    /**
+     * Store the exact clips of a frame.
+     * @param image - an image handed out by the registry.
+     * @param frameKey - identifies the frame and display axes.
+     * @param minPercentile - the lower clip percentile.
+     * @param maxPercentile - the upper clip percentile.
+     * @param clips - the clips.
+     */
+    void setClips( const Carta::Lib::Image::ImageInterface* image, const QString& frameKey,
+            double minPercentile, double maxPercentile, const std::vector<double>& clips );
+
+    /**
+     * Return the memory used by each registered image.
+     * @return - one entry for each open image.
+     */
+    std::vector<Usage> getUsage() const;
+
+    //Maximum number of clip entries kept for one image.
+    static const int CLIP_CACHE_SIZE;
+
+    virtual ~ImageRegistry();
+
+private:
+
+    struct Clips {
+        double minPercentile;
+        double maxPercentile;
+        std::vector<double> clips;
+    };
+
+    struct Entry {
+        //Distinguishes an entry from a later one for the same path.
+        qint64 serial = 0;
+        qint64 modified = 0;
+        std::weak_ptr<Carta::Lib::Image::ImageInterface> handle;
+        //Held while the image is being opened.
+        std::shared_ptr<QMutex> openMutex;
+        QHash<QString, std::shared_ptr<Carta::Lib::Image::ImageInterface> > permuted;
+        QHash<QString, Clips> clips;
+    };
+
+    //Size of the pixel data of an image.
+    static qint64 _getDataBytes( const std::shared_ptr<Carta::Lib::Image::ImageInterface>& image );
+
+    //Drop permuted views that are not in use until the given number of bytes was
+    //freed; returns the number of bytes freed.
+    qint64 _releasePermuted( qint64 bytes );
+
+    //Tell the memory governor how much the permuted views use.
+    void _reportPermuted();
+
+    ImageRegistry();
+
+    //Find the entry of an image handed out by the registry.
+    Entry* _findEntry( const Carta::Lib::Image::ImageInterface* image );
+    const Entry* _findEntry( const Carta::Lib::Image::ImageInterface* image ) const;
+
+    //Called when the last handle of an image goes away.
+    void _release( const Carta::Lib::Image::ImageInterface* image, const QString& key, qint64 serial );
+
+    mutable QMutex m_mutex;
+    QHash<QString, Entry> m_entries;
+    //Canonical path of the image behind each handed out pointer.
+    QHash<const Carta::Lib::Image::ImageInterface*, QString> m_paths;
+    //Read lock of each handed out pointer; kept until the image itself is released so
+    //that readers of an image replaced by a newer file still share a lock.
+    QHash<const Carta::Lib::Image::ImageInterface*, std::shared_ptr<QMutex> > m_readLocks;
+    //Read lock of images that did not come from the registry.
+    std::shared_ptr<QMutex> m_defaultReadLock;
+    qint64 m_serial;
+    int m_governorId;
+
+    ImageRegistry( const ImageRegistry& other);
+    ImageRegistry& operator=( const ImageRegistry& other );
+};
+}
+}
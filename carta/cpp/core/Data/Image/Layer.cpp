@@ -150,6 +150,10 @@ bool Layer::_isEmpty() const {
     return false;
 }
 
+bool Layer::_isClipPending() const {
+    return false;
+}
+
 
 bool Layer::_isMatch( const QString& name ) const {
     bool matched = false;
@@ -63,6 +63,9 @@ signals:
     virtual void contourSetAdded(Layer* data, const QString& name );
     virtual void colorStateChanged();
 
+    //Notification that exact clips computed in the background are ready to be shown.
+    void clipsChanged();
+
 
     //Notification that a new image has been produced.
     void renderingDone( const std::shared_ptr<RenderResponse>& response );
@@ -389,6 +392,13 @@ protected:
      */
     virtual bool _isEmpty() const;
 
+    /**
+     * Returns true if the layer is shown with estimated clips while the exact ones
+     * are still being computed.
+     * @return - true if exact clips are pending; false otherwise.
+     */
+    virtual bool _isClipPending() const;
+
 
     /**
      * Returns true if this data is selected; false otherwise.
@@ -406,6 +416,15 @@ protected:
     virtual void _load( std::vector<int> frames, bool autoClip, double clipMinPercentile,
             double clipMaxPercentile ) = 0;
 
+    /**
+     * Read and color map frames that are likely to be displayed next in the background.
+     * @param frames - the current frames, one for each of the known axis types.
+     * @param axisType - the axis that is being animated.
+     * @param upcoming - frame indices along the animated axis, most urgent first.
+     */
+    virtual void _prefetchFrames( const std::vector<int>& frames,
+            Carta::Lib::AxisInfo::KnownType axisType, const QList<int>& upcoming ) = 0;
+
     /**
      * Remove the contour set from this layer.
      * @param contourSet - the contour set to remove from the layer.
@@ -54,6 +54,7 @@ LayerData::LayerData(const QString& path, const QString& id) :
         m_renderQueued = false;
 
         _initializeState();
+        connect( m_dataSource.get(), SIGNAL(clipsChanged()), this, SIGNAL(clipsChanged()));
 
         Carta::State::ObjectManager* objMan = Carta::State::ObjectManager::objectManager();
         ColorState* colorObj = objMan->createObject<ColorState>();
@@ -473,6 +474,14 @@ void LayerData::_initializeState() {
     m_state.insertValue<bool>( layerAlphaKey, true );
 }
 
+bool LayerData::_isClipPending() const {
+    bool pending = false;
+    if ( m_dataSource ){
+        pending = m_dataSource->_isClipPending();
+    }
+    return pending;
+}
+
 bool LayerData::_isContourDraw() const {
     bool contourDraw = false;
     for ( std::set< std::shared_ptr<DataContours> >::iterator it = m_dataContours.begin();
@@ -505,6 +514,13 @@ void LayerData::_load(std::vector<int> frames, bool recomputeClipsOnNewFrame,
 
 
 
+void LayerData::_prefetchFrames( const std::vector<int>& frames,
+        AxisInfo::KnownType axisType, const QList<int>& upcoming ){
+    if ( m_dataSource ){
+        m_dataSource->_prefetchFrames( frames, axisType, upcoming );
+    }
+}
+
 void LayerData::_removeContourSet( std::shared_ptr<DataContours> contourSet ){
     if ( contourSet ){
         QString targetName = contourSet->getName();
@@ -623,7 +639,7 @@ void LayerData::_renderStart(){
     gridService->setAxisDisplayInfo( axisInfo );
 
     std::shared_ptr<Carta::Lib::NdArray::RawViewInterface> rawData( m_dataSource->_getRawData( frames ));
-    m_drawSync->setInput( rawData );
+    m_drawSync->setInput( rawData, m_dataSource->_getReadLock() );
     m_drawSync->setContours( m_dataContours );
 
     //Which display axes will be drawn.
@@ -747,22 +763,35 @@ void LayerData::_resetPan( ){
 QString LayerData::_setFileName( const QString& fileName, bool * success ){
     QString result = m_dataSource->_setFileName( fileName, success );
     if ( *success){
-        DataLoader* dLoader = Util::findSingletonObject<DataLoader>();
-        QString shortName = dLoader->getShortName( fileName );
-        //m_state.setValue<QString>(DataSource::DATA_PATH, fileName );
-
-        //Default is to have the layer name match the file name, unless
-        //the user has explicitly set it.
-        QString layerName = m_state.getValue<QString>( LAYER_NAME );
-        if ( layerName.isEmpty() || layerName.length() == 0 ){
-            m_state.setValue<QString>( LAYER_NAME, shortName );
-            m_state.flushState();
-        }
-        result = m_state.getValue<QString>( Util::ID );
+        result = _setLayerNameDefault( fileName );
     }
     return result;
 }
 
+QString LayerData::_setImage( const QString& fileName,
+        std::shared_ptr<Carta::Lib::Image::ImageInterface> image, bool* success ){
+    QString result = m_dataSource->_setImage( fileName, image, success );
+    if ( *success ){
+        result = _setLayerNameDefault( fileName );
+    }
+    return result;
+}
+
+QString LayerData::_setLayerNameDefault( const QString& fileName ){
+    DataLoader* dLoader = Util::findSingletonObject<DataLoader>();
+    QString shortName = dLoader->getShortName( fileName );
+    //m_state.setValue<QString>(DataSource::DATA_PATH, fileName );
+
+    //Default is to have the layer name match the file name, unless
+    //the user has explicitly set it.
+    QString layerName = m_state.getValue<QString>( LAYER_NAME );
+    if ( layerName.isEmpty() || layerName.length() == 0 ){
+        m_state.setValue<QString>( LAYER_NAME, shortName );
+        m_state.flushState();
+    }
+    return m_state.getValue<QString>( Util::ID );
+}
+
 bool LayerData::_setLayersGrouped( bool /*grouped*/  ){
     return false;
 }
@@ -274,6 +274,9 @@ protected:
     virtual void _load( std::vector<int> frames, bool autoClip, double clipMinPercentile,
                 double clipMaxPercentile ) Q_DECL_OVERRIDE;
 
+    virtual void _prefetchFrames( const std::vector<int>& frames,
+            Carta::Lib::AxisInfo::KnownType axisType, const QList<int>& upcoming ) Q_DECL_OVERRIDE;
+
 
     /**
      * Center the image.
@@ -294,6 +297,20 @@ protected:
      */
     virtual QString _setFileName( const QString& fileName, bool* success ) Q_DECL_OVERRIDE;
 
+    /**
+     * Use an image that has already been opened.
+     * @param fileName - an identifier for the location of the image file.
+     * @param image - the opened image.
+     * @param success - set to true if the image could be used.
+     * @return - an error message if the image could not be used or the id of
+     *      the layer if it is successfully loaded.
+     */
+    QString _setImage( const QString& fileName,
+            std::shared_ptr<Carta::Lib::Image::ImageInterface> image, bool* success );
+
+    //Name the layer after the file it was loaded from.
+    QString _setLayerNameDefault( const QString& fileName );
+
     /**
      * Returns the location on the image corresponding to a screen point in
      * pixels.
@@ -337,6 +354,8 @@ protected:
          */
     virtual bool _isContourDraw() const Q_DECL_OVERRIDE;
 
+    virtual bool _isClipPending() const Q_DECL_OVERRIDE;
+
     /**
          * Remove the contour set from this layer.
          * @param contourSet - the contour set to remove from the layer.
@@ -67,7 +67,7 @@ void LayerGroup::_addContourSet( std::shared_ptr<DataContours> contourSet){
 }
 
 QString LayerGroup::_addData(const QString& fileName, bool* success, int* stackIndex,
-        QSize viewSize ) {
+        QSize viewSize, std::shared_ptr<Carta::Lib::Image::ImageInterface> image ) {
     QString result;
     Carta::State::ObjectManager* objMan = Carta::State::ObjectManager::objectManager();
     LayerData* targetSource = objMan->createObject<LayerData>();
@@ -76,7 +76,13 @@ QString LayerGroup::_addData(const QString& fileName, bool* success, int* stackI
     connect( targetSource, SIGNAL(contourSetRemoved(const QString&)),
             this, SIGNAL(contourSetRemoved(const QString&)));
     connect( targetSource, SIGNAL(colorStateChanged()), this, SIGNAL(colorStateChanged() ));
-    result = targetSource->_setFileName(fileName, success );
+    connect( targetSource, SIGNAL(clipsChanged()), this, SIGNAL(clipsChanged()));
+    if ( image ){
+        result = targetSource->_setImage( fileName, image, success );
+    }
+    else {
+        result = targetSource->_setFileName(fileName, success );
+    }
     //If we are making a new layer, see if there is a selected group.  If so,
     //add to the group.  If not, add to this group.
     if ( *success ){
@@ -103,6 +109,7 @@ bool LayerGroup::_addGroup(){
     LayerGroup* targetSource = objMan->createObject<LayerGroup>();
     connect( targetSource, SIGNAL(removeLayer(Layer*)),
             this, SLOT( _removeLayer( Layer*)));
+    connect( targetSource, SIGNAL(clipsChanged()), this, SIGNAL(clipsChanged()));
     m_children.append( std::shared_ptr<Layer>(targetSource));
     return true;
 }
@@ -669,6 +676,18 @@ bool LayerGroup::_isDescendant( const QString& id ) const {
     return descendant;
 }
 
+bool LayerGroup::_isClipPending() const {
+    bool pending = false;
+    int childCount = m_children.size();
+    for ( int i = 0; i < childCount; i++ ){
+        if ( m_children[i]->_isClipPending() ){
+            pending = true;
+            break;
+        }
+    }
+    return pending;
+}
+
 bool LayerGroup::_isEmpty() const {
     bool empty = true;
     int childCount = m_children.size();
@@ -690,6 +709,14 @@ void LayerGroup::_load(std::vector<int> frames, bool recomputeClipsOnNewFrame,
     }
 }
 
+void LayerGroup::_prefetchFrames( const std::vector<int>& frames,
+        AxisInfo::KnownType axisType, const QList<int>& upcoming ){
+    int childCount = m_children.size();
+    for ( int i = 0; i < childCount; i++ ){
+        m_children[i]->_prefetchFrames( frames, axisType, upcoming );
+    }
+}
+
 void LayerGroup::_removeData( int index ){
     int childCount = m_children.size();
     if ( 0 <= index && index < childCount ){
@@ -49,9 +49,12 @@ protected:
      * @param stackIndex - set to the index of the image in this group if it is loaded
      *      in this group.
      * @param viewSize - the current client view size.
+     * @param image - the image if it has already been opened; otherwise, it is opened
+     *      from the file.
      */
     QString _addData(const QString& fileName, bool* success, int* stackIndex,
-                      QSize viewSize=QSize()  );
+                      QSize viewSize=QSize(),
+                      std::shared_ptr<Carta::Lib::Image::ImageInterface> image = nullptr );
 
 
 
@@ -333,6 +336,12 @@ protected:
      */
     virtual bool _isEmpty() const Q_DECL_OVERRIDE;
 
+    /**
+     * Returns true if one of the layers in the group is waiting on exact clips.
+     * @return - true if exact clips are pending; false otherwise.
+     */
+    virtual bool _isClipPending() const Q_DECL_OVERRIDE;
+
     /**
      * Return a QImage representation of this data.
      * @param frames - a list of frames to load, one for each of the known axis types.
@@ -343,6 +352,9 @@ protected:
     virtual void _load( std::vector<int> frames, bool autoClip, double clipMinPercentile,
                double clipMaxPercentile ) Q_DECL_OVERRIDE;
 
+    virtual void _prefetchFrames( const std::vector<int>& frames,
+            Carta::Lib::AxisInfo::KnownType axisType, const QList<int>& upcoming ) Q_DECL_OVERRIDE;
+
     /**
      * Remove the contour set from this layer.
      * @param contourSet - the contour set to remove from the layer.
@@ -16,6 +16,8 @@
 
 #include <QDebug>
 #include <QDir>
+#include <QFileInfo>
+#include <QtConcurrent/QtConcurrentRun>
 #include "Stack.h"
 
 
@@ -53,10 +55,11 @@ Stack::Stack(const QString& path, const QString& id) :
     _initializeSelections();
 }
 
-QString Stack::_addDataImage(const QString& fileName, bool* success ) {
+QString Stack::_addDataImage(const QString& fileName, bool* success,
+        std::shared_ptr<Carta::Lib::Image::ImageInterface> image ) {
     int stackIndex = -1;
     QSize viewSize = m_stackDraw->getClientSize();
-    QString result = _addData( fileName, success, &stackIndex, viewSize);
+    QString result = _addData( fileName, success, &stackIndex, viewSize, image );
     if ( *success && stackIndex >= 0 ){
         _resetFrames( stackIndex );
         _saveState();
@@ -69,6 +72,7 @@ void Stack::_addDataRegions( std::vector<std::shared_ptr<Region>> regions ){
     for ( int i = 0; i < count; i++ ){
         m_regions.push_back( regions[i]);
     }
+    _resetRegionIndex();
     _saveStateRegions();
 }
 
@@ -132,6 +136,7 @@ QString Stack::_closeRegion( const QString& regionId ){
         }
     }
     if ( regionRemoved ){
+        _resetRegionIndex();
         _saveStateRegions();
     }
     else {
@@ -203,6 +208,14 @@ QString Stack::_getCursorText( int mouseX, int mouseY ){
     if ( dataIndex >= 0 ){
         std::vector<int> frameIndices = _getFrameIndices();
         cursorText = m_children[dataIndex]->_getCursorText( mouseX, mouseY, frameIndices );
+        bool valid = false;
+        QPointF imagePt = m_children[dataIndex]->_getImagePt( QPointF( mouseX, mouseY ), &valid );
+        if ( valid ){
+            QStringList regionIds = _getRegionIdsAt( imagePt.x(), imagePt.y() );
+            if ( !regionIds.isEmpty() ){
+                cursorText.append( "Region: " + regionIds.join( ", " ) + "<br />" );
+            }
+        }
     }
     return cursorText;
 }
@@ -317,6 +330,26 @@ int Stack::_getSelectImageIndex() const {
     return selectImageIndex;
 }
 
+QStringList Stack::_getRegionIdsAt( double x, double y ) const {
+    QStringList regionIds;
+    std::vector<int> indices = m_regionIndex.getRegionsAt( x, y );
+    for ( int index : indices ){
+        //Regions loaded from a file are identified by the file path and an index.
+        QString regionId = QFileInfo( m_regions[index]->getUserId() ).fileName();
+        regionIds.append( regionId );
+    }
+    return regionIds;
+}
+
+std::vector<std::shared_ptr<const Carta::Lib::RegionMask> > Stack::_getRegionMasks() const {
+    int regionCount = m_regionIndex.getRegionCount();
+    std::vector<std::shared_ptr<const Carta::Lib::RegionMask> > masks( regionCount );
+    for ( int i = 0; i < regionCount; i++ ){
+        masks[i] = m_regionIndex.getMask( i );
+    }
+    return masks;
+}
+
 std::vector<Carta::Lib::RegionInfo> Stack::_getRegions() const {
     int regionCount = m_regions.size();
     std::vector<Carta::Lib::RegionInfo> regionInfos( regionCount );
@@ -458,6 +491,11 @@ QString Stack::_moveSelectedLayers( bool moveDown ){
     return result;
 }
 
+void Stack::_prefetchFrames( AxisInfo::KnownType axisType, const QList<int>& upcoming ){
+    std::vector<int> frames = _getFrameIndices();
+    LayerGroup::_prefetchFrames( frames, axisType, upcoming );
+}
+
 void Stack::_render( QList<std::shared_ptr<Layer> > datas, int gridIndex){
     std::vector<int> frames =_getFrameIndices();
     const Carta::Lib::KnownSkyCS& cs = _getCoordinateSystem();
@@ -531,11 +569,38 @@ void Stack::_resetStack( const Carta::State::StateInterface& restoreState ){
         std::shared_ptr<Region> region = RegionFactory::makeRegion( regionState );
         m_regions.append( region );
     }
+    _resetRegionIndex();
     _saveStateRegions();
     _saveState();
     emit viewLoad();
 }
 
+void Stack::_resetRegionIndex(){
+    //Region files can hold thousands of regions; rasterise them on the render
+    //threads in chunks and index them once they are all done.
+    const int CHUNK_SIZE = 64;
+    int regionCount = m_regions.size();
+    QList<QFuture<void> > futures;
+    for ( int start = CHUNK_SIZE; start < regionCount; start += CHUNK_SIZE ){
+        QList<std::shared_ptr<Region> > chunk = m_regions.mid( start, CHUNK_SIZE );
+        futures.append( QtConcurrent::run( Globals::instance()->renderPool(), [chunk] () {
+            for ( const std::shared_ptr<Region>& region : chunk ){
+                region->getMask();
+            }
+        }));
+    }
+    m_regionIndex.clear();
+    for ( int i = 0; i < regionCount && i < CHUNK_SIZE; i++ ){
+        m_regions[i]->getMask();
+    }
+    for ( QFuture<void>& future : futures ){
+        future.waitForFinished();
+    }
+    for ( int i = 0; i < regionCount; i++ ){
+        m_regionIndex.add( m_regions[i]->getMask() );
+    }
+}
+
 void Stack::_resetPan( bool panZoomAll ){
     if ( panZoomAll ){
         int dataCount = m_children.size();
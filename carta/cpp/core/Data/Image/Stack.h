@@ -9,6 +9,7 @@
 #include "CartaLib/IImage.h"
 #include "CartaLib/AxisInfo.h"
 #include "CartaLib/RegionInfo.h"
+#include "CartaLib/RegionIndex.h"
 
 namespace Carta {
 
@@ -76,7 +77,8 @@ private slots:
 
 private:
 
-    QString _addDataImage(const QString& fileName, bool* success );
+    QString _addDataImage(const QString& fileName, bool* success,
+            std::shared_ptr<Carta::Lib::Image::ImageInterface> image = nullptr );
     void _addDataRegions( std::vector<std::shared_ptr<Region>> regions );
 
     QString _closeRegion( const QString& regionId );
@@ -94,6 +96,10 @@ private:
     std::vector<int> _getImageSlice() const;
     int _getIndex( const QString& layerId) const;
      std::vector<Carta::Lib::RegionInfo> _getRegions() const;
+    std::vector<std::shared_ptr<const Carta::Lib::RegionMask> > _getRegionMasks() const;
+
+    //Returns the user ids of the regions containing the given image point.
+    QStringList _getRegionIdsAt( double x, double y ) const;
 
 
      int _getSelectImageIndex() const;
@@ -122,6 +128,13 @@ private:
 
 
     QString _moveSelectedLayers( bool moveDown );
+
+    /**
+     * Read and color map frames along the animated axis in the background.
+     * @param axisType - the axis that is being animated.
+     * @param upcoming - frame indices along the animated axis, most urgent first.
+     */
+    void _prefetchFrames( Carta::Lib::AxisInfo::KnownType axisType, const QList<int>& upcoming );
     void _render(QList<std::shared_ptr<Layer> > datas, int gridIndex);
     void _renderAll();
 
@@ -150,6 +163,9 @@ private:
     QString _saveImage( const QString& saveName );
 
 
+    //Rebuild the spatial index of the regions after they have changed.
+    void _resetRegionIndex();
+
     void _saveState( bool flush = true );
     void _saveStateRegions();
     bool _setCompositionMode( const QString& id, const QString& compositionMode,
@@ -187,6 +203,8 @@ private:
     Selection* m_selectImage;
     std::vector<Selection*> m_selects;
     QList<std::shared_ptr<Region> > m_regions;
+    //Masks of m_regions, in the same order.
+    Carta::Lib::RegionIndex m_regionIndex;
 
     /// Saves images
     SaveService *m_saveService;
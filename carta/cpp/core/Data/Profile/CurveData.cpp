@@ -127,8 +127,7 @@ void CurveData::_convertRestFrequency( const QString& oldUnits, const QString& n
 
 void CurveData::copy( const std::shared_ptr<CurveData> & other ){
     if ( other ){
-        m_plotDataX = other->m_plotDataX;
-        m_plotDataY = other->m_plotDataY;
+        m_plotData = other->m_plotData;
         m_region = other->m_region;
         m_imageSource = other->m_imageSource;
 
@@ -155,7 +154,9 @@ QColor CurveData::getColor() const {
 }
 
 QString CurveData::getCursorText( double x, double y, double* error ) const {
-    int dataCount = m_plotDataX.size();
+    const std::vector<double>& plotDataX = m_plotData.getX();
+    const std::vector<double>& plotDataY = m_plotData.getY();
+    int dataCount = plotDataX.size();
     //Normalize the error by the size of the data.
     double targetErrorX = 0;
     double targetErrorY = 0;
@@ -167,8 +168,8 @@ QString CurveData::getCursorText( double x, double y, double* error ) const {
     int selectedIndex = -1;
     double minErrorX = std::numeric_limits<double>::max();
     for ( int i = 0; i < dataCount; i++ ) {
-        double curveX = m_plotDataX[i];
-        double curveY = m_plotDataY[i];
+        double curveX = plotDataX[i];
+        double curveY = plotDataY[i];
 
         double errorX = fabs( curveX - x );
         double errorY = fabs( curveY - y );
@@ -184,12 +185,12 @@ QString CurveData::getCursorText( double x, double y, double* error ) const {
     //as a tooltip.
     QString toolTipStr;
     if ( selectedIndex >= 0 ){
-        *error = qSqrt( qPow( m_plotDataX[selectedIndex] - x, 2 )+ qPow(m_plotDataY[selectedIndex] - y, 2) );
+        *error = qSqrt( qPow( plotDataX[selectedIndex] - x, 2 )+ qPow(plotDataY[selectedIndex] - y, 2) );
         toolTipStr.append( "(" );
-        toolTipStr.append(QString::number( m_plotDataX[selectedIndex] ));
+        toolTipStr.append(QString::number( plotDataX[selectedIndex] ));
         //toolTipStr.append( " " +xUnit +", " );
         toolTipStr.append( ", ");
-        toolTipStr.append(QString::number( m_plotDataY[selectedIndex],'g',4 ));
+        toolTipStr.append(QString::number( plotDataY[selectedIndex],'g',4 ));
         //toolTipStr.append( " " + yUnit+ ")");
         toolTipStr.append( ")");
     }
@@ -204,10 +205,12 @@ std::shared_ptr<Carta::Lib::Image::ImageInterface> CurveData::getImage() const {
 
 void CurveData::getMinMax(double* xmin, double* xmax, double* ymin,
         double* ymax) const {
-    int maxPoints = m_plotDataX.size();
+    const std::vector<double>& plotDataX = m_plotData.getX();
+    const std::vector<double>& plotDataY = m_plotData.getY();
+    int maxPoints = plotDataX.size();
     for (int i = 0; i < maxPoints; ++i) {
-        double dx = m_plotDataX[i];
-        double dy = m_plotDataY[i];
+        double dx = plotDataX[i];
+        double dy = plotDataY[i];
         *xmin = (*xmin > dx) ? dx : *xmin;
         *xmax = (*xmax < dx) ? dx : *xmax;
         *ymin = (*ymin > dy) ? dy : *ymin;
@@ -236,13 +239,8 @@ QString CurveData::getNameRegion() const {
 }
 
 
-std::vector< std::pair<double, double> > CurveData::getPlotData() const {
-    int dataCount = m_plotDataX.size();
-    std::vector<std::pair<double,double> > data( dataCount );
-    for ( int i = 0; i < dataCount; i++ ){
-        data[i] = std::pair<double,double>( m_plotDataX[i], m_plotDataY[i] );
-    }
-    return data;
+Carta::Lib::CurveBuffer CurveData::getPlotData() const {
+    return m_plotData;
 }
 
 
@@ -286,12 +284,12 @@ QString CurveData::getStatistic() const {
     return m_state.getValue<QString>( STATISTIC );
 }
 
-std::vector<double> CurveData::getValuesX() const {
-    return m_plotDataX;
+const std::vector<double>& CurveData::getValuesX() const {
+    return m_plotData.getX();
 }
 
-std::vector<double> CurveData::getValuesY() const {
-    return m_plotDataY;
+const std::vector<double>& CurveData::getValuesY() const {
+    return m_plotData.getY();
 }
 
 
@@ -371,18 +369,21 @@ void CurveData::setColor( QColor color ){
 
 void CurveData::setData( const std::vector<double>& valsX, const std::vector<double>& valsY  ){
     CARTA_ASSERT( valsX.size() == valsY.size() );
-    m_plotDataX = valsX;
-    m_plotDataY = valsY;
+    m_plotData = Carta::Lib::CurveBuffer( valsX, valsY );
+}
+
+void CurveData::setData( const Carta::Lib::CurveBuffer& curve ){
+    m_plotData = curve;
 }
 
-void CurveData::setDataX( const std::vector<double>& valsX ){
-    CARTA_ASSERT( m_plotDataY.size() == valsX.size());
-    m_plotDataX = valsX;
+void CurveData::setDataX( std::vector<double> valsX ){
+    CARTA_ASSERT( m_plotData.size() == static_cast<int>( valsX.size() ) );
+    m_plotData.setX( std::move( valsX ) );
 }
 
-void CurveData::setDataY( const std::vector<double>& valsY ){
-    CARTA_ASSERT( m_plotDataX.size() == valsY.size());
-    m_plotDataY = valsY;
+void CurveData::setDataY( std::vector<double> valsY ){
+    CARTA_ASSERT( m_plotData.size() == static_cast<int>( valsY.size() ) );
+    m_plotData.setY( std::move( valsY ) );
 }
 
 
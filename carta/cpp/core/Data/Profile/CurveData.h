@@ -8,6 +8,7 @@
 #include "State/StateInterface.h"
 #include "CartaLib/IImage.h"
 #include "CartaLib/ProfileInfo.h"
+#include "CartaLib/CurveBuffer.h"
 #include <QColor>
 #include <QObject>
 
@@ -84,9 +85,9 @@ public:
 
     /**
      * Return the curve data.
-     * @return - the (x,y) pairs that make up the plot curve.
+     * @return - the points that make up the plot curve, sharing their storage.
      */
-    std::vector< std::pair<double, double> > getPlotData() const;
+    Carta::Lib::CurveBuffer getPlotData() const;
 
     /**
      * Return information for calculating a profile.
@@ -147,13 +148,13 @@ public:
      * Get the curve x-coordinates.
      * @return - the curve x-coordinate values.
      */
-    std::vector<double> getValuesX() const;
+    const std::vector<double>& getValuesX() const;
 
     /**
      * Get the curve y-coordinates.
      * @return - the curve y-coordinate values.
      */
-    std::vector<double> getValuesY() const;
+    const std::vector<double>& getValuesY() const;
 
     /**
      * Returns true if the identifier passed in matches this curve's identifier;
@@ -181,17 +182,23 @@ public:
      */
     void setData( const std::vector<double>& valsX, const std::vector<double>& valsY  );
 
+    /**
+     * Set the points that comprise the curve.
+     * @param curve - the points of the curve; their storage is shared.
+     */
+    void setData( const Carta::Lib::CurveBuffer& curve );
+
     /**
      * Set the x-values that comprise the curve.
      * @param valsX - the x-coordinate values of the curve.
      */
-    void setDataX( const std::vector<double>& valsX );
+    void setDataX( std::vector<double> valsX );
 
     /**
      * Set the y- data values that comprise the curve.
      * @param valsY - the y-coordinate values of the curve.
      */
-    void setDataY( const std::vector<double>& valsY );
+    void setDataY( std::vector<double> valsY );
 
     /**
      * Set the name of the layer that is the source of profile.
@@ -309,8 +316,7 @@ private:
     CurveData( const QString& path, const QString& id );
     class Factory;
 
-    std::vector<double> m_plotDataX;
-    std::vector<double> m_plotDataY;
+    Carta::Lib::CurveBuffer m_plotData;
     std::shared_ptr<Region> m_region;
 
     double m_restFrequency;
@@ -1,4 +1,6 @@
 #include "ProfileRenderThread.h"
+#include "CartaLib/CurveBuffer.h"
+#include "CartaLib/Trace.h"
 #include <QFile>
 #include <QDataStream>
 #include <QDebug>
@@ -19,6 +21,8 @@ Carta::Lib::Hooks::ProfileResult ProfileRenderThread::getResult() const {
 
 
 void ProfileRenderThread::run(){
+   // waits for the forked worker and reads its result
+   CARTA_TRACE_SCOPE( "profile", "ProfileRenderThread::run" );
    QFile file;
    if ( !file.open( m_fileDescriptor, QIODevice::ReadOnly, QFileDevice::AutoCloseHandle ) ){
        QString errorStr("Could not read Profile results");
@@ -27,6 +31,7 @@ void ProfileRenderThread::run(){
    }
    else {
        QDataStream dataStream( & file );
+       Carta::Lib::setNativeByteOrder( dataStream );
        dataStream >> m_result;
        file.close();
    }
@@ -1,7 +1,9 @@
 #include "ProfileRenderWorker.h"
 #include "Globals.h"
 #include "PluginManager.h"
+#include "CartaLib/Trace.h"
 #include "CartaLib/Hooks/ProfileHook.h"
+#include "CartaLib/CurveBuffer.h"
 #include <QFile>
 #include <QDataStream>
 #include <string.h>
@@ -44,7 +46,12 @@ int ProfileRenderWorker::computeProfile(){
         return -1;
     }
 
-    int pid = fork ();
+    // forking copies the page tables of the whole process
+    int pid = -1;
+    {
+        CARTA_TRACE_SCOPE( "profile", "fork" );
+        pid = fork ();
+    }
     if (pid == -1){
         // Failure
         qDebug() << "*** ProfileRenderWorker::run: fork failed: " << strerror (errno);
@@ -78,6 +85,7 @@ int ProfileRenderWorker::computeProfile(){
         return 0;
     }
     QDataStream dataStream( &file );
+    Carta::Lib::setNativeByteOrder( dataStream );
     dataStream << m_result;
     file.close();
     exit(0);
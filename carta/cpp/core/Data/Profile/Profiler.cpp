@@ -23,6 +23,7 @@
 #include "CartaLib/Hooks/Plot2DResult.h"
 #include "CartaLib/Hooks/ConversionIntensityHook.h"
 #include "CartaLib/Hooks/ConversionSpectralHook.h"
+#include "CartaLib/Hooks/ConversionInfoHook.h"
 #include "CartaLib/Hooks/ProfileHook.h"
 #include "CartaLib/AxisInfo.h"
 #include "CartaLib/ProfileInfo.h"
@@ -253,6 +254,13 @@ void Profiler::_convertX( std::vector<double>& converted,
         std::shared_ptr<Carta::Lib::Image::ImageInterface> dataSource,
         const QString& oldUnit, const QString& newUnit ) const {
     if ( dataSource ){
+        //Convert directly if we can, otherwise let the plugins do it.
+        Carta::Lib::UnitConversionPlan plan = Carta::Lib::UnitConversionPlan::spectral(
+                oldUnit, newUnit, _getConversionInfo( dataSource ) );
+        if ( plan.isValid() ){
+            plan.apply( converted );
+            return;
+        }
         auto result = Globals::instance()-> pluginManager()
                              -> prepare <Carta::Lib::Hooks::ConversionSpectralHook>(dataSource,
                                      oldUnit, newUnit, converted );
@@ -273,20 +281,30 @@ void Profiler::_convertX( std::vector<double>& converted,
 
 std::vector<double> Profiler::_convertUnitsY( std::shared_ptr<CurveData> curveData, const QString& newUnit ) const {
     std::vector<double> converted = curveData->getValuesY();
-    std::vector<double> plotDataX = curveData->getValuesX();
     QString leftUnit = m_state.getValue<QString>( AXIS_UNITS_LEFT );
     Controller* controller = _getControllerSelected();
     if ( controller ){
         std::shared_ptr<Carta::Lib::Image::ImageInterface> dataSource =
                 curveData->getSource();
         if ( dataSource ){
-            //First, we need to make sure the x-values are in Hertz.
-            QString hertzKey = UnitsSpectral::NAME_FREQUENCY + "(" + UnitsFrequency::UNIT_HZ + ")";
-            std::vector<double> hertzVals = _convertUnitsX( curveData, hertzKey );
             bool validBounds = false;
             std::pair<double,double> boundsY = m_plotManager->getPlotBoundsY( curveData->getName(), &validBounds );
             if ( validBounds ){
                 QString maxUnit = m_plotManager->getAxisUnitsY();
+                Carta::Lib::UnitConversionPlan plan = Carta::Lib::UnitConversionPlan::intensity(
+                        leftUnit, newUnit, boundsY.second, maxUnit, _getConversionInfo( dataSource ) );
+
+                //The x-values are only needed, in Hertz, for conversions involving Kelvin.
+                std::vector<double> hertzVals;
+                if ( !plan.isValid() || plan.needsAux() ){
+                    QString hertzKey = UnitsSpectral::NAME_FREQUENCY + "(" + UnitsFrequency::UNIT_HZ + ")";
+                    hertzVals = _convertUnitsX( curveData, hertzKey );
+                }
+                if ( plan.isValid() ){
+                    plan.apply( converted, hertzVals );
+                    return converted;
+                }
+
                 auto result = Globals::instance()-> pluginManager()
                                      -> prepare <Carta::Lib::Hooks::ConversionIntensityHook>(dataSource,
                                              leftUnit, newUnit, hertzVals, converted,
@@ -472,6 +490,43 @@ QString Profiler::getAxisUnitsBottom() const {
 }
 
 
+Carta::Lib::UnitConversionInfo Profiler::_getConversionInfo(
+        std::shared_ptr<Carta::Lib::Image::ImageInterface> dataSource ) const {
+    //Forget images that are gone while looking for this one.
+    for ( auto iter = m_conversionInfos.begin(); iter != m_conversionInfos.end(); ){
+        std::shared_ptr<Carta::Lib::Image::ImageInterface> image = iter->first.lock();
+        if ( !image ){
+            iter = m_conversionInfos.erase( iter );
+        }
+        else if ( image == dataSource ){
+            return iter->second;
+        }
+        else {
+            ++iter;
+        }
+    }
+    Carta::Lib::UnitConversionInfo info;
+    if ( dataSource ){
+        auto result = Globals::instance()-> pluginManager()
+                             -> prepare <Carta::Lib::Hooks::ConversionInfoHook>( dataSource );
+        auto lam = [&info] ( const Carta::Lib::Hooks::ConversionInfoHook::ResultType &data ) {
+            info.merge( data );
+        };
+        try {
+            result.forEach( lam );
+        }
+        catch( char*& error ){
+            QString errorStr( error );
+            ErrorManager* hr = Util::findSingletonObject<ErrorManager>();
+            hr->registerError( errorStr );
+        }
+        m_conversionInfos.push_back( std::make_pair(
+                std::weak_ptr<Carta::Lib::Image::ImageInterface>( dataSource ), info ) );
+    }
+    return info;
+}
+
+
 Controller* Profiler::_getControllerSelected() const {
     //We are only supporting one linked controller.
     Controller* controller = nullptr;
@@ -1244,17 +1299,8 @@ void Profiler::_profileRendered(const Carta::Lib::Hooks::ProfileResult& result,
         hr->registerError( errorMessage );
     }
     else {
-        std::vector< std::pair<double,double> > data = result.getData();
-        int dataCount = data.size();
-        if ( dataCount > 0 ){
-            std::vector<double> plotDataX( dataCount );
-            std::vector<double> plotDataY( dataCount );
-
-            for( int i = 0 ; i < dataCount; i ++ ){
-                plotDataX[i] = data[i].first;
-                plotDataY[i] = data[i].second;
-            }
-
+        Carta::Lib::CurveBuffer curve = result.getCurve();
+        if ( !curve.isEmpty() ){
             std::shared_ptr<CurveData> profileCurve( nullptr );
             if ( curveIndex < 0 || createNew ){
                 Carta::State::ObjectManager* objMan = Carta::State::ObjectManager::objectManager();
@@ -1275,7 +1321,7 @@ void Profiler::_profileRendered(const Carta::Lib::Hooks::ProfileResult& result,
                 profileCurve = m_plotCurves[curveIndex];
             }
 
-            profileCurve->setData( plotDataX, plotDataY );
+            profileCurve->setData( curve );
             _saveCurveState();
             _updateZoomRangeBasedOnPercent();
             _updatePlotBounds();
@@ -1356,7 +1402,7 @@ QString Profiler::setAxisUnitsBottom( const QString& unitStr ){
             int curveCount = m_plotCurves.size();
             for ( int i = 0; i < curveCount; i++ ){
                 std::vector<double> converted = _convertUnitsX( m_plotCurves[i], actualUnits );
-                m_plotCurves[i]->setDataX( converted );
+                m_plotCurves[i]->setDataX( std::move( converted ) );
             }
 
             //Update the state & graph
@@ -1393,7 +1439,7 @@ QString Profiler::setAxisUnitsLeft( const QString& unitStr ){
             int curveCount = m_plotCurves.size();
             for ( int i = 0; i < curveCount; i++ ){
                 std::vector<double> converted = _convertUnitsY( m_plotCurves[i], actualUnits );
-                m_plotCurves[i]->setDataY( converted );
+                m_plotCurves[i]->setDataY( std::move( converted ) );
             }
             //Update the state and plot
             m_state.setValue<QString>( AXIS_UNITS_LEFT, actualUnits );
@@ -1910,7 +1956,7 @@ void Profiler::_updatePlotData(){
     int curveCount = m_plotCurves.size();
     //Put the data into the plot.
     for ( int i = 0; i < curveCount; i++ ){
-        std::vector< std::pair<double,double> > plotData = m_plotCurves[i]->getPlotData();
+        Carta::Lib::CurveBuffer plotData = m_plotCurves[i]->getPlotData();
         QString dataId = m_plotCurves[i]->getName();
         Carta::Lib::Hooks::Plot2DResult plotResult( dataId, "", "", plotData );
         m_plotManager->addData( &plotResult );
@@ -11,6 +11,7 @@
 #include "Data/ILinkable.h"
 #include "CartaLib/IImage.h"
 #include "CartaLib/Hooks/ProfileResult.h"
+#include "CartaLib/UnitConversionPlan.h"
 
 #include <QObject>
 
@@ -364,6 +365,11 @@ private:
     std::vector<double> _convertUnitsY( std::shared_ptr<CurveData> curveData,
             const QString& newUnit ) const;
 
+    //What the unit conversion plans need to know about an image.  The plugins
+    //are only asked once per image.
+    Carta::Lib::UnitConversionInfo _getConversionInfo(
+            std::shared_ptr<Carta::Lib::Image::ImageInterface> dataSource ) const;
+
     void _generateData( std::shared_ptr<Layer> layer, bool createNew = false );
     void _generateData( std::shared_ptr<Carta::Lib::Image::ImageInterface> image,
              int curveIndex, const QString& layerName, bool createNew = false );
@@ -426,6 +432,10 @@ private:
     //Plot data
     QList< std::shared_ptr<CurveData> > m_plotCurves;
 
+    //Unit conversion information for the images of the curves.
+    mutable std::vector< std::pair< std::weak_ptr<Carta::Lib::Image::ImageInterface>,
+        Carta::Lib::UnitConversionInfo > > m_conversionInfos;
+
     //For a movie.
     int m_oldFrame;
     int m_currentFrame;
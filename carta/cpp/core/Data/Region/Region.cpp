@@ -46,25 +46,22 @@ void Region::addCorners( const std::vector< std::pair<double,double> >& corners
         m_state.insertValue<double>( yLookup, corners[i].second );
     }
     m_state.flushState();
+    _resetInfo();
 }
 
 std::shared_ptr<Carta::Lib::RegionInfo> Region::getInfo() const {
-    std::shared_ptr<Carta::Lib::RegionInfo> info( new Carta::Lib::RegionInfo() );
-    info->setRegionType( getRegionType() );
-    int cornerCount = m_state.getArraySize( CORNERS );
-    std::vector< std::pair<double,double> > corners( cornerCount );
-    for( int i = 0; i < cornerCount; i++ ){
-        QString eleLookup = Carta::State::UtilState::getLookup( CORNERS, i );
-        QString xLookup = Carta::State::UtilState::getLookup( eleLookup, Util::XCOORD );
-        QString yLookup = Carta::State::UtilState::getLookup( eleLookup, Util::YCOORD );
-        double xValue = m_state.getValue<double>( xLookup );
-        double yValue = m_state.getValue<double>( yLookup );
-        corners[i] = std::pair<double,double>( xValue, yValue );
-    }
-    info->setCorners( corners );
+    std::shared_ptr<Carta::Lib::RegionInfo> info( new Carta::Lib::RegionInfo( m_info ) );
     return info;
 }
 
+std::shared_ptr<const Carta::Lib::RegionMask> Region::getMask() const {
+    QMutexLocker locker( &m_maskMutex );
+    if ( !m_mask ){
+        m_mask.reset( new Carta::Lib::RegionMask( Carta::Lib::RegionMask::rasterize( m_info ) ) );
+    }
+    return m_mask;
+}
+
 Carta::Lib::RegionInfo::RegionType Region::getRegionType( const QString& regionTypeStr ){
     Carta::Lib::RegionInfo::RegionType regionType = Carta::Lib::RegionInfo::RegionType::Unknown;
     int result = QString::compare( regionTypeStr, REGION_POLYGON, Qt::CaseInsensitive );
@@ -90,6 +87,10 @@ QString Region::_getStateString() const {
     return m_state.toString();
 }
 
+QString Region::getUserId() const {
+    return m_state.getValue<QString>( Util::ID );
+}
+
 
 void Region::_initializeCallbacks(){
     addCommandCallback( "shapeChanged", [=] (const QString & /*cmd*/,
@@ -106,6 +107,7 @@ void Region::_initializeState(){
     m_state.insertValue<QString>( Util::ID, "");
     m_state.insertArray( CORNERS, 0 );
     m_state.flushState();
+    _resetInfo();
 }
 
 bool Region::_isMatch( const QString& id ) const {
@@ -139,6 +141,24 @@ void Region::_restoreState( const QString& stateStr ){
         m_state.insertValue<double>( yLookup, yValue );
     }
     m_state.flushState();
+    _resetInfo();
+}
+
+void Region::_resetInfo(){
+    m_info.setRegionType( getRegionType() );
+    int cornerCount = m_state.getArraySize( CORNERS );
+    std::vector< std::pair<double,double> > corners( cornerCount );
+    for( int i = 0; i < cornerCount; i++ ){
+        QString eleLookup = Carta::State::UtilState::getLookup( CORNERS, i );
+        QString xLookup = Carta::State::UtilState::getLookup( eleLookup, Util::XCOORD );
+        QString yLookup = Carta::State::UtilState::getLookup( eleLookup, Util::YCOORD );
+        double xValue = m_state.getValue<double>( xLookup );
+        double yValue = m_state.getValue<double>( yLookup );
+        corners[i] = std::pair<double,double>( xValue, yValue );
+    }
+    m_info.setCorners( corners );
+    QMutexLocker locker( &m_maskMutex );
+    m_mask.reset();
 }
 
 void Region::setRegionType( Carta::Lib::RegionInfo::RegionType regionType ){
@@ -157,6 +177,7 @@ void Region::setRegionType( Carta::Lib::RegionInfo::RegionType regionType ){
     if ( !regionTypeStr.isEmpty() && regionTypeStr != oldRegionTypeStr ){
         m_state.setValue<QString>( REGION_TYPE, regionTypeStr );
         m_state.flushState();
+        _resetInfo();
     }
 }
 
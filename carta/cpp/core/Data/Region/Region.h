@@ -7,6 +7,9 @@
 #include "State/StateInterface.h"
 #include "State/ObjectManager.h"
 #include "CartaLib/RegionInfo.h"
+#include "CartaLib/RegionMask.h"
+
+#include <QMutex>
 
 namespace Carta {
 
@@ -30,6 +33,20 @@ public:
      */
     std::shared_ptr<Carta::Lib::RegionInfo> getInfo() const;
 
+    /**
+     * Return the pixels of the region.  The mask is computed the first time it is
+     * asked for and kept until the region changes; this method may be called from
+     * several threads at once.
+     * @return - the rasterised region.
+     */
+    std::shared_ptr<const Carta::Lib::RegionMask> getMask() const;
+
+    /**
+     * Return the identifier of the region shown to the user.
+     * @return - the file name and index of a region loaded from a file.
+     */
+    QString getUserId() const;
+
     /**
      * Return the RegionType corresponding to the given string representation.
      * @param regionTypeStr - a string representation of a region shape such as "ellipse".
@@ -80,6 +97,9 @@ private:
     void _initializeCallbacks();
     void _initializeState();
 
+    //Rebuild the cached region information from the state.
+    void _resetInfo();
+
     /**
      * Return the region state as a string.
      * @return - the region state as a string.
@@ -105,6 +125,13 @@ private:
     // is created graphically, the id will be just an index.
     void _setUserId( const QString& fileName, int index );
 
+    //The corners and type of the region, kept so they do not have to be looked
+    //up in the state each time.
+    Carta::Lib::RegionInfo m_info;
+
+    mutable QMutex m_maskMutex;
+    mutable std::shared_ptr<const Carta::Lib::RegionMask> m_mask;
+
     Region( const Region& other);
     Region& operator=( const Region& other );
 
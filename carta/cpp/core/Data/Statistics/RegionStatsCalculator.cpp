@@ -0,0 +1,325 @@
+#include "RegionStatsCalculator.h"
+#include "Data/Image/ImageRegistry.h"
+#include "CartaLib/Algorithms/RegionStatistics.h"
+#include "CartaLib/ICoordinateFormatter.h"
+#include "CartaLib/IImage.h"
+
+#include <QDebug>
+#include <QMutexLocker>
+#include <QStringList>
+#include <QThread>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <algorithm>
+
+namespace Carta {
+
+namespace Data {
+
+const int RegionStatsCalculator::CHUNK_SIZE = 32;
+
+//Everything a computation needs, shared by its tasks.
+struct RegionStatsCalculator::Job {
+    int generation = 0;
+    std::vector<std::shared_ptr<Carta::Lib::Image::ImageInterface> > images;
+    std::vector<Carta::Lib::RegionInfo> regions;
+    std::vector<std::shared_ptr<const Carta::Lib::RegionMask> > masks;
+    std::vector<int> frameIndices;
+    std::vector<double> beamAreas;
+    //Read lock of each image.
+    std::vector<std::shared_ptr<QMutex> > readLocks;
+    //A coordinate formatter for each image and chunk of regions; formatters are not
+    //thread safe, so they are made up front and each is only used by its chunk.
+    std::vector<std::vector<CoordinateFormatterInterface::SharedPtr> > formatters;
+};
+
+//The current plane of an image, x varies fastest.
+struct RegionStatsCalculator::Plane {
+    std::vector<float> data;
+    int width = 0;
+    int height = 0;
+    //Image axes of the plane.
+    int axisX = 0;
+    int axisY = 1;
+    //Frame of every image axis, the plane axes are zero.
+    std::vector<int> frames;
+};
+
+RegionStatsCalculator::RegionStatsCalculator( QObject* parent ) :
+    QObject( parent ),
+    m_generation( 0 ){
+    m_pool.setMaxThreadCount( std::max( QThread::idealThreadCount(), 1 ) );
+}
+
+void RegionStatsCalculator::cancel(){
+    QMutexLocker locker( &m_mutex );
+    m_generation++;
+    m_results.clear();
+}
+
+void RegionStatsCalculator::_computeImage( std::shared_ptr<Job> job, int imageIndex ){
+    if ( job->generation != m_generation ){
+        return;
+    }
+    std::shared_ptr<Carta::Lib::Image::ImageInterface> image = job->images[imageIndex];
+    const std::vector<int>& dims = image->dims();
+    int dimCount = dims.size();
+    if ( dimCount < 2 ){
+        return;
+    }
+
+    //The plane axes are the ones marked -1 in the frame indices; images without
+    //frame information use their first two axes.
+    std::shared_ptr<Plane> plane( new Plane() );
+    plane->frames.resize( dimCount, 0 );
+    std::vector<int> planeAxes;
+    for ( int i = 0; i < dimCount; i++ ){
+        int frame = i < static_cast<int>( job->frameIndices.size() ) ? job->frameIndices[i] : 0;
+        if ( frame < 0 ){
+            planeAxes.push_back( i );
+        }
+        else {
+            plane->frames[i] = std::min( frame, dims[i] - 1 );
+        }
+    }
+    if ( planeAxes.size() != 2 ){
+        planeAxes = { 0, 1 };
+        for ( int i = 0; i < 2; i++ ){
+            plane->frames[i] = 0;
+        }
+    }
+    plane->axisX = planeAxes[0];
+    plane->axisY = planeAxes[1];
+    plane->width = dims[plane->axisX];
+    plane->height = dims[plane->axisY];
+
+    //Other views may be reading the same image.
+    QMutexLocker readLocker( job->readLocks[imageIndex].get() );
+    Carta::Lib::NdArray::RawViewInterface* rawData = nullptr;
+    try {
+        SliceND planeSlice;
+        for ( int i = 0; i < dimCount; i++ ){
+            if ( i != plane->axisX && i != plane->axisY ){
+                planeSlice.start( plane->frames[i] );
+                planeSlice.end( plane->frames[i] + 1 );
+            }
+            if ( i < dimCount - 1 ){
+                planeSlice.next();
+            }
+        }
+        rawData = image->getDataSlice( planeSlice );
+    }
+    catch( ... ){
+        rawData = nullptr;
+    }
+    if ( rawData == nullptr ){
+        qWarning() << "Could not read the image plane for region statistics";
+        return;
+    }
+    plane->data.reserve( static_cast<size_t>( plane->width ) * plane->height );
+    Carta::Lib::NdArray::TypedView<float> view( rawData, true );
+    std::vector<float>& data = plane->data;
+    view.forEach( [&data] ( const float& val ) {
+        data.push_back( val );
+    });
+    readLocker.unlock();
+
+    int regionCount = job->masks.size();
+    for ( int first = 0; first < regionCount; first += CHUNK_SIZE ){
+        int count = std::min( CHUNK_SIZE, regionCount - first );
+        QtConcurrent::run( &m_pool, this, &RegionStatsCalculator::_computeRegions,
+                job, imageIndex, plane, first, count );
+    }
+}
+
+void RegionStatsCalculator::_computeRegions( std::shared_ptr<Job> job, int imageIndex,
+        std::shared_ptr<Plane> plane, int firstRegion, int regionCount ){
+    QList<Result> results;
+    for ( int i = firstRegion; i < firstRegion + regionCount; i++ ){
+        if ( job->generation != m_generation ){
+            return;
+        }
+        Result result;
+        result.imageIndex = imageIndex;
+        result.regionIndex = i;
+        result.stats = _makeStats( *job, imageIndex, *plane, i );
+        results.append( result );
+    }
+    {
+        QMutexLocker locker( &m_mutex );
+        if ( job->generation != m_generation ){
+            return;
+        }
+        m_results.append( results );
+    }
+    emit statsAvailable();
+}
+
+QList<Carta::Lib::StatInfo> RegionStatsCalculator::_makeStats( const Job& job, int imageIndex,
+        const Plane& plane, int regionIndex ){
+    QList<Carta::Lib::StatInfo> stats;
+    std::shared_ptr<const Carta::Lib::RegionMask> mask = job.masks[regionIndex];
+    if ( !mask ){
+        return stats;
+    }
+    Carta::Lib::Algorithms::RegionMoments moments = Carta::Lib::Algorithms::accumulateRegion(
+            *mask, plane.data.data(), plane.width, plane.height );
+    if ( moments.count == 0 ){
+        return stats;
+    }
+
+    //Pixel positions over all image axes.
+    QRect box = mask->getBoundingBox().intersected( QRect( 0, 0, plane.width, plane.height ) );
+    auto position = [&plane] ( int x, int y ) -> std::vector<int> {
+        std::vector<int> pos = plane.frames;
+        pos[plane.axisX] = x;
+        pos[plane.axisY] = y;
+        return pos;
+    };
+    auto toString = [] ( const std::vector<int>& pos ) -> QString {
+        QStringList values;
+        for ( int val : pos ){
+            values.append( QString::number( val ) );
+        }
+        return "[" + values.join( ", " ) + "]";
+    };
+    std::vector<int> blc = position( box.left(), box.top() );
+    std::vector<int> trc = position( box.right(), box.bottom() );
+    std::vector<int> minPos = position( moments.minX, moments.minY );
+    std::vector<int> maxPos = position( moments.maxX, moments.maxY );
+
+    auto insert = [&stats] ( Carta::Lib::StatInfo::StatType statType, const QString& value ) {
+        Carta::Lib::StatInfo info( statType );
+        info.setValue( value );
+        stats.append( info );
+    };
+    insert( Carta::Lib::StatInfo::StatType::FrameCount, QString::number( moments.count ) );
+    insert( Carta::Lib::StatInfo::StatType::Sum, QString::number( moments.sum ) );
+    insert( Carta::Lib::StatInfo::StatType::SumSq, QString::number( moments.sumSq ) );
+    insert( Carta::Lib::StatInfo::StatType::Min, QString::number( moments.min ) );
+    insert( Carta::Lib::StatInfo::StatType::Max, QString::number( moments.max ) );
+    insert( Carta::Lib::StatInfo::StatType::Mean, QString::number( moments.mean() ) );
+    insert( Carta::Lib::StatInfo::StatType::Sigma, QString::number( moments.sigma() ) );
+    insert( Carta::Lib::StatInfo::StatType::RMS, QString::number( moments.rms() ) );
+    double beamArea = imageIndex < static_cast<int>( job.beamAreas.size() ) ? job.beamAreas[imageIndex] : 0;
+    if ( beamArea > 0 ){
+        insert( Carta::Lib::StatInfo::StatType::FluxDensity, QString::number( moments.sum / beamArea ) );
+    }
+    insert( Carta::Lib::StatInfo::StatType::Blc, toString( blc ) );
+    insert( Carta::Lib::StatInfo::StatType::Trc, toString( trc ) );
+    insert( Carta::Lib::StatInfo::StatType::MinPos, toString( minPos ) );
+    insert( Carta::Lib::StatInfo::StatType::MaxPos, toString( maxPos ) );
+
+    //World coordinates, with the formatter of the chunk.  The four positions are
+    //converted in one batch.
+    CoordinateFormatterInterface::SharedPtr cf = job.formatters[imageIndex][regionIndex / CHUNK_SIZE];
+    int axisCount = static_cast<int>( plane.frames.size() );
+    if ( cf && cf->nAxes() == axisCount ){
+        const std::vector<int>* positions[] = { &blc, &trc, &minPos, &maxPos };
+        const Carta::Lib::StatInfo::StatType worldTypes[] = {
+                Carta::Lib::StatInfo::StatType::Blcf, Carta::Lib::StatInfo::StatType::Trcf,
+                Carta::Lib::StatInfo::StatType::MinPosf, Carta::Lib::StatInfo::StatType::MaxPosf };
+        std::vector<double> pixels;
+        for ( const std::vector<int>* pos : positions ){
+            pixels.insert( pixels.end(), pos->begin(), pos->end() );
+        }
+        std::vector<double> worlds;
+        std::vector<bool> valid;
+        cf->toWorldBatch( pixels, worlds, &valid );
+        int worldAxisCount = worlds.size() / 4;
+        for ( int i = 0; i < 4; i++ ){
+            QString value;
+            if ( valid[i] ){
+                std::vector<double> world( worlds.begin() + i * worldAxisCount,
+                        worlds.begin() + ( i + 1 ) * worldAxisCount );
+                value = cf->formatFromWorldCoordinate( world ).join( ", " );
+            }
+            insert( worldTypes[i], value );
+        }
+    }
+
+    //Put in an identifier.
+    const Carta::Lib::RegionInfo& region = job.regions[regionIndex];
+    QString regionType = "Polygon";
+    if ( region.getRegionType() == Carta::Lib::RegionInfo::RegionType::Ellipse ){
+        regionType = "Ellipse";
+    }
+    else {
+        int cornerCount = region.getCorners().size();
+        if ( cornerCount == 1 ){
+            regionType = "Point";
+        }
+        else if ( cornerCount == 4 ){
+            regionType = "Rectangle";
+        }
+    }
+    QString blcVal = toString( blc );
+    QString trcVal = toString( trc );
+    QString idVal = regionType + ":" + blcVal;
+    if ( blcVal != trcVal ){
+        idVal = idVal + " x " + trcVal;
+    }
+    Carta::Lib::StatInfo info( Carta::Lib::StatInfo::StatType::Name );
+    info.setValue( idVal );
+    info.setImageStat( false );
+    stats.append( info );
+    return stats;
+}
+
+void RegionStatsCalculator::start( const std::vector<std::shared_ptr<Carta::Lib::Image::ImageInterface> >& images,
+        const std::vector<Carta::Lib::RegionInfo>& regions,
+        const std::vector<std::shared_ptr<const Carta::Lib::RegionMask> >& masks,
+        const std::vector<int>& frameIndices, const std::vector<double>& beamAreas ){
+    std::shared_ptr<Job> job( new Job() );
+    {
+        QMutexLocker locker( &m_mutex );
+        m_generation++;
+        m_results.clear();
+        job->generation = m_generation;
+    }
+    job->images = images;
+    job->regions = regions;
+    job->masks = masks;
+    job->regions.resize( masks.size() );
+    job->frameIndices = frameIndices;
+    job->beamAreas = beamAreas;
+    if ( masks.empty() ){
+        return;
+    }
+    int imageCount = images.size();
+    int chunkCount = ( masks.size() + CHUNK_SIZE - 1 ) / CHUNK_SIZE;
+    job->readLocks.resize( imageCount );
+    job->formatters.resize( imageCount );
+    for ( int i = 0; i < imageCount; i++ ){
+        if ( images[i] ){
+            job->readLocks[i] = ImageRegistry::instance()->getReadLock( images[i].get() );
+            for ( int j = 0; j < chunkCount; j++ ){
+                job->formatters[i].push_back( CoordinateFormatterInterface::SharedPtr(
+                        images[i]->metaData()->coordinateFormatter()->clone() ) );
+            }
+        }
+    }
+    for ( int i = 0; i < imageCount; i++ ){
+        if ( images[i] ){
+            QtConcurrent::run( &m_pool, this, &RegionStatsCalculator::_computeImage, job, i );
+        }
+    }
+}
+
+QList<RegionStatsCalculator::Result> RegionStatsCalculator::takeResults(){
+    QMutexLocker locker( &m_mutex );
+    QList<Result> results;
+    results.swap( m_results );
+    return results;
+}
+
+void RegionStatsCalculator::waitForDone(){
+    m_pool.waitForDone();
+}
+
+RegionStatsCalculator::~RegionStatsCalculator(){
+    cancel();
+    m_pool.waitForDone();
+}
+}
+}
@@ -0,0 +1,117 @@
+/***
+ * Computes the statistics of many regions on the current planes of a set of images.
+ *
+ * Each image plane is read once and the regions are accumulated from their rasterised
+ * masks, in chunks spread over a thread pool. Results are handed out as the chunks
+ * finish, so a region file with thousands of regions shows statistics progressively
+ * rather than after all of them have been computed.
+ */
+
+#pragma once
+
+#include "CartaLib/RegionInfo.h"
+#include "CartaLib/RegionMask.h"
+#include "CartaLib/StatInfo.h"
+
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QThreadPool>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace Carta {
+namespace Lib {
+namespace Image {
+class ImageInterface;
+}
+}
+}
+
+namespace Carta {
+
+namespace Data {
+
+class RegionStatsCalculator : public QObject {
+
+    Q_OBJECT
+
+public:
+
+    //Statistics of one region on one image.
+    struct Result {
+        int imageIndex = -1;
+        int regionIndex = -1;
+        QList<Carta::Lib::StatInfo> stats;
+    };
+
+    RegionStatsCalculator( QObject* parent = nullptr );
+
+    /**
+     * Start computing region statistics; results of an earlier computation that
+     * have not been taken yet are discarded.  The image planes are read under the
+     * read locks of the images.
+     * @param images - the images.
+     * @param regions - information about the regions (used for labelling).
+     * @param masks - the rasterised regions, in the same order as the regions.
+     * @param frameIndices - the current frame of each image axis, -1 for the display axes.
+     * @param beamAreas - the beam area in pixels of each image, zero if there is no beam.
+     */
+    void start( const std::vector<std::shared_ptr<Carta::Lib::Image::ImageInterface> >& images,
+            const std::vector<Carta::Lib::RegionInfo>& regions,
+            const std::vector<std::shared_ptr<const Carta::Lib::RegionMask> >& masks,
+            const std::vector<int>& frameIndices, const std::vector<double>& beamAreas );
+
+    /**
+     * Stop the current computation.
+     */
+    void cancel();
+
+    /**
+     * Return the results computed since the last call.
+     * @return - statistics of the regions that have finished.
+     */
+    QList<Result> takeResults();
+
+    /**
+     * Wait for all background work to finish.
+     */
+    void waitForDone();
+
+    //Number of regions handled by one task.
+    static const int CHUNK_SIZE;
+
+    virtual ~RegionStatsCalculator();
+
+signals:
+
+    //New results can be taken.
+    void statsAvailable();
+
+private:
+
+    struct Job;
+    struct Plane;
+
+    //Read the plane of an image and queue the region chunks (background thread).
+    void _computeImage( std::shared_ptr<Job> job, int imageIndex );
+
+    //Accumulate the statistics of some regions (background thread).
+    void _computeRegions( std::shared_ptr<Job> job, int imageIndex,
+            std::shared_ptr<Plane> plane, int firstRegion, int regionCount );
+
+    static QList<Carta::Lib::StatInfo> _makeStats( const Job& job, int imageIndex,
+            const Plane& plane, int regionIndex );
+
+    QMutex m_mutex;
+    QList<Result> m_results;
+    std::atomic<int> m_generation;
+    QThreadPool m_pool;
+
+    RegionStatsCalculator( const RegionStatsCalculator& other);
+    RegionStatsCalculator& operator=( const RegionStatsCalculator& other );
+};
+}
+}
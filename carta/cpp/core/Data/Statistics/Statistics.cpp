@@ -1,8 +1,10 @@
 #include "Statistics.h"
+#include "RegionStatsCalculator.h"
 #include "Data/Settings.h"
 #include "Data/LinkableImpl.h"
 #include "Data/Image/Controller.h"
 #include "Data/Image/DataSource.h"
+#include "Data/Image/ImageRegistry.h"
 #include "Data/Error/ErrorManager.h"
 #include "Data/Util.h"
 
@@ -48,6 +50,7 @@ using Carta::State::StateInterface;
 Statistics::Statistics( const QString& path, const QString& id):
             CartaObject( CLASS_NAME, path, id ),
             m_linkImpl( new LinkableImpl( path )),
+            m_regionStats( new RegionStatsCalculator() ),
             //Store region and image selection
             m_stateData( UtilState::getLookup(path, StateInterface::STATE_DATA )){
 
@@ -57,6 +60,7 @@ Statistics::Statistics( const QString& path, const QString& id):
 
     _initializeDefaultState();
     _initializeCallbacks();
+    connect( m_regionStats.get(), SIGNAL(statsAvailable()), this, SLOT(_regionStatsAvailable()) );
 }
 
 
@@ -355,6 +359,7 @@ QString Statistics::removeLink( CartaObject* cartaObject){
         if ( removed ){
             controller->disconnect(this);
             m_controllerLinked = false;
+            m_regionStats->cancel();
             m_stateData.resizeArray( STATS, 0 );
         }
     }
@@ -428,6 +433,34 @@ QString Statistics::setStatVisible( bool showStat, const QString& statName,
 }
 
 
+void Statistics::_regionStatsAvailable(){
+    QList<RegionStatsCalculator::Result> results = m_regionStats->takeResults();
+    if ( results.isEmpty() ){
+        return;
+    }
+    int imageCount = m_stateData.getArraySize( STATS );
+    for ( const RegionStatsCalculator::Result& result : results ){
+        if ( result.imageIndex >= imageCount ){
+            continue;
+        }
+        //The image statistics come first, followed by one entry for each region.
+        QString arrayLookup = UtilState::getLookup( STATS, result.imageIndex );
+        int statIndex = result.regionIndex + 1;
+        if ( statIndex >= m_stateData.getArraySize( arrayLookup ) ){
+            continue;
+        }
+        QString objLookup = UtilState::getLookup( arrayLookup, statIndex );
+        int keyCount = result.stats.size();
+        for ( int j = 0; j < keyCount; j++ ){
+            QString label = result.stats[j].getLabel();
+            QString lookup = UtilState::getLookup( objLookup, label );
+            m_stateData.insertValue<QString>( lookup, result.stats[j].getValue() );
+        }
+    }
+    m_stateData.flushState();
+}
+
+
 void Statistics::_updateStatistics( Controller* controller, Carta::Lib::AxisInfo::KnownType /*type*/  ){
     if ( controller != nullptr ){
 
@@ -437,36 +470,51 @@ void Statistics::_updateStatistics( Controller* controller, Carta::Lib::AxisInfo
         std::vector< std::shared_ptr<Carta::Lib::Image::ImageInterface> > dataSources =
                 controller->getImages();
 
-
-
         std::vector<Carta::Lib::RegionInfo> regions = controller->getRegions();
+        std::vector<std::shared_ptr<const Carta::Lib::RegionMask> > masks = controller->getRegionMasks();
+        int regionCount = masks.size();
 
         std::vector<int> frameIndices = controller->getImageSlice();
 
         int sourceCount = dataSources.size();
+        std::vector<double> beamAreas( sourceCount, 0 );
         if ( sourceCount > 0 ){
+            //Only the image statistics come from the plugin; the regions are computed
+            //here from their masks, all of them in one pass over each image plane.
+            std::vector<Carta::Lib::RegionInfo> noRegions;
+            //The plugin reads the images, which other views may be reading as well.
+            std::vector<std::shared_ptr<QMutex> > readLocks;
+            std::vector<std::unique_ptr<QMutexLocker> > readLockers;
+            for ( int i = 0; i < sourceCount; i++ ){
+                readLocks.push_back( ImageRegistry::instance()->getReadLock( dataSources[i].get() ) );
+                readLockers.emplace_back( new QMutexLocker( readLocks.back().get() ) );
+            }
             auto result = Globals::instance()-> pluginManager()
-                         -> prepare <Carta::Lib::Hooks::ImageStatisticsHook>(dataSources, regions, frameIndices);
-            auto lam = [=] ( const Carta::Lib::Hooks::ImageStatisticsHook::ResultType &data ) {
+                         -> prepare <Carta::Lib::Hooks::ImageStatisticsHook>(dataSources, noRegions, frameIndices);
+            auto lam = [=, &beamAreas] ( const Carta::Lib::Hooks::ImageStatisticsHook::ResultType &data ) {
 
                 //An array for each image
                 int dataCount = data.size();
                 m_stateData.resizeArray( STATS, dataCount );
                 for ( int i = 0; i < dataCount; i++ ){
-                    //Each element of the image array contains an array of statistics.
+                    //Each element of the image array contains an array of statistics,
+                    //the image statistics followed by those of the regions.
                     QString arrayLookup = UtilState::getLookup( STATS, i );
                     int statCount = data[i].size();
-                    m_stateData.setArray( arrayLookup, statCount );
+                    m_stateData.setArray( arrayLookup, statCount + regionCount );
 
                     //Go through each set of statistics for the image.
                     for ( int k = 0; k < statCount; k++ ){
                         QString objLookup = UtilState::getLookup( arrayLookup, k );
-                        QList<QString> existingKeys = m_stateData.getMemberNames( objLookup );
                         int keyCount = data[i][k].size();
                         for ( int j = 0; j < keyCount; j++ ){
                             QString label = data[i][k][j].getLabel();
                             QString lookup = UtilState::getLookup( objLookup, label );
                             m_stateData.insertValue<QString>( lookup, data[i][k][j].getValue() );
+                            if ( data[i][k][j].getType() == Carta::Lib::StatInfo::StatType::BeamArea &&
+                                    i < sourceCount ){
+                                beamAreas[i] = data[i][k][j].getValue().toDouble();
+                            }
                         }
                     }
                 }
@@ -479,9 +527,12 @@ void Statistics::_updateStatistics( Controller* controller, Carta::Lib::AxisInfo
                 ErrorManager* hr = Util::findSingletonObject<ErrorManager>();
                 hr->registerError( errorStr );
             }
+            readLockers.clear();
+            m_regionStats->start( dataSources, regions, masks, frameIndices, beamAreas );
         }
         //No statistics
         else {
+            m_regionStats->cancel();
             m_stateData.resizeArray( STATS, 0 );
         }
         m_stateData.flushState();
@@ -20,6 +20,7 @@ namespace Data {
 
 class Controller;
 class LinkableImpl;
+class RegionStatsCalculator;
 class Settings;
 
 class Statistics : public QObject, public Carta::State::CartaObject, public ILinkable {
@@ -93,6 +94,11 @@ private slots:
      */
     void _updateStatistics( Controller* controller, Carta::Lib::AxisInfo::KnownType type = Carta::Lib::AxisInfo::KnownType::SPECTRAL );
 
+    /**
+     * Store the region statistics that have been computed so far.
+     */
+    void _regionStatsAvailable();
+
 private:
     const static QString FROM;
     const static QString LABEL;
@@ -129,6 +135,9 @@ private:
     //Preference settings
     std::unique_ptr<Settings> m_settings;
 
+    //Computes region statistics in the background.
+    std::unique_ptr<RegionStatsCalculator> m_regionStats;
+
 
     Carta::State::StateInterface m_stateData;
 
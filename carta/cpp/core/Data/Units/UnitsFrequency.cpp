@@ -40,13 +40,12 @@ UnitsFrequency::UnitsFrequency( const QString& path, const QString& id):
 
 QString UnitsFrequency::getActualUnits( const QString& unitStr ) const {
     QString actualUnits;
-    int dataCount = m_state.getArraySize( UNIT_LIST );
+    const QStringList& units = _getUnits();
+    int dataCount = units.size();
     for ( int i = 0; i < dataCount; i++ ){
-        QString key = Carta::State::UtilState::getLookup( UNIT_LIST, i );
-        QString unitName = m_state.getValue<QString>( key );
-        int result = QString::compare( unitName, unitStr, Qt::CaseInsensitive );
+        int result = QString::compare( units[i], unitStr, Qt::CaseInsensitive );
         if ( result == 0 ){
-            actualUnits = unitName;
+            actualUnits = units[i];
             break;
         }
     }
@@ -59,19 +58,21 @@ QString UnitsFrequency::getDefault() const {
 }
 
 
-void UnitsFrequency::_initUnit( int * index, const QString& unit ){
-    QString key = Carta::State::UtilState::getLookup( UNIT_LIST, *index );
-    m_state.setValue<QString>( key, unit );
-    *index = *index + 1;
+const QStringList& UnitsFrequency::_getUnits(){
+    //The same for every session, so built once.
+    static const QStringList units = { UNIT_HZ, UNIT_MHZ, UNIT_GHZ };
+    return units;
 }
 
 
 void UnitsFrequency::_initializeDefaultState(){
-    m_state.insertArray( UNIT_LIST, 3 );
-    int i = 0;
-    _initUnit( &i, UNIT_HZ );
-    _initUnit( &i, UNIT_MHZ );
-    _initUnit( &i, UNIT_GHZ );
+    const QStringList& units = _getUnits();
+    int unitCount = units.size();
+    m_state.insertArray( UNIT_LIST, unitCount );
+    for ( int i = 0; i < unitCount; i++ ){
+        QString key = Carta::State::UtilState::getLookup( UNIT_LIST, i );
+        m_state.setValue<QString>( key, units[i] );
+    }
     m_state.flushState();
 }
 
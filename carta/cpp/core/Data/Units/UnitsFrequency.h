@@ -43,7 +43,7 @@ public:
 private:
 
     void _initializeDefaultState();
-    void _initUnit( int * index, const QString& unit );
+    static const QStringList& _getUnits();
 
     static bool m_registered;
     UnitsFrequency( const QString& path, const QString& id );
@@ -43,13 +43,11 @@ UnitsIntensity::UnitsIntensity( const QString& path, const QString& id):
 
 QString UnitsIntensity::getActualUnits( const QString& unitStr ) const {
     QString actualUnits;
-    int dataCount = m_state.getArraySize( UNIT_LIST );
+    int dataCount = m_units.size();
     for ( int i = 0; i < dataCount; i++ ){
-        QString key = Carta::State::UtilState::getLookup( UNIT_LIST, i );
-        QString unitName = m_state.getValue<QString>( key );
-        int result = QString::compare( unitName, unitStr, Qt::CaseInsensitive );
+        int result = QString::compare( m_units[i], unitStr, Qt::CaseInsensitive );
         if ( result == 0 ){
-            actualUnits = unitName;
+            actualUnits = m_units[i];
             break;
         }
     }
@@ -61,20 +59,22 @@ QString UnitsIntensity::getDefault() const {
     return m_defaultUnit;
 }
 
-void UnitsIntensity::_initUnit( int * index, const QString& name ){
-    QString key = Carta::State::UtilState::getLookup( UNIT_LIST, *index );
-    m_state.setValue<QString>( key, name );
-    *index = *index + 1;
-}
-
 void UnitsIntensity::_initializeDefaultState(){
-    m_state.insertArray( UNIT_LIST, 4 );
-    int i = 0;
-    _initUnit( &i, NAME_JYBEAM );
-    _initUnit( &i, NAME_JYSR );
-    _initUnit( &i, NAME_JYARCSEC );
-    _initUnit( &i, NAME_KELVIN );
+    //The default list is the same for every session, so built once.
+    static const QStringList defaultUnits = { NAME_JYBEAM, NAME_JYSR, NAME_JYARCSEC, NAME_KELVIN };
+    m_state.insertArray( UNIT_LIST, defaultUnits.size() );
     m_defaultUnit = NAME_JYBEAM;
+    _setUnits( defaultUnits );
+}
+
+void UnitsIntensity::_setUnits( const QStringList& units ){
+    m_units = units;
+    int unitCount = units.size();
+    m_state.resizeArray( UNIT_LIST, unitCount );
+    for ( int i = 0; i < unitCount; i++ ){
+        QString key = Carta::State::UtilState::getLookup( UNIT_LIST, i );
+        m_state.setValue<QString>( key, units[i] );
+    }
     m_state.flushState();
 }
 
@@ -101,13 +101,7 @@ void UnitsIntensity::resetUnits( Carta::Lib::ProfileInfo::AggregateType stat ){
         units.append( NAME_KELVIN );
         m_defaultUnit = NAME_JYBEAM;
     }
-    int unitCount = units.size();
-    m_state.resizeArray( UNIT_LIST, unitCount );
-    for ( int i = 0; i < unitCount; i++ ){
-        QString key = Carta::State::UtilState::getLookup( UNIT_LIST, i );
-        m_state.setValue<QString>( key, units[i] );
-    }
-    m_state.flushState();
+    _setUnits( units );
 }
 
 
@@ -56,9 +56,11 @@ private:
     const static QString NAME_KELVIN;
 
     QString m_defaultUnit;
+    //The units currently offered, also published in the state.
+    QStringList m_units;
 
     void _initializeDefaultState();
-    void _initUnit( int * index, const QString& name);
+    void _setUnits( const QStringList& units );
 
     static bool m_registered;
     UnitsIntensity( const QString& path, const QString& id );
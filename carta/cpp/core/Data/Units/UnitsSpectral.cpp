@@ -47,13 +47,12 @@ UnitsSpectral::UnitsSpectral( const QString& path, const QString& id):
 
 QString UnitsSpectral::getActualUnits( const QString& unitStr ) const {
     QString actualUnits;
-    int dataCount = m_state.getArraySize( UNIT_LIST );
+    const QStringList& units = _getUnits();
+    int dataCount = units.size();
     for ( int i = 0; i < dataCount; i++ ){
-        QString key = Carta::State::UtilState::getLookup( UNIT_LIST, i );
-        QString unitName = m_state.getValue<QString>( key );
-        int result = QString::compare( unitName, unitStr, Qt::CaseInsensitive );
+        int result = QString::compare( units[i], unitStr, Qt::CaseInsensitive );
         if ( result == 0 ){
-            actualUnits = unitName;
+            actualUnits = units[i];
             break;
         }
     }
@@ -66,36 +65,46 @@ QString UnitsSpectral::getDefault() const {
 }
 
 
-void UnitsSpectral::_initUnit( int * index, const QString& name, const QString& unit ){
-    QString key = Carta::State::UtilState::getLookup( UNIT_LIST, *index );
+QString UnitsSpectral::_makeUnit( const QString& name, const QString& unit ){
     QString value = name;
     if ( unit.length() > 0 ){
         value = value + "("+unit+")";
     }
-    m_state.setValue<QString>( key, value );
-    *index = *index + 1;
+    return value;
+}
+
+
+const QStringList& UnitsSpectral::_getUnits(){
+    //The same for every session, so built once.
+    static const QStringList units = {
+        _makeUnit( NAME_VELOCITY_RADIO, UNIT_MS ),
+        _makeUnit( NAME_VELOCITY_RADIO, UNIT_KMS ),
+        _makeUnit( NAME_VELOCITY_OPTICAL, UNIT_MS ),
+        _makeUnit( NAME_VELOCITY_OPTICAL, UNIT_KMS ),
+        _makeUnit( NAME_FREQUENCY, UnitsFrequency::UNIT_HZ ),
+        _makeUnit( NAME_FREQUENCY, UnitsFrequency::UNIT_MHZ ),
+        _makeUnit( NAME_FREQUENCY, UnitsFrequency::UNIT_GHZ ),
+        _makeUnit( NAME_WAVELENGTH, UnitsWavelength::UNIT_MM ),
+        _makeUnit( NAME_WAVELENGTH, UnitsWavelength::UNIT_UM ),
+        _makeUnit( NAME_WAVELENGTH, UnitsWavelength::UNIT_NM ),
+        _makeUnit( NAME_WAVELENGTH, UnitsWavelength::UNIT_ANGSTROM ),
+        _makeUnit( NAME_WAVELENGTH_OPTICAL, UnitsWavelength::UNIT_MM ),
+        _makeUnit( NAME_WAVELENGTH_OPTICAL, UnitsWavelength::UNIT_UM ),
+        _makeUnit( NAME_WAVELENGTH_OPTICAL, UnitsWavelength::UNIT_NM ),
+        _makeUnit( NAME_WAVELENGTH_OPTICAL, UnitsWavelength::UNIT_ANGSTROM ),
+        _makeUnit( NAME_CHANNEL, "" ) };
+    return units;
 }
 
 
 void UnitsSpectral::_initializeDefaultState(){
-    m_state.insertArray( UNIT_LIST, 16 );
-    int i = 0;
-    _initUnit( &i, NAME_VELOCITY_RADIO, UNIT_MS );
-    _initUnit( &i, NAME_VELOCITY_RADIO, UNIT_KMS );
-    _initUnit( &i, NAME_VELOCITY_OPTICAL, UNIT_MS );
-    _initUnit( &i, NAME_VELOCITY_OPTICAL, UNIT_KMS );
-    _initUnit( &i, NAME_FREQUENCY, UnitsFrequency::UNIT_HZ );
-    _initUnit( &i, NAME_FREQUENCY, UnitsFrequency::UNIT_MHZ );
-    _initUnit( &i, NAME_FREQUENCY, UnitsFrequency::UNIT_GHZ );
-    _initUnit( &i, NAME_WAVELENGTH, UnitsWavelength::UNIT_MM );
-    _initUnit( &i, NAME_WAVELENGTH, UnitsWavelength::UNIT_UM );
-    _initUnit( &i, NAME_WAVELENGTH, UnitsWavelength::UNIT_NM );
-    _initUnit( &i, NAME_WAVELENGTH, UnitsWavelength::UNIT_ANGSTROM );
-    _initUnit( &i, NAME_WAVELENGTH_OPTICAL, UnitsWavelength::UNIT_MM );
-    _initUnit( &i, NAME_WAVELENGTH_OPTICAL, UnitsWavelength::UNIT_UM );
-    _initUnit( &i, NAME_WAVELENGTH_OPTICAL, UnitsWavelength::UNIT_NM );
-    _initUnit( &i, NAME_WAVELENGTH_OPTICAL, UnitsWavelength::UNIT_ANGSTROM );
-    _initUnit( &i, NAME_CHANNEL, "" );
+    const QStringList& units = _getUnits();
+    int unitCount = units.size();
+    m_state.insertArray( UNIT_LIST, unitCount );
+    for ( int i = 0; i < unitCount; i++ ){
+        QString key = Carta::State::UtilState::getLookup( UNIT_LIST, i );
+        m_state.setValue<QString>( key, units[i] );
+    }
     m_state.flushState();
 }
 
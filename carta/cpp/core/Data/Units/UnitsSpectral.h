@@ -49,7 +49,8 @@ private:
     const static QString UNIT_KMS;
 
     void _initializeDefaultState();
-    void _initUnit( int * index, const QString& name, const QString& unit );
+    static QString _makeUnit( const QString& name, const QString& unit );
+    static const QStringList& _getUnits();
 
     static bool m_registered;
     UnitsSpectral( const QString& path, const QString& id );
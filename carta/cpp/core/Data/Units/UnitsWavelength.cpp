@@ -40,13 +40,12 @@ UnitsWavelength::UnitsWavelength( const QString& path, const QString& id):
 
 QString UnitsWavelength::getActualUnits( const QString& unitStr ) const {
     QString actualUnits;
-    int dataCount = m_state.getArraySize( UNIT_LIST );
+    const QStringList& units = _getUnits();
+    int dataCount = units.size();
     for ( int i = 0; i < dataCount; i++ ){
-        QString key = Carta::State::UtilState::getLookup( UNIT_LIST, i );
-        QString unitName = m_state.getValue<QString>( key );
-        int result = QString::compare( unitName, unitStr, Qt::CaseInsensitive );
+        int result = QString::compare( units[i], unitStr, Qt::CaseInsensitive );
         if ( result == 0 ){
-            actualUnits = unitName;
+            actualUnits = units[i];
             break;
         }
     }
@@ -59,20 +58,21 @@ QString UnitsWavelength::getDefault() const {
 }
 
 
-void UnitsWavelength::_initUnit( int * index, const QString& unit ){
-    QString key = Carta::State::UtilState::getLookup( UNIT_LIST, *index );
-    m_state.setValue<QString>( key, unit );
-    *index = *index + 1;
+const QStringList& UnitsWavelength::_getUnits(){
+    //The same for every session, so built once.
+    static const QStringList units = { UNIT_MM, UNIT_UM, UNIT_NM, UNIT_ANGSTROM };
+    return units;
 }
 
 
 void UnitsWavelength::_initializeDefaultState(){
-    m_state.insertArray( UNIT_LIST, 4 );
-    int i = 0;
-    _initUnit( &i, UNIT_MM );
-    _initUnit( &i, UNIT_UM );
-    _initUnit( &i, UNIT_NM );
-    _initUnit( &i, UNIT_ANGSTROM );
+    const QStringList& units = _getUnits();
+    int unitCount = units.size();
+    m_state.insertArray( UNIT_LIST, unitCount );
+    for ( int i = 0; i < unitCount; i++ ){
+        QString key = Carta::State::UtilState::getLookup( UNIT_LIST, i );
+        m_state.setValue<QString>( key, units[i] );
+    }
     m_state.flushState();
 }
 
@@ -44,7 +44,7 @@ public:
 private:
 
     void _initializeDefaultState();
-    void _initUnit( int * index, const QString& unit );
+    static const QStringList& _getUnits();
 
     static bool m_registered;
     UnitsWavelength( const QString& path, const QString& id );
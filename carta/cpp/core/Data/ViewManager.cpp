@@ -367,11 +367,8 @@ void ViewManager::_initCallbacks(){
         const QString DATA( "data");
         std::set<QString> keys = {Util::ID,DATA};
         std::map<QString,QString> dataValues = Carta::State::UtilState::parseParamMap( params, keys );
-        bool fileLoaded = false;
-        QString result = loadFile( dataValues[Util::ID], dataValues[DATA],&fileLoaded);
-        if ( !fileLoaded ){
-            Util::commandPostProcess( result);
-        }
+        QString result = loadFileAsync( dataValues[Util::ID], dataValues[DATA] );
+        Util::commandPostProcess( result );
         return "";
     });
 
@@ -553,6 +550,23 @@ QString ViewManager::loadFile( const QString& controlId, const QString& fileName
 }
 
 
+QString ViewManager::loadFileAsync( const QString& controlId, const QString& fileName ){
+    QString result = "Could not load "+fileName+", unrecognized image view: "+controlId;
+    int controlCount = getControllerCount();
+    for ( int i = 0; i < controlCount; i++ ){
+        const QString controlPath= m_controllers[i]->getPath();
+        if ( controlId  == controlPath ){
+            _makeDataLoader();
+            QString path = m_dataLoader->getFile( fileName, "" );
+            m_controllers[i]->addDataAsync( path );
+            result = "";
+            break;
+        }
+    }
+    return result;
+}
+
+
 void ViewManager::_moveView( const QString& plugin, int oldIndex, int newIndex ){
     if ( oldIndex != newIndex && oldIndex >= 0 && newIndex >= 0 ){
         if ( plugin == Controller::PLUGIN_NAME ){
@@ -30,6 +30,12 @@ DefaultContourGeneratorService::setInput( Carta::Lib::NdArray::RawViewInterface:
     m_rawView = rawView;
 }
 
+void
+DefaultContourGeneratorService::setReadLock( std::shared_ptr < QMutex > readLock )
+{
+    m_readLock = readLock;
+}
+
 Lib::IContourGeneratorService::JobId
 DefaultContourGeneratorService::start( Lib::IContourGeneratorService::JobId jobId )
 {
@@ -51,7 +57,11 @@ DefaultContourGeneratorService::timerCB()
     // run the contour algorithm
     Carta::Lib::Algorithms::ContourConrec cc;
     cc.setLevels( m_levels);
-    auto rawContours = cc.compute( m_rawView.get() );
+    Carta::Lib::Algorithms::ContourConrec::Result rawContours;
+    {
+        QMutexLocker locker( m_readLock.get() );
+        rawContours = cc.compute( m_rawView.get() );
+    }
 
     // build the result
     Result result;
@@ -5,6 +5,7 @@
 #pragma once
 #include "CartaLib/IContourGeneratorService.h"
 
+#include <QMutex>
 #include <QObject>
 #include <QTimer>
 
@@ -32,6 +33,10 @@ public:
     virtual JobId
     start( JobId jobId ) override;
 
+    /// set the lock to hold while reading from the input
+    void
+    setReadLock( std::shared_ptr < QMutex > readLock );
+
 signals:
 
 private slots:
@@ -43,6 +48,7 @@ private:
     std::vector < double > m_levels;
     JobId m_lastJobId = - 1;
     Carta::Lib::NdArray::RawViewInterface::SharedPtr m_rawView = nullptr;
+    std::shared_ptr < QMutex > m_readLock = nullptr;
     QTimer m_timer;
 
 };
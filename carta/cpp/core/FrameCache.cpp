@@ -0,0 +1,310 @@
+/**
+ *
+ **/
+
+#include "FrameCache.h"
+#include "MemoryGovernor.h"
+#include <QMutexLocker>
+#include <algorithm>
+
+namespace Carta
+{
+namespace Core
+{
+FrameCacheKey &
+FrameCacheKey::add( const void * data, size_t size )
+{
+    // two independent 64 bit lanes: FNV-1a and a multiply/xorshift mix
+    if ( isNull() ) {
+        hi = 0xcbf29ce484222325ULL;
+        lo = 0x9e3779b97f4a7c15ULL;
+    }
+    const unsigned char * ptr = static_cast < const unsigned char * > ( data );
+    for ( size_t i = 0 ; i < size ; i++ ) {
+        hi = ( hi ^ ptr[i] ) * 0x100000001b3ULL;
+        lo = ( lo + ptr[i] ) * 0xff51afd7ed558ccdULL;
+        lo ^= lo >> 29;
+    }
+    return * this;
+}
+
+FrameCacheKey &
+FrameCacheKey::add( const QString & str )
+{
+    // include the length so that ("ab","c") and ("a","bc") differ
+    add( qint64( str.size() ) );
+    return add( str.constData(), str.size() * sizeof( QChar ) );
+}
+
+FrameCacheKey &
+FrameCacheKey::add( const FrameCacheKey & key )
+{
+    add( & key.hi, sizeof( key.hi ) );
+    return add( & key.lo, sizeof( key.lo ) );
+}
+
+FrameCacheKey &
+FrameCacheKey::add( double val )
+{
+    return add( & val, sizeof( val ) );
+}
+
+FrameCacheKey &
+FrameCacheKey::add( qint64 val )
+{
+    return add( & val, sizeof( val ) );
+}
+
+constexpr qint64 FrameCache::DefaultBudget;
+constexpr double FrameCache::CompositedShare;
+
+FrameCache::FrameCache( qint64 budget )
+    : m_budget( budget )
+{ }
+
+FrameCache::~FrameCache()
+{
+    if ( m_governor ) {
+        m_governor-> removeConsumer( m_governorId );
+    }
+}
+
+bool
+FrameCache::find( Tier tier, const FrameCacheKey & key, QImage & image )
+{
+    QMutexLocker locker( & m_mutex );
+    TierData & data = m_tiers[static_cast < int > ( tier )];
+    auto iter = data.entries.find( key );
+    if ( iter == data.entries.end() ) {
+        data.misses++;
+        return false;
+    }
+    data.hits++;
+    _touch( data, iter.value() );
+    image = iter.value().image;
+    return true;
+}
+
+bool
+FrameCache::touch( Tier tier, const FrameCacheKey & key )
+{
+    QMutexLocker locker( & m_mutex );
+    TierData & data = m_tiers[static_cast < int > ( tier )];
+    auto iter = data.entries.find( key );
+    if ( iter == data.entries.end() ) {
+        return false;
+    }
+    _touch( data, iter.value() );
+    return true;
+}
+
+void
+FrameCache::insert( Tier tier, const FrameCacheKey & key, const QImage & image )
+{
+    if ( key.isNull() || image.isNull() ) {
+        return;
+    }
+    qint64 bytes = image.byteCount();
+    QMutexLocker locker( & m_mutex );
+    if ( bytes > m_budget ) {
+        return;
+    }
+    TierData & data = m_tiers[static_cast < int > ( tier )];
+    auto iter = data.entries.find( key );
+    if ( iter != data.entries.end() ) {
+        data.bytes -= iter.value().bytes;
+        m_bytes -= iter.value().bytes;
+        iter.value().image = image;
+        iter.value().bytes = bytes;
+        _touch( data, iter.value() );
+    }
+    else {
+        data.lru.push_front( key );
+        Entry & entry = data.entries[key];
+        entry.image = image;
+        entry.bytes = bytes;
+        entry.lruPos = data.lru.begin();
+        entry.lastUsed = ++m_tick;
+    }
+    data.bytes += bytes;
+    m_bytes += bytes;
+    _trim();
+    _report();
+    locker.unlock();
+
+    // other memory users may need some of this back
+    if ( m_governor ) {
+        m_governor-> relieve();
+    }
+}
+
+qint64
+FrameCache::release( qint64 bytes )
+{
+    QMutexLocker locker( & m_mutex );
+    qint64 before = m_bytes;
+    _trimTo( std::max < qint64 > ( 0, m_bytes - bytes ) );
+    _report();
+    return before - m_bytes;
+}
+
+void
+FrameCache::setGovernor( MemoryGovernor * governor )
+{
+    QMutexLocker locker( & m_mutex );
+    if ( m_governor ) {
+        m_governor-> removeConsumer( m_governorId );
+    }
+    m_governor = governor;
+    m_governorId = - 1;
+    if ( m_governor ) {
+        m_governorId = m_governor-> addConsumer( "frame cache",
+                                                 [this] ( qint64 bytes ) {
+                                                     return release( bytes );
+                                                 } );
+        _report();
+    }
+}
+
+void
+FrameCache::setBudget( qint64 bytes )
+{
+    QMutexLocker locker( & m_mutex );
+    m_budget = std::max < qint64 > ( 0, bytes );
+    _trim();
+    _report();
+}
+
+qint64
+FrameCache::budget() const
+{
+    QMutexLocker locker( & m_mutex );
+    return m_budget;
+}
+
+qint64
+FrameCache::bytesUsed() const
+{
+    QMutexLocker locker( & m_mutex );
+    return m_bytes;
+}
+
+std::vector < FrameCache::TierStats >
+FrameCache::stats() const
+{
+    QMutexLocker locker( & m_mutex );
+    std::vector < TierStats > result;
+    for ( int i = 0 ; i < static_cast < int > ( Tier::Count ) ; i++ ) {
+        const TierData & data = m_tiers[i];
+        TierStats stats;
+        stats.name = tierName( static_cast < Tier > ( i ) );
+        stats.hits = data.hits;
+        stats.misses = data.misses;
+        stats.bytes = data.bytes;
+        stats.entries = data.entries.size();
+        result.push_back( stats );
+    }
+    return result;
+}
+
+void
+FrameCache::resetStats()
+{
+    QMutexLocker locker( & m_mutex );
+    for ( TierData & data : m_tiers ) {
+        data.hits = 0;
+        data.misses = 0;
+    }
+}
+
+void
+FrameCache::clear()
+{
+    QMutexLocker locker( & m_mutex );
+    for ( TierData & data : m_tiers ) {
+        data.lru.clear();
+        data.entries.clear();
+        data.bytes = 0;
+    }
+    m_bytes = 0;
+    _report();
+}
+
+QString
+FrameCache::tierName( Tier tier )
+{
+    switch ( tier ) {
+    case Tier::Mapped :
+        return "mapped";
+    case Tier::Composited :
+        return "composited";
+    default :
+        return "unknown";
+    }
+}
+
+void
+FrameCache::_touch( TierData & data, Entry & entry )
+{
+    data.lru.splice( data.lru.begin(), data.lru, entry.lruPos );
+    entry.lastUsed = ++m_tick;
+}
+
+void
+FrameCache::_evictOne( TierData & data )
+{
+    CARTA_ASSERT( ! data.lru.empty() );
+    auto iter = data.entries.find( data.lru.back() );
+    data.bytes -= iter.value().bytes;
+    m_bytes -= iter.value().bytes;
+    data.entries.erase( iter );
+    data.lru.pop_back();
+}
+
+void
+FrameCache::_trim()
+{
+    _trimTo( m_budget );
+}
+
+void
+FrameCache::_report()
+{
+    if ( m_governor ) {
+        m_governor-> setBytes( m_governorId, m_bytes );
+    }
+}
+
+void
+FrameCache::_trimTo( qint64 target )
+{
+    TierData & composited = m_tiers[static_cast < int > ( Tier::Composited )];
+    while ( m_bytes > target ) {
+        // composited images are cheap to redo, trim them first if they take
+        // more than their share
+        if ( composited.bytes > target * CompositedShare ) {
+            _evictOne( composited );
+            continue;
+        }
+
+        // otherwise evict the globally oldest entry
+        TierData * oldest = nullptr;
+        quint64 oldestTick = 0;
+        for ( TierData & data : m_tiers ) {
+            if ( data.lru.empty() ) {
+                continue;
+            }
+            quint64 tick = data.entries.find( data.lru.back() ).value().lastUsed;
+            if ( ! oldest || tick < oldestTick ) {
+                oldest = & data;
+                oldestTick = tick;
+            }
+        }
+        if ( ! oldest ) {
+            break;
+        }
+        _evictOne( * oldest );
+    }
+}
+}
+}
@@ -0,0 +1,228 @@
+/**
+ * Process wide cache for rendered frames, shared by all views and layers.
+ *
+ * Frames are stored in tiers:
+ *   - Mapped: full frames after the pixel pipeline (colormap) was applied, before any
+ *     pan/zoom. These are expensive to recompute (read + colormap) and can be reused
+ *     for any pan/zoom/output size.
+ *   - Composited: the final viewport images, after pan/zoom. These are cheap to
+ *     recompute from a mapped frame, so they only get a small share of the budget.
+ *
+ * All tiers share one byte budget. Within a tier entries are evicted in least recently
+ * used order. When over budget, the composited tier is trimmed first if it exceeds its
+ * share, otherwise the tier holding the globally oldest entry loses it.
+ *
+ * The cache can report to a MemoryGovernor, which may ask it to give memory back when
+ * other parts of the process need it.
+ *
+ * Keys are 128 bit hashes built incrementally with FrameCacheKey::add(), so that callers
+ * can pre-hash the parts that change rarely (view id, pipeline id) and only mix in
+ * pan/zoom when rendering.
+ **/
+
+#pragma once
+
+#include "CartaLib/CartaLib.h"
+#include <QImage>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QMetaType>
+#include <list>
+
+namespace Carta
+{
+namespace Core
+{
+class MemoryGovernor;
+
+/// 128 bit key identifying a cached frame
+struct FrameCacheKey
+{
+    quint64 hi = 0;
+    quint64 lo = 0;
+
+    /// a default constructed key means 'do not cache'
+    bool
+    isNull() const
+    {
+        return hi == 0 && lo == 0;
+    }
+
+    bool
+    operator== ( const FrameCacheKey & other ) const
+    {
+        return hi == other.hi && lo == other.lo;
+    }
+
+    bool
+    operator!= ( const FrameCacheKey & other ) const
+    {
+        return ! ( * this == other );
+    }
+
+    /// mix raw bytes into the key
+    FrameCacheKey &
+    add( const void * data, size_t size );
+
+    /// mix a string into the key
+    FrameCacheKey &
+    add( const QString & str );
+
+    /// mix another key into this key
+    FrameCacheKey &
+    add( const FrameCacheKey & key );
+
+    /// mix a value into the key, doubles are mixed in bit for bit
+    FrameCacheKey &
+    add( double val );
+
+    FrameCacheKey &
+    add( qint64 val );
+};
+
+inline uint
+qHash( const FrameCacheKey & key, uint seed = 0 )
+{
+    return ::qHash( key.lo ^ ( key.hi * 0x9e3779b97f4a7c15ULL ), seed );
+}
+
+class FrameCache
+{
+    CLASS_BOILERPLATE( FrameCache );
+
+public:
+
+    enum class Tier
+    {
+        Mapped = 0,
+        Composited,
+        Count
+    };
+
+    /// statistics of a single tier
+    struct TierStats
+    {
+        QString name;
+        quint64 hits = 0;
+        quint64 misses = 0;
+        qint64 bytes = 0;
+        int entries = 0;
+    };
+
+    /// default budget if nothing is configured
+    static constexpr qint64 DefaultBudget = 1024LL * 1024 * 1024;
+
+    /// share of the budget the composited tier can keep when trimming
+    static constexpr double CompositedShare = 0.25;
+
+    explicit
+    FrameCache( qint64 budget = DefaultBudget );
+
+    ~FrameCache();
+
+    /// look up a frame, counts as a hit or a miss
+    /// \return true if found, image is set to the cached frame
+    bool
+    find( Tier tier, const FrameCacheKey & key, QImage & image );
+
+    /// check if a frame is cached without affecting statistics, the frame is marked
+    /// as recently used
+    bool
+    touch( Tier tier, const FrameCacheKey & key );
+
+    /// insert (or replace) a frame, may evict other frames to stay within budget
+    /// frames larger than the whole budget are not cached
+    void
+    insert( Tier tier, const FrameCacheKey & key, const QImage & image );
+
+    /// evict frames, least recently used first, until the given number of bytes
+    /// was freed or the cache is empty
+    /// \return the number of bytes freed
+    qint64
+    release( qint64 bytes );
+
+    /// report usage to the governor and let it reclaim frames under memory pressure,
+    /// the governor must outlive the cache
+    void
+    setGovernor( MemoryGovernor * governor );
+
+    /// set the byte budget shared by all tiers
+    void
+    setBudget( qint64 bytes );
+
+    /// current byte budget
+    qint64
+    budget() const;
+
+    /// bytes used by all tiers
+    qint64
+    bytesUsed() const;
+
+    /// statistics for all tiers, indexed by Tier
+    std::vector < TierStats >
+    stats() const;
+
+    /// reset hit/miss counters
+    void
+    resetStats();
+
+    /// drop all frames
+    void
+    clear();
+
+    static QString
+    tierName( Tier tier );
+
+private:
+
+    struct Entry
+    {
+        QImage image;
+        qint64 bytes = 0;
+        quint64 lastUsed = 0;
+        std::list < FrameCacheKey >::iterator lruPos;
+    };
+
+    struct TierData
+    {
+        /// most recently used at the front
+        std::list < FrameCacheKey > lru;
+        QHash < FrameCacheKey, Entry > entries;
+        qint64 bytes = 0;
+        quint64 hits = 0;
+        quint64 misses = 0;
+    };
+
+    /// mark the entry as most recently used
+    void
+    _touch( TierData & data, Entry & entry );
+
+    /// remove the least recently used entry of the given tier
+    void
+    _evictOne( TierData & data );
+
+    /// evict entries until at most target bytes are used
+    void
+    _trimTo( qint64 target );
+
+    /// evict entries until the budget is met
+    void
+    _trim();
+
+    /// tell the governor about the current usage
+    void
+    _report();
+
+    mutable QMutex m_mutex;
+    TierData m_tiers[static_cast < int > ( Tier::Count )];
+    qint64 m_budget;
+    qint64 m_bytes = 0;
+    quint64 m_tick = 0;
+    MemoryGovernor * m_governor = nullptr;
+    int m_governorId = - 1;
+};
+}
+}
+
+Q_DECLARE_METATYPE( Carta::Core::FrameCacheKey )
@@ -6,6 +6,10 @@
 #include "IConnector.h"
 #include "IPlatform.h"
 #include "PluginManager.h"
+#include "MainConfig.h"
+#include "FrameCache.h"
+#include "MemoryGovernor.h"
+#include <QThreadPool>
 
 Globals * Globals::m_instance = nullptr;
 
@@ -64,6 +68,38 @@ void Globals::setMainConfig(const MainConfig::ParsedInfo * mainConfig)
     m_mainConfig = mainConfig;
 }
 
+Carta::Core::FrameCache * Globals::frameCache()
+{
+    if( ! m_frameCache) {
+        qint64 budget = Carta::Core::FrameCache::DefaultBudget;
+        if( m_mainConfig && m_mainConfig-> getFrameCacheSizeMB() > 0) {
+            budget = qint64( m_mainConfig-> getFrameCacheSizeMB()) * 1024 * 1024;
+        }
+        m_frameCache = new Carta::Core::FrameCache( budget);
+        m_frameCache-> setGovernor( memoryGovernor());
+    }
+    return m_frameCache;
+}
+
+Carta::Core::MemoryGovernor * Globals::memoryGovernor()
+{
+    if( ! m_memoryGovernor) {
+        qint64 budget = Carta::Core::MemoryGovernor::DefaultBudget;
+        if( m_mainConfig && m_mainConfig-> getMemoryBudgetMB() > 0) {
+            budget = qint64( m_mainConfig-> getMemoryBudgetMB()) * 1024 * 1024;
+        }
+        m_memoryGovernor = new Carta::Core::MemoryGovernor( budget);
+    }
+    return m_memoryGovernor;
+}
+
+QThreadPool * Globals::renderPool()
+{
+    if( ! m_renderPool) {
+        m_renderPool = new QThreadPool;
+    }
+    return m_renderPool;
+}
 
 Globals::Globals()
 {
@@ -72,6 +108,9 @@ Globals::Globals()
     m_pluginManager = nullptr;
     m_cmdLineInfo = nullptr;
     m_mainConfig = nullptr;
+    m_frameCache = nullptr;
+    m_memoryGovernor = nullptr;
+    m_renderPool = nullptr;
 }
 
 
@@ -18,6 +18,8 @@ class IConnector;
 class IPlatform;
 namespace CmdLine { class ParsedInfo; }
 namespace MainConfig { class ParsedInfo; }
+namespace Carta { namespace Core { class FrameCache; class MemoryGovernor; } }
+class QThreadPool;
 
 class Globals {
 
@@ -55,6 +57,15 @@ public:
     const MainConfig::ParsedInfo * mainConfig() const;
     void setMainConfig(const MainConfig::ParsedInfo * mainConfig);
 
+    /// get the frame cache shared by all views, created on first use
+    Carta::Core::FrameCache * frameCache();
+
+    /// get the accountant of large memory users, created on first use
+    Carta::Core::MemoryGovernor * memoryGovernor();
+
+    /// get the worker threads shared by all views for rendering, created on first use
+    QThreadPool * renderPool();
+
 protected:
 
 //    PluginManager * m_pluginManager = nullptr;
@@ -63,6 +74,9 @@ protected:
     IConnector * m_connector = nullptr;
     const CmdLine::ParsedInfo * m_cmdLineInfo = nullptr;
     const MainConfig::ParsedInfo * m_mainConfig = nullptr;
+    Carta::Core::FrameCache * m_frameCache = nullptr;
+    Carta::Core::MemoryGovernor * m_memoryGovernor = nullptr;
+    QThreadPool * m_renderPool = nullptr;
 
     static Globals * m_instance;
 
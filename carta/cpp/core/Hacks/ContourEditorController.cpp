@@ -96,9 +96,11 @@ ContourEditorController::startRendering( ContourEditorController::JobId jobId )
 }
 
 void
-ContourEditorController::setInput( Carta::Lib::NdArray::RawViewInterface::SharedPtr rawView )
+ContourEditorController::setInput( Carta::Lib::NdArray::RawViewInterface::SharedPtr rawView,
+                                   std::shared_ptr < QMutex > readLock )
 {
     m_contourSvc-> setInput( rawView );
+    m_contourSvc-> setReadLock( readLock );
 }
 
 namespace VGE = Carta::Lib::VectorGraphics::Entries;
@@ -56,8 +56,12 @@ public:
     startRendering( JobId jobId = - 1 );
 
     /// set the input data
+    /// \param rawView the data
+    /// \param readLock lock to hold while reading the data, if it is shared with
+    /// other threads
     void
-    setInput( Carta::Lib::NdArray::RawViewInterface::SharedPtr rawView );
+    setInput( Carta::Lib::NdArray::RawViewInterface::SharedPtr rawView,
+              std::shared_ptr < QMutex > readLock = nullptr );
 
 signals:
 
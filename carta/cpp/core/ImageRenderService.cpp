@@ -4,8 +4,15 @@
 
 #include "ImageRenderService.h"
 #include "CartaLib/LinearMap.h"
+#include "CartaLib/Hooks/PreRenderRaw.h"
+#include "CartaLib/Trace.h"
+#include "Globals.h"
 #include <QColor>
 #include <QPainter>
+#include <QRunnable>
+#include <QThread>
+#include <QtConcurrent/QtConcurrentRun>
+#include <algorithm>
 
 namespace NdArray = Carta::Lib::NdArray;
 
@@ -19,6 +26,72 @@ static constexpr QImage::Format OptimalQImageFormat = QImage::Format_ARGB32_Prem
 /// \todo check if the bug is still there in Qt5.4+, it definitely is there in Qt5.3
 static constexpr bool QtPremultipliedBugStillExists = true;
 
+/// internal helper that runs a sequence of raw values through the pixel pipeline
+/// and stores the results in a qimage, the values are expected in row-major order
+/// starting with the bottom row (the image is constructed bottom-up)
+template < class Pipeline >
+class RgbWriter
+{
+public:
+
+    RgbWriter( QSize size, Pipeline & pipe, QImage & qImage, QRgb nanColor )
+        : m_size( size )
+          , m_pipe( pipe )
+          , m_nanColor( nanColor )
+    {
+        QImage::Format desiredFormat = OptimalQImageFormat;
+        if ( QtPremultipliedBugStillExists ) {
+            desiredFormat = QImage::Format_ARGB32;
+        }
+
+        // QImage::Format desiredFormat = QImage::Format_ARGB32;
+        if ( qImage.format() != desiredFormat ||
+             qImage.size() != size ) {
+            qImage = QImage( size, desiredFormat );
+        }
+        auto bytesPerLine = qImage.bytesPerLine();
+        CARTA_ASSERT( bytesPerLine == size.width() * 4 );
+        Q_UNUSED( bytesPerLine );
+
+        // start with a pointer to the beginning of last row (we are constructing image
+        // bottom-up)
+        m_outPtr = reinterpret_cast < QRgb * > (
+            qImage.bits() + size.width() * ( size.height() - 1 ) * 4 );
+    }
+
+    void
+    operator() ( double ival )
+    {
+        if ( Q_LIKELY( ! std::isnan( ival ) ) ) {
+            m_pipe.convertq( ival, * m_outPtr );
+        }
+        else {
+            * m_outPtr = m_nanColor;
+        }
+        m_outPtr++;
+        m_counter++;
+
+        // build the image bottom-up
+        if ( m_counter % m_size.width() == 0 ) {
+            m_outPtr -= m_size.width() * 2;
+        }
+    }
+
+    int64_t
+    count() const
+    {
+        return m_counter;
+    }
+
+private:
+
+    QSize m_size;
+    Pipeline & m_pipe;
+    QRgb m_nanColor;
+    QRgb * m_outPtr = nullptr;
+    int64_t m_counter = 0;
+};
+
 /// internal algorithm for converting an instance of image interface to qimage
 /// using the pixel pipeline
 ///
@@ -32,80 +105,152 @@ iView2qImage( NdArray::RawViewInterface * rawView, Pipeline & pipe, QImage & qIm
         QRgb nanColor)
 {
     //qDebug() << "rv2qi2" << rawView-> dims();
+    CARTA_TRACE_SCOPE( "render", "iView2qImage" );
     typedef double Scalar;
 
     QSize size( rawView->dims()[0], rawView->dims()[1] );
-
-    QImage::Format desiredFormat = OptimalQImageFormat;
-    if ( QtPremultipliedBugStillExists ) {
-        desiredFormat = QImage::Format_ARGB32;
-    }
-
-    // QImage::Format desiredFormat = QImage::Format_ARGB32;
-    if ( qImage.format() != desiredFormat ||
-         qImage.size() != size ) {
-        qImage = QImage( size, desiredFormat );
-    }
-    auto bytesPerLine = qImage.bytesPerLine();
-    CARTA_ASSERT( bytesPerLine == size.width() * 4 );
-    Q_UNUSED( bytesPerLine );
-
-    // start with a pointer to the beginning of last row (we are constructing image
-    // bottom-up)
-    QRgb * outPtr = reinterpret_cast < QRgb * > (
-        qImage.bits() + size.width() * ( size.height() - 1 ) * 4 );
-
-    if( 0) {
-        CARTA_ASSERT( qImage.bits() + size.width() * (size.height() - 1) * 4 == qImage.scanLine( size.height() - 1));
-        // sanity check
-        for( int y = 0 ; y < size.height() ; y ++ ) {
-            CARTA_ASSERT( qImage.bits() + size.width() * 4 * y == qImage.scanLine(y) );
-        }
-    }
+    RgbWriter < Pipeline > writer( size, pipe, qImage, nanColor );
 
     // make a double view
     NdArray::TypedView < Scalar > typedView( rawView, false );
 
     /// @todo for more efficiency, instead of forEach() we should switch to one of the
     /// higher performance APIs and maybe even sprinkle it with some openmp/cilk magic :)
-    int64_t counter = 0;
-
-
     auto lambda = [&] ( const Scalar & ival )
     {
-        if ( Q_LIKELY( ! std::isnan( ival ) ) ) {
-            pipe.convertq( ival, * outPtr );
-        }
-        else {
-            * outPtr = nanColor;
-        }
-        outPtr++;
-        counter++;
-
-        // build the image bottom-up
-        if ( counter % size.width() == 0 ) {
-            outPtr -= size.width() * 2;
-        }
+        writer( ival );
     };
     typedView.forEach( lambda );
 
-    CARTA_ASSERT( counter == size.width() * size.height());
+    CARTA_ASSERT( writer.count() == size.width() * size.height());
 
 } // rawView2QImage
 
+/// same as iView2qImage(), but the input is a contiguous frame (see rawView2frame())
+template < class Pipeline >
+static void
+frame2qImage( const std::vector < float > & frame, QSize size, Pipeline & pipe,
+              QImage & qImage, QRgb nanColor )
+{
+    CARTA_ASSERT( int64_t( frame.size() ) == int64_t( size.width() ) * size.height() );
+    CARTA_TRACE_SCOPE( "render", "frame2qImage" );
+    RgbWriter < Pipeline > writer( size, pipe, qImage, nanColor );
+    for ( float val : frame ) {
+        writer( val );
+    }
+} // frame2qImage
+
+/// read a 2d view into a contiguous float buffer (row-major, bottom row first)
+static void
+rawView2frame( NdArray::RawViewInterface * rawView, std::vector < float > & frame )
+{
+    const auto & dims = rawView->dims();
+    frame.resize( int64_t( dims[0] ) * dims[1] );
+    float * outPtr = frame.data();
+    NdArray::TypedView < float > typedView( rawView, false );
+    typedView.forEach( [& outPtr] ( const float & val ) {
+                           * outPtr = val;
+                           outPtr++;
+                       } );
+} // rawView2frame
+
 namespace Carta
 {
 namespace Core
 {
 namespace ImageRenderService
 {
+namespace
+{
+/// background job that reads one view and colour-maps it using a snapshot of the
+/// cached pixel pipeline, the result is delivered to Service::_prefetchDone()
+class PrefetchJob : public QRunnable
+{
+public:
+
+    typedef Lib::PixelPipeline::CachedPipeline < true > InterpPipeline;
+    typedef Lib::PixelPipeline::CachedPipeline < false > PlainPipeline;
+
+    PrefetchJob( QObject * service,
+                 FrameCacheKey frameKey,
+                 NdArray::RawViewInterface::SharedPtr view,
+                 std::shared_ptr < InterpPipeline > interpPipe,
+                 std::shared_ptr < PlainPipeline > plainPipe,
+                 QRgb nanColor,
+                 std::shared_ptr < QMutex > readLock,
+                 std::shared_ptr < PrefetchWanted > wanted )
+        : m_service( service )
+          , m_frameKey( frameKey )
+          , m_view( view )
+          , m_interpPipe( interpPipe )
+          , m_plainPipe( plainPipe )
+          , m_nanColor( nanColor )
+          , m_readLock( readLock )
+          , m_wanted( wanted )
+    { }
+
+    virtual void
+    run() override
+    {
+        bool wanted = false;
+        {
+            QMutexLocker locker( & m_wanted-> mutex );
+            wanted = m_wanted-> frameIds.contains( m_frameKey );
+        }
+        QImage image;
+        if ( wanted ) {
+            QSize size( m_view-> dims()[0], m_view-> dims()[1] );
+            std::vector < float > frame;
+            {
+                QMutexLocker locker( m_readLock.get() );
+                ::rawView2frame( m_view.get(), frame );
+            }
+
+            // the pipelines are only read from, so sharing them between jobs is fine
+            if ( m_interpPipe ) {
+                ::frame2qImage( frame, size, * m_interpPipe, image, m_nanColor );
+            }
+            else {
+                ::frame2qImage( frame, size, * m_plainPipe, image, m_nanColor );
+            }
+        }
+        QMetaObject::invokeMethod( m_service, "_prefetchDone", Qt::QueuedConnection,
+                                   Q_ARG( Carta::Core::FrameCacheKey, m_frameKey ),
+                                   Q_ARG( QImage, image ) );
+    }
+
+private:
+
+    QObject * m_service;
+    FrameCacheKey m_frameKey;
+    NdArray::RawViewInterface::SharedPtr m_view;
+    std::shared_ptr < InterpPipeline > m_interpPipe;
+    std::shared_ptr < PlainPipeline > m_plainPipe;
+    QRgb m_nanColor;
+    std::shared_ptr < QMutex > m_readLock;
+    std::shared_ptr < PrefetchWanted > m_wanted;
+};
+}
+
 void
 Service::setInputView( NdArray::RawViewInterface::SharedPtr view, QString cacheId )
 {
     m_inputView = view;
 
     m_inputViewCacheId = cacheId;
+    m_inputViewKey = FrameCacheKey();
+    if ( ! cacheId.isEmpty() ) {
+        m_inputViewKey.add( cacheId );
+    }
     m_frameImage = QImage(); // indicate a need to recompute
+    m_frameGeneration++;
+}
+
+void
+Service::setReadLock( std::shared_ptr < QMutex > readLock )
+{
+    // jobs already running keep the lock they were started with
+    m_readLock = readLock;
 }
 
 void
@@ -173,9 +318,11 @@ Service::setPixelPipeline( IClippedPixelPipeline::SharedPtr pixelPipeline,
 {
     m_pixelPipelineRaw = pixelPipeline;
     m_pixelPipelineCacheId = cacheId;
+    m_pixelPipelineKey = FrameCacheKey().add( cacheId );
 
     // invalidate frame cache
     m_frameImage = QImage();
+    m_frameGeneration++;
 
     // invalidate pixel pipeline cache
     m_cachedPP = nullptr;
@@ -189,6 +336,7 @@ Service::setPixelPipelineCacheSettings( const PixelPipelineCacheSettings & param
 
     // invalidate frame cache
     m_frameImage = QImage();
+    m_frameGeneration++;
 
     // invalidate pixel pipeline cache
     m_cachedPP = nullptr;
@@ -217,6 +365,8 @@ Service::render( JobId jobId )
 }
 
 Service::Service( QObject * parent ) : Carta::Lib::IImageRenderService( parent ),
+        m_prefetchWanted( new PrefetchWanted ),
+        m_readLock( new QMutex ),
         m_defaultNan( true ),
         m_nanColor( 255, 0, 0 )
 {
@@ -230,11 +380,184 @@ Service::Service( QObject * parent ) : Carta::Lib::IImageRenderService( parent )
     m_renderTimer.setInterval( 1 );
     connect( & m_renderTimer, & QTimer::timeout, this, & Me::internalRenderSlot );
 
-    m_frameCache.setMaxCost( 1 * 1024 * 1024 * 1024 ); // 1 gig
+    connect( & m_frameWatcher, & QFutureWatcher < QImage >::finished,
+             this, & Me::_frameRendered );
+
+    m_frameCache = Globals::instance()-> frameCache();
+    qRegisterMetaType < Carta::Core::FrameCacheKey > ();
+
+    // leave one core for the gui/main thread
+    m_prefetchPool.setMaxThreadCount( std::max( 1, QThread::idealThreadCount() - 1 ) );
 }
 
 Service::~Service()
-{ }
+{
+    // jobs post their results to us, make sure none of them outlive us
+    {
+        QMutexLocker locker( & m_prefetchWanted-> mutex );
+        m_prefetchWanted-> frameIds.clear();
+    }
+    m_prefetchPool.clear();
+    m_prefetchPool.waitForDone();
+}
+
+void
+Service::prefetch( const std::vector < std::pair < QString,
+                                                   NdArray::RawViewInterface::SharedPtr > > & views )
+{
+    QSet < FrameCacheKey > wanted;
+    std::vector < PrefetchJob * > jobs;
+
+    // jobs can only use a snapshot of the cached pipeline, as the raw pipeline is not
+    // guaranteed to be thread safe, and plugins filtering the raw data run on the
+    // main thread only
+    auto pm = Globals::instance()-> pluginManager();
+    bool canPrefetch = m_pixelPipelineRaw && m_pixelPipelineCacheSettings.enabled &&
+                       ! ( pm && pm-> hasPlugins < Carta::Lib::Hooks::PreRenderRawHook > () );
+    if ( canPrefetch ) {
+        QRgb nanColor = getNanColor().rgb();
+        std::shared_ptr < PrefetchJob::InterpPipeline > interpPipe;
+        std::shared_ptr < PrefetchJob::PlainPipeline > plainPipe;
+
+        // prefetched frames may take up half of the budget, the rest is for the frames
+        // that were shown recently
+        qint64 budget = m_frameCache-> budget() / 2;
+        qint64 used = 0;
+        for ( const auto & entry : views ) {
+            if ( entry.first.isEmpty() || ! entry.second || entry.second-> dims().size() < 2 ) {
+                continue;
+            }
+            used += qint64( entry.second-> dims()[0] ) * entry.second-> dims()[1] * 4;
+            if ( used > budget ) {
+                break;
+            }
+            FrameCacheKey frameKey = _mappedFrameKey( FrameCacheKey().add( entry.first ), nanColor );
+            wanted.insert( frameKey );
+
+            // touch() also marks the frame as recently used so it survives until shown
+            if ( m_prefetchPending.contains( frameKey ) ||
+                 m_frameCache-> touch( FrameCache::Tier::Mapped, frameKey ) ) {
+                continue;
+            }
+            if ( ! interpPipe && ! plainPipe ) {
+                double clipMin, clipMax;
+                m_pixelPipelineRaw-> getClips( clipMin, clipMax );
+                if ( m_pixelPipelineCacheSettings.interpolated ) {
+                    interpPipe = std::make_shared < PrefetchJob::InterpPipeline > ();
+                    interpPipe-> cache( * m_pixelPipelineRaw, m_pixelPipelineCacheSettings.size,
+                                        clipMin, clipMax );
+                }
+                else {
+                    plainPipe = std::make_shared < PrefetchJob::PlainPipeline > ();
+                    plainPipe-> cache( * m_pixelPipelineRaw, m_pixelPipelineCacheSettings.size,
+                                       clipMin, clipMax );
+                }
+            }
+            m_prefetchPending.insert( frameKey );
+            jobs.push_back( new PrefetchJob( this, frameKey, entry.second, interpPipe, plainPipe,
+                                             nanColor, m_readLock, m_prefetchWanted ) );
+        }
+    }
+
+    // jobs from earlier requests that are no longer wanted will not do any work
+    {
+        QMutexLocker locker( & m_prefetchWanted-> mutex );
+        m_prefetchWanted-> frameIds = wanted;
+    }
+    for ( PrefetchJob * job : jobs ) {
+        m_prefetchPool.start( job );
+    }
+}
+
+void
+Service::_prefetchDone( Carta::Core::FrameCacheKey frameKey, QImage image )
+{
+    m_prefetchPending.remove( frameKey );
+    m_frameCache-> insert( FrameCache::Tier::Mapped, frameKey, image );
+}
+
+bool
+Service::_startFrameRender( const FrameCacheKey & frameKey, QRgb nanColor,
+                            double clipMin, double clipMax )
+{
+    // only the cached pipeline is safe to use from another thread, and plugins
+    // filtering the raw data run on the main thread only
+    auto pm = Globals::instance()-> pluginManager();
+    if ( ! m_pixelPipelineCacheSettings.enabled ||
+         ( pm && pm-> hasPlugins < Carta::Lib::Hooks::PreRenderRawHook > () ) ) {
+        return false;
+    }
+
+    std::shared_ptr < Lib::PixelPipeline::CachedPipeline < true > > interpPipe;
+    std::shared_ptr < Lib::PixelPipeline::CachedPipeline < false > > plainPipe;
+    if ( m_pixelPipelineCacheSettings.interpolated ) {
+        if ( ! m_cachedPPinterp ) {
+            m_cachedPPinterp.reset( new Lib::PixelPipeline::CachedPipeline < true > () );
+            m_cachedPPinterp-> cache( * m_pixelPipelineRaw,
+                                      m_pixelPipelineCacheSettings.size, clipMin, clipMax );
+        }
+        interpPipe = m_cachedPPinterp;
+    }
+    else {
+        if ( ! m_cachedPP ) {
+            m_cachedPP.reset( new Lib::PixelPipeline::CachedPipeline < false > () );
+            m_cachedPP-> cache( * m_pixelPipelineRaw,
+                                m_pixelPipelineCacheSettings.size, clipMin, clipMax );
+        }
+        plainPipe = m_cachedPP;
+    }
+
+    // the job only holds on to shared pointers, so it can safely outlive us
+    NdArray::RawViewInterface::SharedPtr view = m_inputView;
+    std::shared_ptr < QMutex > readLock = m_readLock;
+    auto job = [view, readLock, interpPipe, plainPipe, nanColor] () -> QImage {
+        QImage image;
+        QMutexLocker locker( readLock.get() );
+        if ( interpPipe ) {
+            ::iView2qImage( view.get(), * interpPipe, image, nanColor );
+        }
+        else {
+            ::iView2qImage( view.get(), * plainPipe, image, nanColor );
+        }
+        return image;
+    };
+
+    m_frameJobRunning = true;
+    m_frameJobKey = frameKey;
+    m_frameJobGeneration = m_frameGeneration;
+    m_frameWatcher.setFuture( QtConcurrent::run( Globals::instance()-> renderPool(), job ) );
+    return true;
+} // _startFrameRender
+
+void
+Service::_frameRendered()
+{
+    m_frameJobRunning = false;
+    QImage image = m_frameWatcher.result();
+    m_frameCache-> insert( FrameCache::Tier::Mapped, m_frameJobKey, image );
+
+    // settings may have changed while we were rendering, in which case the
+    // frame is only good for the cache and we start over
+    if ( m_frameJobGeneration == m_frameGeneration ) {
+        m_frameImage = image;
+    }
+    internalRenderSlot();
+}
+
+FrameCacheKey
+Service::_mappedFrameKey( const FrameCacheKey & viewKey, QRgb nanColor ) const
+{
+    // view, pipeline, nan color and pixel pipeline cache settings
+    FrameCacheKey key = viewKey;
+    key.add( m_pixelPipelineKey );
+    key.add( qint64( nanColor ) );
+    key.add( qint64( m_pixelPipelineCacheSettings.enabled ) );
+    if ( m_pixelPipelineCacheSettings.enabled ) {
+        key.add( qint64( m_pixelPipelineCacheSettings.interpolated ) );
+        key.add( qint64( m_pixelPipelineCacheSettings.size ) );
+    }
+    return key;
+}
 
 QPointF
 Service::img2screen( const QPointF & p )
@@ -271,16 +594,43 @@ Service::screen2img( const QPointF & p )
     return res;
 }
 
+bool
+Service::_filterRawFrame()
+{
+    m_filteredFrame.clear();
+    auto pm = Globals::instance()-> pluginManager();
+    if ( ! pm || ! pm-> hasPlugins < Carta::Lib::Hooks::PreRenderRawHook > () ) {
+        return false;
+    }
+    const auto & dims = m_inputView-> dims();
+    if ( dims.size() < 2 ) {
+        return false;
+    }
+    ::rawView2frame( m_inputView.get(), m_filteredFrame );
+    pm-> prepare < Carta::Lib::Hooks::PreRenderRawHook > (
+        m_inputViewCacheId, dims[0], dims[1], m_filteredFrame.data() ).executeAll();
+    return true;
+}
+
+template < class Pipeline >
 void
-Service::internalRenderSlot()
+Service::_renderFrame( bool filtered, Pipeline & pipe, QRgb nanColor )
 {
-    //static int renderCount = 0;
-    //qDebug() << "Image render" << renderCount++ << "xyz";
+    if ( filtered ) {
+        QSize size( m_inputView-> dims()[0], m_inputView-> dims()[1] );
+        ::frame2qImage( m_filteredFrame, size, pipe, m_frameImage, nanColor );
+        // the frame image is all we need from now on
+        m_filteredFrame = std::vector < float > ();
+    }
+    else {
+        ::iView2qImage( m_inputView.get(), pipe, m_frameImage, nanColor );
+    }
+}
 
-    // raw double to base64 converter
-    auto d2hex = [] (double x) -> QString {
-        return QByteArray( (char *) ( & x ), sizeof( x ) ).toBase64();
-    };
+void
+Service::internalRenderSlot()
+{
+    CARTA_TRACE_SCOPE( "render", "internalRenderSlot" );
 
     double clipMin, clipMax;
     m_pixelPipelineRaw-> getClips( clipMin, clipMax );
@@ -290,50 +640,26 @@ Service::internalRenderSlot()
         m_pixelPipelineRaw->convertq( clipMin, nanColor );
     }
 
-    // cache id will be concatenation of:
-    // view id
-    // pipeline id
-    // output size
-    // pan
-    // zoom
-    // nan
-    // pixel pipeline cache settings
-    // Floats are binary-encoded (base64)
-    QString cacheId = QString( "%1/%2/%3x%4/%5,%6/%7/%8" )
-                          .arg( m_inputViewCacheId )
-                          .arg( m_pixelPipelineCacheId )
-                          .arg( m_outputSize.width() )
-                          .arg( m_outputSize.height() )
-                          .arg( d2hex( m_pan.x() ) )
-                          .arg( d2hex( m_pan.y() ) )
-                          .arg( d2hex( m_zoom ) )
-                          .arg( QString::number(nanColor) );
-
-
-    if ( m_pixelPipelineCacheSettings.enabled ) {
-        cacheId += QString( "/1/%1/%2" )
-                       .arg( int (m_pixelPipelineCacheSettings.interpolated) )
-                       .arg( m_pixelPipelineCacheSettings.size );
-    }
-    else {
-        cacheId += "/0";
-    }
-
-//    qDebug() << "internalRenderSlot... cache size: "
-//             << m_frameCache.totalCost() * 100.0 / m_frameCache.maxCost() << "% "
-//             << m_frameCache.size() << "entries";
-//    qDebug() << "id:" << cacheId;
-    struct Scope {
-        ~Scope() { /*qDebug() << "internalRenderSlot done";*/ } }
-    debugScopeGuard;
-
-    auto cachedImage = m_frameCache.object( cacheId );
-    if ( cachedImage ) {
-        //qDebug() << "frame cache hit";
-        emit done( * cachedImage, m_lastSubmittedJobId );
-        return;
+    // the composited image depends on the colour-mapped frame, output size, pan and
+    // zoom, an uncached view (null key) is never looked up
+    FrameCacheKey frameKey;
+    FrameCacheKey viewportKey;
+    if ( ! m_inputViewKey.isNull() ) {
+        frameKey = _mappedFrameKey( m_inputViewKey, nanColor );
+        viewportKey = frameKey;
+        viewportKey.add( qint64( m_outputSize.width() ) )
+            .add( qint64( m_outputSize.height() ) )
+            .add( m_pan.x() )
+            .add( m_pan.y() )
+            .add( m_zoom );
+
+        QImage cachedImage;
+        if ( m_frameCache-> find( FrameCache::Tier::Composited, viewportKey, cachedImage ) ) {
+            CARTA_TRACE_COUNT( "render.compositedHit", 1 );
+            emit done( cachedImage, m_lastSubmittedJobId );
+            return;
+        }
     }
-    //qDebug() << "frame cache miss";
 
     if ( ! m_inputView ) {
         qCritical() << "input view not set";
@@ -348,9 +674,33 @@ Service::internalRenderSlot()
 
 
 
+    // reuse a colour-mapped frame (possibly prefetched) if we have one, so switching
+    // back to a frame only needs to redo pan/zoom
+    if ( m_frameImage.isNull() && ! frameKey.isNull() ) {
+        m_frameCache-> find( FrameCache::Tier::Mapped, frameKey, m_frameImage );
+    }
+
     // render the frame if needed
     if ( m_frameImage.isNull() ) {
+        CARTA_TRACE_COUNT( "render.frameMiss", 1 );
 
+        // a frame is already being rendered in the background, we continue when it
+        // arrives
+        if ( m_frameJobRunning ) {
+            return;
+        }
+        if ( _startFrameRender( frameKey, nanColor, clipMin, clipMax ) ) {
+            return;
+        }
+
+        // prefetch jobs and other users of the image may be reading from it
+        QMutexLocker locker( m_readLock.get() );
+
+        // give plugins a chance to filter the raw data, the whole frame is handed
+        // over at once in a contiguous buffer
+        bool filtered = _filterRawFrame();
+
+        // render either the filtered frame or straight from the input view
         if ( pixelPipelineCacheSettings().enabled ) {
             if ( pixelPipelineCacheSettings().interpolated ) {
                 if ( ! m_cachedPPinterp ) {
@@ -358,7 +708,7 @@ Service::internalRenderSlot()
                     m_cachedPPinterp-> cache( * m_pixelPipelineRaw,
                             pixelPipelineCacheSettings().size, clipMin, clipMax );
                 }
-                ::iView2qImage( m_inputView.get(), * m_cachedPPinterp, m_frameImage, nanColor );
+                _renderFrame( filtered, * m_cachedPPinterp, nanColor );
             }
             else {
                 if ( ! m_cachedPP ) {
@@ -366,12 +716,14 @@ Service::internalRenderSlot()
                     m_cachedPP-> cache( * m_pixelPipelineRaw,
                             pixelPipelineCacheSettings().size, clipMin, clipMax );
                 }
-                ::iView2qImage( m_inputView.get(), * m_cachedPP, m_frameImage, nanColor );
+                _renderFrame( filtered, * m_cachedPP, nanColor );
             }
         }
         else {
-            ::iView2qImage( m_inputView.get(), * m_pixelPipelineRaw, m_frameImage, nanColor );
+            _renderFrame( filtered, * m_pixelPipelineRaw, nanColor );
         }
+
+        m_frameCache-> insert( FrameCache::Tier::Mapped, frameKey, m_frameImage );
     }
 
     // prepare output
@@ -446,7 +798,7 @@ Service::internalRenderSlot()
 
 
     // insert this image into frame cache
-    m_frameCache.insert( cacheId, new QImage( img ), img.byteCount() );
+    m_frameCache-> insert( FrameCache::Tier::Composited, viewportKey, img );
 
 } // internalRenderSlot
 
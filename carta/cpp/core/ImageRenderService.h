@@ -33,12 +33,16 @@
 #include "CartaLib/PixelPipeline/IPixelPipeline.h"
 #include "CartaLib/Nullable.h"
 #include "CartaLib/IImageRenderService.h"
+#include "FrameCache.h"
 #include <QImage>
 #include <QObject>
 #include <QColor>
 #include <QStringList>
-#include <QCache>
 #include <QTimer>
+#include <QThreadPool>
+#include <QFutureWatcher>
+#include <QMutex>
+#include <QSet>
 
 namespace Carta
 {
@@ -54,6 +58,14 @@ typedef Lib::PixelPipeline::IClippedPixelPipeline IClippedPixelPipeline;
 /// job id
 typedef int64_t JobId;
 
+/// frame ids the latest prefetch request still wants, shared between the service
+/// and its prefetch jobs so that outdated jobs can bail out early
+struct PrefetchWanted
+{
+    QMutex mutex;
+    QSet < FrameCacheKey > frameIds;
+};
+
 /// Implementation of the rendering service
 /// \warning this object could potentially live it a separate thread, so make all connections
 /// to it as explicitly queued
@@ -99,6 +111,14 @@ public:
     setInputView( Carta::Lib::NdArray::RawViewInterface::SharedPtr view,
                   QString cacheId = QString() ) override;
 
+    ///
+    /// \brief sets the lock to hold while reading from the input views
+    /// \param readLock the read lock of the image the views come from, shared with
+    /// every other reader of that image (see ImageRegistry::getReadLock)
+    ///
+    void
+    setReadLock( std::shared_ptr < QMutex > readLock );
+
     ///
     /// \brief set the desired output size of the image
     /// \param size the size to output
@@ -176,6 +196,16 @@ public:
     virtual QPointF
     screen2img( const QPointF & p ) override;
 
+    /// \brief read and colour-map the given views in the background, so that a later
+    /// setInputView() with one of the cache ids does not have to touch the data again
+    /// \param views pairs of (cache id, view), the most urgent first
+    ///
+    /// Any earlier prefetch requests that have not started yet are abandoned. Only as
+    /// many views as fit into half of the frame cache budget are prefetched.
+    void
+    prefetch( const std::vector < std::pair < QString,
+                                              Carta::Lib::NdArray::RawViewInterface::SharedPtr > > & views );
+
 public slots:
 
     /// ask the service to render using the current settings and use the given
@@ -200,12 +230,49 @@ protected slots:
     void
     internalRenderSlot();
 
+private slots:
+
+    /// a prefetch job finished, image is null if the job was abandoned
+    void
+    _prefetchDone( Carta::Core::FrameCacheKey frameKey, QImage image );
+
+    /// the frame started by _startFrameRender() is ready
+    void
+    _frameRendered();
+
 private:
 
+    /// key of a colour-mapped frame of the given view rendered with the current pipeline
+    FrameCacheKey
+    _mappedFrameKey( const FrameCacheKey & viewKey, QRgb nanColor ) const;
+
+    /// if any plugins listen to PreRenderRawHook, read the input view into
+    /// m_filteredFrame and let the plugins modify it
+    /// \return true if the frame should be rendered from m_filteredFrame
+    bool
+    _filterRawFrame();
+
+    /// colour-map the input view on the shared render pool, so that services of other
+    /// layers can render at the same time, _frameRendered() is called when done
+    /// \return false if the frame has to be rendered on this thread
+    bool
+    _startFrameRender( const FrameCacheKey & frameKey, QRgb nanColor,
+                       double clipMin, double clipMax );
+
+    /// render m_frameImage from the filtered frame or the input view
+    template < class Pipeline >
+    void
+    _renderFrame( bool filtered, Pipeline & pipe, QRgb nanColor );
+
     // the following are rendering parameters
     Carta::Lib::NdArray::RawViewInterface::SharedPtr m_inputView = nullptr;
     QString m_inputViewCacheId;
     QString m_pixelPipelineCacheId;
+
+    /// hashed versions of the above, the view key is null if the view should not be cached
+    FrameCacheKey m_inputViewKey;
+    FrameCacheKey m_pixelPipelineKey;
+
     QSize m_outputSize = QSize( 10, 10 );
 
     /// instance of the pixel pipeline (very likely slow)
@@ -217,17 +284,43 @@ private:
     /// current pan (coordinates of the image pixel that is to be centered on the screen)
     QPointF m_pan = QPointF( 0, 0 );
 
-    // cached pipelines
-    Lib::PixelPipeline::CachedPipeline < true >::UniquePtr m_cachedPPinterp = nullptr;
-    Lib::PixelPipeline::CachedPipeline < false >::UniquePtr m_cachedPP = nullptr;
+    // cached pipelines, shared with the background frame render
+    Lib::PixelPipeline::CachedPipeline < true >::SharedPtr m_cachedPPinterp = nullptr;
+    Lib::PixelPipeline::CachedPipeline < false >::SharedPtr m_cachedPP = nullptr;
     PixelPipelineCacheSettings m_pixelPipelineCacheSettings;
 
     /// here we store the whole frame rendered, it is essentially a cache to make
     /// pan/zoom to work faster
     QImage m_frameImage;
 
-    /// cache for individual frames (to make movie playing little bit faster)
-    QCache < QString, QImage > m_frameCache;
+    /// incremented whenever m_frameImage is invalidated
+    quint64 m_frameGeneration = 0;
+
+    /// frame being rendered on the render pool
+    QFutureWatcher < QImage > m_frameWatcher;
+    bool m_frameJobRunning = false;
+    FrameCacheKey m_frameJobKey;
+    quint64 m_frameJobGeneration = 0;
+
+    /// raw values of the frame as modified by PreRenderRawHook plugins
+    std::vector < float > m_filteredFrame;
+
+    /// colour-mapped and composited frames, shared with all other services
+    FrameCache * m_frameCache = nullptr;
+
+    /// background threads for prefetching
+    QThreadPool m_prefetchPool;
+
+    /// ids of frames queued or being prefetched
+    QSet < FrameCacheKey > m_prefetchPending;
+
+    /// frame ids the latest prefetch request still wants
+    std::shared_ptr < PrefetchWanted > m_prefetchWanted;
+
+    /// serializes reading from the image, as image plugins are not required to
+    /// support concurrent reads; until setReadLock() is called the service has a lock
+    /// of its own, which only keeps its own jobs apart
+    std::shared_ptr < QMutex > m_readLock;
 
     /// last requested job id
     JobId m_lastSubmittedJobId = - 1;
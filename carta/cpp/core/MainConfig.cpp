@@ -11,6 +11,7 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QDir>
+#include <QFileInfo>
 #include <QCoreApplication>
 #include <cmath>
 
@@ -84,12 +85,27 @@ ParsedInfo parse(const QString & filePath)
         info.m_pluginDirectories.append( QDir::cleanPath(raw));
     }
 
+    // the plugin discovery cache goes next to the config file unless configured
+    QJsonValue pluginCache = json[ "pluginCache"];
+    if( pluginCache.isString()) {
+        QString raw = pluginCache.toString();
+        raw.replace( "$(HOME)", QDir::homePath());
+        info.m_pluginCacheFile = raw.isEmpty() ? raw : QDir::cleanPath( raw);
+    }
+    else {
+        info.m_pluginCacheFile = QFileInfo( filePath).absolutePath() + "/pluginCache.json";
+    }
+    _storeBool( json["eagerPluginLoading"], &info.m_eagerPluginLoading, "eager plugin loading");
+    _storeBool( json["tracing"], &info.m_tracing, "tracing");
+
     _storeBool( json["hacksEnabled"], &info.m_hacksEnabled, "hacks enabled");
     _storeBool( json["developerLayout"], &info.m_developerLayout, "developer layout");
     _storeBool( json["qtDecorations"], &info.m_developerDecorations, "developer decorations");
 
     _storePositiveInt( json["histogramBinCountMax"], &info.m_histogramBinCountMax, "histogram bin count max");
     _storePositiveInt( json["contourLevelCountMax"], &info.m_contourLevelCountMax, "contour level count max");
+    _storePositiveInt( json["frameCacheSizeMB"], &info.m_frameCacheSizeMB, "frame cache size");
+    _storePositiveInt( json["memoryBudgetMB"], &info.m_memoryBudgetMB, "memory budget");
 
     return info;
 }
@@ -99,6 +115,21 @@ const QStringList & ParsedInfo::pluginDirectories() const
     return m_pluginDirectories;
 }
 
+const QString & ParsedInfo::pluginCacheFile() const
+{
+    return m_pluginCacheFile;
+}
+
+bool ParsedInfo::isEagerPluginLoading() const
+{
+    return m_eagerPluginLoading;
+}
+
+bool ParsedInfo::isTracing() const
+{
+    return m_tracing;
+}
+
 bool ParsedInfo::hacksEnabled() const
 {
     qDebug() << "Hacks enabled retuning "<<m_hacksEnabled;
@@ -118,6 +149,14 @@ int ParsedInfo::getContourLevelCountMax() const {
     return m_contourLevelCountMax;
 }
 
+int ParsedInfo::getFrameCacheSizeMB() const {
+    return m_frameCacheSizeMB;
+}
+
+int ParsedInfo::getMemoryBudgetMB() const {
+    return m_memoryBudgetMB;
+}
+
 int ParsedInfo::getHistogramBinCountMax() const {
     return m_histogramBinCountMax;
 }
@@ -40,6 +40,43 @@ public:
      */
     int getContourLevelCountMax() const;
 
+    /**
+     * Returns any valid user set size of the frame cache in megabytes or -1 if no
+     * valid user supplied value has been provided.
+     * @return the frame cache size in megabytes or -1 if no valid value has
+     *   been specified.
+     */
+    int getFrameCacheSizeMB() const;
+
+    /**
+     * Returns any valid user set limit on the memory used by caches and large
+     * buffers in megabytes or -1 if no valid user supplied value has been provided.
+     * @return the memory budget in megabytes or -1 if no valid value has
+     *   been specified.
+     */
+    int getMemoryBudgetMB() const;
+
+    /**
+     * Returns the file in which the results of plugin discovery are cached between
+     * runs, or an empty string if they should not be cached.
+     * @return the location of the plugin discovery cache.
+     */
+    const QString & pluginCacheFile() const;
+
+    /**
+     * Returns whether all plugins should be loaded at startup, rather than when one
+     * of their hooks is first used.
+     * @return true to load all plugins at startup; false otherwise.
+     */
+    bool isEagerPluginLoading() const;
+
+    /**
+     * Returns whether hot paths should be traced from startup.
+     * @return true to record timings from startup; false to wait until tracing is
+     *      turned on by a scripted client.
+     */
+    bool isTracing() const;
+
     /// whether hacks are enabled or not
     bool hacksEnabled() const;
 
@@ -83,11 +120,16 @@ public:
 protected:
 
     QStringList m_pluginDirectories;
+    QString m_pluginCacheFile;
+    bool m_eagerPluginLoading = false;
+    bool m_tracing = false;
     bool m_hacksEnabled = false;
     bool m_developerDecorations = false;
     bool m_developerLayout = false;
     int m_histogramBinCountMax = -1;
     int m_contourLevelCountMax = -1;
+    int m_frameCacheSizeMB = -1;
+    int m_memoryBudgetMB = -1;
 
     QJsonObject m_json;
 
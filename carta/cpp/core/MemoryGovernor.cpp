@@ -0,0 +1,190 @@
+/**
+ *
+ **/
+
+#include "MemoryGovernor.h"
+#include <QMutexLocker>
+#include <algorithm>
+
+namespace Carta
+{
+namespace Core
+{
+constexpr qint64 MemoryGovernor::DefaultBudget;
+
+MemoryGovernor::Reservation::Reservation( MemoryGovernor * governor, const QString & name,
+                                          qint64 bytes )
+    : m_governor( governor )
+{
+    if ( ! m_governor || bytes <= 0 ) {
+        return;
+    }
+    m_fits = m_governor-> reserve( bytes );
+    m_id = m_governor-> addConsumer( name );
+    m_governor-> setBytes( m_id, bytes );
+}
+
+MemoryGovernor::Reservation::~Reservation()
+{
+    if ( m_governor && m_id >= 0 ) {
+        m_governor-> removeConsumer( m_id );
+    }
+}
+
+bool
+MemoryGovernor::Reservation::fits() const
+{
+    return m_fits;
+}
+
+MemoryGovernor::MemoryGovernor( qint64 budget )
+    : m_budget( budget )
+{ }
+
+int
+MemoryGovernor::addConsumer( const QString & name, EvictFunc evict )
+{
+    QMutexLocker locker( & m_mutex );
+    int id = m_nextId++;
+    Consumer & consumer = m_consumers[id];
+    consumer.stats.name = name;
+    consumer.stats.evictable = static_cast < bool > ( evict );
+    consumer.evict = evict;
+    return id;
+}
+
+void
+MemoryGovernor::removeConsumer( int id )
+{
+    QMutexLocker locker( & m_mutex );
+    auto iter = m_consumers.find( id );
+    if ( iter == m_consumers.end() ) {
+        return;
+    }
+    m_bytes -= iter.value().stats.bytes;
+    m_consumers.erase( iter );
+}
+
+void
+MemoryGovernor::setBytes( int id, qint64 bytes )
+{
+    QMutexLocker locker( & m_mutex );
+    auto iter = m_consumers.find( id );
+    if ( iter == m_consumers.end() ) {
+        return;
+    }
+    ConsumerStats & stats = iter.value().stats;
+    m_bytes += bytes - stats.bytes;
+    stats.bytes = bytes;
+    stats.peakBytes = std::max( stats.peakBytes, bytes );
+}
+
+bool
+MemoryGovernor::reserve( qint64 bytes )
+{
+    // each round asks the largest consumer that can help; the consumers report their
+    // new usage through setBytes() from within the callback
+    const int MaxRounds = 64;
+    for ( int round = 0 ; round < MaxRounds ; round++ ) {
+        std::vector < std::pair < qint64, EvictFunc > > candidates;
+        qint64 over = 0;
+        {
+            QMutexLocker locker( & m_mutex );
+            over = _overBudget( bytes );
+            if ( over <= 0 ) {
+                return true;
+            }
+            for ( const Consumer & consumer : m_consumers ) {
+                if ( consumer.evict && consumer.stats.bytes > 0 ) {
+                    candidates.push_back( std::make_pair( consumer.stats.bytes, consumer.evict ) );
+                }
+            }
+        }
+        std::sort( candidates.begin(), candidates.end(),
+                   [] ( const std::pair < qint64, EvictFunc > & a,
+                        const std::pair < qint64, EvictFunc > & b ) {
+                       return a.first > b.first;
+                   } );
+        bool freed = false;
+        for ( auto & candidate : candidates ) {
+            qint64 freedBytes = candidate.second( over );
+            {
+                QMutexLocker locker( & m_mutex );
+                m_evictions++;
+            }
+            if ( freedBytes > 0 ) {
+                freed = true;
+                break;
+            }
+        }
+        if ( ! freed ) {
+            return false;
+        }
+    }
+    QMutexLocker locker( & m_mutex );
+    return _overBudget( bytes ) <= 0;
+} // reserve
+
+bool
+MemoryGovernor::relieve()
+{
+    return reserve( 0 );
+}
+
+void
+MemoryGovernor::setBudget( qint64 bytes )
+{
+    {
+        QMutexLocker locker( & m_mutex );
+        m_budget = bytes;
+    }
+    relieve();
+}
+
+qint64
+MemoryGovernor::budget() const
+{
+    QMutexLocker locker( & m_mutex );
+    return m_budget;
+}
+
+qint64
+MemoryGovernor::bytesUsed() const
+{
+    QMutexLocker locker( & m_mutex );
+    return m_bytes;
+}
+
+std::vector < MemoryGovernor::ConsumerStats >
+MemoryGovernor::stats() const
+{
+    QMutexLocker locker( & m_mutex );
+    std::vector < ConsumerStats > result;
+    for ( const Consumer & consumer : m_consumers ) {
+        result.push_back( consumer.stats );
+    }
+    std::sort( result.begin(), result.end(),
+               [] ( const ConsumerStats & a, const ConsumerStats & b ) {
+                   return a.bytes > b.bytes;
+               } );
+    return result;
+}
+
+quint64
+MemoryGovernor::evictionCount() const
+{
+    QMutexLocker locker( & m_mutex );
+    return m_evictions;
+}
+
+qint64
+MemoryGovernor::_overBudget( qint64 extra ) const
+{
+    qint64 over = 0;
+    if ( m_budget > 0 ) {
+        over = m_bytes + extra - m_budget;
+    }
+    return over;
+}
+}
+}
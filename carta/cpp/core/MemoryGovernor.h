@@ -0,0 +1,146 @@
+/**
+ * Process wide accounting of large memory users.
+ *
+ * Caches and large allocations register here as consumers and report how many bytes
+ * they hold. Caches also supply an eviction callback. Whenever an allocation is
+ * reserved, or a cache reports pressure, the governor checks the budget and asks the
+ * evictable consumers (largest first) to free memory until it is met.
+ *
+ * The governor only trims caches and reports; it never refuses an allocation. If the
+ * caches cannot free enough, the allocation goes ahead over budget and shows up as
+ * such in stats(). Each server session runs in its own process, so the budget is the
+ * budget of a session.
+ *
+ * Recording usage never evicts, so setBytes() can be called while holding the
+ * consumer's own locks. reserve() and relieve() call eviction callbacks and must be
+ * called without holding any lock an eviction callback takes.
+ *
+ * Transient allocations (permuted copies, quantile buffers) use Reservation, which
+ * makes room before the allocation and accounts for the bytes while it lives.
+ **/
+
+#pragma once
+
+#include "CartaLib/CartaLib.h"
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <functional>
+#include <vector>
+
+namespace Carta
+{
+namespace Core
+{
+class MemoryGovernor
+{
+    CLASS_BOILERPLATE( MemoryGovernor );
+
+public:
+
+    /// asked to free the given number of bytes, returns the number of bytes freed
+    typedef std::function < qint64 ( qint64 ) > EvictFunc;
+
+    /// accounting of a single consumer
+    struct ConsumerStats
+    {
+        QString name;
+        qint64 bytes = 0;
+        qint64 peakBytes = 0;
+        bool evictable = false;
+    };
+
+    /// makes room for an allocation and accounts for it while it exists
+    class Reservation
+    {
+    public:
+
+        /// governor can be null, in which case nothing is accounted
+        Reservation( MemoryGovernor * governor, const QString & name, qint64 bytes );
+
+        ~Reservation();
+
+        /// whether the allocation fitted in the budget after eviction; it is
+        /// accounted either way
+        bool
+        fits() const;
+
+    private:
+
+        MemoryGovernor * m_governor;
+        int m_id = - 1;
+        bool m_fits = true;
+
+        Reservation( const Reservation & ) = delete;
+        Reservation &
+        operator= ( const Reservation & ) = delete;
+    };
+
+    /// default global budget if nothing is configured
+    static constexpr qint64 DefaultBudget = 4LL * 1024 * 1024 * 1024;
+
+    /// a budget of 0 or less is unlimited
+    explicit
+    MemoryGovernor( qint64 budget = DefaultBudget );
+
+    /// register a consumer
+    /// \return id of the consumer
+    int
+    addConsumer( const QString & name, EvictFunc evict = nullptr );
+
+    void
+    removeConsumer( int id );
+
+    /// record the bytes currently held by a consumer, never evicts
+    void
+    setBytes( int id, qint64 bytes );
+
+    /// make room for an allocation of the given size
+    /// \return true if the allocation fits in the budget
+    bool
+    reserve( qint64 bytes );
+
+    /// evict until the budget is met
+    /// \return true if the budget is met
+    bool
+    relieve();
+
+    void
+    setBudget( qint64 bytes );
+
+    qint64
+    budget() const;
+
+    /// bytes held by all consumers
+    qint64
+    bytesUsed() const;
+
+    /// accounting of all consumers
+    std::vector < ConsumerStats >
+    stats() const;
+
+    /// number of eviction callbacks made so far
+    quint64
+    evictionCount() const;
+
+private:
+
+    struct Consumer
+    {
+        ConsumerStats stats;
+        EvictFunc evict;
+    };
+
+    /// bytes over the budget if extra bytes were added
+    qint64
+    _overBudget( qint64 extra ) const;
+
+    mutable QMutex m_mutex;
+    QHash < int, Consumer > m_consumers;
+    int m_nextId = 0;
+    qint64 m_budget;
+    qint64 m_bytes = 0;
+    quint64 m_evictions = 0;
+};
+}
+}
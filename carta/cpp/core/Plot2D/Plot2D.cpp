@@ -2,13 +2,19 @@
 #include "Data/Plotter/LineStyles.h"
 #include "Data/Histogram/PlotStyles.h"
 #include "CartaLib/PixelPipeline/CustomizablePixelPipeline.h"
+#include "CartaLib/Algorithms/CurveDecimation.h"
+#include <qwt_scale_map.h>
 #include <QDebug>
+#include <cmath>
 
 namespace Carta {
 namespace Plot2D {
 
 using Carta::Data::LineStyles;
 
+const int Plot2D::DECIMATION_LEVELS = 8;
+const int Plot2D::DECIMATION_DENSITY = 4;
+
 Plot2D::Plot2D():
     m_defaultColor( "#6699CC" ),
     m_brush( m_defaultColor ){
@@ -18,10 +24,44 @@ Plot2D::Plot2D():
 
 }
 
+void Plot2D::_clearDecimated(){
+    m_decimated.clear();
+}
+
 std::pair<double,double> Plot2D::getBoundsY() const {
     return std::pair<double,double>( m_minValueY, m_maxValueY );
 }
 
+const std::vector<int>* Plot2D::_getDecimated( const QwtScaleMap& xMap, int from, int to,
+        const double* xs, const double* ys, bool maxOnly ) const {
+    int columns = static_cast<int>( std::ceil( std::fabs( xMap.pDist() ) ) );
+    int count = to - from + 1;
+    if ( columns <= 0 || count <= DECIMATION_DENSITY * columns ){
+        return nullptr;
+    }
+    ZoomKey key( xMap.s1(), xMap.s2(), columns, from, to );
+    auto iter = m_decimated.find( key );
+    if ( iter == m_decimated.end() ){
+        if ( static_cast<int>( m_decimated.size() ) >= DECIMATION_LEVELS ){
+            m_decimated.clear();
+        }
+        std::vector<int> indices;
+        if ( maxOnly ){
+            indices = Carta::Lib::Algorithms::maxPerColumn( xs + from, ys + from, count,
+                    xMap.s1(), xMap.s2(), columns );
+        }
+        else {
+            indices = Carta::Lib::Algorithms::m4Decimate( xs + from, ys + from, count,
+                    xMap.s1(), xMap.s2(), columns );
+        }
+        for ( int& index : indices ){
+            index = index + from;
+        }
+        iter = m_decimated.insert( std::make_pair( key, indices ) ).first;
+    }
+    return &iter->second;
+}
+
 QString Plot2D::getId() const {
     return m_id;
 }
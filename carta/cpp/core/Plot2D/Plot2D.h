@@ -3,10 +3,14 @@
  */
 #pragma once
 
+#include "CartaLib/CurveBuffer.h"
 #include <QString>
 #include <QBrush>
 #include <qwt_plot.h>
+#include <map>
 #include <memory>
+#include <tuple>
+#include <vector>
 
 namespace Carta {
     namespace Lib {
@@ -16,6 +20,7 @@ namespace Carta {
     }
 }
 class QPainter;
+class QwtScaleMap;
 
 namespace Carta {
 namespace Plot2D {
@@ -74,9 +79,9 @@ public:
 
     /**
      * Store the data to be plotted.
-     * @param data the plot data.
+     * @param data the plot data; its storage is shared rather than copied.
      */
-    virtual void setData ( std::vector<std::pair<double,double> > data ) = 0;
+    virtual void setData ( const Carta::Lib::CurveBuffer& data ) = 0;
 
     /**
      * Set the draw style for the data (outline, filled, line).
@@ -116,6 +121,28 @@ public:
 
 
 protected:
+
+    /**
+     * Return the points to draw when the data has many more points than there are
+     * pixel columns; the result is cached for each zoom level.
+     * @param xMap - maps the x-values to pixels.
+     * @param from - the index of the first point to draw.
+     * @param to - the index of the last point to draw.
+     * @param xs - the x-values of the points.
+     * @param ys - the y-values of the points.
+     * @param maxOnly - true to keep only the largest value of each column (for columns
+     *      drawn from a baseline); false to keep the first, last, smallest and largest
+     *      (for lines).
+     * @return - the indices of the points to draw or nullptr if all of them should be drawn.
+     */
+    const std::vector<int>* _getDecimated( const QwtScaleMap& xMap, int from, int to,
+            const double* xs, const double* ys, bool maxOnly ) const;
+
+    /**
+     * Forget decimated points; to be called when the data changes.
+     */
+    void _clearDecimated();
+
     std::shared_ptr<Carta::Lib::PixelPipeline::CustomizablePixelPipeline> m_pipeline;
     QString m_drawStyle;
     Qt::PenStyle m_penStyle;
@@ -126,6 +153,14 @@ protected:
     double m_minValueY;
     QString m_id;
 
+    //Decimated points by zoom level (visible x-range, pixel columns, from, to).
+    typedef std::tuple<double,double,int,int,int> ZoomKey;
+    mutable std::map<ZoomKey, std::vector<int> > m_decimated;
+    //Number of zoom levels that are cached.
+    static const int DECIMATION_LEVELS;
+    //Points per pixel column above which data is decimated.
+    static const int DECIMATION_DENSITY;
+
     Plot2D( const Plot2D& other);
     Plot2D& operator=( const Plot2D& other );
 
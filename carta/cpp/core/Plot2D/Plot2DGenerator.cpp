@@ -7,6 +7,8 @@
 #include <qwt_scale_engine.h>
 #include <qwt_scale_widget.h>
 #include <qwt_plot_renderer.h>
+#include <qwt_scale_map.h>
+#include <QPainter>
 #include "Data/Plotter/LegendLocations.h"
 #include "CartaLib/PixelPipeline/CustomizablePixelPipeline.h"
 
@@ -17,11 +19,33 @@ namespace Plot2D {
 const double Plot2DGenerator::EXTRA_RANGE_PERCENT = 0.05;
 
 
+//Draws nothing; it remembers the scale maps and canvas rectangle used when the plot
+//was rendered, so the overlay can be painted onto the rendered image later.
+class Plot2DGenerator::CanvasRecorder : public QwtPlotItem {
+public:
+    CanvasRecorder(){
+        setZ( -1 );
+    }
+
+    virtual void draw( QPainter* /*painter*/, const QwtScaleMap& xMap,
+            const QwtScaleMap& yMap, const QRectF& canvasRect ) const Q_DECL_OVERRIDE {
+        m_xMap = xMap;
+        m_yMap = yMap;
+        m_canvasRect = canvasRect;
+    }
+
+    mutable QwtScaleMap m_xMap;
+    mutable QwtScaleMap m_yMap;
+    mutable QRectF m_canvasRect;
+};
+
+
 Plot2DGenerator::Plot2DGenerator( PlotType plotType ):
     m_rangeColor( nullptr ),
     m_vLine( nullptr ),
     m_gridLines( nullptr),
-    m_font( "Helvetica", 10){
+    m_font( "Helvetica", 10),
+    m_baseDirty( true ){
     m_legendVisible = false;
     m_logScale = false;
     m_legendPosition = Carta::Data::LegendLocations::BOTTOM;
@@ -37,6 +61,9 @@ Plot2DGenerator::Plot2DGenerator( PlotType plotType ):
     m_range = new Plot2DSelection();
     m_range->attach(m_plot);
 
+    m_canvasRecorder = new CanvasRecorder();
+    m_canvasRecorder->attach( m_plot );
+
 
     if ( plotType == PlotType::PROFILE ){
         m_vLine = new Plot2DLine();
@@ -54,10 +81,11 @@ Plot2DGenerator::Plot2DGenerator( PlotType plotType ):
 }
 
 
-void Plot2DGenerator::addData(std::vector<std::pair<double,double> > dataVector,
+void Plot2DGenerator::addData( const Carta::Lib::CurveBuffer& dataVector,
         const QString& id ){
+    m_baseDirty = true;
 
-    if ( dataVector.size() == 0 ){
+    if ( dataVector.isEmpty() ){
         return;
     }
 
@@ -90,6 +118,7 @@ void Plot2DGenerator::addData(std::vector<std::pair<double,double> > dataVector,
 
 
 void Plot2DGenerator::clearData(){
+    m_baseDirty = true;
     int dataCount = m_datas.size();
     for ( int i = 0; i < dataCount; i++ ){
         m_datas[i]->detachFromPlot();
@@ -100,14 +129,12 @@ void Plot2DGenerator::clearData(){
 
 void Plot2DGenerator::clearSelection(){
     m_range->reset();
-    m_plot->replot();
 }
 
 
 void Plot2DGenerator::clearSelectionColor(){
     if ( m_rangeColor != nullptr ){
         m_rangeColor->reset();
-        m_plot->replot();
     }
 }
 
@@ -229,6 +256,7 @@ std::pair<double,double> Plot2DGenerator::getWorldPt(int x, int y, int width, in
 }
 
 void Plot2DGenerator::removeData( const QString& dataName ){
+    m_baseDirty = true;
     std::shared_ptr<Plot2D> pData = _findData( dataName );
     if ( pData ){
         pData->detachFromPlot();
@@ -237,12 +265,14 @@ void Plot2DGenerator::removeData( const QString& dataName ){
 }
 
 void Plot2DGenerator::setAxisXRange( double min, double max ){
+    m_baseDirty = true;
     m_plot->setAxisScale( QwtPlot::xBottom, min, max );
     m_plot->replot();
 }
 
 
 void Plot2DGenerator::setColor( QColor color, const QString& id ){
+    m_baseDirty = true;
     if ( id.isEmpty() || id.trimmed().length() == 0 ){
         int dataCount = m_datas.size();
         for ( int i = 0; i < dataCount; i++ ){
@@ -263,6 +293,7 @@ void Plot2DGenerator::setColor( QColor color, const QString& id ){
 
 
 void Plot2DGenerator::setColored( bool colored, const QString& id ){
+    m_baseDirty = true;
     if ( id.isEmpty() || id.trimmed().length() == 0 ){
         int dataCount = m_datas.size();
         for ( int i = 0; i < dataCount; i++ ){
@@ -278,6 +309,7 @@ void Plot2DGenerator::setColored( bool colored, const QString& id ){
 }
 
 void Plot2DGenerator::setCurveName( const QString& oldName, const QString& newName ){
+    m_baseDirty = true;
     std::shared_ptr<Plot2D> plotData = _findData( oldName );
     if ( plotData ){
         plotData->setId( newName );
@@ -285,6 +317,7 @@ void Plot2DGenerator::setCurveName( const QString& oldName, const QString& newNa
 }
 
 void Plot2DGenerator::setGridLines( bool showGrid ){
+    m_baseDirty = true;
     if ( !m_gridLines ){
         m_gridLines = new QwtPlotGrid();
         m_gridLines->enableX( false );
@@ -316,6 +349,7 @@ void Plot2DGenerator::setLegendLocation( const QString& position ){
 }
 
 void Plot2DGenerator::setLegendLine( bool showLegendLine ){
+    m_baseDirty = true;
     int dataCount = m_datas.size();
     m_legendLineShow = showLegendLine;
     for ( int i = 0; i < dataCount; i++ ){
@@ -333,6 +367,7 @@ void Plot2DGenerator::setLegendVisible( bool visible ){
 
 
 void Plot2DGenerator::setLogScale(bool logScale){
+    m_baseDirty = true;
     m_logScale = logScale;
     _updateScales();
 }
@@ -341,12 +376,12 @@ void Plot2DGenerator::setLogScale(bool logScale){
 void Plot2DGenerator::setMarkerLine( double xPos ){
     if ( m_vLine ){
         m_vLine->setPosition( xPos );
-        m_plot->replot();
     }
 }
 
 
 void Plot2DGenerator::setPipeline( std::shared_ptr<Carta::Lib::PixelPipeline::CustomizablePixelPipeline> pipeline){
+    m_baseDirty = true;
     int dataCount = m_datas.size();
     for ( int i = 0; i < dataCount; i++ ){
         m_datas[i]->setPipeline( pipeline );
@@ -357,7 +392,6 @@ void Plot2DGenerator::setPipeline( std::shared_ptr<Carta::Lib::PixelPipeline::Cu
 
 void Plot2DGenerator::setRange(double min, double max){
     m_range->setClipValues(min, max);
-    m_plot->replot();
 }
 
 
@@ -365,14 +399,12 @@ void Plot2DGenerator::setRangeColor(double min, double max){
     if ( m_rangeColor ){
         m_rangeColor->setClipValues(min, max);
     }
-    m_plot->replot();
 }
 
 
 void Plot2DGenerator::setRangePixels(double min, double max){
     m_range->setHeight(m_height);
     m_range->setBoundaryValues(min, max);
-    m_plot->replot();
 }
 
 
@@ -384,7 +416,6 @@ void Plot2DGenerator::setRangePixelsColor(double min, double max){
     if ( m_vLine ){
         m_vLine->setPositionPixel( min, max );
     }
-    m_plot->replot();
 }
 
 
@@ -428,6 +459,7 @@ bool Plot2DGenerator::setSize( int width, int height ){
 
 
 void Plot2DGenerator::setLineStyle( const QString& style, const QString& id ){
+    m_baseDirty = true;
     if ( id.isEmpty() || id.trimmed().length() == 0 ){
         int dataCount = m_datas.size();
         for ( int i = 0; i < dataCount; i++ ){
@@ -451,6 +483,7 @@ void Plot2DGenerator::setLineStyle( const QString& style, const QString& id ){
 
 
 void Plot2DGenerator::setStyle( const QString& style, const QString& id ){
+    m_baseDirty = true;
     if ( id.isEmpty() || id.trimmed().length() == 0 ){
         int dataCount = m_datas.size();
         for ( int i = 0; i < dataCount; i++ ){
@@ -467,6 +500,7 @@ void Plot2DGenerator::setStyle( const QString& style, const QString& id ){
 
 
 void Plot2DGenerator::setTitleAxisX( const QString& title){
+    m_baseDirty = true;
     m_axisNameX = title;
     QString axisTitle = m_axisNameX;
     if ( !m_axisUnitX.isEmpty() ){
@@ -479,6 +513,7 @@ void Plot2DGenerator::setTitleAxisX( const QString& title){
 
 
 void Plot2DGenerator::setTitleAxisY( const QString& title){
+    m_baseDirty = true;
     m_axisNameY = title;
     QString axisTitle = m_axisNameY;
     if ( !m_axisUnitY.isEmpty()){
@@ -494,7 +529,6 @@ void Plot2DGenerator::setTitleAxisY( const QString& title){
 
 
 QImage Plot2DGenerator::toImage( int width, int height ) const {
-    QwtPlotRenderer renderer;
     if ( width <= 0 ){
         width = m_width;
     }
@@ -502,18 +536,54 @@ QImage Plot2DGenerator::toImage( int width, int height ) const {
         height = m_height;
     }
     m_plot->resize( width, height );
-    QImage plotImage(width, height, QImage::Format_RGB32);
-    renderer.renderTo(m_plot, plotImage );
+    QSize imageSize( width, height );
+    if ( m_baseDirty || m_baseImage.size() != imageSize ){
+        _setOverlayVisible( false );
+        QwtPlotRenderer renderer;
+        QImage baseImage( width, height, QImage::Format_RGB32 );
+        renderer.renderTo( m_plot, baseImage );
+        _setOverlayVisible( true );
+        m_baseImage = baseImage;
+        m_baseDirty = false;
+    }
+
+    //Paint the marker and selections on a copy of the cached curves.
+    QImage plotImage = m_baseImage.copy();
+    QPainter painter( &plotImage );
+    painter.setClipRect( m_canvasRecorder->m_canvasRect );
+    const QwtScaleMap& xMap = m_canvasRecorder->m_xMap;
+    const QwtScaleMap& yMap = m_canvasRecorder->m_yMap;
+    const QRectF& canvasRect = m_canvasRecorder->m_canvasRect;
+    m_range->draw( &painter, xMap, yMap, canvasRect );
+    if ( m_rangeColor ){
+        m_rangeColor->draw( &painter, xMap, yMap, canvasRect );
+    }
+    if ( m_vLine ){
+        m_vLine->draw( &painter, xMap, yMap, canvasRect );
+    }
     return plotImage;
 }
 
 
+void Plot2DGenerator::_setOverlayVisible( bool visible ) const {
+    m_range->setVisible( visible );
+    if ( m_rangeColor ){
+        m_rangeColor->setVisible( visible );
+    }
+    if ( m_vLine ){
+        m_vLine->setVisible( visible );
+    }
+}
+
+
 void Plot2DGenerator::_updateLegend(){
+    m_baseDirty = true;
     m_plot->setLegendPosition( m_legendVisible, m_legendPosition, m_legendExternal );
 }
 
 
 void Plot2DGenerator::_updateScales(){
+    m_baseDirty = true;
     int dataCount = m_datas.size();
     if ( dataCount > 0 ){
         std::pair<double,double> firstBounds = m_datas[0]->getBoundsY();
@@ -563,6 +633,8 @@ Plot2DGenerator::~Plot2DGenerator(){
         delete m_gridLines;
     }
     delete m_gridLines;
+    m_canvasRecorder->detach();
+    delete m_canvasRecorder;
     delete m_range;
     delete m_plot;
 }
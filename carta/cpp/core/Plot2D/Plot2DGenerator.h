@@ -1,10 +1,16 @@
 /**
  * Generates an image of a 2D plot based on set configuration (display) parameters.
+ *
+ * The plot is drawn in two layers.  The curves, axes, grid and legend are rendered
+ * into a cached image that is only redrawn when one of them changes; the channel
+ * marker and the selections are painted over a copy of it, so moving them does
+ * not redraw the data.
  */
 #pragma once
 
 #include "CartaLib/Hooks/Plot2DResult.h"
 #include <QFont>
+#include <QImage>
 #include <QString>
 #include <memory>
 #include <qwt_plot.h>
@@ -19,8 +25,6 @@ class CustomizablePixelPipeline;
 }
 }
 
-class QImage;
-
 namespace Carta {
 namespace Plot2D {
 
@@ -46,10 +50,10 @@ public:
 
     /**
      * Sets the data for the plot.
-     * @param data the plot data (x,y) pairs and additional information for plotting.
+     * @param data the plot data (x,y) points, shared with the plot rather than copied.
      * @param id - an identifier for the new data set.
      */
-    void addData( std::vector< std::pair<double,double> > data, const QString& id );
+    void addData( const Carta::Lib::CurveBuffer& data, const QString& id );
 
     /**
      * Remove all data from the plot.
@@ -304,8 +308,13 @@ public:
     virtual ~Plot2DGenerator();
 
 private:
+    class CanvasRecorder;
+
     std::shared_ptr<Plot2D> _findData( const QString& id ) const;
 
+    //Show or hide the marker and selections.
+    void _setOverlayVisible( bool visible ) const;
+
     void _updateLegend();
 
     //Update the y-axis scales (where to plot from).
@@ -334,6 +343,12 @@ private:
     QFont m_font;
     PlotType m_plotType;
 
+    //Curves, axes and legend without the marker and selections.
+    mutable QImage m_baseImage;
+    mutable bool m_baseDirty;
+    //Remembers where the canvas was when the base image was rendered.
+    CanvasRecorder* m_canvasRecorder;
+
     Plot2DGenerator( const Plot2DGenerator& other);
     Plot2DGenerator& operator=( const Plot2DGenerator& other );
 };
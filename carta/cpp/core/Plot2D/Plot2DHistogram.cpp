@@ -101,30 +101,58 @@ void Plot2DHistogram::drawSeries( QPainter *painter, const QwtScaleMap &xMap,
     }
     m_lastY = rect.bottom();
     m_lastX = rect.left();
-    drawColumns( painter, xMap, yMap, from, to );
+    const std::vector<int>* indices = _getDecimated( xMap, from, to,
+            m_centersX.data(), m_valuesY.data(), true );
+    if ( indices == nullptr ){
+        drawColumns( painter, xMap, yMap, from, to );
+    }
+    else {
+        //Each kept bin is widened halfway to its neighbours, so the columns stay
+        //contiguous.
+        int indexCount = indices->size();
+        int start = from;
+        for ( int i = 0; i < indexCount; i++ ){
+            int index = ( *indices )[i];
+            int end = to;
+            if ( i < indexCount - 1 ){
+                end = index + ( ( *indices )[i+1] - index ) / 2;
+            }
+            QwtIntervalSample sample( m_data[index].value,
+                    m_data[start].interval.minValue(), m_data[end].interval.maxValue() );
+            drawColumn( painter, columnRect( sample, xMap, yMap ), sample );
+            start = end + 1;
+        }
+    }
     if ( m_drawStyle == Carta::Data::PlotStyles::PLOT_STYLE_OUTLINE ){
         QwtPainter::drawLine( painter, m_lastX, m_lastY, m_lastX, rect.bottom());
     }
 }
 
-void Plot2DHistogram::setData ( std::vector<std::pair<double,double> > dataVector ){
+void Plot2DHistogram::setData ( const Carta::Lib::CurveBuffer& dataVector ){
+    const std::vector<double>& xs = dataVector.getX();
+    const std::vector<double>& ys = dataVector.getY();
     int dataCount = dataVector.size();
     m_maxValueY = -1;
     m_minValueY = std::numeric_limits<double>::max();
     m_data.clear();
+    m_centersX.clear();
+    m_valuesY.clear();
     for ( int i = 0; i < dataCount-1; i++ ){
         //Only add in nonzero counts
-        if ( dataVector[i].second > 0 ){
-            QwtIntervalSample sample( dataVector[i].second, dataVector[i].first, dataVector[i+1].first );
+        if ( ys[i] > 0 ){
+            QwtIntervalSample sample( ys[i], xs[i], xs[i+1] );
             m_data.push_back( sample );
-            if ( dataVector[i].second > m_maxValueY ){
-                m_maxValueY = dataVector[i].second;
+            m_centersX.push_back( ( xs[i] + xs[i+1] ) / 2 );
+            m_valuesY.push_back( ys[i] );
+            if ( ys[i] > m_maxValueY ){
+                m_maxValueY = ys[i];
             }
-            if ( dataVector[i].second < m_minValueY ){
-                m_minValueY = dataVector[i].second;
+            if ( ys[i] < m_minValueY ){
+                m_minValueY = ys[i];
             }
         }
     }
+    _clearDecimated();
     setSamples( m_data );
 }
 
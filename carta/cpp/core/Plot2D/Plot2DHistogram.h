@@ -53,7 +53,7 @@ public:
      * Store the data to be plotted.
      * @param data the plot data.
      */
-    virtual void setData ( std::vector<std::pair<double,double> > data ) Q_DECL_OVERRIDE;
+    virtual void setData ( const Carta::Lib::CurveBuffer& data ) Q_DECL_OVERRIDE;
 
     /**
      * Destructor.
@@ -69,6 +69,9 @@ protected:
 private:
 
     QVector< QwtIntervalSample > m_data;
+    //Bin centers and counts, used to decimate the bins.
+    std::vector<double> m_centersX;
+    std::vector<double> m_valuesY;
     mutable double m_lastY;
     mutable double m_lastX;
     Plot2DHistogram( const Plot2DHistogram& other);
@@ -33,7 +33,9 @@ void Plot2DProfile::drawLines (QPainter *painter, const QwtScaleMap &xMap,
     curvePen.setStyle( m_penStyle );
     painter->setPen( curvePen );
     if ( from != to ){
-        QwtPlotCurve::drawLines( painter, xMap, yMap, canvasRect, from, to );
+        if ( !_drawDecimated( painter, xMap, yMap, from, to ) ){
+            QwtPlotCurve::drawLines( painter, xMap, yMap, canvasRect, from, to );
+        }
     }
     else {
         drawSymbol( painter, xMap, yMap, canvasRect, from, to );
@@ -41,13 +43,35 @@ void Plot2DProfile::drawLines (QPainter *painter, const QwtScaleMap &xMap,
 }
 
 
+bool Plot2DProfile::_drawDecimated( QPainter* painter, const QwtScaleMap& xMap,
+        const QwtScaleMap& yMap, int from, int to ) const {
+    const std::vector<double>& xs = m_data.getX();
+    const std::vector<double>& ys = m_data.getY();
+    const std::vector<int>* indices = _getDecimated( xMap, from, to,
+            xs.data(), ys.data(), false );
+    if ( indices == nullptr ){
+        return false;
+    }
+    //With several points per pixel column, lines and steps look the same.
+    QPolygonF points;
+    points.reserve( indices->size() );
+    for ( int index : *indices ){
+        points.append( QPointF( xMap.transform( xs[index] ), yMap.transform( ys[index] ) ) );
+    }
+    QwtPainter::drawPolyline( painter, points );
+    return true;
+}
+
+
 void Plot2DProfile::drawSteps (QPainter *painter, const QwtScaleMap &xMap,
         const QwtScaleMap &yMap, const QRectF &canvasRect, int from, int to) const {
     QPen curvePen( m_defaultColor );
     curvePen.setStyle( m_penStyle );
     painter->setPen( curvePen );
     if ( from != to ){
-        QwtPlotCurve::drawSteps( painter, xMap, yMap, canvasRect, from, to );
+        if ( !_drawDecimated( painter, xMap, yMap, from, to ) ){
+            QwtPlotCurve::drawSteps( painter, xMap, yMap, canvasRect, from, to );
+        }
     }
     else {
         drawSymbol( painter, xMap, yMap, canvasRect, from, to );
@@ -83,35 +107,34 @@ QwtGraphic Plot2DProfile::legendIcon( int /*index*/, const QSizeF& iconSize ) co
     return icon;
 }
 
-void Plot2DProfile::setData ( std::vector<std::pair<double,double> > datas ){
-    int dataCount = datas.size();
-    m_datasX.resize( dataCount );
-    m_datasY.resize( dataCount );
+void Plot2DProfile::setData ( const Carta::Lib::CurveBuffer& datas ){
+    m_data = datas;
+    const std::vector<double>& ys = m_data.getY();
+    int dataCount = m_data.size();
     if ( dataCount > 1 ){
         m_maxValueY = -1 * std::numeric_limits<double>::max();
         m_minValueY = std::numeric_limits<double>::max();
         for ( int i = 0; i < dataCount; i++ ){
-            m_datasX[i] = datas[i].first;
-            m_datasY[i] = datas[i].second;
-            if ( m_datasY[i] > m_maxValueY ){
-                m_maxValueY = m_datasY[i];
+            if ( ys[i] > m_maxValueY ){
+                m_maxValueY = ys[i];
             }
-            if ( m_datasY[i] < m_minValueY ){
-                m_minValueY = m_datasY[i];
+            if ( ys[i] < m_minValueY ){
+                m_minValueY = ys[i];
             }
         }
     }
     else if ( dataCount == 1 ){
         const double INC = 0.0000001;
-        m_minValueY = m_datasY[0] - INC;
-        m_maxValueY = m_datasY[0] + INC;
+        m_minValueY = ys[0] - INC;
+        m_maxValueY = ys[0] + INC;
     }
     //No data so just use bogus bounds
     else {
         m_maxValueY = 1;
         m_minValueY = 0;
     }
-    setRawSamples( m_datasX.data(), m_datasY.data(), dataCount );
+    _clearDecimated();
+    setRawSamples( m_data.getX().data(), ys.data(), dataCount );
 }
 
 
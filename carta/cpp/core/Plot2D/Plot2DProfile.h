@@ -59,7 +59,7 @@ public:
      * Store the data to be plotted.
      * @param data the plot data.
      */
-    virtual void setData ( std::vector<std::pair<double,double> > data ) Q_DECL_OVERRIDE;
+    virtual void setData ( const Carta::Lib::CurveBuffer& data ) Q_DECL_OVERRIDE;
 
     /**
      * Set the draw style for the data (continuous, step, etc).
@@ -96,8 +96,13 @@ protected:
 
 private:
 
-    std::vector<double> m_datasX;
-    std::vector<double> m_datasY;
+    //Draw a decimated version of the data if there are many more points than
+    //pixels; returns false if all points should be drawn.
+    bool _drawDecimated( QPainter* painter, const QwtScaleMap& xMap,
+            const QwtScaleMap& yMap, int from, int to ) const;
+
+    //The plotted points; Qwt draws from its columns directly.
+    Carta::Lib::CurveBuffer m_data;
     Plot2DProfile( const Plot2DProfile& other);
     Plot2DProfile& operator=( const Plot2DProfile& other );
 
@@ -5,10 +5,15 @@
 #include "PluginManager.h"
 #include "Algorithms/Graphs/TopoSort.h"
 #include "CartaLib/HtmlString.h"
+#include "CartaLib/Hooks/Initialize.h"
 #include "CartaLib/Hooks/LoadPlugin.h"
 #include "Globals.h"
 #include "MainConfig.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
 #include <QDirIterator>
+#include <QFileInfo>
 #include <QImage>
 #include <QPluginLoader>
 #include <QLibrary>
@@ -17,6 +22,10 @@
 #include <QJsonParseError>
 #include <QJsonObject>
 #include <QJsonArray>
+#include <QSaveFile>
+#include <QThread>
+#include <QtConcurrent/QtConcurrentRun>
+#include <algorithm>
 
 namespace Internal
 {
@@ -38,7 +47,14 @@ recursiveValue( const QJsonObject & obj, const QString & path )
 }
 }
 
+constexpr HookId PluginManager::HookCount;
+
 PluginManager::PluginManager()
+    : m_hook2plugin( HookCount )
+    , m_hookStats( new AtomicHookStats[HookCount] )
+    , m_cachedHandlers( HookCount, nullptr )
+    , m_hookMemos( HookCount )
+    , m_notified( HookCount, false )
 {
 //    qDebug() << "Initializing PluginManager...";
 }
@@ -59,10 +75,17 @@ PluginManager::loadPlugins()
 //        processLoadedCppPlugin(plugin);
 //    }
 
+    QElapsedTimer timer;
+    timer.start();
+    m_eagerLoading = Globals::instance()-> mainConfig()-> isEagerPluginLoading();
+    m_discoveryCacheFile = Globals::instance()-> mainConfig()-> pluginCacheFile();
+    readDiscoveryCache();
+
     // find all plugins in the provided search paths
     // The plugins are not loaded in this step, only parsing is performed.
     // all plugins are put into this list, whether they are native, or not
     m_discoveredPlugins = findAllPlugins();
+    qint64 discoveryMs = timer.restart();
 
     qDebug() << "Total plugins found:" << m_discoveredPlugins.size();
     for ( size_t ind = 0 ; ind < m_discoveredPlugins.size() ; ++ind ) {
@@ -70,11 +93,16 @@ PluginManager::loadPlugins()
     }
 
     // assign a unique integer for each plugin found
-    std::map < QString, int > dep2ind;
+    m_pluginIndex.clear();
     for ( size_t i = 0 ; i < m_discoveredPlugins.size() ; i++ ) {
         PluginInfo & pInfo = m_discoveredPlugins[i];
-        dep2ind[pInfo.json.name] = i;
+        m_pluginIndex[pInfo.json.name] = i;
+    }
+    m_pluginStates.reset( new std::atomic < int >[m_discoveredPlugins.size()] );
+    for ( size_t i = 0 ; i < m_discoveredPlugins.size() ; i++ ) {
+        m_pluginStates[i] = NotLoaded;
     }
+    m_notified.assign( HookCount, false );
 
     //
     // figure out loading dependencies
@@ -94,8 +122,8 @@ PluginManager::loadPlugins()
         // for every dependency add appropriate arrow to toposort
         for ( QString & dep : pInfo.json.depends ) {
             // convert dependency to index...
-            auto it = dep2ind.find( dep );
-            if ( it == dep2ind.end() ) {
+            auto it = m_pluginIndex.find( dep );
+            if ( it == m_pluginIndex.end() ) {
                 pInfo.errors << "Cannot satisfy dependency '" + dep + "'";
                 qCritical() << "Cannot find dependency" << pInfo.json.name << "/" << dep;
                 break;
@@ -110,8 +138,11 @@ PluginManager::loadPlugins()
     // figure out the order
     qDebug() << "toposort";
     auto loadingOrder = tsort.compute();
+    qint64 orderingMs = timer.restart();
 
     // now try to load the plugins in this order
+    int loadedCount = 0;
+    int deferredCount = 0;
     if ( loadingOrder.size() != m_discoveredPlugins.size() ) {
         // could not figure out order, must have a loop
         qCritical() << "Could not figure out loading order, must have a dependency loop!";
@@ -121,78 +152,322 @@ PluginManager::loadPlugins()
         for ( auto & ind : loadingOrder ) {
             qDebug() << "  " << ind << m_discoveredPlugins[ind].json.name;
         }
+        QMutexLocker locker( & m_loadMutex );
+        std::vector < int > registered;
         for ( auto & ind : loadingOrder ) {
             PluginInfo & pInfo = m_discoveredPlugins[ind];
-            qDebug() << QString( "Loading plugin %1[%2]" )
-                .arg( pInfo.json.name ).arg( pInfo.json.typeString );
 
             // skip plugins that already have errors
             if ( ! pInfo.errors.empty() ) {
-                qDebug() << "...skipping due to previous errors";
+                qDebug() << QString( "Skipping plugin %1[%2] due to previous errors" )
+                    .arg( pInfo.json.name ).arg( pInfo.json.typeString );
                 continue;
             }
 
-            // attempt to load native plugin using native method
-            if ( pInfo.json.typeString == "c++" || pInfo.json.typeString == "lib" ) {
-                bool success = loadNativePlugin( pInfo );
-                if ( ! success ) {
-                    qCritical() << QString( "Failed to load plugin %1[%2]" )
-                        .arg( pInfo.json.name ).arg( pInfo.json.typeString );
-                    qCritical() << "...reasons: " << pInfo.errors.join( "\n" );
-                    continue;
-                }
-
-                // if this plugin is a lib, we can skip to the next plugin
-                if ( pInfo.json.typeString == "lib" ) {
-                    continue;
-                }
+            // plugins are loaded when they are first needed if we know which hooks they
+            // listen to, and at least one of them is more than a notification
+            bool deferred = ! m_eagerLoading && pInfo.hooksKnown;
+            if ( deferred && ! pInfo.hooks.empty() ) {
+                deferred = std::any_of( pInfo.hooks.begin(), pInfo.hooks.end(), [] ( HookId id ) {
+                    return ! isNotificationHook( id );
+                } );
             }
-            else {
-                // let's see if any of the existing plugins can load this plugin
-                // via the LoadPlugin hook
-                Nullable < IPlugin * > iPlug = prepare < Carta::Lib::Hooks::LoadPlugin > (
-                    pInfo.dirPath, pInfo.json ).first();
-                if ( iPlug.isSet() ) {
-                    pInfo.rawPlugin = iPlug.val();
-                }
+            if ( deferred ) {
+                qDebug() << QString( "Deferring plugin %1[%2]" )
+                    .arg( pInfo.json.name ).arg( pInfo.json.typeString );
+                registerHooks( pInfo );
+                registered.push_back( ind );
+                deferredCount++;
+                continue;
             }
 
-            // if we failed to make a raw plugin, report an error
-            if ( ! pInfo.errors.isEmpty() || ! pInfo.rawPlugin ) {
-                qCritical() << "Failed to load plugin using plugins" << pInfo.json.name;
-                qCritical() << "...reasons: " << pInfo.errors.join( "\n" );
-                pInfo.errors << "Unknown type perhaps?";
-                continue;
+            if ( loadWithDependencies( ind ) ) {
+                registerHooks( pInfo );
+                registered.push_back( ind );
+                loadedCount++;
             }
+        }
 
-            // call plugins' initialize()
-            qDebug() << "Calling plugin's initialize";
-            IPlugin::InitInfo initInfo;
-            initInfo.pluginPath = pInfo.dirPath;
-            auto json = Globals::instance()-> mainConfig()-> json();
-            initInfo.json = json["plugins"].toObject()[pInfo.json.name].toObject();
-            pInfo.rawPlugin->initialize( initInfo );
-
-            // find out what hooks this plugin wants to listen to
-            qDebug() << "Calling plugin's getInitialHookList";
-            auto hooks = pInfo.rawPlugin-> getInitialHookList();
-
-            // for each hook the plugin wants to listen to, add it to the appropriate
-            // lookup slot in m_hook2plugin
-            for ( auto id : hooks ) {
-                m_hook2plugin[id].push_back( & pInfo );
+        // a deferred plugin loaded as a dependency of another one may listen to other
+        // hooks than the cache said; nothing calls hooks yet, so the lists can still
+        // be rebuilt in loading order
+        if ( m_hooksChanged ) {
+            for ( auto & plugins : m_hook2plugin ) {
+                plugins.clear();
             }
-            qDebug() << "Plugin initialized";
+            for ( auto ind : registered ) {
+                registerHooks( m_discoveredPlugins[ind] );
+            }
+            clearHookCaches();
+            m_hooksChanged = false;
         }
     }
+    qint64 loadingMs = timer.elapsed();
+    m_started = true;
+    writeDiscoveryCache();
+
+    qDebug() << QString( "Plugin startup: discovery %1 ms, ordering %2 ms, loading %3 ms "
+                         "(%4 loaded, %5 deferred)" )
+        .arg( discoveryMs ).arg( orderingMs ).arg( loadingMs )
+        .arg( loadedCount ).arg( deferredCount );
 } // loadPlugins
 
+IPlugin *
+PluginManager::activate( PluginManager::PluginInfo * pInfo )
+{
+    int index = pInfo - m_discoveredPlugins.data();
+    if ( m_pluginStates[index] != Loaded ) {
+        QMutexLocker locker( & m_loadMutex );
+        if ( ! loadWithDependencies( index ) ) {
+            return nullptr;
+        }
+    }
+    return pInfo-> rawPlugin;
+}
+
+IPlugin *
+PluginManager::loadedPlugin( PluginManager::PluginInfo * pInfo ) const
+{
+    int index = pInfo - m_discoveredPlugins.data();
+    if ( m_pluginStates[index] != Loaded ) {
+        return nullptr;
+    }
+    return pInfo-> rawPlugin;
+}
+
+bool
+PluginManager::isNotificationHook( HookId id )
+{
+    return id == Carta::Lib::Hooks::Initialize::staticId;
+}
+
+bool
+PluginManager::loadWithDependencies( int index )
+{
+    PluginInfo & pInfo = m_discoveredPlugins[index];
+    int state = m_pluginStates[index];
+    if ( state != NotLoaded ) {
+        // a plugin that is being loaded cannot be used by its own initialization
+        return state == Loaded;
+    }
+    if ( ! pInfo.errors.empty() ) {
+        m_pluginStates[index] = Failed;
+        return false;
+    }
+    m_pluginStates[index] = Loading;
+
+    // dependencies come first in the loading order, but deferred ones are
+    // loaded here; as before, a dependency that fails does not stop the attempt
+    for ( const QString & dep : pInfo.json.depends ) {
+        auto it = m_pluginIndex.find( dep );
+        if ( it != m_pluginIndex.end() && ! loadWithDependencies( it-> second ) ) {
+            qWarning() << "Plugin" << pInfo.json.name << "depends on" << dep
+                       << "which could not be loaded";
+        }
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    bool success = loadPlugin( pInfo );
+    pInfo.loadMs = timer.nsecsElapsed() / 1e6;
+    m_pluginStates[index] = success ? Loaded : Failed;
+    qDebug() << QString( "Plugin %1 %2 in %3 ms" ).arg( pInfo.json.name )
+        .arg( success ? "loaded" : "failed to load" ).arg( pInfo.loadMs );
+
+    // with lazy loading the plugin can come ahead of the ones that answered so far
+    if ( success ) {
+        clearHookCaches();
+    }
+
+    // plugins loaded after startup update the cache themselves
+    if ( m_started ) {
+        writeDiscoveryCache();
+    }
+    return success;
+} // loadWithDependencies
+
+bool
+PluginManager::loadPlugin( PluginManager::PluginInfo & pInfo )
+{
+    qDebug() << QString( "Loading plugin %1[%2]" )
+        .arg( pInfo.json.name ).arg( pInfo.json.typeString );
+
+    // attempt to load native plugin using native method
+    if ( pInfo.json.typeString == "c++" || pInfo.json.typeString == "lib" ) {
+        bool success = loadNativePlugin( pInfo );
+        if ( ! success ) {
+            qCritical() << QString( "Failed to load plugin %1[%2]" )
+                .arg( pInfo.json.name ).arg( pInfo.json.typeString );
+            qCritical() << "...reasons: " << pInfo.errors.join( "\n" );
+            return false;
+        }
+
+        // if this plugin is a lib, there is nothing to initialize
+        if ( pInfo.json.typeString == "lib" ) {
+            if ( ! pInfo.hooksKnown ) {
+                pInfo.hooksKnown = true;
+                m_discoveryCacheDirty = true;
+            }
+            return true;
+        }
+    }
+    else {
+        // let's see if any of the existing plugins can load this plugin
+        // via the LoadPlugin hook
+        Nullable < IPlugin * > iPlug = prepare < Carta::Lib::Hooks::LoadPlugin > (
+            pInfo.dirPath, pInfo.json ).first();
+        if ( iPlug.isSet() ) {
+            pInfo.rawPlugin = iPlug.val();
+        }
+    }
+
+    // if we failed to make a raw plugin, report an error
+    if ( ! pInfo.errors.isEmpty() || ! pInfo.rawPlugin ) {
+        qCritical() << "Failed to load plugin using plugins" << pInfo.json.name;
+        qCritical() << "...reasons: " << pInfo.errors.join( "\n" );
+        pInfo.errors << "Unknown type perhaps?";
+        return false;
+    }
+
+    // call plugins' initialize()
+    qDebug() << "Calling plugin's initialize";
+    IPlugin::InitInfo initInfo;
+    initInfo.pluginPath = pInfo.dirPath;
+    auto json = Globals::instance()-> mainConfig()-> json();
+    initInfo.json = json["plugins"].toObject()[pInfo.json.name].toObject();
+    pInfo.rawPlugin->initialize( initInfo );
+
+    // find out what hooks this plugin wants to listen to
+    qDebug() << "Calling plugin's getInitialHookList";
+    std::vector < HookId > hooks;
+    for ( auto id : pInfo.rawPlugin-> getInitialHookList() ) {
+        if ( id < 0 ) {
+            qWarning() << "Ignoring invalid hook id" << id << "of" << pInfo.json.name;
+            continue;
+        }
+        hooks.push_back( id );
+    }
+    if ( pInfo.hooksKnown && hooks != pInfo.hooks ) {
+        if ( m_started ) {
+            // hooks are looked up in m_hook2plugin without a lock, so the registration
+            // cannot change now; the cache will be fixed for next time
+            qWarning() << "Plugin" << pInfo.json.name << "listens to different hooks than cached";
+        }
+        else {
+            // loadPlugins() registers the actual hooks before it finishes
+            m_hooksChanged = true;
+        }
+    }
+    if ( ! pInfo.hooksKnown || hooks != pInfo.hooks ) {
+        m_discoveryCacheDirty = true;
+    }
+    pInfo.hooks = hooks;
+    pInfo.hooksKnown = true;
+
+    // catch up on notifications that were sent before the plugin was loaded
+    if ( std::find( hooks.begin(), hooks.end(), Carta::Lib::Hooks::Initialize::staticId ) != hooks.end()
+         && m_notified[Carta::Lib::Hooks::Initialize::staticId] ) {
+        Carta::Lib::Hooks::Initialize::Params params;
+        Carta::Lib::Hooks::Initialize hookData( & params );
+        pInfo.rawPlugin-> handleHook( hookData );
+    }
+    qDebug() << "Plugin initialized";
+    return true;
+} // loadPlugin
+
+void
+PluginManager::registerHooks( PluginManager::PluginInfo & pInfo )
+{
+    // for each hook the plugin wants to listen to, add it to the appropriate
+    // lookup slot in m_hook2plugin
+    for ( auto id : pInfo.hooks ) {
+        if ( id >= HookId( m_hook2plugin.size() ) ) {
+            m_hook2plugin.resize( id + 1 );
+        }
+        m_hook2plugin[id].push_back( & pInfo );
+    }
+}
+
 const std::vector < PluginManager::PluginInfo > &
 PluginManager::getInfoList()
 {
     return m_discoveredPlugins;
 }
 
+std::vector < PluginManager::HookStats >
+PluginManager::getHookStats() const
+{
+    std::vector < HookStats > list;
+    for ( HookId id = 0 ; id < HookCount ; id++ ) {
+        const AtomicHookStats & src = m_hookStats[id];
+        if ( src.calls == 0 ) {
+            continue;
+        }
+        HookStats stats;
+        stats.id = id;
+        stats.name = Carta::Lib::Hooks::hookName(
+            static_cast < Carta::Lib::Hooks::UniqueHookIDs > ( id ) );
+        stats.calls = src.calls;
+        stats.memoHits = src.memoHits;
+        stats.totalMs = src.totalNs / 1e6;
+        stats.maxMs = src.maxNs / 1e6;
+        list.push_back( stats );
+    }
+    return list;
+}
+
+void
+PluginManager::resetHookStats()
+{
+    for ( HookId id = 0 ; id < HookCount ; id++ ) {
+        AtomicHookStats & stats = m_hookStats[id];
+        stats.calls = 0;
+        stats.memoHits = 0;
+        stats.totalNs = 0;
+        stats.maxNs = 0;
+    }
+}
+
+PluginManager::PluginInfo *
+PluginManager::cachedHandler( HookId id ) const
+{
+    QMutexLocker locker( & m_hookCacheMutex );
+    return m_cachedHandlers[id];
+}
+
+void
+PluginManager::setCachedHandler( HookId id, PluginManager::PluginInfo * pInfo )
+{
+    QMutexLocker locker( & m_hookCacheMutex );
+    m_cachedHandlers[id] = pInfo;
+}
+
+void
+PluginManager::clearHookCaches()
+{
+    QMutexLocker locker( & m_hookCacheMutex );
+    std::fill( m_cachedHandlers.begin(), m_cachedHandlers.end(), nullptr );
+    for ( auto & memo : m_hookMemos ) {
+        memo.reset();
+    }
+}
+
+void
+PluginManager::recordHookCall( HookId id, qint64 nsecs, bool memoHit )
+{
+    if ( ! isKnownHook( id ) ) {
+        return;
+    }
+    AtomicHookStats & stats = m_hookStats[id];
+    stats.calls++;
+    if ( memoHit ) {
+        stats.memoHits++;
+    }
+    stats.totalNs += nsecs;
+    qint64 oldMax = stats.maxNs;
+    while ( nsecs > oldMax && ! stats.maxNs.compare_exchange_weak( oldMax, nsecs ) ) { }
+}
+
 std::vector < PluginManager::PluginInfo >
 PluginManager::findAllPlugins()
 {
@@ -206,6 +481,8 @@ PluginManager::findAllPlugins()
         "disabledPlugins" ).toVariant().toStringList();
     qDebug() << "Disabled plugins:" << disabledPlugins;
 
+    // collect the plugin directories
+    QStringList pluginDirs;
     for ( auto dirPath : m_pluginSearchPaths ) {
         qDebug() << "  processing path:" << dirPath;
         QDir dir( dirPath );
@@ -226,29 +503,215 @@ PluginManager::findAllPlugins()
             if ( ! dit.fileInfo().isDir() ) {
                 continue;
             }
-            qDebug() << "    examining:" << dit.fileInfo().fileName();
-            PluginInfo info = parsePluginDir( dit.filePath() );
-            if ( ! info.errors.empty() ) {
-                qWarning() << "Could not load plugin from:" << dit.filePath()
-                           << "\n  - reason: " << info.errors.join( "\n" )
-                           << "\n================================";
+            pluginDirs.append( dit.filePath() );
+        }
+    }
+
+    // take unchanged plugins from the cache and parse the others in parallel
+    int dirCount = pluginDirs.size();
+    std::vector < PluginInfo > infos( dirCount );
+    std::vector < QFuture < PluginInfo > > parsing( dirCount );
+    std::vector < bool > cached( dirCount, false );
+    int cacheHits = 0;
+    for ( int i = 0 ; i < dirCount ; i++ ) {
+        QString signature = pluginSignature( pluginDirs[i] );
+        QJsonObject entry = m_discoveryCache[pluginDirs[i]].toObject();
+        QString cachedSignature = signature + configSignature( entry["name"].toString() );
+        if ( entry["signature"].toString() == cachedSignature && fromCacheEntry( entry, infos[i] ) ) {
+            infos[i].dirPath = pluginDirs[i];
+            infos[i].signature = cachedSignature;
+            cached[i] = true;
+            cacheHits++;
+        }
+        else {
+            infos[i].signature = signature;
+            parsing[i] = QtConcurrent::run( this, & PluginManager::parsePluginDir, pluginDirs[i] );
+        }
+    }
+    if ( cacheHits < dirCount ) {
+        m_discoveryCacheDirty = true;
+    }
+
+    for ( int i = 0 ; i < dirCount ; i++ ) {
+        if ( ! cached[i] ) {
+            QString signature = infos[i].signature;
+            infos[i] = parsing[i].result();
+            infos[i].signature = signature + configSignature( infos[i].json.name );
+        }
+        qDebug() << "    examined:" << QFileInfo( pluginDirs[i] ).fileName()
+                 << ( cached[i] ? "(cached)" : "" );
+        PluginInfo & info = infos[i];
+        if ( ! info.errors.empty() ) {
+            qWarning() << "Could not load plugin from:" << pluginDirs[i]
+                       << "\n  - reason: " << info.errors.join( "\n" )
+                       << "\n================================";
+        }
+        else {
+            // skip black-listed plugins right now
+            if ( disabledPlugins.contains( info.json.name ) ) {
+                qDebug() << "Ignoring disabled plugin:" << pluginDirs[i];
             }
             else {
-                // skip black-listed plugins right now
-                if ( disabledPlugins.contains( info.json.name ) ) {
-                    qDebug() << "Ignoring disabled plugin:" << dit.filePath();
-                }
-                else {
-                    list.push_back( info );
-                }
+                list.push_back( info );
             }
         }
     }
 
-    qDebug() << "Done looking for plugins. Found: " << list.size();
+    qDebug() << "Done looking for plugins. Found: " << list.size()
+             << "of which" << cacheHits << "unchanged since the last run";
     return list;
 } // findAllPlugins
 
+QString
+PluginManager::pluginSignature( const QString & dirName )
+{
+    QStringList stamps;
+    for ( const QString & path : { dirName, dirName + "/plugin.json", dirName + "/libplugin.so",
+                                   dirName + "/libplugin.dylib", dirName + "/libs" } ) {
+        QFileInfo info( path );
+        if ( info.exists() ) {
+            stamps << QString::number( info.lastModified().toMSecsSinceEpoch() )
+                + ":" + QString::number( info.size() );
+        }
+        else {
+            stamps << "-";
+        }
+    }
+
+    // python plugins are loaded from name.py, which may import other modules of
+    // the plugin; editing them in place does not touch the directory
+    QDir dir( dirName );
+    for ( const QFileInfo & info : dir.entryInfoList( QStringList( "*.py" ), QDir::Files, QDir::Name ) ) {
+        stamps << info.fileName() + ":" + QString::number( info.lastModified().toMSecsSinceEpoch() )
+            + ":" + QString::number( info.size() );
+    }
+    return stamps.join( "," );
+}
+
+QString
+PluginManager::configSignature( const QString & pluginName )
+{
+    auto json = Globals::instance()-> mainConfig()-> json();
+    QJsonObject config = json["plugins"].toObject()[pluginName].toObject();
+    return ",config:" + QString::fromUtf8( QJsonDocument( config ).toJson( QJsonDocument::Compact ) );
+}
+
+void
+PluginManager::readDiscoveryCache()
+{
+    m_discoveryCache = QJsonObject();
+    if ( m_discoveryCacheFile.isEmpty() ) {
+        return;
+    }
+    QFile file( m_discoveryCacheFile );
+    if ( ! file.open( QFile::ReadOnly ) ) {
+        return;
+    }
+    QJsonDocument jsonDoc = QJsonDocument::fromJson( file.readAll() );
+    QJsonObject json = jsonDoc.object();
+    if ( json["version"].toInt() != 1 ) {
+        qDebug() << "Ignoring plugin cache" << m_discoveryCacheFile;
+        return;
+    }
+    m_discoveryCache = json["plugins"].toObject();
+}
+
+void
+PluginManager::writeDiscoveryCache()
+{
+    if ( ! m_discoveryCacheDirty || m_discoveryCacheFile.isEmpty() ) {
+        return;
+    }
+    m_discoveryCacheDirty = false;
+
+    // keep the entries of plugins that were not found this time, they may be
+    // disabled for now
+    for ( const PluginInfo & pInfo : m_discoveredPlugins ) {
+        m_discoveryCache[pInfo.dirPath] = toCacheEntry( pInfo );
+    }
+    QJsonObject json;
+    json["version"] = 1;
+    json["plugins"] = m_discoveryCache;
+
+    QDir().mkpath( QFileInfo( m_discoveryCacheFile ).absolutePath() );
+    QSaveFile file( m_discoveryCacheFile );
+    if ( ! file.open( QFile::WriteOnly ) ) {
+        qWarning() << "Could not write plugin cache" << m_discoveryCacheFile;
+        return;
+    }
+    file.write( QJsonDocument( json ).toJson( QJsonDocument::Compact ) );
+    if ( ! file.commit() ) {
+        qWarning() << "Could not write plugin cache" << m_discoveryCacheFile;
+    }
+}
+
+QJsonObject
+PluginManager::toCacheEntry( const PluginManager::PluginInfo & pInfo )
+{
+    QJsonObject entry;
+    entry["signature"] = pInfo.signature;
+    entry["name"] = pInfo.json.name;
+    entry["version"] = pInfo.json.version;
+    entry["type"] = pInfo.json.typeString;
+    entry["description"] = pInfo.json.description;
+    entry["about"] = pInfo.json.about;
+    entry["depends"] = QJsonArray::fromStringList( pInfo.json.depends );
+    entry["soPath"] = pInfo.soPath;
+    entry["libPaths"] = QJsonArray::fromStringList( pInfo.libPaths );
+
+    // hooks are stored by name, so that the cache survives renumbering
+    if ( pInfo.hooksKnown && pInfo.errors.isEmpty() ) {
+        QJsonArray hooks;
+        for ( HookId id : pInfo.hooks ) {
+            if ( ! isKnownHook( id ) ) {
+                return entry;
+            }
+            hooks.append( Carta::Lib::Hooks::hookName(
+                              static_cast < Carta::Lib::Hooks::UniqueHookIDs > ( id ) ) );
+        }
+        entry["hooks"] = hooks;
+    }
+    return entry;
+}
+
+bool
+PluginManager::fromCacheEntry( const QJsonObject & entry, PluginManager::PluginInfo & pInfo )
+{
+    pInfo.json.name = entry["name"].toString();
+    pInfo.json.version = entry["version"].toString();
+    pInfo.json.typeString = entry["type"].toString();
+    pInfo.json.description = entry["description"].toString();
+    pInfo.json.about = entry["about"].toString();
+    pInfo.json.depends = entry["depends"].toVariant().toStringList();
+    pInfo.soPath = entry["soPath"].toString();
+    pInfo.libPaths = entry["libPaths"].toVariant().toStringList();
+    if ( pInfo.json.name.isEmpty() || pInfo.json.typeString.isEmpty() ) {
+        return false;
+    }
+
+    pInfo.hooks.clear();
+    pInfo.hooksKnown = entry["hooks"].isArray();
+    for ( auto hook : entry["hooks"].toArray() ) {
+        HookId found = - 1;
+        for ( HookId id = 0 ; id < HookCount ; id++ ) {
+            if ( hook.toString() == Carta::Lib::Hooks::hookName(
+                     static_cast < Carta::Lib::Hooks::UniqueHookIDs > ( id ) ) ) {
+                found = id;
+                break;
+            }
+        }
+        if ( found < 0 ) {
+            // a hook this build does not know about, so the plugin has to be loaded
+            // to find out
+            pInfo.hooks.clear();
+            pInfo.hooksKnown = false;
+            break;
+        }
+        pInfo.hooks.push_back( found );
+    }
+    return true;
+}
+
 PluginManager::PluginInfo
 PluginManager::parsePluginDir( const QString & dirName )
 {
@@ -391,6 +854,10 @@ PluginManager::loadNativePlugin( PluginManager::PluginInfo & pInfo )
         libsToLoad.push_back( i );
     }
 
+    // libraries in the order in which they could be loaded, so that next time
+    // they can all be loaded in the first round
+    QStringList loadOrder;
+
     qDebug() << "  - heuristics to load libraries:" << pInfo.libPaths.size();
     while ( ! libsToLoad.empty() ) {
         qDebug() << "  - heuristic loop start with" << libsToLoad.size() << " remaining";
@@ -413,6 +880,7 @@ PluginManager::loadNativePlugin( PluginManager::PluginInfo & pInfo )
             }
             else {
                 qDebug() << "      success";
+                loadOrder.append( libPath );
             }
         }
 
@@ -441,6 +909,11 @@ PluginManager::loadNativePlugin( PluginManager::PluginInfo & pInfo )
         return false;
     }
 
+    if ( loadOrder != pInfo.libPaths ) {
+        pInfo.libPaths = loadOrder;
+        m_discoveryCacheDirty = true;
+    }
+
     // if this was a lib plugin, we are done
     if ( pInfo.json.typeString != "c++" ) {
         return true;
@@ -470,6 +943,13 @@ PluginManager::loadNativePlugin( PluginManager::PluginInfo & pInfo )
     }
     qDebug() << "Raw plugin loaded.";
 
+    // plugins loaded lazily may be loaded from a worker thread, but they should
+    // live in the main thread like the ones loaded at startup
+    QThread * mainThread = QCoreApplication::instance() ? QCoreApplication::instance()-> thread() : nullptr;
+    if ( mainThread && plugin-> thread() != mainThread ) {
+        plugin-> moveToThread( mainThread );
+    }
+
     // try to cast the loaded qobject to our carta plugin interface
     IPlugin * cartaPlugin = qobject_cast < IPlugin * > ( plugin );
     if ( ! cartaPlugin ) {
@@ -8,11 +8,17 @@
 #include "CartaLib/Nullable.h"
 
 #include <QImage>
+#include <QJsonObject>
 #include <QString>
+#include <QMutex>
+#include <QElapsedTimer>
 #include <vector>
+#include <map>
 #include <functional>
 #include <utility>
 #include <memory>
+#include <atomic>
+#include <type_traits>
 
 // helper to convert hooks to hookid's so that we can group them all in one place
 // all work is done in specialization
@@ -29,6 +35,13 @@ struct ResTrait <void> {
 
 class PluginManager;
 
+/// memoised results of an idempotent hook, keyed on the hook's parameters
+/// (the Params of idempotent hooks must be comparable with ==)
+template <typename T>
+struct HookMemo {
+    std::vector< std::pair< typename T::Params, std::vector< typename T::ResultType > > > entries;
+};
+
 ///
 /// @todo this should be an inner class of PluginManager
 template <typename T>
@@ -75,16 +88,7 @@ public:
 //    std::vector<typename T::ResultType> vector();
 
     /// keep executing plugins until one answers
-    Nullable<typename T::ResultType> first() {
-        Nullable<typename T::ResultType> result;
-        auto wrapper = [& result] (typename T::ResultType && hookResult) -> bool {
-            result = hookResult;
-            return false;
-        };
-        forEachCond( wrapper);
-        // return unset value
-        return result;
-    }
+    Nullable<typename T::ResultType> first();
 
 protected:
 
@@ -96,6 +100,18 @@ protected:
         : m_params( std::forward<typename T::Params>( params))
     {}
 
+    /// forEachCond() for hooks that are not memoised
+    void forEachCondImpl( std::function< bool(typename T::ResultType)> & func, std::false_type);
+
+    /// forEachCond() for idempotent hooks, results are served from the memo
+    void forEachCondImpl( std::function< bool(typename T::ResultType)> & func, std::true_type);
+
+    /// first() for hooks whose answering plugin may depend on the parameters
+    Nullable<typename T::ResultType> firstImpl( std::false_type);
+
+    /// first() for hooks without parameters, the answering plugin is remembered
+    Nullable<typename T::ResultType> firstImpl( std::true_type);
+
     typename T::Params m_params;
     PluginManager * m_pm;
 
@@ -122,8 +138,18 @@ public:
         /// this means that if errors is not empty, the plugin could not be
         /// parsed
         QStringList errors;
-        /// library paths (for "cpp" and "lib" type plugins)
+        /// library paths (for "cpp" and "lib" type plugins), in the order in which
+        /// they could be loaded last time
         QStringList libPaths;
+        /// ids of the hooks the plugin listens to, valid if hooksKnown is set
+        std::vector< HookId > hooks;
+        /// whether the hooks are known, either from the discovery cache or because
+        /// the plugin was loaded
+        bool hooksKnown = false;
+        /// modification times of the plugin's files, used to validate the discovery cache
+        QString signature;
+        /// time it took to load and initialize the plugin (ms), -1 if it was not loaded
+        double loadMs = -1;
     };
 
     /// constructor - does not currently do anything interesting at all
@@ -133,11 +159,44 @@ public:
     void setPluginSearchPaths( const QStringList & pathList);
 
     /// find and load plugins from the specified directories
+    ///
+    /// plugins whose hooks are known from the discovery cache are only loaded when
+    /// one of their hooks is first dispatched, unless eager loading is configured
     void loadPlugins();
 
     /// return information about all plugins
     const std::vector<PluginInfo> & getInfoList();
 
+    /// timing information about the dispatch of a single hook
+    struct HookStats {
+        /// id of the hook
+        HookId id = -1;
+        /// readable name of the hook
+        QString name;
+        /// number of times the hook was dispatched
+        quint64 calls = 0;
+        /// number of dispatches answered from the memo
+        quint64 memoHits = 0;
+        /// total time spent in the dispatches (ms)
+        double totalMs = 0;
+        /// longest single dispatch (ms)
+        double maxMs = 0;
+    };
+
+    /// return the dispatch statistics of all hooks that were called at least once
+    std::vector<HookStats> getHookStats() const;
+
+    /// reset the dispatch statistics
+    void resetHookStats();
+
+    /// returns true if at least one plugin listens to the given hook, this can be used
+    /// to skip preparing expensive hook parameters
+    template <typename Hook>
+    bool hasPlugins() const
+    {
+        return ! listForHook( Hook::staticId).empty();
+    }
+
     ///
     /// Prepare the execution of the hook
     ///
@@ -158,10 +217,59 @@ public:
 protected:
 
     /// return a list of plugins that registered the given hook
-    std::vector<PluginInfo *> & listForHook( HookId id) {
+    const std::vector<PluginInfo *> & listForHook( HookId id) const {
+        static const std::vector<PluginInfo *> empty;
+        if( id < 0 || id >= HookId( m_hook2plugin.size())) {
+            return empty;
+        }
         return m_hook2plugin[ id];
     }
 
+    /// returns true if the id has a slot in the dense per-hook tables
+    static bool isKnownHook( HookId id) {
+        return id >= 0 && id < HookCount;
+    }
+
+    /// states of a discovered plugin
+    enum LoadState { NotLoaded, Loading, Loaded, Failed };
+
+    /// return the plugin, loading and initializing it and its dependencies first if
+    /// this did not happen yet; returns nullptr if the plugin could not be loaded
+    IPlugin * activate( PluginInfo * pInfo);
+
+    /// return the plugin if it is loaded, nullptr otherwise
+    IPlugin * loadedPlugin( PluginInfo * pInfo) const;
+
+    /// hooks that only notify plugins (Initialize) do not cause plugins to be loaded;
+    /// a plugin loaded later receives them right after it was initialized
+    static bool isNotificationHook( HookId id);
+
+    /// load and initialize a plugin after its dependencies, m_loadMutex must be held
+    bool loadWithDependencies( int index);
+
+    /// load and initialize a single plugin, m_loadMutex must be held
+    bool loadPlugin( PluginInfo & pInfo);
+
+    /// add a plugin to the lists of the hooks it listens to
+    void registerHooks( PluginInfo & pInfo);
+
+    /// return the plugin that answered the last first() call of a parameterless hook
+    PluginInfo * cachedHandler( HookId id) const;
+
+    /// remember the plugin that answered first() of a parameterless hook
+    void setCachedHandler( HookId id, PluginInfo * pInfo);
+
+    /// forget the cached handlers and memoised results, called whenever a plugin
+    /// is loaded since it may take priority over the plugins that answered so far
+    void clearHookCaches();
+
+    /// record the duration of one hook dispatch
+    void recordHookCall( HookId id, qint64 nsecs, bool memoHit);
+
+    /// return the memo of an idempotent hook, creating it if necessary
+    template <typename T>
+    std::shared_ptr< HookMemo<T> > memoForHook();
+
     /// find all plugins in the provided search paths and parse their
     /// cooresponding .json files
     std::vector< PluginInfo > findAllPlugins();
@@ -174,14 +282,86 @@ protected:
     /// attempt to load a native plugin
     bool loadNativePlugin( PluginInfo & pInfo);
 
-    /// list of plugins registered per hook
-    /// \todo we should probably use std::vector for little more performance
-    /// but that means we'll need to ensure consecutive numbering of hooks...
-    std::map< HookId, std::vector< PluginInfo *> > m_hook2plugin;
+    /// modification times of the files that parsePluginDir() looks at and of the
+    /// modules of python plugins
+    static QString pluginSignature( const QString & dirName);
+
+    /// the plugin's section of the main config, which is passed to initialize()
+    /// and may change the hooks it listens to
+    static QString configSignature( const QString & pluginName);
+
+    /// read the plugin discovery cache into m_discoveryCache
+    void readDiscoveryCache();
+
+    /// save the discovered plugins to the discovery cache, if anything changed
+    void writeDiscoveryCache();
+
+    /// convert between plugin information and discovery cache entries
+    static QJsonObject toCacheEntry( const PluginInfo & pInfo);
+    static bool fromCacheEntry( const QJsonObject & entry, PluginInfo & pInfo);
+
+    /// number of hooks with consecutive ids (see UniqueHookIDs)
+    static constexpr HookId HookCount =
+            static_cast< HookId >( Carta::Lib::Hooks::UniqueHookIDs::HookCount);
+
+    /// list of plugins registered per hook, indexed by hook id
+    std::vector< std::vector< PluginInfo *> > m_hook2plugin;
+
+    /// dispatch statistics, indexed by hook id
+    struct AtomicHookStats {
+        std::atomic< quint64 > calls { 0 };
+        std::atomic< quint64 > memoHits { 0 };
+        std::atomic< qint64 > totalNs { 0 };
+        std::atomic< qint64 > maxNs { 0 };
+    };
+    std::unique_ptr< AtomicHookStats[] > m_hookStats;
+
+    /// protects m_cachedHandlers and m_hookMemos, hooks can be called from
+    /// worker threads
+    mutable QMutex m_hookCacheMutex;
+
+    /// plugin that answered first() of parameterless hooks, indexed by hook id
+    std::vector< PluginInfo * > m_cachedHandlers;
+
+    /// memoised results of idempotent hooks (HookMemo<T>), indexed by hook id
+    std::vector< std::shared_ptr< void > > m_hookMemos;
 
     /// list of all discovered plugins
     std::vector< PluginInfo > m_discoveredPlugins;
 
+    /// index of each discovered plugin by name
+    std::map< QString, int > m_pluginIndex;
+
+    /// LoadState of each discovered plugin, readable without m_loadMutex
+    std::unique_ptr< std::atomic< int >[] > m_pluginStates;
+
+    /// serializes loading plugins, recursive because initializing a plugin may
+    /// dispatch hooks that need other plugins
+    mutable QMutex m_loadMutex { QMutex::Recursive };
+
+    /// notification hooks that have been dispatched, indexed by hook id and
+    /// protected by m_loadMutex
+    std::vector< bool > m_notified;
+
+    /// whether plugins should be loaded at startup
+    bool m_eagerLoading = true;
+
+    /// location of the discovery cache, empty if there is none
+    QString m_discoveryCacheFile;
+
+    /// cache entries by plugin directory
+    QJsonObject m_discoveryCache;
+
+    /// whether the discovery cache needs to be written
+    bool m_discoveryCacheDirty = false;
+
+    /// whether loadPlugins() has finished
+    bool m_started = false;
+
+    /// whether a plugin registered from the cache turned out to listen to other
+    /// hooks while loadPlugins() was running
+    bool m_hooksChanged = false;
+
     template<typename T> friend class HookHelper;
 
     /// list of plugin search paths
@@ -189,23 +369,60 @@ protected:
 
 };
 
+template <typename T>
+std::shared_ptr< HookMemo<T> > PluginManager::memoForHook()
+{
+    QMutexLocker locker( & m_hookCacheMutex);
+    std::shared_ptr< void > & slot = m_hookMemos[ T::staticId];
+    if( ! slot) {
+        slot = std::make_shared< HookMemo<T> >();
+    }
+    return std::static_pointer_cast< HookMemo<T> >( slot);
+}
+
 /// the workhorse - keep calling each plugin that implementes the hook, followed
 /// by calling the supplied callback function, until we run out of plugins
 /// or the callback return 'false'
 template <typename T>
 void HookHelper<T>::forEachCond( std::function< bool(typename T::ResultType)> func)
+{
+    // idempotent hooks with a slot in the dense tables are served from the memo
+    typedef std::integral_constant< bool,
+            Carta::Lib::Hooks::IsIdempotentHook<T>::value
+            && ( T::staticId < PluginManager::HookCount ) > Memoised;
+    forEachCondImpl( func, Memoised());
+}
+
+template <typename T>
+void HookHelper<T>::forEachCondImpl( std::function< bool(typename T::ResultType)> & func,
+                                     std::false_type)
 {
     HookId hookId = T::staticId;
+    QElapsedTimer timer;
+    timer.start();
 
     // get the list of plugins that claim they handle this hook
-    auto pluginList = m_pm-> listForHook( hookId);
+    const auto & pluginList = m_pm-> listForHook( hookId);
 
     // make an actual instance of the Hook on the stack and give it a pointer
     // to the parameters
     T hookData( & m_params);
 
+    // notifications go only to plugins that are loaded, the others receive them
+    // when they are loaded; holding the load lock makes sure that nobody misses one
+    bool notification = PluginManager::isNotificationHook( hookId);
+    QMutexLocker loadLocker( notification ? & m_pm-> m_loadMutex : nullptr);
+    if( notification) {
+        m_pm-> m_notified[ hookId] = true;
+    }
+
     for( auto pluginInfo : pluginList) {
-        bool handled = pluginInfo-> rawPlugin-> handleHook( hookData);
+        IPlugin * plugin = notification ? m_pm-> loadedPlugin( pluginInfo)
+                                        : m_pm-> activate( pluginInfo);
+        if( ! plugin) {
+            continue;
+        }
+        bool handled = plugin-> handleHook( hookData);
         // skip to the next plugin immediately if this hook was not handled by
         // this plugin
         if( ! handled) {
@@ -218,6 +435,114 @@ void HookHelper<T>::forEachCond( std::function< bool(typename T::ResultType)> fu
             break;
         }
     }
+
+    m_pm-> recordHookCall( hookId, timer.nsecsElapsed(), false);
+}
+
+template <typename T>
+void HookHelper<T>::forEachCondImpl( std::function< bool(typename T::ResultType)> & func,
+                                     std::true_type)
+{
+    HookId hookId = T::staticId;
+    QElapsedTimer timer;
+    timer.start();
+
+    auto memo = m_pm-> memoForHook<T>();
+    std::vector< typename T::ResultType > results;
+    bool memoHit = false;
+    {
+        QMutexLocker locker( & m_pm-> m_hookCacheMutex);
+        for( const auto & entry : memo-> entries) {
+            if( entry.first == m_params) {
+                results = entry.second;
+                memoHit = true;
+                break;
+            }
+        }
+    }
+
+    // on a miss, run all plugins (not just until func() aborts) so that the
+    // complete list of results can be replayed next time
+    if( ! memoHit) {
+        for( auto pluginInfo : m_pm-> listForHook( hookId)) {
+            IPlugin * plugin = m_pm-> activate( pluginInfo);
+            T hookData( & m_params);
+            if( plugin && plugin-> handleHook( hookData)) {
+                results.push_back( hookData.result);
+            }
+        }
+        QMutexLocker locker( & m_pm-> m_hookCacheMutex);
+        memo-> entries.push_back( std::make_pair( m_params, results));
+    }
+
+    for( auto & result : results) {
+        if( ! func( result)) {
+            break;
+        }
+    }
+
+    m_pm-> recordHookCall( hookId, timer.nsecsElapsed(), memoHit);
+}
+
+template <typename T>
+Nullable<typename T::ResultType> HookHelper<T>::first()
+{
+    // memoised hooks already skip the plugins, otherwise parameterless hooks
+    // can go straight to the plugin that answered last time
+    typedef std::integral_constant< bool,
+            std::is_empty< typename T::Params>::value
+            && ! Carta::Lib::Hooks::IsIdempotentHook<T>::value
+            && ( T::staticId < PluginManager::HookCount ) > CacheHandler;
+    return firstImpl( CacheHandler());
+}
+
+template <typename T>
+Nullable<typename T::ResultType> HookHelper<T>::firstImpl( std::false_type)
+{
+    Nullable<typename T::ResultType> result;
+    auto wrapper = [& result] (typename T::ResultType && hookResult) -> bool {
+        result = hookResult;
+        return false;
+    };
+    forEachCond( wrapper);
+    // return unset value
+    return result;
+}
+
+template <typename T>
+Nullable<typename T::ResultType> HookHelper<T>::firstImpl( std::true_type)
+{
+    HookId hookId = T::staticId;
+    QElapsedTimer timer;
+    timer.start();
+
+    // try the plugin that answered last time first
+    auto cached = m_pm-> cachedHandler( hookId);
+    if( cached) {
+        T hookData( & m_params);
+        if( cached-> rawPlugin-> handleHook( hookData)) {
+            m_pm-> recordHookCall( hookId, timer.nsecsElapsed(), false);
+            return hookData.result;
+        }
+    }
+
+    // otherwise walk the list and remember who answered
+    Nullable<typename T::ResultType> result;
+    for( auto pluginInfo : m_pm-> listForHook( hookId)) {
+        if( pluginInfo == cached) {
+            continue;
+        }
+        IPlugin * plugin = m_pm-> activate( pluginInfo);
+        T hookData( & m_params);
+        if( plugin && plugin-> handleHook( hookData)) {
+            m_pm-> setCachedHandler( hookId, pluginInfo);
+            result = hookData.result;
+            break;
+        }
+    }
+
+    m_pm-> recordHookCall( hookId, timer.nsecsElapsed(), false);
+    return result;
 }
 
 
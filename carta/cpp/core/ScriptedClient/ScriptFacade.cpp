@@ -4,15 +4,20 @@
 #include "Data/Animator/Animator.h"
 #include "Data/Animator/AnimatorType.h"
 #include "Data/Image/Controller.h"
+#include "Data/Image/ImageRegistry.h"
 #include "Data/Selection.h"
 #include "Data/Colormap/Colormap.h"
 #include "Data/Colormap/Colormaps.h"
 #include "Data/Util.h"
+#include "FrameCache.h"
+#include "MemoryGovernor.h"
 #include "Data/Histogram/Histogram.h"
 #include "Data/Layout/Layout.h"
 #include "Data/Preferences/PreferencesSave.h"
 #include "Data/Image/Grid/GridControls.h"
 #include "Data/Image/Contour/ContourControls.h"
+#include "Globals.h"
+#include "CartaLib/Trace.h"
 
 #include <QDebug>
 #include <cmath>
@@ -158,6 +163,100 @@ QStringList ScriptFacade::getPluginList() const {
     return resultList;
 }
 
+QStringList ScriptFacade::getHookStats( bool reset ) {
+    QStringList resultList;
+    auto pm = Globals::instance()->pluginManager();
+    for ( const PluginManager::HookStats & stats : pm->getHookStats() ) {
+        resultList << QString( "%1 calls=%2 memoHits=%3 totalMs=%4 maxMs=%5" )
+                      .arg( stats.name ).arg( stats.calls ).arg( stats.memoHits )
+                      .arg( stats.totalMs ).arg( stats.maxMs );
+    }
+    if ( reset ) {
+        pm->resetHookStats();
+    }
+    if ( resultList.isEmpty() ) {
+        resultList = QStringList( "" );
+    }
+    return resultList;
+}
+
+QStringList ScriptFacade::getFrameCacheStats( bool reset ) {
+    QStringList resultList;
+    Carta::Core::FrameCache * cache = Globals::instance()->frameCache();
+    for ( const Carta::Core::FrameCache::TierStats & stats : cache->stats() ) {
+        quint64 lookups = stats.hits + stats.misses;
+        double hitRatio = lookups > 0 ? double( stats.hits ) / lookups : 0;
+        resultList << QString( "%1 hits=%2 misses=%3 hitRatio=%4 entries=%5 bytes=%6" )
+                      .arg( stats.name ).arg( stats.hits ).arg( stats.misses )
+                      .arg( hitRatio ).arg( stats.entries ).arg( stats.bytes );
+    }
+    resultList << QString( "budget bytes=%1" ).arg( cache->budget() );
+    if ( reset ) {
+        cache->resetStats();
+    }
+    return resultList;
+}
+
+QStringList ScriptFacade::getMemoryUsage() {
+    QStringList resultList;
+    Carta::Core::MemoryGovernor * governor = Globals::instance()->memoryGovernor();
+    for ( const Carta::Core::MemoryGovernor::ConsumerStats & stats : governor->stats() ) {
+        resultList << QString( "%1 bytes=%2 peakBytes=%3 evictable=%4" )
+                      .arg( stats.name ).arg( stats.bytes )
+                      .arg( stats.peakBytes ).arg( stats.evictable ? "true" : "false" );
+    }
+    resultList << QString( "budget bytes=%1" ).arg( governor->budget() );
+    resultList << QString( "used bytes=%1 evictions=%2" )
+                  .arg( governor->bytesUsed() ).arg( governor->evictionCount() );
+    return resultList;
+}
+
+QStringList ScriptFacade::getImageMemory() {
+    QStringList resultList;
+    for ( const Carta::Data::ImageRegistry::Usage & usage : Carta::Data::ImageRegistry::instance()->getUsage() ) {
+        resultList << QString( "%1 handles=%2 dataBytes=%3 permutedViews=%4 clipEntries=%5" )
+                      .arg( usage.path ).arg( usage.handles ).arg( usage.dataBytes )
+                      .arg( usage.permutedViews ).arg( usage.clipEntries );
+    }
+    if ( resultList.isEmpty() ) {
+        resultList = QStringList( "" );
+    }
+    return resultList;
+}
+
+QStringList ScriptFacade::setTracing( bool enabled ) {
+    Carta::Lib::Trace::setEnabled( enabled );
+    QStringList resultList("");
+    return resultList;
+}
+
+QStringList ScriptFacade::getMetrics( bool reset, const QString& traceFile ) {
+    namespace Trace = Carta::Lib::Trace;
+    QStringList resultList;
+    resultList << QString( "tracing enabled=%1" ).arg( Trace::isEnabled() ? "true" : "false" );
+    for ( const Trace::SiteStats & stats : Trace::getSiteStats() ) {
+        resultList << QString( "%1/%2 calls=%3 totalMs=%4 meanMs=%5 maxMs=%6" )
+                      .arg( stats.category ).arg( stats.name ).arg( stats.calls )
+                      .arg( stats.totalMs ).arg( stats.totalMs / stats.calls ).arg( stats.maxMs );
+    }
+    for ( const Trace::CounterStats & stats : Trace::getCounterStats() ) {
+        resultList << QString( "%1 value=%2" ).arg( stats.name ).arg( stats.value );
+    }
+    if ( !traceFile.isEmpty() ) {
+        int eventCount = Trace::writeChromeTrace( traceFile );
+        if ( eventCount < 0 ) {
+            resultList << _logErrorMessage( ERROR, "Could not write trace file " + traceFile );
+        }
+        else {
+            resultList << QString( "trace file=%1 events=%2" ).arg( traceFile ).arg( eventCount );
+        }
+    }
+    if ( reset ) {
+        Trace::reset();
+    }
+    return resultList;
+}
+
 QStringList ScriptFacade::loadFile( const QString& objectId, const QString& fileName){
     QStringList resultList;
     bool loadSuccess = false;
@@ -225,6 +225,55 @@ public:
      */
     QStringList getPluginList() const;
 
+    /**
+     * Returns timing information about the plugin hooks dispatched so far.
+     * @param reset true if the statistics should be cleared afterwards.
+     * @return one line per hook with its name, number of calls, number of
+     *      calls answered from the memo, total and longest dispatch time.
+     */
+    QStringList getHookStats( bool reset );
+
+    /**
+     * Returns usage information about the frame cache shared by all views.
+     * @param reset true if the hit/miss counters should be cleared afterwards.
+     * @return one line per cache tier with its name, hits, misses, hit ratio,
+     *      number of entries and bytes used, followed by the total budget.
+     */
+    QStringList getFrameCacheStats( bool reset );
+
+    /**
+     * Returns the memory accounted by the memory governor.
+     * @return one line per memory consumer with its name, bytes held, peak
+     *      bytes and whether it can be evicted, followed by the budget, the
+     *      total bytes used and the number of evictions so far.
+     */
+    QStringList getMemoryUsage();
+
+    /**
+     * Returns the memory used by the images that are open in any session.
+     * @return one line per image with its path, number of handles, bytes of
+     *      pixel data, number of cached permuted views and clip entries.
+     */
+    QStringList getImageMemory();
+
+    /**
+     * Start or stop recording timings of the hot paths.
+     * @param enabled true to start recording; false to stop.
+     * @return an empty list.
+     */
+    QStringList setTracing( bool enabled );
+
+    /**
+     * Returns the timings and counters recorded since the last reset.
+     * @param reset true if the timings, counters and events should be cleared afterwards.
+     * @param traceFile if not empty, the recent events are also written to this file
+     *      in the Chrome trace format.
+     * @return whether tracing is on, one line per traced scope with its number of
+     *      calls, total, mean and longest time, one line per counter with its value
+     *      and, if a trace file was requested, the number of events written to it.
+     */
+    QStringList getMetrics( bool reset, const QString& traceFile );
+
     /**
      * Set the image channel to the specified value.
      * @param animatorId the unique server-side id of an object managing an animator.
@@ -11,6 +11,9 @@ namespace Core
 {
 namespace ScriptedClient
 {
+const QString ScriptedCommandInterpreter::BATCH = "batch";
+const QString ScriptedCommandInterpreter::REQUEST_ID = "id";
+
 ScriptedCommandInterpreter::ScriptedCommandInterpreter( int port, QObject * parent )
     : QObject( parent )
 {
@@ -23,38 +26,19 @@ ScriptedCommandInterpreter::ScriptedCommandInterpreter( int port, QObject * pare
 
     connect( m_messageListener.get(), & MessageListener::receivedAsync,
              this, & ScriptedCommandInterpreter::asyncMessageReceivedCB );
+
+    _initCommandTable();
 }
 
-/// The bulk of this method is a massive if/else if/.../else statement.
-/// It's not pretty, but it works. So far I have been unable to come up
-/// with a way of simplifying it that doesn't just make it needlessly
-/// complex.
+/// Commands are looked up by their lower case name in a hash table, which
+/// is filled in once here. Each handler pulls its arguments out of the
+/// json "args" object and forwards them to the ScriptFacade.
 /// In order to make it more readable, I have tried to include some
 /// extra comments about the commands, and also to group the commands
 /// according to which Python classes they relate to.
 void
-ScriptedCommandInterpreter::tagMessageReceivedCB( TagMessage tm )
+ScriptedCommandInterpreter::_initCommandTable()
 {
-    m_scriptFacade = ScriptFacade::getInstance();
-    if ( tm.tag() != "json" ) {
-        qWarning() << "I don't handle tag" << tm.tag();
-        return;
-    }
-    JsonMessage jm = JsonMessage::fromTagMessage( tm );
-    if ( ! jm.doc().isObject() ) {
-        qWarning() << "Received json is not object...";
-        return;
-    }
-    QJsonObject jo = jm.doc().object();
-    // Get the command name and the arguments.
-    // Arguments will be parsed according to the command name.
-    QString cmd = jo["cmd"].toString().toLower();
-    auto args = jo["args"].toObject();
-    QStringList result;
-    // By default, assume that we will be sending a proper result back.
-    // If an error occurs, key will be set to "error".
-    QString key = "result";
-
     /// Section: Application Commands
     /// -----------------------------
     /// These commands come from the Python Cartavis class. They are
@@ -62,142 +46,171 @@ ScriptedCommandInterpreter::tagMessageReceivedCB( TagMessage tm )
     /// things like the different windows in the GUI and the
     /// relationships between the windows.
 
-    if ( cmd == "getcolormapviews" ) {
-        result = m_scriptFacade->getColorMapViews();
-    }
+    m_commandTable["getcolormapviews"] = [this]( const QJsonObject & /*args*/ ) -> QStringList {
+        return m_scriptFacade->getColorMapViews();
+    };
 
-    else if ( cmd == "getimageviews" ) {
-        result = m_scriptFacade->getImageViews();
-    }
+    m_commandTable["getimageviews"] = [this]( const QJsonObject & /*args*/ ) -> QStringList {
+        return m_scriptFacade->getImageViews();
+    };
 
-    else if ( cmd == "getanimatorviews" ) {
-        result = m_scriptFacade->getAnimatorViews();
-    }
+    m_commandTable["getanimatorviews"] = [this]( const QJsonObject & /*args*/ ) -> QStringList {
+        return m_scriptFacade->getAnimatorViews();
+    };
 
-    else if ( cmd == "gethistogramviews" ) {
-        result = m_scriptFacade->getHistogramViews();
-    }
+    m_commandTable["gethistogramviews"] = [this]( const QJsonObject & /*args*/ ) -> QStringList {
+        return m_scriptFacade->getHistogramViews();
+    };
 
-    else if ( cmd == "setanalysislayout" ) {
-        result = m_scriptFacade->setAnalysisLayout();
-    }
+    m_commandTable["setanalysislayout"] = [this]( const QJsonObject & /*args*/ ) -> QStringList {
+        return m_scriptFacade->setAnalysisLayout();
+    };
 
-    else if ( cmd == "setimagelayout" ) {
-        result = m_scriptFacade->setImageLayout();
-    }
+    m_commandTable["setimagelayout"] = [this]( const QJsonObject & /*args*/ ) -> QStringList {
+        return m_scriptFacade->setImageLayout();
+    };
 
-    else if ( cmd == "setcustomlayout" ) {
+    m_commandTable["setcustomlayout"] = [this]( const QJsonObject & args ) -> QStringList {
         int rows = args["nrows"].toInt();
         int columns = args["ncols"].toInt();
-        result = m_scriptFacade->setCustomLayout(rows, columns);
-    }
+        return m_scriptFacade->setCustomLayout(rows, columns);
+    };
 
-    else if ( cmd == "setplugins" ) {
+    m_commandTable["setplugins"] = [this]( const QJsonObject & args ) -> QStringList {
         QString plugins = args["plugins"].toString();
         QStringList pluginsList = plugins.split(' ');
-        result = m_scriptFacade->setPlugins(pluginsList);
-    }
+        return m_scriptFacade->setPlugins(pluginsList);
+    };
 
-    else if ( cmd == "getpluginlist" ) {
-        result = m_scriptFacade->getPluginList();
-    }
+    m_commandTable["getpluginlist"] = [this]( const QJsonObject & /*args*/ ) -> QStringList {
+        return m_scriptFacade->getPluginList();
+    };
 
-    else if ( cmd == "addlink" ) {
+    m_commandTable["addlink"] = [this]( const QJsonObject & args ) -> QStringList {
         QString source = args["sourceView"].toString();
         QString dest = args["destView"].toString();
-        result = m_scriptFacade->addLink(source, dest);
-    }
+        return m_scriptFacade->addLink(source, dest);
+    };
 
-    else if ( cmd == "removelink" ) {
+    m_commandTable["removelink"] = [this]( const QJsonObject & args ) -> QStringList {
         QString source = args["sourceView"].toString();
         QString dest = args["destView"].toString();
-        result = m_scriptFacade->removeLink(source, dest);
-    }
+        return m_scriptFacade->removeLink(source, dest);
+    };
 
-    else if ( cmd == "savesnapshot" ) {
+    m_commandTable["savesnapshot"] = [this]( const QJsonObject & args ) -> QStringList {
         QString sessionId = args["sessionId"].toString();
         QString saveName = args["saveName"].toString();
         bool saveLayout = args["saveLayout"].toBool();
         bool savePreferences = args["savePreferences"].toBool();
         bool saveData = args["saveData"].toBool();
         QString description = args["description"].toString();
-        result = m_scriptFacade->saveSnapshot(sessionId, saveName, saveLayout, savePreferences, saveData, description);
-    }
+        return m_scriptFacade->saveSnapshot(sessionId, saveName, saveLayout, savePreferences, saveData, description);
+    };
 
-    else if ( cmd == "getsnapshots" ) {
+    m_commandTable["getsnapshots"] = [this]( const QJsonObject & args ) -> QStringList {
         QString sessionId = args["sessionId"].toString();
-        result = m_scriptFacade->getSnapshots(sessionId);
-    }
+        return m_scriptFacade->getSnapshots(sessionId);
+    };
 
-    else if ( cmd == "getsnapshotobjects" ) {
+    m_commandTable["getsnapshotobjects"] = [this]( const QJsonObject & args ) -> QStringList {
         QString sessionId = args["sessionId"].toString();
-        result = m_scriptFacade->getSnapshotObjects(sessionId);
-    }
+        return m_scriptFacade->getSnapshotObjects(sessionId);
+    };
 
-    else if ( cmd == "deletesnapshot" ) {
+    m_commandTable["deletesnapshot"] = [this]( const QJsonObject & args ) -> QStringList {
         QString sessionId = args["sessionId"].toString();
         QString saveName = args["saveName"].toString();
-        result = m_scriptFacade->deleteSnapshot(sessionId, saveName);
-    }
+        return m_scriptFacade->deleteSnapshot(sessionId, saveName);
+    };
 
-    else if ( cmd == "restoresnapshot" ) {
+    m_commandTable["restoresnapshot"] = [this]( const QJsonObject & args ) -> QStringList {
         QString sessionId = args["sessionId"].toString();
         QString saveName = args["saveName"].toString();
-        result = m_scriptFacade->restoreSnapshot(sessionId, saveName);
-    }
-
-    else if ( cmd == "getcolormaps" ) {
-        result = m_scriptFacade->getColorMaps();
-    }
+        return m_scriptFacade->restoreSnapshot(sessionId, saveName);
+    };
+
+    m_commandTable["gethookstats"] = [this]( const QJsonObject & args ) -> QStringList {
+        bool reset = args["reset"].toBool();
+        return m_scriptFacade->getHookStats( reset );
+    };
+
+    m_commandTable["getframecachestats"] = [this]( const QJsonObject & args ) -> QStringList {
+        bool reset = args["reset"].toBool();
+        return m_scriptFacade->getFrameCacheStats( reset );
+    };
+
+    m_commandTable["getmemoryusage"] = [this]( const QJsonObject & /*args*/ ) -> QStringList {
+        return m_scriptFacade->getMemoryUsage();
+    };
+
+    m_commandTable["getimagememory"] = [this]( const QJsonObject & /*args*/ ) -> QStringList {
+        return m_scriptFacade->getImageMemory();
+    };
+
+    m_commandTable["settracing"] = [this]( const QJsonObject & args ) -> QStringList {
+        bool enabled = args["enabled"].toBool();
+        return m_scriptFacade->setTracing( enabled );
+    };
+
+    m_commandTable["getmetrics"] = [this]( const QJsonObject & args ) -> QStringList {
+        bool reset = args["reset"].toBool();
+        QString traceFile = args["traceFile"].toString();
+        return m_scriptFacade->getMetrics( reset, traceFile );
+    };
+
+    m_commandTable["getcolormaps"] = [this]( const QJsonObject & /*args*/ ) -> QStringList {
+        return m_scriptFacade->getColorMaps();
+    };
 
     /// Section: Colormap Commands
     /// --------------------------
     /// These commands come from the Python Colormap class. They enable
     /// colormaps to be set and manipulated.
 
-    else if ( cmd == "setcolormap" ) {
+    m_commandTable["setcolormap"] = [this]( const QJsonObject & args ) -> QStringList {
         QString colormapId = args["colormapId"].toString();
         QString colormapName = args["colormapName"].toString();
-        result = m_scriptFacade->setColorMap( colormapId, colormapName );
-    }
+        return m_scriptFacade->setColorMap( colormapId, colormapName );
+    };
 
-    else if ( cmd == "reversecolormap" ) {
+    m_commandTable["reversecolormap"] = [this]( const QJsonObject & args ) -> QStringList {
         QString colormapId = args["colormapId"].toString();
         QString reverseString = args["reverseString"].toString().toLower();
-        result = m_scriptFacade->reverseColorMap( colormapId, reverseString );
-    }
+        return m_scriptFacade->reverseColorMap( colormapId, reverseString );
+    };
 
-    else if ( cmd == "invertcolormap" ) {
+    m_commandTable["invertcolormap"] = [this]( const QJsonObject & args ) -> QStringList {
         QString colormapId = args["colormapId"].toString();
         QString invertString = args["invertString"].toString().toLower();
-        result = m_scriptFacade->invertColorMap( colormapId, invertString );
-    }
+        return m_scriptFacade->invertColorMap( colormapId, invertString );
+    };
 
-    else if ( cmd == "setcolormix" ) {
+    m_commandTable["setcolormix"] = [this]( const QJsonObject & args ) -> QStringList {
         QString colormapId = args["colormapId"].toString();
         double red = args["red"].toDouble();
         double green = args["green"].toDouble();
         double blue = args["blue"].toDouble();
-        result = m_scriptFacade->setColorMix( colormapId, red, green, blue );
-    }
+        return m_scriptFacade->setColorMix( colormapId, red, green, blue );
+    };
 
-    else if ( cmd == "setgamma" ) {
+    m_commandTable["setgamma"] = [this]( const QJsonObject & args ) -> QStringList {
         QString colormapId = args["colormapId"].toString();
         double gamma = args["gammaValue"].toDouble();
-        result = m_scriptFacade->setGamma( colormapId, gamma );
-    }
+        return m_scriptFacade->setGamma( colormapId, gamma );
+    };
 
-    else if ( cmd == "setdatatransform" ) {
+    m_commandTable["setdatatransform"] = [this]( const QJsonObject & args ) -> QStringList {
         QString colormapId = args["colormapId"].toString();
         QString transform = args["transform"].toString();
-        result = m_scriptFacade->setDataTransform( colormapId, transform );
-    }
+        return m_scriptFacade->setDataTransform( colormapId, transform );
+    };
 
-    else if ( cmd == "setnandefault" ) {
+    m_commandTable["setnandefault"] = [this]( const QJsonObject & args ) -> QStringList {
         QString colormapId = args["colormapId"].toString();
         QString nanDefaultString = args["nanDefaultString"].toString().toLower();
-        result = m_scriptFacade->setNanDefault( colormapId, nanDefaultString);
-    }
+        return m_scriptFacade->setNanDefault( colormapId, nanDefaultString);
+    };
 
     /// Section: Image/Controller Commands
     /// ----------------------------------
@@ -205,109 +218,110 @@ ScriptedCommandInterpreter::tagMessageReceivedCB( TagMessage tm )
     /// images to be loaded and manipulated and can also return
     /// information about the images.
 
-    else if ( cmd == "loadfile" ) {
+    m_commandTable["loadfile"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         QString fileName = args["fname"].toString();
-        result = m_scriptFacade->loadFile( imageView, fileName );
-    }
+        return m_scriptFacade->loadFile( imageView, fileName );
+    };
 
-    else if ( cmd == "getlinkedcolormaps" ) {
+    m_commandTable["getlinkedcolormaps"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
-        result = m_scriptFacade->getLinkedColorMaps( imageView );
-    }
+        return m_scriptFacade->getLinkedColorMaps( imageView );
+    };
 
-    else if ( cmd == "getlinkedanimators" ) {
+    m_commandTable["getlinkedanimators"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
-        result = m_scriptFacade->getLinkedAnimators( imageView );
-    }
+        return m_scriptFacade->getLinkedAnimators( imageView );
+    };
 
-    else if ( cmd == "getlinkedhistograms" ) {
+    m_commandTable["getlinkedhistograms"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
-        result = m_scriptFacade->getLinkedHistograms( imageView );
-    }
+        return m_scriptFacade->getLinkedHistograms( imageView );
+    };
 
-    else if ( cmd == "setclipvalue" ) {
+    m_commandTable["setclipvalue"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         double clipValue = args["clipValue"].toDouble();
-        result = m_scriptFacade->setClipValue( imageView, clipValue );
-    }
+        return m_scriptFacade->setClipValue( imageView, clipValue );
+    };
 
-    else if ( cmd == "centeronpixel" ) {
+    m_commandTable["centeronpixel"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         double x = args["xval"].toDouble();
         double y = args["yval"].toDouble();
-        result = m_scriptFacade->centerOnPixel( imageView, x, y );
-    }
+        return m_scriptFacade->centerOnPixel( imageView, x, y );
+    };
 
-    else if ( cmd == "setzoomlevel" ) {
+    m_commandTable["setzoomlevel"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         double zoomLevel = args["zoomLevel"].toDouble();
-        result = m_scriptFacade->setZoomLevel( imageView, zoomLevel );
-    }
+        return m_scriptFacade->setZoomLevel( imageView, zoomLevel );
+    };
 
-    else if ( cmd == "getzoomlevel" ) {
+    m_commandTable["getzoomlevel"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
-        result = m_scriptFacade->getZoomLevel( imageView );
-    }
+        return m_scriptFacade->getZoomLevel( imageView );
+    };
 
-    else if ( cmd == "resetzoom" ) {
+    m_commandTable["resetzoom"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
-        result = m_scriptFacade->resetZoom( imageView );
-    }
+        return m_scriptFacade->resetZoom( imageView );
+    };
 
-    else if ( cmd == "centerimage" ) {
+    m_commandTable["centerimage"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
-        result = m_scriptFacade->centerImage( imageView );
-    }
+        return m_scriptFacade->centerImage( imageView );
+    };
 
-    else if ( cmd == "getcenterpixel" ) {
+    m_commandTable["getcenterpixel"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
-        result = m_scriptFacade->getCenterPixel( imageView );
-    }
+        return m_scriptFacade->getCenterPixel( imageView );
+    };
 
-    else if ( cmd == "getimagedimensions" ) {
+    m_commandTable["getimagedimensions"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
-        result = m_scriptFacade->getImageDimensions( imageView );
-    }
+        return m_scriptFacade->getImageDimensions( imageView );
+    };
 
-    else if ( cmd == "getchannelcount" ) {
+    m_commandTable["getchannelcount"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
-        result = m_scriptFacade->getChannelCount( imageView );
-    }
+        return m_scriptFacade->getChannelCount( imageView );
+    };
 
-    else if ( cmd == "getoutputsize" ) {
+    m_commandTable["getoutputsize"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
-        result = m_scriptFacade->getOutputSize( imageView );
-    }
+        return m_scriptFacade->getOutputSize( imageView );
+    };
 
-    else if ( cmd == "getintensity" ) {
+    m_commandTable["getintensity"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         int frameLow = args["frameLow"].toInt();
         int frameHigh = args["frameHigh"].toInt();
         double percentile = args["percentile"].toDouble();
-        result = m_scriptFacade->getIntensity( imageView, frameLow, frameHigh, percentile );
-    }
+        return m_scriptFacade->getIntensity( imageView, frameLow, frameHigh, percentile );
+    };
 
-    else if ( cmd == "getpixelcoordinates" ) {
+    m_commandTable["getpixelcoordinates"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         double ra = args["ra"].toDouble();
         double dec = args["dec"].toDouble();
-        result = m_scriptFacade->getPixelCoordinates( imageView, ra, dec );
-    }
+        return m_scriptFacade->getPixelCoordinates( imageView, ra, dec );
+    };
 
-    else if ( cmd == "getpixelvalue" ) {
+    m_commandTable["getpixelvalue"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         double x = args["x"].toDouble();
         double y = args["y"].toDouble();
-        result = m_scriptFacade->getPixelValue( imageView, x, y );
-    }
+        return m_scriptFacade->getPixelValue( imageView, x, y );
+    };
 
-    else if ( cmd == "getpixelunits" ) {
+    m_commandTable["getpixelunits"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
-        result = m_scriptFacade->getPixelUnits( imageView );
-    }
+        return m_scriptFacade->getPixelUnits( imageView );
+    };
 
-    else if ( cmd == "getcoordinates" ) {
+    m_commandTable["getcoordinates"] = [this]( const QJsonObject & args ) -> QStringList {
+        QStringList result;
         QString imageView = args["imageView"].toString();
         double x = args["x"].toDouble();
         double y = args["y"].toDouble();
@@ -338,234 +352,235 @@ ScriptedCommandInterpreter::tagMessageReceivedCB( TagMessage tm )
             result = QStringList( "error" );
             result.append( "Invalid coordinate system: " + systemStr );
         }
-    }
+        return result;
+    };
 
-    else if ( cmd == "getimagenames" ) {
+    m_commandTable["getimagenames"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
-        result = m_scriptFacade->getImageNames( imageView );
-    }
+        return m_scriptFacade->getImageNames( imageView );
+    };
 
-    else if ( cmd == "closeimage" ) {
+    m_commandTable["closeimage"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         QString imageName = args["imageName"].toString();
-        result = m_scriptFacade->closeImage( imageView, imageName );
-    }
+        return m_scriptFacade->closeImage( imageView, imageName );
+    };
 
-    else if ( cmd == "showimage" ) {
+    m_commandTable["showimage"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         QString imageName = args["imageName"].toString();
-        result = m_scriptFacade->showImage( imageView, imageName);
-    }
+        return m_scriptFacade->showImage( imageView, imageName);
+    };
 
-    else if ( cmd == "hideimage" ) {
+    m_commandTable["hideimage"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         QString imageName = args["imageName"].toString();
-        result = m_scriptFacade->hideImage( imageView, imageName );
-    }
+        return m_scriptFacade->hideImage( imageView, imageName );
+    };
 
-    else if ( cmd == "setcompositionmode" ) {
+    m_commandTable["setcompositionmode"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         QString imageName = args["imageName"].toString();
-        result = m_scriptFacade->setCompositionMode( imageView, imageName );
-    }
+        return m_scriptFacade->setCompositionMode( imageView, imageName );
+    };
 
-    else if ( cmd == "setstackselectauto" ) {
+    m_commandTable["setstackselectauto"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         QString stackSelectFlag = args["stackSelectFlag "].toString();
-        result = m_scriptFacade->setStackSelectAuto( imageView, stackSelectFlag );
-    }
+        return m_scriptFacade->setStackSelectAuto( imageView, stackSelectFlag );
+    };
 
-    else if ( cmd == "setpanzoomall" ) {
+    m_commandTable["setpanzoomall"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         QString setPanZoomAllFlag = args["setPanZoomAllFlag"].toString();
-        result = m_scriptFacade->setPanZoomAll( imageView, setPanZoomAllFlag );
-    }
+        return m_scriptFacade->setPanZoomAll( imageView, setPanZoomAllFlag );
+    };
 
-    else if ( cmd == "setmaskalpha" ) {
+    m_commandTable["setmaskalpha"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         QString imageName = args["imageName"].toString();
         QString alphaAmount = args["alphaAmount"].toString();
-        result = m_scriptFacade->setMaskAlpha( imageView, imageName, alphaAmount );
-    }
+        return m_scriptFacade->setMaskAlpha( imageView, imageName, alphaAmount );
+    };
 
-    else if ( cmd == "setmaskcolor" ) {
+    m_commandTable["setmaskcolor"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         QString imageName = args["imageName"].toString();
         QString redAmount = args["redAmount"].toString();
         QString greenAmount = args["greenAmount"].toString();
         QString blueAmount = args["blueAmount"].toString();
-        result = m_scriptFacade->setMaskColor( imageView, imageName, redAmount, greenAmount, blueAmount );
-    }
+        return m_scriptFacade->setMaskColor( imageView, imageName, redAmount, greenAmount, blueAmount );
+    };
 
     /// Section: Grid Commands
     /// ----------------------------------
     /// These commands also come from the Python Image class. They allow
     /// the grid to be manipulated.
 
-    else if ( cmd == "setgridaxescolor" ) {
+    m_commandTable["setgridaxescolor"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         int red = args["red"].toInt();
         int green = args["green"].toInt();
         int blue = args["blue"].toInt();
-        result = m_scriptFacade->setGridAxesColor( imageView, red, green, blue );
-    }
+        return m_scriptFacade->setGridAxesColor( imageView, red, green, blue );
+    };
 
-    else if ( cmd == "setgridaxesthickness" ) {
+    m_commandTable["setgridaxesthickness"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         int thickness = args["thickness"].toInt();
-        result = m_scriptFacade->setGridAxesThickness( imageView, thickness );
-    }
+        return m_scriptFacade->setGridAxesThickness( imageView, thickness );
+    };
 
-    else if ( cmd == "setgridaxestransparency" ) {
+    m_commandTable["setgridaxestransparency"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         int transparency = args["transparency"].toInt();
-        result = m_scriptFacade->setGridAxesTransparency( imageView, transparency );
-    }
+        return m_scriptFacade->setGridAxesTransparency( imageView, transparency );
+    };
 
-    else if ( cmd == "setgridapplyall" ) {
+    m_commandTable["setgridapplyall"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         bool applyAll = args["applyAll"].toBool();
-        result = m_scriptFacade->setGridApplyAll( imageView, applyAll );
-    }
+        return m_scriptFacade->setGridApplyAll( imageView, applyAll );
+    };
 
-    else if ( cmd == "setgridcoordinatesystem" ) {
+    m_commandTable["setgridcoordinatesystem"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         QString coordSystem = args["coordSystem"].toString();
-        result = m_scriptFacade->setGridCoordinateSystem( imageView, coordSystem );
-    }
+        return m_scriptFacade->setGridCoordinateSystem( imageView, coordSystem );
+    };
 
-    else if ( cmd == "setgridfontfamily" ) {
+    m_commandTable["setgridfontfamily"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         QString fontFamily = args["fontFamily"].toString();
-        result = m_scriptFacade->setGridFontFamily( imageView, fontFamily );
-    }
+        return m_scriptFacade->setGridFontFamily( imageView, fontFamily );
+    };
 
-    else if ( cmd == "setgridfontsize" ) {
+    m_commandTable["setgridfontsize"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         int fontSize = args["fontSize"].toInt();
-        result = m_scriptFacade->setGridFontSize( imageView, fontSize );
-    }
+        return m_scriptFacade->setGridFontSize( imageView, fontSize );
+    };
 
-    else if ( cmd == "setgridcolor" ) {
+    m_commandTable["setgridcolor"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         int redAmount = args["redAmount"].toInt();
         int greenAmount = args["greenAmount"].toInt();
         int blueAmount = args["blueAmount"].toInt();
-        result = m_scriptFacade->setGridColor( imageView, redAmount, greenAmount, blueAmount );
-    }
+        return m_scriptFacade->setGridColor( imageView, redAmount, greenAmount, blueAmount );
+    };
 
-    else if ( cmd == "setgridspacing" ) {
+    m_commandTable["setgridspacing"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         double spacing = args["spacing"].toDouble();
-        result = m_scriptFacade->setGridSpacing( imageView, spacing );
-    }
+        return m_scriptFacade->setGridSpacing( imageView, spacing );
+    };
 
-    else if ( cmd == "setgridthickness" ) {
+    m_commandTable["setgridthickness"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         int thickness = args["thickness"].toInt();
-        result = m_scriptFacade->setGridThickness( imageView, thickness );
-    }
+        return m_scriptFacade->setGridThickness( imageView, thickness );
+    };
 
-    else if ( cmd == "setgridtransparency" ) {
+    m_commandTable["setgridtransparency"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         int transparency = args["transparency"].toInt();
-        result = m_scriptFacade->setGridTransparency( imageView, transparency );
-    }
+        return m_scriptFacade->setGridTransparency( imageView, transparency );
+    };
 
-    else if ( cmd == "setgridlabelcolor" ) {
+    m_commandTable["setgridlabelcolor"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         int redAmount = args["redAmount"].toInt();
         int greenAmount = args["greenAmount"].toInt();
         int blueAmount = args["blueAmount"].toInt();
-        result = m_scriptFacade->setGridLabelColor( imageView, redAmount, greenAmount, blueAmount );
-    }
+        return m_scriptFacade->setGridLabelColor( imageView, redAmount, greenAmount, blueAmount );
+    };
 
-    else if ( cmd == "setshowgridaxis" ) {
+    m_commandTable["setshowgridaxis"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         bool showAxis = args["showAxis"].toBool();
-        result = m_scriptFacade->setShowGridAxis( imageView, showAxis );
-    }
+        return m_scriptFacade->setShowGridAxis( imageView, showAxis );
+    };
 
-    else if ( cmd == "setshowgridcoordinatesystem" ) {
+    m_commandTable["setshowgridcoordinatesystem"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         bool showCoordinateSystem = args["showCoordinateSystem"].toBool();
-        result = m_scriptFacade->setShowGridCoordinateSystem( imageView, showCoordinateSystem );
-    }
+        return m_scriptFacade->setShowGridCoordinateSystem( imageView, showCoordinateSystem );
+    };
 
-    else if ( cmd == "setshowgridlines" ) {
+    m_commandTable["setshowgridlines"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         bool showGridLines = args["showGridLines"].toBool();
-        result = m_scriptFacade->setShowGridLines( imageView, showGridLines );
-    }
+        return m_scriptFacade->setShowGridLines( imageView, showGridLines );
+    };
 
-    else if ( cmd == "setshowgridinternallabels" ) {
+    m_commandTable["setshowgridinternallabels"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         bool showInternalLabels = args["showInternalLabels"].toBool();
-        result = m_scriptFacade->setShowGridInternalLabels( imageView, showInternalLabels );
-    }
+        return m_scriptFacade->setShowGridInternalLabels( imageView, showInternalLabels );
+    };
 
-    else if ( cmd == "setshowgridstatistics" ) {
+    m_commandTable["setshowgridstatistics"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         bool showStatistics = args["showStatistics"].toBool();
-        result = m_scriptFacade->setShowGridStatistics( imageView, showStatistics );
-    }
+        return m_scriptFacade->setShowGridStatistics( imageView, showStatistics );
+    };
 
-    else if ( cmd == "setshowgridticks" ) {
+    m_commandTable["setshowgridticks"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         bool showTicks = args["showTicks"].toBool();
-        result = m_scriptFacade->setShowGridTicks( imageView, showTicks );
-    }
+        return m_scriptFacade->setShowGridTicks( imageView, showTicks );
+    };
 
-    else if ( cmd == "setgridtickcolor" ) {
+    m_commandTable["setgridtickcolor"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         int redAmount = args["redAmount"].toInt();
         int greenAmount = args["greenAmount"].toInt();
         int blueAmount = args["blueAmount"].toInt();
-        result = m_scriptFacade->setGridTickColor( imageView, redAmount, greenAmount, blueAmount );
-    }
+        return m_scriptFacade->setGridTickColor( imageView, redAmount, greenAmount, blueAmount );
+    };
 
-    else if ( cmd == "setgridtickthickness" ) {
+    m_commandTable["setgridtickthickness"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         int tickThickness = args["tickThickness"].toInt();
-        result = m_scriptFacade->setGridTickThickness( imageView, tickThickness );
-    }
+        return m_scriptFacade->setGridTickThickness( imageView, tickThickness );
+    };
 
-    else if ( cmd == "setgridticktransparency" ) {
+    m_commandTable["setgridticktransparency"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         int transparency = args["transparency"].toInt();
-        result = m_scriptFacade->setGridTickTransparency( imageView, transparency );
-    }
+        return m_scriptFacade->setGridTickTransparency( imageView, transparency );
+    };
 
-    else if ( cmd == "setgridtheme" ) {
+    m_commandTable["setgridtheme"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         QString theme = args["theme"].toString();
-        result = m_scriptFacade->setGridTheme( imageView, theme );
-    }
+        return m_scriptFacade->setGridTheme( imageView, theme );
+    };
 
     /// Section: Contour Commands
     /// ----------------------------------
     /// These commands also come from the Python Image class. They allow
     /// contours to be manipulated.
 
-    else if ( cmd == "deletecontourset" ) {
+    m_commandTable["deletecontourset"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         QString name = args["name"].toString();
-        result = m_scriptFacade->deleteContourSet( imageView, name );
-    }
+        return m_scriptFacade->deleteContourSet( imageView, name );
+    };
 
-    else if ( cmd == "generatecontourset" ) {
+    m_commandTable["generatecontourset"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         QString name = args["name"].toString();
-        result = m_scriptFacade->generateContourSet( imageView, name );
-    }
+        return m_scriptFacade->generateContourSet( imageView, name );
+    };
 
-    else if ( cmd == "selectcontourset" ) {
+    m_commandTable["selectcontourset"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         QString name = args["name"].toString();
-        result = m_scriptFacade->selectContourSet( imageView, name );
-    }
+        return m_scriptFacade->selectContourSet( imageView, name );
+    };
 
-    else if ( cmd == "setcontouralpha" ) {
+    m_commandTable["setcontouralpha"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         QString contourName = args["contourName"].toString();
         QJsonArray levelsArray = args["levels"].toArray();
@@ -574,10 +589,10 @@ ScriptedCommandInterpreter::tagMessageReceivedCB( TagMessage tm )
         for ( auto level : levelsArray ) {
             levels.push_back( level.toDouble() );
         }
-        result = m_scriptFacade->setContourAlpha( imageView, contourName, levels, transparency );
-    }
+        return m_scriptFacade->setContourAlpha( imageView, contourName, levels, transparency );
+    };
 
-    else if ( cmd == "setcontourcolor" ) {
+    m_commandTable["setcontourcolor"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         QString contourName = args["contourName"].toString();
         QJsonArray levelsArray = args["levels"].toArray();
@@ -588,46 +603,46 @@ ScriptedCommandInterpreter::tagMessageReceivedCB( TagMessage tm )
         for ( auto level : levelsArray ) {
             levels.push_back( level.toDouble() );
         }
-        result = m_scriptFacade->setContourColor( imageView, contourName, levels, red, green, blue );
-    }
+        return m_scriptFacade->setContourColor( imageView, contourName, levels, red, green, blue );
+    };
 
-    else if ( cmd == "setcontourdashednegative" ) {
+    m_commandTable["setcontourdashednegative"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         bool useDash = args["useDash"].toBool();
-        result = m_scriptFacade->setContourDashedNegative( imageView, useDash );
-    }
+        return m_scriptFacade->setContourDashedNegative( imageView, useDash );
+    };
 
-    else if ( cmd == "setcontourgeneratemethod" ) {
+    m_commandTable["setcontourgeneratemethod"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         QString method = args["method"].toString();
-        result = m_scriptFacade->setContourGenerateMethod( imageView, method );
-    }
+        return m_scriptFacade->setContourGenerateMethod( imageView, method );
+    };
 
-    else if ( cmd == "setcontourspacing" ) {
+    m_commandTable["setcontourspacing"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         QString method = args["method"].toString();
-        result = m_scriptFacade->setContourSpacing( imageView, method );
-    }
+        return m_scriptFacade->setContourSpacing( imageView, method );
+    };
 
-    else if ( cmd == "setcontourlevelcount" ) {
+    m_commandTable["setcontourlevelcount"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         int count = args["count"].toInt();
-        result = m_scriptFacade->setContourLevelCount( imageView, count );
-    }
+        return m_scriptFacade->setContourLevelCount( imageView, count );
+    };
 
-    else if ( cmd == "setcontourlevelmax" ) {
+    m_commandTable["setcontourlevelmax"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         double value = args["value"].toDouble();
-        result = m_scriptFacade->setContourLevelMax( imageView, value );
-    }
+        return m_scriptFacade->setContourLevelMax( imageView, value );
+    };
 
-    else if ( cmd == "setcontourlevelmin" ) {
+    m_commandTable["setcontourlevelmin"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         double value = args["value"].toDouble();
-        result = m_scriptFacade->setContourLevelMin( imageView, value );
-    }
+        return m_scriptFacade->setContourLevelMin( imageView, value );
+    };
 
-    else if ( cmd == "setcontourlevels" ) {
+    m_commandTable["setcontourlevels"] = [this]( const QJsonObject & args ) -> QStringList {
         QString imageView = args["imageView"].toString();
         QString contourName = args["contourName"].toString();
         QJsonArray levelsArray = args["levels"].toArray();
@@ -635,8 +650,8 @@ ScriptedCommandInterpreter::tagMessageReceivedCB( TagMessage tm )
         for ( auto level : levelsArray ) {
             levels.push_back( level.toDouble() );
         }
-        result = m_scriptFacade->setContourLevels( imageView, contourName, levels );
-    }
+        return m_scriptFacade->setContourLevels( imageView, contourName, levels );
+    };
 
     /// Section: Animator Commands
     /// --------------------------
@@ -644,32 +659,32 @@ ScriptedCommandInterpreter::tagMessageReceivedCB( TagMessage tm )
     /// the animators to be manipulated and can also return information
     /// about the animators.
 
-    else if ( cmd == "setchannel" ) {
+    m_commandTable["setchannel"] = [this]( const QJsonObject & args ) -> QStringList {
         QString animatorView = args["animatorView"].toString();
         int channel = args["channel"].toInt();
-        result = m_scriptFacade->setChannel( animatorView, channel );
-    }
+        return m_scriptFacade->setChannel( animatorView, channel );
+    };
 
-    else if ( cmd == "setimage" ) {
+    m_commandTable["setimage"] = [this]( const QJsonObject & args ) -> QStringList {
         QString animatorView = args["animatorView"].toString();
         int image = args["image"].toInt();
-        result = m_scriptFacade->setImage( animatorView, image );
-    }
+        return m_scriptFacade->setImage( animatorView, image );
+    };
 
-    else if ( cmd == "showimageanimator" ) {
+    m_commandTable["showimageanimator"] = [this]( const QJsonObject & args ) -> QStringList {
         QString animatorView = args["animatorView"].toString();
-        result = m_scriptFacade->showImageAnimator( animatorView );
-    }
+        return m_scriptFacade->showImageAnimator( animatorView );
+    };
 
-    else if ( cmd == "getmaximagecount" ) {
+    m_commandTable["getmaximagecount"] = [this]( const QJsonObject & args ) -> QStringList {
         QString animatorView = args["animatorView"].toString();
-        result = m_scriptFacade->getMaxImageCount( animatorView );
-    }
+        return m_scriptFacade->getMaxImageCount( animatorView );
+    };
 
-    else if ( cmd == "getchannelindex" ) {
+    m_commandTable["getchannelindex"] = [this]( const QJsonObject & args ) -> QStringList {
         QString animatorView = args["animatorView"].toString();
-        result = m_scriptFacade->getChannelIndex( animatorView );
-    }
+        return m_scriptFacade->getChannelIndex( animatorView );
+    };
 
     /// Section: Histogram Commands
     /// --------------------------
@@ -677,114 +692,195 @@ ScriptedCommandInterpreter::tagMessageReceivedCB( TagMessage tm )
     /// the histograms to be manipulated and can also return information
     /// about the histograms.
 
-    else if ( cmd == "setclipbuffer" ) {
+    m_commandTable["setclipbuffer"] = [this]( const QJsonObject & args ) -> QStringList {
         QString histogramView = args["histogramView"].toString();
         int bufferAmount = args["bufferAmount"].toInt();
-        result = m_scriptFacade->setClipBuffer( histogramView, bufferAmount );
-    }
+        return m_scriptFacade->setClipBuffer( histogramView, bufferAmount );
+    };
 
-    else if ( cmd == "setuseclipbuffer" ) {
+    m_commandTable["setuseclipbuffer"] = [this]( const QJsonObject & args ) -> QStringList {
         QString histogramView = args["histogramView"].toString();
         QString useBuffer = args["useBuffer"].toString().toLower();
-        result = m_scriptFacade->setUseClipBuffer( histogramView, useBuffer );
-    }
+        return m_scriptFacade->setUseClipBuffer( histogramView, useBuffer );
+    };
 
-    else if ( cmd == "setcliprange" ) {
+    m_commandTable["setcliprange"] = [this]( const QJsonObject & args ) -> QStringList {
         QString histogramView = args["histogramView"].toString();
         double minRange = args["minRange"].toDouble();
         double maxRange = args["maxRange"].toDouble();
-        result = m_scriptFacade->setClipRange( histogramView, minRange, maxRange );
-    }
+        return m_scriptFacade->setClipRange( histogramView, minRange, maxRange );
+    };
 
-    else if ( cmd == "setcliprangepercent" ) {
+    m_commandTable["setcliprangepercent"] = [this]( const QJsonObject & args ) -> QStringList {
         QString histogramView = args["histogramView"].toString();
         double minPercent = args["minPercent"].toDouble();
         double maxPercent = args["maxPercent"].toDouble();
-        result = m_scriptFacade->setClipRangePercent( histogramView, minPercent, maxPercent );
-    }
+        return m_scriptFacade->setClipRangePercent( histogramView, minPercent, maxPercent );
+    };
 
-    else if ( cmd == "getcliprange" ) {
+    m_commandTable["getcliprange"] = [this]( const QJsonObject & args ) -> QStringList {
         QString histogramView = args["histogramView"].toString();
-        result = m_scriptFacade->getClipRange( histogramView );
-    }
+        return m_scriptFacade->getClipRange( histogramView );
+    };
 
-    else if ( cmd == "applyclips" ) {
+    m_commandTable["applyclips"] = [this]( const QJsonObject & args ) -> QStringList {
         QString histogramView = args["histogramView"].toString();
-        result = m_scriptFacade->applyClips( histogramView );
-    }
+        return m_scriptFacade->applyClips( histogramView );
+    };
 
-    else if ( cmd == "setbincount" ) {
+    m_commandTable["setbincount"] = [this]( const QJsonObject & args ) -> QStringList {
         QString histogramView = args["histogramView"].toString();
         int binCount = args["binCount"].toInt();
-        result = m_scriptFacade->setBinCount( histogramView, binCount );
-    }
+        return m_scriptFacade->setBinCount( histogramView, binCount );
+    };
 
-    else if ( cmd == "setbinwidth" ) {
+    m_commandTable["setbinwidth"] = [this]( const QJsonObject & args ) -> QStringList {
         QString histogramView = args["histogramView"].toString();
         double binWidth = args["binWidth"].toDouble();
-        result = m_scriptFacade->setBinWidth( histogramView, binWidth );
-    }
+        return m_scriptFacade->setBinWidth( histogramView, binWidth );
+    };
 
-    else if ( cmd == "setplanemode" ) {
+    m_commandTable["setplanemode"] = [this]( const QJsonObject & args ) -> QStringList {
         QString histogramView = args["histogramView"].toString();
         QString planeMode = args["planeMode"].toString();
-        result = m_scriptFacade->setPlaneMode( histogramView, planeMode );
-    }
+        return m_scriptFacade->setPlaneMode( histogramView, planeMode );
+    };
 
-    else if ( cmd == "setplanerange" ) {
+    m_commandTable["setplanerange"] = [this]( const QJsonObject & args ) -> QStringList {
         QString histogramView = args["histogramView"].toString();
         double minPlane = args["minPlane"].toDouble();
         double maxPlane = args["maxPlane"].toDouble();
-        result = m_scriptFacade->setPlaneRange( histogramView, minPlane, maxPlane );
-    }
+        return m_scriptFacade->setPlaneRange( histogramView, minPlane, maxPlane );
+    };
 
-    else if ( cmd == "setchannelunit" ) {
+    m_commandTable["setchannelunit"] = [this]( const QJsonObject & args ) -> QStringList {
         QString histogramView = args["histogramView"].toString();
         QString unit = args["unit"].toString();
-        result = m_scriptFacade->setChannelUnit( histogramView, unit );
-    }
+        return m_scriptFacade->setChannelUnit( histogramView, unit );
+    };
 
-    else if ( cmd == "setgraphstyle" ) {
+    m_commandTable["setgraphstyle"] = [this]( const QJsonObject & args ) -> QStringList {
         QString histogramView = args["histogramView"].toString();
         QString graphStyle = args["graphStyle"].toString();
-        result = m_scriptFacade->setGraphStyle( histogramView, graphStyle );
-    }
+        return m_scriptFacade->setGraphStyle( histogramView, graphStyle );
+    };
 
-    else if ( cmd == "setlogcount" ) {
+    m_commandTable["setlogcount"] = [this]( const QJsonObject & args ) -> QStringList {
         QString histogramView = args["histogramView"].toString();
         QString logCount = args["logCount"].toString().toLower();
-        result = m_scriptFacade->setLogCount( histogramView, logCount );
-    }
+        return m_scriptFacade->setLogCount( histogramView, logCount );
+    };
 
-    else if ( cmd == "setcolored" ) {
+    m_commandTable["setcolored"] = [this]( const QJsonObject & args ) -> QStringList {
         QString histogramView = args["histogramView"].toString();
         QString colored = args["colored"].toString().toLower();
-        result = m_scriptFacade->setColored( histogramView, colored );
-    }
+        return m_scriptFacade->setColored( histogramView, colored );
+    };
 
-    else if ( cmd == "savehistogram" ) {
+    m_commandTable["savehistogram"] = [this]( const QJsonObject & args ) -> QStringList {
         QString histogramView = args["histogramView"].toString();
         QString filename = args["filename"].toString();
         int width = args["width"].toInt();
         int height = args["height"].toInt();
         QString aspectStr = args["aspectRatioMode"].toString().toLower();
-        result = m_scriptFacade->saveHistogram( histogramView, filename, width, height, aspectStr );
-    }
+        return m_scriptFacade->saveHistogram( histogramView, filename, width, height, aspectStr );
+    };
 
-    else {
-        qDebug() << "Unknown command " + cmd+", sending error back";
-        key = "error";
-        result.append("Unknown command");
+} // _initCommandTable
+
+QJsonObject
+ScriptedCommandInterpreter::_executeCommand( const QString & cmd, const QJsonObject & args )
+{
+    auto it = m_commandTable.constFind( cmd );
+    if ( it == m_commandTable.constEnd() ) {
+        qDebug() << "Unknown command " + cmd + ", sending error back";
+        QJsonObject rjo;
+        rjo.insert( "error", QJsonValue::fromVariant( QStringList( "Unknown command" ) ) );
+        return rjo;
+    }
+    QStringList result = it.value()( args );
+    if ( result.isEmpty() ) {
+        result.append( "" );
+    }
+    return _makeReply( result );
+}
+
+QJsonArray
+ScriptedCommandInterpreter::_executeBatch( const QJsonArray & commands )
+{
+    // All commands of a batch are executed inside this single event loop
+    // iteration, so the view refresh timers and the queued state callbacks
+    // coalesce and the views are only re-rendered once for the whole batch.
+    QJsonArray results;
+    for ( const QJsonValue & entry : commands ) {
+        QJsonObject entryObject = entry.toObject();
+        QString cmd = entryObject["cmd"].toString().toLower();
+        if ( cmd == BATCH ) {
+            results.append( _makeReply( QStringList( "error" ) << "Batches cannot be nested" ) );
+        }
+        else {
+            results.append( _executeCommand( cmd, entryObject["args"].toObject() ) );
+        }
     }
+    return results;
+}
 
+QJsonObject
+ScriptedCommandInterpreter::_makeReply( const QStringList & result )
+{
+    // By default, assume that we will be sending a proper result back.
+    // If an error occurred, key will be set to "error".
+    QString key = "result";
     if ( result[0] == "error" ) {
         key = "error";
     }
-
     QJsonObject rjo;
     rjo.insert( key, QJsonValue::fromVariant( result ) );
+    return rjo;
+}
+
+void
+ScriptedCommandInterpreter::_sendReply( QJsonObject rjo, const QJsonValue & requestId )
+{
+    // echo the request id back, so that pipelining clients can match
+    // replies to their requests
+    if ( ! requestId.isUndefined() && ! requestId.isNull() ) {
+        rjo.insert( REQUEST_ID, requestId );
+    }
     JsonMessage rjm = JsonMessage( QJsonDocument( rjo ) );
     m_messageListener->send( rjm.toTagMessage() );
+}
+
+void
+ScriptedCommandInterpreter::tagMessageReceivedCB( TagMessage tm )
+{
+    m_scriptFacade = ScriptFacade::getInstance();
+    if ( tm.tag() != "json" ) {
+        qWarning() << "I don't handle tag" << tm.tag();
+        return;
+    }
+    JsonMessage jm = JsonMessage::fromTagMessage( tm );
+    if ( ! jm.doc().isObject() ) {
+        qWarning() << "Received json is not object...";
+        return;
+    }
+    QJsonObject jo = jm.doc().object();
+    // Get the command name and the arguments.
+    // Arguments will be parsed according to the command name.
+    QString cmd = jo["cmd"].toString().toLower();
+    auto args = jo["args"].toObject();
+    QJsonValue requestId = jo[REQUEST_ID];
+
+    if ( cmd == BATCH ) {
+        // a batch carries an array of {cmd, args} objects and is answered
+        // with a single reply holding one {result|error} object per command
+        QJsonObject rjo;
+        rjo.insert( "result", _executeBatch( args["commands"].toArray() ) );
+        _sendReply( rjo, requestId );
+        return;
+    }
+
+    _sendReply( _executeCommand( cmd, args ), requestId );
 } // tagMessageReceivedCB
 
 void
@@ -807,6 +903,7 @@ ScriptedCommandInterpreter::asyncMessageReceivedCB( TagMessage tm )
     QJsonObject jo = jm.doc().object();
     QString cmd = jo["cmd"].toString().toLower();
     auto args = jo["args"].toObject();
+    m_asyncRequestId = jo[REQUEST_ID];
     if ( cmd == "saveimage" ) {
         QString imageView = args["imageView"].toString();
         QString filename = args["filename"].toString();
@@ -830,8 +927,7 @@ void ScriptedCommandInterpreter::saveImageResultCB( bool saveResult ){
         result[0] = "Could not save image.";
     }
     rjo.insert( key, QJsonValue::fromVariant( result ) );
-    JsonMessage rjm = JsonMessage( QJsonDocument( rjo ) );
-    m_messageListener->send( rjm.toTagMessage() );
+    _sendReply( rjo, m_asyncRequestId );
 }
 
 }
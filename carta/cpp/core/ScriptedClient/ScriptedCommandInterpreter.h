@@ -14,6 +14,8 @@
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QDir>
+#include <QHash>
+#include <functional>
 #include <memory>
 
 namespace Carta
@@ -29,6 +31,17 @@ class ScriptedCommandInterpreter : public QObject
 
 public:
 
+    /// name of the command that carries an array of commands to execute in order
+    static const QString BATCH;
+
+    /// optional key of a request; it is echoed back in the reply so that
+    /// clients can pipeline several commands before reading the results
+    static const QString REQUEST_ID;
+
+    /// handler for a single command, receives the "args" object of the request
+    /// and returns the result list ("error" as the first entry signals a failure)
+    typedef std::function < QStringList ( const QJsonObject & args ) > CommandHandler;
+
     ScriptedCommandInterpreter( int port, QObject * parent = nullptr );
 
 protected:
@@ -51,7 +64,33 @@ private slots:
 
 private:
 
+    /// fill in the command dispatch table
+    void
+    _initCommandTable();
+
+    /// look up and run a single command, return its {result|error} reply
+    QJsonObject
+    _executeCommand( const QString & cmd, const QJsonObject & args );
+
+    /// run all commands of a batch in order, one result object per command
+    QJsonArray
+    _executeBatch( const QJsonArray & commands );
+
+    /// wrap a result list into a {result|error} json object
+    QJsonObject
+    _makeReply( const QStringList & result );
+
+    /// send the reply back, tagged with the request id if there was one
+    void
+    _sendReply( QJsonObject rjo, const QJsonValue & requestId );
+
     std::unique_ptr < MessageListener > m_messageListener = nullptr;
+
+    /// command name -> handler
+    QHash < QString, CommandHandler > m_commandTable;
+
+    /// request id of the pending asynchronous command
+    QJsonValue m_asyncRequestId;
 };
 }
 }
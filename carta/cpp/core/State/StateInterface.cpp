@@ -9,6 +9,7 @@
 
 #include "IConnector.h"
 #include "Globals.h"
+#include "CartaLib/Trace.h"
 
 #include <rapidjson/document.h>
 #include <rapidjson/stringbuffer.h>
@@ -170,6 +171,7 @@ StateInterface::fetchStateImpl ()
 void
 StateInterface::flushState ()
 {
+    CARTA_TRACE_SCOPE( "state", "flushState" );
     // Convert document to string
 
     QString json = toString();
@@ -7,6 +7,7 @@
 #include "IPlatform.h"
 #include "State/ObjectManager.h"
 #include "Data/ViewManager.h"
+#include "Data/Colormap/Colormaps.h"
 #include "Data/Image/Controller.h"
 #include "PluginManager.h"
 #include "MainConfig.h"
@@ -23,6 +24,7 @@
 #include <QCoreApplication>
 #include <QJsonObject>
 #include <QDir>
+#include <QtConcurrent/QtConcurrentRun>
 #include <QJsonArray>
 
 #include <cmath>
@@ -129,5 +131,14 @@ void Viewer::setDeveloperView( ){
     m_devView = true;
 }
 
+void Viewer::prewarm(){
+    // the colormaps come from a plugin, which may have to be loaded first; doing
+    // that while the platform and the connector start up keeps it off the path
+    // of the first session, which waits for the list if it is not ready yet
+    QtConcurrent::run( Globals::instance()-> renderPool(), [] () {
+        Carta::Data::Colormaps::prewarm();
+    } );
+}
+
 
 
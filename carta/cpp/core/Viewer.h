@@ -37,6 +37,11 @@ public:
     /// Show areas under active development.
     void setDeveloperView( );
 
+    /// start building, in the background, the data that every session shares
+    /// and that does not change while the process runs (e.g. the colormap list)
+    /// should be called once the plugin manager is set up
+    static void prewarm();
+
 signals:
 
 public slots:
@@ -6,7 +6,7 @@ TEMPLATE = lib
 
 ###CONFIG += staticlib
 QT += widgets network
-QT += xml
+QT += xml concurrent
 
 HEADERS += \
     IConnector.h \
@@ -17,6 +17,8 @@ HEADERS += \
     CallbackList.h \
     PluginManager.h \
     Globals.h \
+    FrameCache.h \
+    MemoryGovernor.h \
     Algorithms/Graphs/TopoSort.h \
     stable.h \
     CmdLine.h \
@@ -35,6 +37,7 @@ HEADERS += \
     Data/Colormap/TransformsData.h \
     Data/Colormap/TransformsImage.h \
     Data/DataLoader.h \
+    Data/DirectoryIndex.h \
     Data/Error/ErrorReport.h \
     Data/Error/ErrorManager.h \
     Data/Histogram/Histogram.h \
@@ -69,6 +72,7 @@ HEADERS += \
     Data/Image/Grid/GridControls.h \
     Data/Image/Grid/Themes.h \
     Data/Image/Grid/LabelFormats.h \
+    Data/Image/ImageRegistry.h \
     Data/Image/IPercentIntensityMap.h \
     Data/Image/LayerCompositionModes.h \
     Data/Image/RenderRequest.h \
@@ -102,6 +106,7 @@ HEADERS += \
     Data/Snapshot/Snapshots.h \
     Data/Snapshot/Snapshot.h \
     Data/Snapshot/SnapshotsFile.h \
+    Data/Statistics/RegionStatsCalculator.h \
     Data/Statistics/Statistics.h \
     Data/Units/UnitsFrequency.h \
     Data/Units/UnitsIntensity.h \
@@ -150,6 +155,8 @@ SOURCES += \
     CallbackList.cpp \
     PluginManager.cpp \
     Globals.cpp \
+    FrameCache.cpp \
+    MemoryGovernor.cpp \
     Algorithms/Graphs/TopoSort.cpp \
     CmdLine.cpp \
     MainConfig.cpp \
@@ -191,6 +198,7 @@ SOURCES += \
     Data/Image/Draw/DrawGroupSynchronizer.cpp \
     Data/Image/Draw/DrawSynchronizer.cpp \
     Data/Image/Draw/DrawStackSynchronizer.cpp \
+    Data/Image/ImageRegistry.cpp \
     Data/Image/LayerCompositionModes.cpp \
     Data/Image/RenderRequest.cpp \
     Data/Image/RenderResponse.cpp \
@@ -198,6 +206,7 @@ SOURCES += \
     Data/Image/Save/SaveView.cpp \
     Data/Image/Save/SaveViewLayered.cpp \
     Data/DataLoader.cpp \
+    Data/DirectoryIndex.cpp \
     Data/Error/ErrorReport.cpp \
     Data/Error/ErrorManager.cpp \
     Data/Histogram/Histogram.cpp \
@@ -231,6 +240,7 @@ SOURCES += \
     Data/Snapshot/Snapshots.cpp \
     Data/Snapshot/Snapshot.cpp \
     Data/Snapshot/SnapshotsFile.cpp \
+    Data/Statistics/RegionStatsCalculator.cpp \
     Data/Statistics/Statistics.cpp \
     Data/Units/UnitsFrequency.cpp \
     Data/Units/UnitsIntensity.cpp \
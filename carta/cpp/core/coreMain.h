@@ -10,6 +10,7 @@
 #include "core/CmdLine.h"
 #include "core/MainConfig.h"
 #include "core/Globals.h"
+#include "CartaLib/Trace.h"
 #include <QDebug>
 
 namespace Carta
@@ -59,6 +60,7 @@ coreMainCPP( QString platformString, int argc, char * * argv )
     MainConfig::ParsedInfo mainConfig = MainConfig::parse( configFilePath );
     globals.setMainConfig( & mainConfig );
     qDebug() << "plugin directories:\n - " + mainConfig.pluginDirectories().join( "\n - " );
+    Carta::Lib::Trace::setEnabled( mainConfig.isTracing() );
 
     // initialize plugin manager
     // =========================
@@ -75,6 +77,9 @@ coreMainCPP( QString platformString, int argc, char * * argv )
         qDebug() << "  path:" << entry.json.name;
     }
 
+    // build what all sessions share while the platform and the connector start up
+    Viewer::prewarm();
+
     // initialize platform
     // ===================
     // platform get access to
@@ -4,6 +4,7 @@
 
 #include "DesktopConnector.h"
 #include "CartaLib/LinearMap.h"
+#include "CartaLib/Trace.h"
 #include "core/MyQApp.h"
 #include "core/SimpleRemoteVGView.h"
 #include <iostream>
@@ -254,6 +255,7 @@ DesktopConnector::ViewInfo * DesktopConnector::findViewInfo( const QString & vie
 
 void DesktopConnector::refreshViewNow(IView *view)
 {
+    CARTA_TRACE_SCOPE( "connector", "refreshViewNow" );
     ViewInfo * viewInfo = findViewInfo( view-> name());
     if( ! viewInfo) {
         // this is an internal error...
@@ -162,6 +162,19 @@ CCCoordinateFormatter::formatFromPixelCoordinate( const CoordinateFormatterInter
     return list;
 } // formatFromPixelCoordinate
 
+QStringList
+CCCoordinateFormatter::formatFromWorldCoordinate( const CoordinateFormatterInterface::VD & world )
+{
+    QStringList list;
+    if ( int ( world.size() ) < nAxes() ) {
+        return list;
+    }
+    for ( int i = 0 ; i < nAxes() ; i++ ) {
+        list.append( formatWorldValue( i, world[i] ) );
+    }
+    return list;
+}
+
 QString
 CCCoordinateFormatter::calculateFormatDistance( const CoordinateFormatterInterface::VD & p1,
                                                 const CoordinateFormatterInterface::VD & p2 )
@@ -191,10 +204,11 @@ bool
 CCCoordinateFormatter::toWorld( const CoordinateFormatterInterface::VD & pixel,
                                 CoordinateFormatterInterface::VD & world ) const
 {
-    Q_UNUSED( pixel );
-    Q_UNUSED( world );
-
-    qFatal( "not implemented" );
+    casa::Vector < casa::Double > pixelD = pixel;
+    casa::Vector < casa::Double > worldD;
+    bool valid = m_casaCS->toWorld( worldD, pixelD );
+    world = worldD.tovector();
+    return valid;
 }
 
 bool
@@ -208,6 +222,67 @@ CCCoordinateFormatter::toPixel( const CoordinateFormatterInterface::VD & world,
     return valid;
 }
 
+/// convert points stored one after another with casacore's *Many() methods, the
+/// input and output are wrapped in matrices (one column per point) without copying
+template < typename Convert >
+static int
+convertMany( int nIn, int nOut, const CoordinateFormatterInterface::VD & input,
+             CoordinateFormatterInterface::VD & output, std::vector < bool > * valid,
+             Convert convert )
+{
+    int count = nIn > 0 ? input.size() / nIn : 0;
+    output.resize( size_t( count ) * nOut );
+    if ( valid ) {
+        valid-> assign( count, false );
+    }
+    if ( count == 0 ) {
+        return 0;
+    }
+    const casa::Matrix < casa::Double > in(
+        casa::IPosition( 2, nIn, count ), const_cast < double * > ( input.data() ), casa::SHARE );
+    casa::Matrix < casa::Double > out(
+        casa::IPosition( 2, nOut, count ), output.data(), casa::SHARE );
+    casa::Vector < casa::Bool > failures;
+    convert( out, in, failures );
+    int good = 0;
+    for ( int i = 0 ; i < count ; i++ ) {
+        bool ok = failures.nelements() == 0 || ! failures[i];
+        if ( valid ) {
+            ( * valid )[i] = ok;
+        }
+        good += ok;
+    }
+    return good;
+}
+
+int
+CCCoordinateFormatter::toWorldBatch( const CoordinateFormatterInterface::VD & pixels,
+                                     CoordinateFormatterInterface::VD & worlds,
+                                     std::vector < bool > * valid ) const
+{
+    auto cs = m_casaCS;
+    return convertMany( cs->nPixelAxes(), cs->nWorldAxes(), pixels, worlds, valid,
+                        [cs] ( casa::Matrix < casa::Double > & out,
+                               const casa::Matrix < casa::Double > & in,
+                               casa::Vector < casa::Bool > & failures ) {
+                            cs->toWorldMany( out, in, failures );
+                        } );
+}
+
+int
+CCCoordinateFormatter::toPixelBatch( const CoordinateFormatterInterface::VD & worlds,
+                                     CoordinateFormatterInterface::VD & pixels,
+                                     std::vector < bool > * valid ) const
+{
+    auto cs = m_casaCS;
+    return convertMany( cs->nWorldAxes(), cs->nPixelAxes(), worlds, pixels, valid,
+                        [cs] ( casa::Matrix < casa::Double > & out,
+                               const casa::Matrix < casa::Double > & in,
+                               casa::Vector < casa::Bool > & failures ) {
+                            cs->toPixelMany( out, in, failures );
+                        } );
+}
+
 void
 CCCoordinateFormatter::setTextOutputFormat( CoordinateFormatterInterface::TextFormat fmt )
 {
@@ -29,6 +29,9 @@ public:
     virtual QStringList
     formatFromPixelCoordinate( const VD & pix ) override;
 
+    virtual QStringList
+    formatFromWorldCoordinate( const VD & world ) override;
+
     virtual QString
     calculateFormatDistance( const VD & p1, const VD & p2 ) override;
 
@@ -44,6 +47,14 @@ public:
     virtual bool
     toPixel( const VD & world, VD & pixel ) const override;
 
+    virtual int
+    toWorldBatch( const VD & pixels, VD & worlds,
+                  std::vector < bool > * valid = nullptr ) const override;
+
+    virtual int
+    toPixelBatch( const VD & worlds, VD & pixels,
+                  std::vector < bool > * valid = nullptr ) const override;
+
     virtual void
     setTextOutputFormat( TextFormat fmt ) override;
 
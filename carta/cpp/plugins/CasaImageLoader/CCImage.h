@@ -12,8 +12,11 @@
 #include "casacore/images/Images/ImageInterface.h"
 #include "casacore/images/Images/ImageUtilities.h"
 #include "casacore/images/Images/TempImage.h"
+#include "casacore/casa/Arrays/Slicer.h"
 
 #include <QDebug>
+#include <QFileInfo>
+#include <QDateTime>
 #include <memory>
 #include <set>
 
@@ -42,6 +45,28 @@ public:
 
     virtual casa::ImageInfo getImageInfo() const = 0;
 
+    /**
+     * Returns an identity for caching results derived from a casa image: its file and
+     * the file's modification time, as in the image registry.  Unlike the address of
+     * the image it cannot be reused by a different image.
+     * @param casaImage - the image.
+     * @return - the identity, or an empty string if the image is not backed by a file,
+     *      e.g. a temporary permuted image.
+     */
+    static QString
+    getIdentity( const casa::ImageInterface < casa::Float > * casaImage )
+    {
+        QString identity;
+        if ( casaImage ) {
+            QFileInfo fileInfo( casaImage-> name().c_str() );
+            if ( fileInfo.exists() ) {
+                identity = fileInfo.canonicalFilePath() + ":" +
+                           QString::number( fileInfo.lastModified().toMSecsSinceEpoch() );
+            }
+        }
+        return identity;
+    }
+
 //    virtual casa::ImageInterface<casa::Float> * getCasaIIfloat() = 0;
 
 
@@ -124,7 +149,7 @@ public:
     virtual bool
     hasMask() const override
     {
-        return false;
+        return m_hasMask;
     }
 
     virtual bool
@@ -161,6 +186,12 @@ public:
         qFatal( "not implemented" );
     }
 
+    virtual Carta::Lib::BitMask
+    getMaskBits( const SliceND & sliceInfo ) override
+    {
+        return _getMaskBits( sliceInfo.apply( m_dims ) );
+    }
+
     /// \todo implement this
     virtual Carta::Lib::NdArray::RawViewInterface *
     getErrorSlice( const SliceND & sliceInfo) override
@@ -184,22 +215,7 @@ public:
         // create an image interface instance and populate it with various
         // values from casa::ImageInterface
         CCImage::SharedPtr img = std::make_shared < CCImage < PType > > ();
-        img-> m_pixelType = Carta::Lib::Image::CType2PixelType < PType >::type;
-        img-> m_dims      = casaImage-> shape().asStdVector();
-        img-> m_casaII    = casaImage;
-        img-> m_unit      = Carta::Lib::Unit( casaImage-> units().getName().c_str() );
-
-        // get title and escape html characters in case there are any
-        QString htmlTitle = casaImage->imageInfo().objectName().c_str();
-        htmlTitle = htmlTitle.toHtmlEscaped();
-
-        // make our own copy of the coordinate system using 'clone'
-        std::shared_ptr<casa::CoordinateSystem> casaCS(
-                    static_cast<casa::CoordinateSystem *> (casaImage->coordinates().clone()));
-
-        // construct a meta data instance
-        img-> m_meta = std::make_shared < CCMetaDataInterface > ( htmlTitle, casaCS );
-
+        img-> _init( casaImage );
         return img;
     } // create
 
@@ -222,6 +238,67 @@ public:
     CCImage() { }
 
 protected:
+
+    /// populate the cached values from casa::ImageInterface, shared with subclasses
+    /// that provide their own data access
+    void
+    _init( casa::ImageInterface < PType > * casaImage )
+    {
+        m_pixelType = Carta::Lib::Image::CType2PixelType < PType >::type;
+        m_dims      = casaImage-> shape().asStdVector();
+        m_casaII    = casaImage;
+        m_unit      = Carta::Lib::Unit( casaImage-> units().getName().c_str() );
+
+        // the mask of a FITSImage only marks the NaN and blank pixels, which the
+        // data already reports as NaN, so reading it would read the pixels twice
+        m_hasMask = casaImage-> hasPixelMask() && casaImage-> imageType() != "FITSImage";
+
+        // get title and escape html characters in case there are any
+        QString htmlTitle = casaImage->imageInfo().objectName().c_str();
+        htmlTitle = htmlTitle.toHtmlEscaped();
+
+        // make our own copy of the coordinate system using 'clone'
+        std::shared_ptr<casa::CoordinateSystem> casaCS(
+                    static_cast<casa::CoordinateSystem *> (casaImage->coordinates().clone()));
+
+        // construct a meta data instance
+        m_meta = std::make_shared < CCMetaDataInterface > ( htmlTitle, casaCS );
+    } // _init
+
+    /// pack the pixel mask of an applied slice into bits, in the order in which
+    /// CCRawView visits the pixels
+    /// \return an empty mask if the image has no mask or nothing in the slice is masked
+    /// \warning negative steps are not handled, like in CCRawView
+    Carta::Lib::BitMask
+    _getMaskBits( const SliceND::ApplyResult & appliedSlice )
+    {
+        if ( ! m_hasMask || appliedSlice.isError() ) {
+            return Carta::Lib::BitMask();
+        }
+        int imgDims = m_dims.size();
+        casa::IPosition blc( imgDims, 0 );
+        auto trc = blc;
+        auto inc = blc;
+        for ( int i = 0 ; i < imgDims ; i++ ) {
+            const auto & slice1d = appliedSlice.dims()[i];
+            blc( i ) = slice1d.start;
+            trc( i ) = slice1d.end();
+            inc( i ) = slice1d.isSingle() ? 1 : slice1d.step;
+        }
+        casa::Slicer slicer( blc, trc, inc, casa::Slicer::endIsLast );
+        casa::Array < casa::Bool > mask = m_casaII-> getMaskSlice( slicer );
+
+        // the booleans only live until they are packed
+        casa::Bool deleteIt = false;
+        const casa::Bool * maskData = mask.getStorage( deleteIt );
+        Carta::Lib::BitMask bits = Carta::Lib::BitMask::fromBools( maskData, mask.nelements() );
+        mask.freeStorage( maskData, deleteIt );
+        if ( bits.isAllValid() ) {
+            return Carta::Lib::BitMask();
+        }
+        return bits;
+    } // _getMaskBits
+
     /// type of the image data
     Carta::Lib::Image::PixelType m_pixelType;
 
@@ -234,6 +311,9 @@ protected:
     /// cached unit
     Carta::Lib::Unit m_unit;
 
+    /// whether pixels of the image can be masked
+    bool m_hasMask = false;
+
     /// meta data pointer
     CCMetaDataInterface::SharedPtr m_meta;
 
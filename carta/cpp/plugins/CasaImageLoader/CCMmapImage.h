@@ -0,0 +1,51 @@
+/**
+ *
+ **/
+
+#pragma once
+
+#include "CCImage.h"
+#include "FitsMmapData.h"
+#include "FitsMmapRawView.h"
+
+/// CCImage for plain FITS files where pixel data is read straight from the memory
+/// mapped file instead of going through casacore.
+///
+/// Coordinates, meta data and the underlying casa image are still provided by
+/// casa::FITSImage (which only reads the header until pixels are requested), so
+/// plugins that down-cast to CCImageBase keep working unchanged.
+class CCMmapImage
+    : public CCImage < float >
+{
+    CLASS_BOILERPLATE( CCMmapImage );
+
+public:
+
+    virtual Carta::Lib::NdArray::RawViewInterface *
+    getDataSlice( const SliceND & sliceInfo ) override
+    {
+        return new FitsMmapRawView( m_mmapData, sliceInfo );
+    }
+
+    /// call this to create an instance of this class, do not use constructor
+    /// \return nullptr if the mapped data does not match the casa image
+    static CCMmapImage::SharedPtr
+    create( casa::ImageInterface < float > * casaImage, FitsMmapData::SharedPtr mmapData )
+    {
+        CCMmapImage::SharedPtr img = std::make_shared < CCMmapImage > ();
+        img-> _init( casaImage );
+        if ( img-> m_dims != mmapData-> dims() ) {
+            return nullptr;
+        }
+        img-> m_mmapData = mmapData;
+        return img;
+    }
+
+    /// do not use this!
+    CCMmapImage() { }
+
+protected:
+
+    /// the mapped pixel data, shared with all views
+    FitsMmapData::SharedPtr m_mmapData;
+};
@@ -8,6 +8,7 @@
 #include <casacore/lattices/Lattices/LatticeStepper.h>
 #include <casacore/lattices/Lattices/LatticeIterator.h>
 #include <casacore/casa/Arrays/IPosition.h>
+#include <limits>
 
 template < typename PType >
 class CCImage;
@@ -201,6 +202,11 @@ CCRawView < PType >::get( const Carta::Lib::NdArray::RawViewInterface::VI & pos
     m_buff = m_ccimage-> m_casaII->
                  operator() ( m_destPos );
 
+    if ( m_ccimage-> m_hasMask && std::numeric_limits < PType >::has_quiet_NaN
+         && ! m_ccimage-> m_casaII-> pixelMask().getAt( m_destPos ) ) {
+        m_buff = std::numeric_limits < PType >::quiet_NaN();
+    }
+
     return reinterpret_cast < const char * > ( & m_buff );
 } // get
 
@@ -238,6 +244,12 @@ CCRawView < PType >::forEach(
     stepper.subSection( blc, trc, inc );
     casa::RO_LatticeIterator < PType > iterator( * casaII, stepper );
 
+    // types without NaN have no way of reporting masked pixels
+    Carta::Lib::BitMask mask;
+    if ( std::numeric_limits < PType >::has_quiet_NaN ) {
+        mask = m_ccimage-> _getMaskBits( m_appliedSlice );
+    }
+
     bool first = true;
     for ( iterator.reset() ; ! iterator.atEnd() ; iterator++ ) {
         if ( ! first ) {
@@ -246,8 +258,21 @@ CCRawView < PType >::forEach(
             qFatal( "something went wrong" );
         }
         const auto & cursor = iterator.cursor();
-        for ( const auto & val : cursor ) {
-            func( reinterpret_cast < const char * > ( & val ) );
+        if ( mask.isEmpty() ) {
+            for ( const auto & val : cursor ) {
+                func( reinterpret_cast < const char * > ( & val ) );
+            }
+        }
+        else {
+            // masked pixels are reported as NaN, whole runs of valid pixels
+            // are passed on without looking at the mask
+            const PType blank = std::numeric_limits < PType >::quiet_NaN();
+            auto it = cursor.begin();
+            mask.forEachRun( [&] ( qint64, qint64 count, bool valid ) {
+                for ( qint64 i = 0 ; i < count ; i++, ++ it ) {
+                    func( reinterpret_cast < const char * > ( valid ? & ( * it ) : & blank ) );
+                }
+            } );
         }
         first = false;
     }
@@ -1,5 +1,6 @@
 #include "CasaImageLoader.h"
 #include "CCImage.h"
+#include "CCMmapImage.h"
 #include "CartaLib/Hooks/Initialize.h"
 #include "CartaLib/Hooks/LoadAstroImage.h"
 #include <QDebug>
@@ -66,6 +67,35 @@ static CCImageBase::SharedPtr tryCast( casa::LatticeBase * lat)
     return res;
 }
 
+///
+/// \brief Attempts to load a plain FITS file with pixels read from a memory mapping.
+/// Casacore is still used for the header (coordinates, units, etc).
+/// \param fname file name with the image
+/// \return the image, or nullptr if this is not a plain FITS file
+///
+Carta::Lib::Image::ImageInterface::SharedPtr CasaImageLoader::loadMmapFits( const QString & fname)
+{
+    FitsMmapData::SharedPtr mmapData = FitsMmapData::open( fname);
+    if( ! mmapData) {
+        return nullptr;
+    }
+    casa::FITSImage * fitsImage = nullptr;
+    try {
+        fitsImage = new casa::FITSImage( fname.toStdString());
+    } catch ( casa::AipsError & e) {
+        qWarning() << "\t-FITS header open failed: " << e.what();
+        return nullptr;
+    }
+    auto res = CCMmapImage::create( fitsImage, mmapData);
+    if( ! res) {
+        qWarning() << "\t-mapped data does not match casa image, not using mapping";
+        delete fitsImage;
+        return nullptr;
+    }
+    qDebug() << "\t-opened as memory mapped FITS";
+    return res;
+}
+
 ///
 /// \brief Attempts to load an image using casacore library, namely the very first
 /// frame of it. Then converts the frame to a QImage using 95% histogram clip values.
@@ -77,6 +107,12 @@ Carta::Lib::Image::ImageInterface::SharedPtr CasaImageLoader::loadImage( const Q
 {
     qDebug() << "CasaImageLoader plugin trying to load image: " << fname;
 
+    // plain FITS files are read through a memory mapping, much faster than casacore
+    auto mmapImage = loadMmapFits( fname );
+    if ( mmapImage ) {
+        return mmapImage;
+    }
+
     //
     // first we open the image as a lattice
     //
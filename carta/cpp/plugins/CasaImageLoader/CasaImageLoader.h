@@ -24,4 +24,5 @@ public:
 private:
 
     Carta::Lib::Image::ImageInterface::SharedPtr loadImage(const QString & fname);
+    Carta::Lib::Image::ImageInterface::SharedPtr loadMmapFits(const QString & fname);
 };
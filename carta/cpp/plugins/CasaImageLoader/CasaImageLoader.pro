@@ -12,14 +12,19 @@ SOURCES += \
     CCImage.cpp \
     CCMetaDataInterface.cpp \
     CCRawView.cpp \
-    CCCoordinateFormatter.cpp
+    CCCoordinateFormatter.cpp \
+    FitsMmapData.cpp \
+    FitsMmapRawView.cpp
 
 HEADERS += \
     CasaImageLoader.h \
     CCImage.h \
     CCMetaDataInterface.h \
     CCRawView.h \
-    CCCoordinateFormatter.h
+    CCCoordinateFormatter.h \
+    CCMmapImage.h \
+    FitsMmapData.h \
+    FitsMmapRawView.h
 
 casacoreLIBS += -L$${CASACOREDIR}/lib
 casacoreLIBS += -lcasa_lattices -lcasa_tables -lcasa_scimath -lcasa_scimath_f -lcasa_mirlib
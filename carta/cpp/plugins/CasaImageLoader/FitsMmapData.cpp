@@ -0,0 +1,224 @@
+/**
+ *
+ **/
+
+#include "FitsMmapData.h"
+#include <QDebug>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+/// size of a FITS block
+const int FitsBlock = 2880;
+
+/// size of a FITS header card
+const int FitsCard = 80;
+
+/// extract the value part of a header card, without the comment
+QString
+cardValue( const QString & card )
+{
+    QString val = card.mid( 10 );
+    int slash = val.indexOf( '/' );
+    if ( slash >= 0 ) {
+        val = val.left( slash );
+    }
+    return val.trimmed();
+}
+}
+
+FitsMmapData::SharedPtr
+FitsMmapData::open( const QString & fname )
+{
+    FitsMmapData::SharedPtr res = std::make_shared < FitsMmapData > ();
+    res-> m_file.setFileName( fname );
+    if ( ! res-> m_file.open( QFile::ReadOnly ) ) {
+        return nullptr;
+    }
+
+    // parse the primary header, block by block until END
+    int naxis = -1;
+    bool simple = false;
+    bool groups = false;
+    bool end = false;
+    std::vector < int64_t > naxes;
+    qint64 dataOffset = 0;
+    while ( ! end ) {
+        QByteArray block = res-> m_file.read( FitsBlock );
+        if ( block.size() != FitsBlock ) {
+            return nullptr;
+        }
+        dataOffset += FitsBlock;
+        for ( int pos = 0 ; pos < FitsBlock && ! end ; pos += FitsCard ) {
+            QString card = QString::fromLatin1( block.constData() + pos, FitsCard );
+            QString key = card.left( 8 ).trimmed();
+
+            // the very first card has to be SIMPLE = T
+            if ( dataOffset == FitsBlock && pos == 0 ) {
+                if ( key != "SIMPLE" || cardValue( card ) != "T" ) {
+                    return nullptr;
+                }
+                simple = true;
+                continue;
+            }
+            if ( key == "END" ) {
+                end = true;
+            }
+            else if ( card.mid( 8, 2 ) != "= " ) {
+                continue;
+            }
+            else if ( key == "BITPIX" ) {
+                res-> m_bitpix = cardValue( card ).toInt();
+            }
+            else if ( key == "NAXIS" ) {
+                naxis = cardValue( card ).toInt();
+                naxes.assign( std::max( naxis, 0 ), 0 );
+            }
+            else if ( key.startsWith( "NAXIS" ) ) {
+                bool ok = false;
+                int ind = key.mid( 5 ).toInt( & ok ) - 1;
+                if ( ok && ind >= 0 && ind < int ( naxes.size() ) ) {
+                    naxes[ind] = cardValue( card ).toLongLong();
+                }
+            }
+            else if ( key == "BSCALE" ) {
+                res-> m_bscale = cardValue( card ).toDouble();
+            }
+            else if ( key == "BZERO" ) {
+                res-> m_bzero = cardValue( card ).toDouble();
+            }
+            else if ( key == "BLANK" ) {
+                res-> m_blank = cardValue( card ).toLongLong( & res-> m_hasBlank );
+            }
+            else if ( key == "GROUPS" ) {
+                groups = cardValue( card ) == "T";
+            }
+        }
+    }
+
+    // only plain images with data in the primary HDU
+    if ( ! simple || groups || naxis < 1 ) {
+        return nullptr;
+    }
+    int bytesPerPixel = std::abs( res-> m_bitpix ) / 8;
+    if ( res-> m_bitpix != 8 && res-> m_bitpix != 16 && res-> m_bitpix != 32
+         && res-> m_bitpix != 64 && res-> m_bitpix != -32 && res-> m_bitpix != -64 ) {
+        return nullptr;
+    }
+    res-> m_size = 1;
+    for ( int64_t n : naxes ) {
+        if ( n < 1 || n > std::numeric_limits < int >::max() ) {
+            return nullptr;
+        }
+        res-> m_dims.push_back( n );
+        res-> m_size *= n;
+    }
+    qint64 dataBytes = res-> m_size * bytesPerPixel;
+    if ( res-> m_file.size() < dataOffset + dataBytes ) {
+        qWarning() << "FITS file is truncated:" << fname;
+        return nullptr;
+    }
+
+    res-> m_data = res-> m_file.map( dataOffset, dataBytes );
+    if ( ! res-> m_data ) {
+        qWarning() << "Could not map FITS data:" << res-> m_file.errorString();
+        return nullptr;
+    }
+    return res;
+} // open
+
+void
+FitsMmapData::convert( int64_t first, int64_t count, int64_t stride, float * dst ) const
+{
+    CARTA_ASSERT( first >= 0 && first + ( count - 1 ) * stride < m_size );
+    switch ( m_bitpix ) {
+    case 8 :
+        _convert < quint8, quint8 > ( first, count, stride, dst );
+        break;
+    case 16 :
+        _convert < qint16, quint16 > ( first, count, stride, dst );
+        break;
+    case 32 :
+        _convert < qint32, quint32 > ( first, count, stride, dst );
+        break;
+    case 64 :
+        _convert < qint64, quint64 > ( first, count, stride, dst );
+        break;
+    case -32 :
+        _convert < float, quint32 > ( first, count, stride, dst );
+        break;
+    case -64 :
+        _convert < double, quint64 > ( first, count, stride, dst );
+        break;
+    default :
+        CARTA_ASSERT( false );
+    }
+}
+
+template < typename Raw, typename UInt >
+void
+FitsMmapData::_convert( int64_t first, int64_t count, int64_t stride, float * dst ) const
+{
+    static_assert( sizeof( Raw ) == sizeof( UInt ), "raw and swap types must match" );
+    const float nan = std::numeric_limits < float >::quiet_NaN();
+    const bool identity = m_bscale == 1.0 && m_bzero == 0.0;
+    const bool blanks = m_hasBlank && std::numeric_limits < Raw >::is_integer;
+    const int64_t step = stride * sizeof( Raw );
+    const uchar * src = m_data + first * sizeof( Raw );
+    Raw raw[BatchSize];
+
+    // the loops below are kept free of branches so that the compiler can
+    // vectorize them
+    while ( count > 0 ) {
+        int n = std::min < int64_t > ( count, BatchSize );
+
+        // byte swap the batch
+        if ( stride == 1 ) {
+            for ( int i = 0 ; i < n ; i++ ) {
+                UInt u;
+                memcpy( & u, src + i * sizeof( Raw ), sizeof( u ) );
+                u = qFromBigEndian( u );
+                memcpy( raw + i, & u, sizeof( u ) );
+            }
+        }
+        else {
+            for ( int i = 0 ; i < n ; i++ ) {
+                UInt u;
+                memcpy( & u, src + i * step, sizeof( u ) );
+                u = qFromBigEndian( u );
+                memcpy( raw + i, & u, sizeof( u ) );
+            }
+        }
+
+        // scale
+        if ( identity ) {
+            for ( int i = 0 ; i < n ; i++ ) {
+                dst[i] = raw[i];
+            }
+        }
+        else {
+            for ( int i = 0 ; i < n ; i++ ) {
+                dst[i] = raw[i] * m_bscale + m_bzero;
+            }
+        }
+        if ( blanks ) {
+            for ( int i = 0 ; i < n ; i++ ) {
+                dst[i] = int64_t( raw[i] ) == m_blank ? nan : dst[i];
+            }
+        }
+
+        src += n * step;
+        dst += n;
+        count -= n;
+    }
+} // _convert
+
+FitsMmapData::~FitsMmapData()
+{
+    if ( m_data ) {
+        m_file.unmap( const_cast < uchar * > ( m_data ) );
+    }
+}
@@ -0,0 +1,72 @@
+/**
+ * Memory mapped access to the primary data unit of a plain FITS file.
+ *
+ * Only simple files are handled: primary HDU with data, no compression, no random
+ * groups. Everything else is left to casacore.
+ *
+ * Once opened the mapping is immutable, so distinct views can read from it at the
+ * same time from different threads. A single view is not thread safe.
+ **/
+
+#pragma once
+
+#include "CartaLib/CartaLib.h"
+#include <QFile>
+#include <QString>
+#include <vector>
+#include <cstdint>
+
+class FitsMmapData
+{
+    CLASS_BOILERPLATE( FitsMmapData );
+
+public:
+
+    /// number of pixels converted at a time
+    const static int BatchSize = 1024;
+
+    /// map the data unit of the given file
+    /// \return nullptr if the file is not a plain FITS file we can map
+    static FitsMmapData::SharedPtr
+    open( const QString & fname );
+
+    /// dimensions of the data unit, fastest varying axis first
+    const std::vector < int > &
+    dims() const
+    {
+        return m_dims;
+    }
+
+    /// total number of pixels
+    int64_t
+    size() const
+    {
+        return m_size;
+    }
+
+    /// convert 'count' pixels to floats, starting at pixel index 'first' and
+    /// advancing by 'stride' pixels, applying BSCALE/BZERO and mapping BLANK to NaN
+    void
+    convert( int64_t first, int64_t count, int64_t stride, float * dst ) const;
+
+    ~FitsMmapData();
+
+    /// use open()
+    FitsMmapData() { }
+
+private:
+
+    template < typename Raw, typename UInt >
+    void
+    _convert( int64_t first, int64_t count, int64_t stride, float * dst ) const;
+
+    QFile m_file;
+    const uchar * m_data = nullptr;
+    std::vector < int > m_dims;
+    int64_t m_size = 0;
+    int m_bitpix = 0;
+    double m_bscale = 1.0;
+    double m_bzero = 0.0;
+    bool m_hasBlank = false;
+    int64_t m_blank = 0;
+};
@@ -0,0 +1,174 @@
+/**
+ *
+ **/
+
+#include "FitsMmapRawView.h"
+#include <QDebug>
+#include <algorithm>
+#include <stdexcept>
+
+FitsMmapRawView::FitsMmapRawView( FitsMmapData::SharedPtr data, const SliceND & sliceInfo )
+{
+    m_data = data;
+    m_appliedSlice = sliceInfo.apply( m_data-> dims() );
+    _init();
+}
+
+FitsMmapRawView::FitsMmapRawView( FitsMmapData::SharedPtr data,
+                                  const SliceND::ApplyResult & applyResult )
+{
+    m_data = data;
+    m_appliedSlice = applyResult;
+    _init();
+}
+
+void
+FitsMmapRawView::_init()
+{
+    const auto & slices = m_appliedSlice.dims();
+    const auto & dataDims = m_data-> dims();
+    CARTA_ASSERT( slices.size() == dataDims.size() );
+
+    m_viewSize = 1;
+    m_origin = 0;
+    int64_t dataStride = 1;
+    for ( size_t i = 0 ; i < slices.size() ; i++ ) {
+        m_viewDims.push_back( slices[i].count );
+        m_viewSize *= std::max < int64_t > ( slices[i].count, 1 );
+        m_strides.push_back( dataStride * slices[i].step );
+        m_origin += dataStride * slices[i].start;
+        dataStride *= dataDims[i];
+    }
+    m_currPosView.resize( m_viewDims.size(), 0 );
+}
+
+const char *
+FitsMmapRawView::get( const VI & pos )
+{
+    // preconditions
+    if ( CARTA_RUNTIME_CHECKS && pos.size() > dims().size() ) {
+        throw std::runtime_error( "invalid position" );
+    }
+
+    int64_t ind = m_origin;
+    for ( size_t i = 0 ; i < pos.size() ; i++ ) {
+        ind += pos[i] * m_strides[i];
+    }
+    m_data-> convert( ind, 1, 1, & m_buff );
+    return reinterpret_cast < const char * > ( & m_buff );
+}
+
+void
+FitsMmapRawView::forEach( std::function < void (const char *) > func, Traversal traversal )
+{
+    Q_UNUSED( traversal );
+    if ( m_viewSize == 0 ) {
+        return;
+    }
+
+    // convert a row at a time, the first axis is the fastest
+    int64_t rowSize = std::max( m_viewDims[0], 1 );
+    std::vector < float > row( rowSize );
+    std::fill( m_currPosView.begin(), m_currPosView.end(), 0 );
+    for ( int64_t first = 0 ; first < m_viewSize ; first += rowSize ) {
+        _readRange( first, rowSize, row.data() );
+        for ( int64_t x = 0 ; x < rowSize ; x++ ) {
+            m_currPosView[0] = x;
+            func( reinterpret_cast < const char * > ( & row[x] ) );
+        }
+
+        // advance the position of the remaining axes
+        for ( size_t i = 1 ; i < m_currPosView.size() ; i++ ) {
+            if ( ++m_currPosView[i] < m_viewDims[i] ) {
+                break;
+            }
+            m_currPosView[i] = 0;
+        }
+    }
+} // forEach
+
+Carta::Lib::NdArray::RawViewInterface *
+FitsMmapRawView::getView( const SliceND & sliceInfo )
+{
+    // apply the slice to dimensions of this view
+    SliceND::ApplyResult ar = sliceInfo.apply( dims() );
+
+    // create applied result that combines m_appliedSlice with ar
+    SliceND::ApplyResult newAr = SliceND::ApplyResult::combine( m_appliedSlice, ar );
+
+    // return a new view based on the new slice
+    return new FitsMmapRawView( m_data, newAr );
+}
+
+int64_t
+FitsMmapRawView::read( int64_t buffSize, char * buff, Traversal traversal )
+{
+    Q_UNUSED( traversal );
+    int64_t count = _readRange( m_readPos, buffSize / sizeof( float ),
+                                reinterpret_cast < float * > ( buff ) );
+    m_readPos += count;
+    return count * sizeof( float );
+}
+
+int64_t
+FitsMmapRawView::read( int64_t chunk, int64_t buffSize, char * buff, Traversal traversal )
+{
+    Q_UNUSED( traversal );
+    int64_t perChunk = buffSize / sizeof( float );
+    int64_t count = _readRange( chunk * perChunk, perChunk,
+                                reinterpret_cast < float * > ( buff ) );
+    return count * sizeof( float );
+}
+
+void
+FitsMmapRawView::forEach( int64_t buffSize,
+                          std::function < void (const char *, int64_t) > func,
+                          char * buff,
+                          Traversal traversal )
+{
+    Q_UNUSED( traversal );
+    int64_t perChunk = buffSize / sizeof( float );
+    if ( perChunk < 1 ) {
+        qWarning() << "FitsMmapRawView::forEach buffer too small" << buffSize;
+        return;
+    }
+    std::vector < float > ownBuff;
+    float * dst = reinterpret_cast < float * > ( buff );
+    if ( ! dst ) {
+        ownBuff.resize( std::min( perChunk, m_viewSize ) );
+        dst = ownBuff.data();
+    }
+    for ( int64_t first = 0 ; first < m_viewSize ; first += perChunk ) {
+        int64_t count = _readRange( first, perChunk, dst );
+        func( reinterpret_cast < const char * > ( dst ), count );
+    }
+}
+
+int64_t
+FitsMmapRawView::_readRange( int64_t first, int64_t count, float * dst )
+{
+    if ( first < 0 || first >= m_viewSize || count < 1 ) {
+        return 0;
+    }
+    count = std::min( count, m_viewSize - first );
+
+    // split the range into runs along the first axis, each run is a single
+    // strided conversion
+    int64_t rowSize = std::max( m_viewDims[0], 1 );
+    int64_t done = 0;
+    while ( done < count ) {
+        int64_t ind = first + done;
+        int64_t x = ind % rowSize;
+        int64_t rest = ind / rowSize;
+        int64_t offset = m_origin + x * m_strides[0];
+        for ( size_t i = 1 ; i < m_viewDims.size() ; i++ ) {
+            int64_t n = std::max( m_viewDims[i], 1 );
+            offset += ( rest % n ) * m_strides[i];
+            rest /= n;
+        }
+        int64_t run = std::min( rowSize - x, count - done );
+        m_data-> convert( offset, run, m_strides[0], dst + done );
+        done += run;
+    }
+    return count;
+} // _readRange
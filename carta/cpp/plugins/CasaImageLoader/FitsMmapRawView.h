@@ -0,0 +1,106 @@
+/**
+ *
+ **/
+
+#pragma once
+
+#include "FitsMmapData.h"
+#include "CartaLib/IImage.h"
+
+/// raw view into a memory mapped FITS data unit
+///
+/// Pixels are converted from the mapped (big endian) data straight into the caller's
+/// buffers in batches, there is no intermediate copy of the image. All state needed
+/// for traversal lives in the view, so distinct views can be used from separate
+/// threads; one view must not be shared between threads.
+///
+/// The order of traversal is the same as for CCRawView, i.e. the first axis varies
+/// fastest. This is also the storage order of the file, so Sequential is optimal.
+class FitsMmapRawView
+    : public Carta::Lib::NdArray::RawViewInterface
+{
+public:
+
+    /// construct a view on the mapped data from provided slice information
+    FitsMmapRawView( FitsMmapData::SharedPtr data, const SliceND & sliceInfo );
+
+    virtual PixelType
+    pixelType() override
+    {
+        return PixelType::Real32;
+    }
+
+    virtual const VI &
+    dims() override
+    {
+        return m_viewDims;
+    }
+
+    virtual const char *
+    get( const VI & pos ) override;
+
+    virtual void
+    forEach( std::function < void (const char *) > func, Traversal traversal ) override;
+
+    virtual const VI &
+    currentPos() override
+    {
+        return m_currPosView;
+    }
+
+    virtual RawViewInterface *
+    getView( const SliceND & sliceInfo ) override;
+
+    virtual int64_t
+    read( int64_t buffSize, char * buff, Traversal traversal ) override;
+
+    virtual void
+    seek( int64_t ind ) override
+    {
+        m_readPos = ind;
+    }
+
+    virtual int64_t
+    read( int64_t chunk, int64_t buffSize, char * buff, Traversal traversal ) override;
+
+    virtual void
+    forEach( int64_t buffSize,
+             std::function < void (const char *, int64_t count) > func,
+             char * buff,
+             Traversal traversal ) override;
+
+private:
+
+    /// construct a view directly from applied slice
+    FitsMmapRawView( FitsMmapData::SharedPtr data, const SliceND::ApplyResult & applyResult );
+
+    /// cache dimensions and strides of the applied slice
+    void
+    _init();
+
+    /// convert 'count' pixels of the view, starting at (view) pixel index 'first'
+    /// \return number of pixels converted
+    int64_t
+    _readRange( int64_t first, int64_t count, float * dst );
+
+    FitsMmapData::SharedPtr m_data;
+    SliceND::ApplyResult m_appliedSlice;
+    VI m_viewDims;
+
+    /// number of pixels in the view
+    int64_t m_viewSize = 0;
+
+    /// distance (in pixels of the data unit) between neighbours along each axis
+    std::vector < int64_t > m_strides;
+
+    /// data unit index of the first pixel of the view
+    int64_t m_origin = 0;
+
+    /// position for the stateful read()
+    int64_t m_readPos = 0;
+
+    VI m_currPosView;
+
+    // buffer for reporting results when calling get()
+    float m_buff;
+};
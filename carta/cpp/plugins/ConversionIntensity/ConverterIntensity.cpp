@@ -1,5 +1,5 @@
 #include "ConverterIntensity.h"
-#include <plugins/ConversionSpectral/Converter.h>
+#include "CartaLib/UnitConversionPlan.h"
 #include <math.h>
 #include <QDebug>
 
@@ -11,9 +11,6 @@ const QString ConverterIntensity::JY = "Jy";
 const QString ConverterIntensity::KELVIN = "Kelvin";
 const QString ConverterIntensity::ADU = "adu";
 const QString ConverterIntensity::TIMES_PIXELS = "*pixels";
-const double ConverterIntensity::SPEED_LIGHT_FACTOR = 0.0000000009;
-const double ConverterIntensity::FREQUENCY_FACTOR = 2 * 0.0000000000000000000000138;
-const double ConverterIntensity::ARCSECONDS_PER_STERADIAN = 206.265 * 206.265;
 
 const QList<QString> ConverterIntensity::BEAM_UNITS =
         QList<QString>() << "pJy/beam" <<"10pJy/beam"<<"100pJy/beam"<<
@@ -68,193 +65,15 @@ bool ConverterIntensity::isSupportedUnits( const QString& yUnit ) {
     return acceptable;
 }
 
-QString ConverterIntensity::stripPixels( const QString& units ) {
-    int pixelIndex = units.indexOf( TIMES_PIXELS );
-    QString strippedUnits = units;
-    if ( pixelIndex > 0 ) {
-        strippedUnits = units.left(pixelIndex );
-    }
-    return strippedUnits;
-}
-
 void ConverterIntensity::convert( std::vector<double>& values,
         const std::vector<double>& hertzValues,
         const QString& oldUnits, const QString& newUnits,
         double maxValue, const QString& maxUnits,
         double beamAngle, double beamArea ) {
-
-    bool supportedUnits = isSupportedUnits( oldUnits );
-    if ( supportedUnits ) {
-        supportedUnits = isSupportedUnits( newUnits );
-    }
-    if ( !supportedUnits ) {
-        return;
-    }
-
-    QString newUnitsBase = stripPixels( newUnits );
-    QString oldUnitsBase = stripPixels( oldUnits );
-    QString maxUnitsBase = stripPixels( maxUnits );
-
-    //Change fraction of peak back to the original units before converting.  We don't
-    //want the current values in fraction of peak going forward.
-    QString baseConvertUnits = oldUnitsBase;
-    int maxPoints = values.size();
-    if ( oldUnitsBase == FRACTION_OF_PEAK && newUnitsBase != FRACTION_OF_PEAK) {
-        for ( int i = 0; i < maxPoints; i++ ) {
-            values[i] = percentToValue( values[i], maxValue);
-        }
-        baseConvertUnits = maxUnitsBase;
-    }
-
-    //Exit if we don't have anything to do.
-    if ( baseConvertUnits == newUnitsBase ) {
-        return;
-    }
-
-    if ( newUnitsBase == FRACTION_OF_PEAK ) {
-        //Scale the vector
-        for ( int i = 0; i < maxPoints; i++ ) {
-            values[ i ] = valueToPercent( values[i], maxValue );
-        }
-    }
-
-    else {
-        //If the original units are in JY or JY_BEAM, strip off a prefix such as
-        //m, k, etc and adjust the data.
-        QString strippedBase = baseConvertUnits;
-        if ( isJansky( baseConvertUnits ) ) {
-            strippedBase = getJanskyBaseUnits( baseConvertUnits );
-            convertJansky( values, baseConvertUnits, strippedBase/*, coord*/ );
-        } else if ( isKelvin( baseConvertUnits )) {
-            strippedBase = getKelvinBaseUnits( baseConvertUnits );
-            convertKelvin( values, baseConvertUnits, strippedBase/*, coord*/ );
-        }
-
-        QString strippedNew = newUnitsBase;
-        if ( isJansky( newUnitsBase)) {
-            strippedNew = getJanskyBaseUnits( newUnitsBase );
-        } else if ( isKelvin( newUnitsBase)) {
-            strippedNew = getKelvinBaseUnits( newUnitsBase );
-        }
-
-        //Do the conversion using the base units without the prefix.
-        for ( int i = 0; i < maxPoints; i++ ) {
-            values[ i ] = convertQuantity( values[i], hertzValues[i],
-                    strippedBase, strippedNew,
-                    beamAngle, beamArea );
-        }
-
-        //Add any additional prefix back in.
-        if ( isJansky( newUnitsBase ) ) {
-            convertJansky( values, strippedNew, newUnitsBase/*, coord*/ );
-        } else if ( isKelvin( newUnitsBase )) {
-            convertKelvin( values, strippedNew, newUnitsBase/*, coord*/ );
-        }
-    }
-}
-
-QString ConverterIntensity::getJanskyBaseUnits( const QString& units ) {
-    QString baseUnits = units;
-    int jyIndex = units.indexOf( JY );
-    if ( jyIndex >= 0 ) {
-        int mJyIndex = units.indexOf( JY_SR );
-        if (mJyIndex >= 0 ) {
-            baseUnits = units.mid( mJyIndex, units.length() - mJyIndex );
-        } else {
-            baseUnits = units.mid( jyIndex, units.length() - jyIndex );
-        }
-    }
-    return baseUnits;
-}
-
-QString ConverterIntensity::getKelvinBaseUnits( const QString& units ) {
-    QString baseUnits = units;
-    int kelvinIndex = units.indexOf( KELVIN );
-    if ( kelvinIndex > 0 ) {
-        baseUnits = units.mid( kelvinIndex, units.length() - kelvinIndex );
-    }
-    return baseUnits;
-}
-
-bool ConverterIntensity::isKelvin( const QString& units ) {
-    bool kelvinUnits = false;
-    if ( units.indexOf( KELVIN) >= 0 ) {
-        kelvinUnits = true;
-    }
-    return kelvinUnits;
-}
-
-bool ConverterIntensity::isJansky( const QString& units ) {
-    bool janskyUnits = false;
-    if ( units.indexOf( JY ) >=0  ) {
-        janskyUnits = true;
-    }
-    return janskyUnits;
-}
-
-void ConverterIntensity::convertJansky( std::vector<double>& values, const QString& oldUnits,
-        const QString& newUnits ) {
-    if ( oldUnits.indexOf( JY_BEAM) >= 0 && newUnits.indexOf( JY_BEAM) >= 0 ) {
-        for ( int i = 0; i < static_cast<int>(values.size()); i++ ) {
-            values[i] = convertJyBeams( oldUnits, newUnits, values[i]);
-        }
-    }
-
-    else if ( oldUnits.indexOf( JY_SR) >= 0 && newUnits.indexOf( JY_SR) >= 0) {
-        for ( int i = 0; i < static_cast<int>(values.size()); i++ ) {
-            values[i] = convertJYSR( oldUnits, newUnits, values[i]);
-        }
-    } else {
-        for ( int i = 0; i < static_cast<int>(values.size()); i++ ) {
-            values[i] = convertJY( oldUnits, newUnits, values[i]);
-        }
-    }
-}
-
-void ConverterIntensity::convertKelvin( std::vector<double>& values,
-        const QString& oldUnits, const QString& newUnits) {
-    for ( int i = 0; i < static_cast<int>(values.size()); i++ ) {
-        if ( oldUnits.indexOf( KELVIN) >= 0 && newUnits.indexOf( KELVIN) >= 0 ) {
-            values[i] = convertKelvin( oldUnits, newUnits, values[i]);
-        }
-    }
-}
-
-double ConverterIntensity::valueToPercent( double yValue, double maxValue ) {
-    double convertedYValue = yValue / maxValue;
-    return convertedYValue;
-}
-
-
-double ConverterIntensity::percentToValue( double yValue, double maxValue ) {
-    double convertedYValue = yValue * maxValue;
-    return convertedYValue;
-}
-
-double ConverterIntensity::beamToArcseconds( double yValue, double beamArea ) {
-    double convertedValue = yValue;
-    if ( beamArea != 0 ) {
-        convertedValue = yValue / beamArea;
-    }
-    return convertedValue;
-}
-
-double ConverterIntensity::arcsecondsToBeam( double yValue, double beamArea ) {
-    double convertedValue = yValue;
-    if ( beamArea != 0 ) {
-        convertedValue = yValue * beamArea;
-    }
-    return convertedValue;
-}
-
-double ConverterIntensity::srToArcseconds( double yValue ) {
-    double convertedValue = yValue / ARCSECONDS_PER_STERADIAN;
-    return convertedValue;
-}
-
-double ConverterIntensity::arcsecondsToSr( double yValue ) {
-    double convertedValue = yValue * ARCSECONDS_PER_STERADIAN;
-    return convertedValue;
+    //The units are only looked at once, when the plan is made.
+    Carta::Lib::UnitConversionPlan plan = Carta::Lib::UnitConversionPlan::intensity(
+            oldUnits, newUnits, maxValue, maxUnits, beamAngle, beamArea );
+    plan.apply( values, hertzValues );
 }
 
 void ConverterIntensity::convert( std::vector<double> &resultValues, int sourceIndex,
@@ -274,84 +93,6 @@ void ConverterIntensity::convert( std::vector<double> &resultValues, int sourceI
     }
 }
 
-double ConverterIntensity::convertNonKelvinUnits( double value,
-        const QString& oldUnits, const QString& newUnits, double beamArea ) {
-    double convertedValue = value;
-    if ( oldUnits != newUnits ){
-        if ( oldUnits == JY_BEAM ) {
-            if ( newUnits != JY_BEAM ) {
-                convertedValue = beamToArcseconds( value, beamArea );
-                if ( newUnits == JY_SR ) {
-                    convertedValue = arcsecondsToSr( convertedValue );
-                }
-            }
-        } else if ( oldUnits == JY_SR ) {
-            if ( newUnits != JY_SR ) {
-                convertedValue = srToArcseconds( value );
-                if ( newUnits == JY_BEAM ) {
-                    convertedValue = arcsecondsToBeam( convertedValue, beamArea );
-                }
-            }
-        } else if ( oldUnits == JY_ARCSEC ) {
-            if ( newUnits != JY_ARCSEC ) {
-                if ( newUnits == JY_SR ) {
-                    convertedValue = arcsecondsToSr( value );
-                } else if ( newUnits == JY_BEAM ) {
-                    convertedValue = arcsecondsToBeam( value, beamArea );
-                } else {
-                    qDebug()<<"Unsupported units: "<<newUnits;
-                }
-
-            }
-        } else {
-            //qDebug() << "Unrecognized units:"<<oldUnits;
-        }
-    }
-    return convertedValue;
-}
-
-
-double ConverterIntensity::convertQuantity( double yValue, double frequencyValue,
-        const QString& oldUnits, const QString& newUnits, double beamSolidAngle,
-        double beamArea ) {
-
-    casa::String oldUnitStr = oldUnits.toStdString();
-    casa::String newUnitStr = newUnits.toStdString();
-
-    double convertedYValue = yValue;
-    if ( oldUnits != KELVIN && newUnits != KELVIN ) {
-        convertedYValue = convertNonKelvinUnits( yValue, oldUnits, newUnits, beamArea );
-    }
-    else if ( oldUnits == KELVIN && newUnits != KELVIN ) {
-        if ( beamSolidAngle > 0 ) {
-            //kelvin * solidAngle * 2 * 1.38 x 10^-23 * freq^2 / (10^-32 x (3 x 10^8)^2)
-            double num = yValue * beamSolidAngle * FREQUENCY_FACTOR * pow( frequencyValue, 2);
-            double den = SPEED_LIGHT_FACTOR;
-            double jyBeamValue = num / den;
-
-            //New units are now JY/BEAM convert them to what we need
-            convertedYValue = convertNonKelvinUnits( jyBeamValue, JY_BEAM, newUnits, beamArea );
-        } else {
-            qDebug() << "Could not convert from Kelvin because the beam solid angle was 0";
-        }
-    } else if ( oldUnits != KELVIN && newUnits == KELVIN ){
-        //oldUnits != KELVIN && newUnits == KELVIN
-        if ( beamSolidAngle > 0 ) {
-            //First convert the value to Jy/Beam
-            double valueBeam = convertNonKelvinUnits( yValue, oldUnits, JY_BEAM, beamArea);
-
-            //Temperature in Kelvin is now:
-            //Jy/beam x 10^(-32) x (3 x 10^8)^2 / ( solidAngle x 2 x 1.38 x 10^-23 x (xvalueinHz)^2 ).
-            double num = valueBeam * SPEED_LIGHT_FACTOR;
-            double den = beamSolidAngle * FREQUENCY_FACTOR * pow(frequencyValue,2);
-            convertedYValue = num / den;
-        } else {
-            qDebug() << "Could not convert to Kelvin because the beamSolidAngle was 0";
-        }
-    }
-    return convertedYValue;
-}
-
 double ConverterIntensity::convertJY( const QString& oldUnits, const QString& newUnits,
         double value ) {
     int sourceIndex = JY_UNITS.indexOf( oldUnits );
@@ -22,7 +22,8 @@ public:
     //Hertz values are needed corresponding to the values for Jy/Beam Kelvin conversions
     //only.  Both oldUnits and newUnits refer to the old and new units of the values
     //array.  In order to do FRACTION_OF_PEAK conversions, a maximum value with
-    //corresponding maximum units must be passed in.
+    //corresponding maximum units must be passed in.  The work is done by
+    //Carta::Lib::UnitConversionPlan, which the core can also use directly.
     static void convert( std::vector<double>& values, const std::vector<double>& hertzValues,
             const QString& oldUnits, const QString& newUnits,
             double maxValue, const QString& maxUnits,
@@ -43,31 +44,8 @@ public:
 
 private:
     ConverterIntensity();
-    static double percentToValue( double yValue, double maxValue );
-    static double valueToPercent( double yValue, double maxValue );
-    static double convertQuantity( double yValue, double frequencyValue,
-            const QString& oldUnits, const QString& newUnits,
-            double beamSolidAngle, double beamArea );
-    static void convertJansky( std::vector<double>& values, const QString& oldUnits,
-            const QString& newUnits );
-    static void convertKelvin( std::vector<double>& values, const QString& oldUnits,
-            const QString& newUnits );
-    static bool isJansky( const QString& units );
-    static bool isKelvin( const QString& units );
-    static double convertNonKelvinUnits( double yValue, const QString& oldUnits,
-            const QString& newUnits, double beamArea );
-    static QString getJanskyBaseUnits( const QString& units );
-    static QString getKelvinBaseUnits( const QString& units );
-    static QString stripPixels( const QString& units );
-    static double beamToArcseconds( double yValue, double beamArea );
-    static double arcsecondsToBeam( double yValue, double beamArea );
-    static double srToArcseconds( double yValue );
-    static double arcsecondsToSr( double yValue );
     static const QList<QString> BEAM_UNITS;
     static const QList<QString> JY_UNITS;
     static const QList<QString> JY_SR_UNITS;
     static const QList<QString> KELVIN_UNITS;
-    static const double SPEED_LIGHT_FACTOR;
-    static const double FREQUENCY_FACTOR;
-    static const double ARCSECONDS_PER_STERADIAN;
 };
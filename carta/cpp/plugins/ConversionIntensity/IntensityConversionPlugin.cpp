@@ -1,5 +1,6 @@
 #include "CartaLib/Hooks/Initialize.h"
 #include "CartaLib/Hooks/ConversionIntensityHook.h"
+#include "CartaLib/Hooks/ConversionInfoHook.h"
 #include "plugins/CasaImageLoader/CCImage.h"
 #include "plugins/ConversionIntensity/IntensityConversionPlugin.h"
 #include "plugins/ConversionIntensity/ConverterIntensity.h"
@@ -73,6 +74,21 @@ IntensityConversionPlugin::handleHook( BaseHook & hookData ){
             return true;
         }
     }
+    else if ( hookData.is < Carta::Lib::Hooks::ConversionInfoHook > () ) {
+        Carta::Lib::Hooks::ConversionInfoHook & hook
+            = static_cast <Carta::Lib::Hooks::ConversionInfoHook & > ( hookData );
+        CCImageBase * base = dynamic_cast<CCImageBase*>( hook.paramsPtr->m_dataSource.get() );
+        if ( base ){
+            casa::ImageInfo information = base->getImageInfo();
+            casa::Double beamAngle;
+            casa::Double beamArea;
+            _getBeamInfo( information, beamAngle, beamArea );
+            hook.result.beamValid = true;
+            hook.result.beamAngle = beamAngle;
+            hook.result.beamArea = beamArea;
+        }
+        return true;
+    }
     qWarning() << "Conversion intensity doesn't know how to handle this hook";
     return false;
 } // handleHook
@@ -81,7 +97,8 @@ std::vector < HookId >
 IntensityConversionPlugin::getInitialHookList(){
     return {
         Carta::Lib::Hooks::Initialize::staticId,
-        Carta::Lib::Hooks::ConversionIntensityHook::staticId
+        Carta::Lib::Hooks::ConversionIntensityHook::staticId,
+        Carta::Lib::Hooks::ConversionInfoHook::staticId
     };
 }
 
@@ -1,4 +1,5 @@
 #include "ConverterChannel.h"
+#include <casacore/casa/Arrays/Matrix.h>
 #include <QDebug>
 
 ConverterChannel::ConverterChannel(const QString& oldUnits, const QString& newUnits) :
@@ -18,30 +19,38 @@ double ConverterChannel::toPixel( double value, casa::SpectralCoordinate spectra
 
 casa::Vector<double> ConverterChannel::convert( const casa::Vector<double>& oldValues,
         casa::SpectralCoordinate spectralCoordinate ) {
-    std::vector<double> resultValues( oldValues.size());
-    for ( int i = 0; i < static_cast<int>(resultValues.size()); i++ ) {
-        double result;
-        bool correct = spectralCoordinate.toWorld( result, oldValues[i]);
-        if ( correct ) {
-            casa::Vector<casa::String> worldUnitsVector = spectralCoordinate.worldAxisUnits();
-            QString worldUnit(worldUnitsVector[0].c_str());
-            if ( worldUnit == newUnits ) {
-                resultValues[i] = result;
-            }
-            else {
-                qDebug() << "worldUnit="<<worldUnit<<" newUnit="<<newUnits;
-                Converter* helper = Converter::getConverter( worldUnit, newUnits);
-                if ( helper != nullptr ){
-                    resultValues[i] = helper->convert( result, spectralCoordinate );
-                    delete helper;
-                }
-                else {
-                    qDebug() << "Could not convert from "<<worldUnit<<" to "<<newUnits;
-                }
-            }
+    //Convert all channels at once, then change the units of the whole batch.
+    int dataCount = oldValues.size();
+    casa::Matrix<casa::Double> pixels( 1, dataCount );
+    pixels.row( 0 ) = oldValues;
+    casa::Matrix<casa::Double> worlds( 1, dataCount );
+    casa::Vector<casa::Bool> failures( dataCount, false );
+    bool correct = spectralCoordinate.toWorldMany( worlds, pixels, failures );
+    casa::Vector<double> resultValues( dataCount, 0.0 );
+    if ( !correct ) {
+        qDebug() << "Could not convert channels: "<<spectralCoordinate.errorMessage().c_str();
+    }
+    for ( int i = 0; i < dataCount; i++ ) {
+        if ( !failures[i] ) {
+            resultValues[i] = worlds( 0, i );
+        }
+    }
+
+    casa::Vector<casa::String> worldUnitsVector = spectralCoordinate.worldAxisUnits();
+    QString worldUnit(worldUnitsVector[0].c_str());
+    if ( worldUnit != newUnits ) {
+        Converter* helper = Converter::getConverter( worldUnit, newUnits);
+        if ( helper != nullptr ){
+            resultValues = helper->convert( resultValues, spectralCoordinate );
+            delete helper;
         }
         else {
-            qDebug() << "Could not convert channel="<<oldValues[i];
+            qDebug() << "Could not convert from "<<worldUnit<<" to "<<newUnits;
+        }
+        for ( int i = 0; i < dataCount; i++ ) {
+            if ( failures[i] ) {
+                resultValues[i] = 0;
+            }
         }
     }
     return resultValues;
@@ -1,13 +1,70 @@
 #include "CartaLib/Hooks/Initialize.h"
 #include "CartaLib/Hooks/ConversionSpectralHook.h"
+#include "CartaLib/Hooks/ConversionInfoHook.h"
 #include "CartaLib/IImage.h"
 #include "plugins/CasaImageLoader/CCImage.h"
 #include "plugins/CasaImageLoader/CCMetaDataInterface.h"
 #include "plugins/ConversionSpectral/Converter.h"
 #include "plugins/ConversionSpectral/SpectralConversionPlugin.h"
 
+#include <casacore/casa/Quanta/Quantum.h>
 #include <QDebug>
+#include <cmath>
 
+namespace
+{
+/// the spectral coordinate of an image, returns false if there isn't one
+bool
+getSpectralCoordinate( std::shared_ptr<Carta::Lib::Image::ImageInterface> image,
+        casa::SpectralCoordinate & sc ){
+    CCImageBase * base = dynamic_cast<CCImageBase*>( image.get() );
+    if ( !base ){
+        return false;
+    }
+    Carta::Lib::Image::MetaDataInterface::SharedPtr metaPtr = base->metaData();
+    CCMetaDataInterface* metaData = dynamic_cast<CCMetaDataInterface*>(metaPtr.get());
+    if ( !metaData ){
+        return false;
+    }
+    std::shared_ptr<casa::CoordinateSystem> cs = metaData->getCoordinateSystem();
+    int spectralIndex = cs->findCoordinate(casa::Coordinate::SPECTRAL,  -1);
+    if ( spectralIndex < 0 ){
+        return false;
+    }
+    sc = cs->spectralCoordinate( spectralIndex );
+    return true;
+}
+
+/// describe the spectral axis in Hz, so the core can build conversion plans
+void
+fillConversionInfo( const casa::SpectralCoordinate & sc, Carta::Lib::UnitConversionInfo & info ){
+    casa::Vector<casa::String> spectralUnits = sc.worldAxisUnits();
+    casa::Quantity unit( 1, spectralUnits[0] );
+    if ( !unit.isConform( "Hz" ) ){
+        return;
+    }
+    double toHz = unit.getValue( "Hz" );
+    info.spectralValid = true;
+    info.restFrequency = sc.restFrequency() * toHz;
+    info.refPixel = sc.referencePixel()[0];
+    info.refValue = sc.referenceValue()[0] * toHz;
+    info.increment = sc.increment()[0] * toHz;
+
+    //Tabular axes and frame conversions are not linear, check a few channels.
+    info.spectralLinear = info.increment != 0;
+    for ( double pixel : { 0.0, info.refPixel + 1, info.refPixel + 1000 } ){
+        casa::Double world;
+        if ( !info.spectralLinear || !sc.toWorld( world, pixel ) ){
+            info.spectralLinear = false;
+            break;
+        }
+        double linear = info.refValue + ( pixel - info.refPixel ) * info.increment;
+        if ( std::fabs( world * toHz - linear ) > 1e-9 * std::fabs( linear ) ){
+            info.spectralLinear = false;
+        }
+    }
+}
+}
 
 SpectralConversionPlugin::SpectralConversionPlugin( QObject * parent ) :
     QObject( parent )
@@ -31,41 +88,29 @@ SpectralConversionPlugin::handleHook( BaseHook & hookData ){
             }
             Converter* converter = Converter::getConverter( oldUnits, newUnits );
             if ( converter ){
-                CCImageBase * base = dynamic_cast<CCImageBase*>( image.get() );
-                if ( base ){
-                    Carta::Lib::Image::MetaDataInterface::SharedPtr metaPtr = base->metaData();
-                    CCMetaDataInterface* metaData = dynamic_cast<CCMetaDataInterface*>(metaPtr.get());
-                    if ( metaData ){
-                        std::shared_ptr<casa::CoordinateSystem> cs = metaData->getCoordinateSystem();
-                        int spectralIndex = cs->findCoordinate(casa::Coordinate::SPECTRAL,  -1);
-                        if ( spectralIndex >= 0 ){
-                            casa::SpectralCoordinate sc = cs->spectralCoordinate( spectralIndex );
-                            std::vector<double> inputValues = hook.paramsPtr->m_inputList;
-                            int dataCount = inputValues.size();
-                            casa::Vector<double> inputs( dataCount );
-                            for ( int i = 0; i < dataCount; i++ ){
-                                inputs[i] = inputValues[i];
-                            }
-                            std::vector<double> resultValues;
-                            if ( !newUnits.isEmpty() ){
-                                casa::Vector<double> outputs = converter->convert( inputs, sc );
-                                resultValues = outputs.tovector();
-                            }
-                            else {
-                                for ( int i = 0; i < dataCount; i++ ){
-                                    double converted = inputs[i];
-                                    if ( oldUnits != "pixel"){
-                                        converted = converter->toPixel( inputs[i], sc );
-                                    }
-                                    resultValues.push_back( converted );
-                                }
+                casa::SpectralCoordinate sc;
+                if ( getSpectralCoordinate( image, sc ) ){
+                    std::vector<double> inputValues = hook.paramsPtr->m_inputList;
+                    int dataCount = inputValues.size();
+                    casa::Vector<double> inputs( inputValues );
+                    std::vector<double> resultValues;
+                    if ( !newUnits.isEmpty() ){
+                        casa::Vector<double> outputs = converter->convert( inputs, sc );
+                        resultValues = outputs.tovector();
+                    }
+                    else {
+                        for ( int i = 0; i < dataCount; i++ ){
+                            double converted = inputs[i];
+                            if ( oldUnits != "pixel"){
+                                converted = converter->toPixel( inputs[i], sc );
                             }
-                            hook.result = resultValues;
-                        }
-                        else {
-                            qDebug() << "Not converting spectral units, no spectral coordinate";
+                            resultValues.push_back( converted );
                         }
                     }
+                    hook.result = resultValues;
+                }
+                else {
+                    qDebug() << "Not converting spectral units, no spectral coordinate";
                 }
                 delete converter;
             }
@@ -73,6 +118,15 @@ SpectralConversionPlugin::handleHook( BaseHook & hookData ){
 
         return true;
     }
+    else if ( hookData.is < Carta::Lib::Hooks::ConversionInfoHook > () ) {
+        Carta::Lib::Hooks::ConversionInfoHook & hook
+            = static_cast < Carta::Lib::Hooks::ConversionInfoHook & > ( hookData );
+        casa::SpectralCoordinate sc;
+        if ( getSpectralCoordinate( hook.paramsPtr->m_dataSource, sc ) ){
+            fillConversionInfo( sc, hook.result );
+        }
+        return true;
+    }
     qWarning() << "Spectral conversion doesn't know how to handle this hook";
     return false;
 } // handleHook
@@ -81,7 +135,8 @@ std::vector < HookId >
 SpectralConversionPlugin::getInitialHookList(){
     return {
                Carta::Lib::Hooks::Initialize::staticId,
-               Carta::Lib::Hooks::ConversionSpectralHook::staticId
+               Carta::Lib::Hooks::ConversionSpectralHook::staticId,
+               Carta::Lib::Hooks::ConversionInfoHook::staticId
     };
 }
 
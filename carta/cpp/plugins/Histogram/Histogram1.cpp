@@ -13,7 +13,7 @@ Histogram1::Histogram1( QObject * parent ) :
 Carta::Lib::Hooks::HistogramResult
 Histogram1::_computeHistogram()
 {
-    vector < std::pair < double, double > > data;
+    Carta::Lib::CurveBuffer data;
     QString name;
     QString unitsX = "";
     QString unitsY = "";
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "CartaLib/CurveBuffer.h"
 #include <vector>
 #include <QString>
 
@@ -21,10 +22,10 @@ public:
     virtual bool compute() = 0;
 
     /**
-     * Returns the histogram data as (intensity,count) pairs.
-     * @return a list of (intensity,count) data pairs.
+     * Returns the histogram data as intensity and count columns.
+     * @return the (intensity,count) points of the histogram.
      */
-    virtual std::vector< std::pair<double,double> > getData() const = 0;
+    virtual Carta::Lib::CurveBuffer getData() const = 0;
 
     /**
      * Returns a display name for the histogram.
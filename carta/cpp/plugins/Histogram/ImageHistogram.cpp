@@ -305,13 +305,10 @@ vector<T> ImageHistogram<T>::getYValues() const {
 }
 
 template <class T>
-std::vector< std::pair<double,double> > ImageHistogram<T>::getData() const {
-    int dataCount = getDataCount();
-    std::vector< std::pair<double,double> > data( dataCount );
-    for ( int i = 0; i < dataCount; i++ ){
-        data[i] = std::pair<double,double>(m_xValues[i],m_yValues[i]);
-    }
-    return data;
+Carta::Lib::CurveBuffer ImageHistogram<T>::getData() const {
+    std::vector<double> xs( m_xValues.begin(), m_xValues.end() );
+    std::vector<double> ys( m_yValues.begin(), m_yValues.end() );
+    return Carta::Lib::CurveBuffer( std::move( xs ), std::move( ys ) );
 }
 
 template <class T>
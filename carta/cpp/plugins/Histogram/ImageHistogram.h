@@ -22,7 +22,7 @@ class ImageHistogram : public IImageHistogram {
 public:
 	ImageHistogram();
 
-    virtual std::vector< std::pair<double,double> > getData() const Q_DECL_OVERRIDE;
+    virtual Carta::Lib::CurveBuffer getData() const Q_DECL_OVERRIDE;
     virtual QString getName() const Q_DECL_OVERRIDE;
     virtual QString getUnitsX() const Q_DECL_OVERRIDE;
     virtual QString getUnitsY() const Q_DECL_OVERRIDE;
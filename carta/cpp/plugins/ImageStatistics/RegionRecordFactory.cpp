@@ -1,6 +1,9 @@
 #include <QDebug>
+#include <QMutex>
 #include <QtCore/qmath.h>
 #include "RegionRecordFactory.h"
+#include "CartaLib/LruCache.h"
+#include "plugins/CasaImageLoader/CCImage.h"
 #include <casacore/images/Regions/ImageRegion.h>
 #include <casacore/images/Regions/RegionManager.h>
 
@@ -12,6 +15,22 @@
 #include <casacore/images/Regions/WCBox.h>
 #include <casacore/images/Images/SubImage.h>
 
+namespace {
+
+//Converting a region to world coordinates is expensive and the same regions are
+//asked for over and over (once per statistics request), so the records are kept.
+//They are keyed on the file and its modification time, like the image registry,
+//rather than on the image address, which can be reused by a different image.
+struct CachedRecord {
+    casa::Record record;
+    QString typeStr;
+};
+
+const int RECORD_CACHE_LIMIT = 1000;
+QMutex recordCacheMutex;
+Carta::Lib::LruCache<QString,CachedRecord> recordCache( RECORD_CACHE_LIMIT );
+}
+
 
 RegionRecordFactory::RegionRecordFactory( ){
 }
@@ -196,6 +215,24 @@ casa::Record RegionRecordFactory::getRegionRecord( Carta::Lib::RegionInfo::Regio
             }
         }
     }
+
+    Carta::Lib::RegionInfo regionInfo;
+    regionInfo.setRegionType( type );
+    regionInfo.setCorners( corners );
+    QString key = CCImageBase::getIdentity( casaImage );
+    if ( !key.isEmpty() ){
+        key = key + ":" + regionInfo.toString() + ":";
+        for ( int frame : slice ){
+            key = key + QString::number( frame ) + ",";
+        }
+        QMutexLocker locker( &recordCacheMutex );
+        CachedRecord cached;
+        if ( recordCache.find( key, cached ) ){
+            typeStr = cached.typeStr;
+            return cached.record;
+        }
+    }
+
     if ( type == Carta::Lib::RegionInfo::RegionType::Polygon ){
         regionRecord = _getRegionRecordPolygon( casaImage, corners, slice, typeStr );
     }
@@ -207,6 +244,13 @@ casa::Record RegionRecordFactory::getRegionRecord( Carta::Lib::RegionInfo::Regio
         qDebug() <<"RegionRecordFactory::getRegionRecord unrecognized region type: "+
                 QString::number((int)(type));
     }
+    if ( regionRecord.nfields() > 0 && !key.isEmpty() ){
+        QMutexLocker locker( &recordCacheMutex );
+        CachedRecord cached;
+        cached.record = regionRecord;
+        cached.typeStr = typeStr;
+        recordCache.insert( key, cached );
+    }
     return regionRecord;
 }
 
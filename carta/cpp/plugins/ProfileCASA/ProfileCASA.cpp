@@ -21,7 +21,8 @@ using namespace std;
 
 
 ProfileCASA::ProfileCASA(QObject *parent) :
-    QObject(parent){
+    QObject(parent),
+    m_records( RECORD_CACHE_LIMIT ){
 }
 
 
@@ -47,7 +48,6 @@ casa::MFrequency::Types ProfileCASA::_determineRefFrame(
 
 Carta::Lib::Hooks::ProfileResult ProfileCASA::_generateProfile( casa::ImageInterface < casa::Float > * imagePtr,
         Carta::Lib::RegionInfo regionInfo, Carta::Lib::ProfileInfo profileInfo ) const {
-    std::vector<std::pair<double,double> > profileData;
     casa::CoordinateSystem cSys = imagePtr->coordinates();
     casa::uInt spectralAxis = 0;
     if ( cSys.hasSpectralAxis()){
@@ -80,16 +80,32 @@ Carta::Lib::Hooks::ProfileResult ProfileCASA::_generateProfile( casa::ImageInter
     }
 
 
-    Carta::Lib::RegionInfo::RegionType shape = regionInfo.getRegionType();
-    std::vector<std::pair<double,double> > regionCorners = regionInfo.getCorners();
-    int cornerCount = regionCorners.size();
-    casa::Vector<casa::Double> x(cornerCount);
-    casa::Vector<casa::Double> y(cornerCount);
-    for ( int i = 0; i < cornerCount; i++ ){
-        x[i] = regionCorners[i].first;
-        y[i] = regionCorners[i].second;
+    //Records are keyed on the image file, not its address, which can be reused
+    //by a different image.
+    QString recordKey = CCImageBase::getIdentity( imagePtr );
+    casa::Record regionRecord;
+    bool cachedRecord = false;
+    if ( !recordKey.isEmpty() ){
+        recordKey = recordKey + ":" + regionInfo.toString();
+        QMutexLocker locker( &m_recordMutex );
+        cachedRecord = m_records.find( recordKey, regionRecord );
+    }
+    if ( !cachedRecord ){
+        Carta::Lib::RegionInfo::RegionType shape = regionInfo.getRegionType();
+        std::vector<std::pair<double,double> > regionCorners = regionInfo.getCorners();
+        int cornerCount = regionCorners.size();
+        casa::Vector<casa::Double> x(cornerCount);
+        casa::Vector<casa::Double> y(cornerCount);
+        for ( int i = 0; i < cornerCount; i++ ){
+            x[i] = regionCorners[i].first;
+            y[i] = regionCorners[i].second;
+        }
+        regionRecord = _getRegionRecord( shape, cSys, x, y);
+        if ( !recordKey.isEmpty() ){
+            QMutexLocker locker( &m_recordMutex );
+            m_records.insert( recordKey, regionRecord );
+        }
     }
-    casa::Record regionRecord = _getRegionRecord( shape, cSys, x, y);
 
     QString spectralType = profileInfo.getSpectralType();
     QString spectralUnit = profileInfo.getSpectralUnit();
@@ -127,11 +143,13 @@ Carta::Lib::Hooks::ProfileResult ProfileCASA::_generateProfile( casa::ImageInter
         }
 
         int dataCount = jyValues.size();
+        std::vector<double> profileX( dataCount );
+        std::vector<double> profileY( dataCount );
         for ( int i = 0; i < dataCount; i++ ){
-            std::pair<double,double> dataPair(xValues[i], jyValues[i]);
-            profileData.push_back( dataPair );
+            profileX[i] = xValues[i];
+            profileY[i] = jyValues[i];
         }
-        profileResult.setData( profileData );
+        profileResult.setCurve( Carta::Lib::CurveBuffer( std::move( profileX ), std::move( profileY ) ) );
     }
     catch( casa::AipsError& error ){
         qDebug() << "Could not generate profile: "<<error.getMesg().c_str();
@@ -7,9 +7,11 @@
 #include "CartaLib/RegionInfo.h"
 #include "CartaLib/ProfileInfo.h"
 #include "CartaLib/Hooks/ProfileResult.h"
+#include "CartaLib/LruCache.h"
 #include "plugins/CasaImageLoader/CCImage.h"
 #include <imageanalysis/ImageAnalysis/ImageCollapserData.h>
 
+#include <QMutex>
 #include <QObject>
 
 namespace casa {
@@ -44,4 +46,10 @@ private:
             const casa::Vector<casa::Double>& x, const casa::Vector<casa::Double>& y) const;
     casa::Record _getRegionRecord( Carta::Lib::RegionInfo::RegionType shape, const casa::CoordinateSystem& cSys,
             const casa::Vector<casa::Double>& x, const casa::Vector<casa::Double>& y) const;
+
+    //Region records by image and region, so profiles of the same region do not
+    //have to convert it to world coordinates again.
+    static const int RECORD_CACHE_LIMIT = 1000;
+    mutable QMutex m_recordMutex;
+    mutable Carta::Lib::LruCache<QString,casa::Record> m_records;
 };
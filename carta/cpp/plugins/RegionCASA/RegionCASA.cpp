@@ -5,6 +5,7 @@
 #include "CartaLib/Hooks/LoadRegion.h"
 #include "CartaLib/RegionInfo.h"
 #include "CartaLib/IImage.h"
+#include "casacore/casa/Arrays/Matrix.h"
 #include "casacore/coordinates/Coordinates/DirectionCoordinate.h"
 #include "casacore/measures/Measures/MCDirection.h"
 #include "imageanalysis/Annotations/RegionTextList.h"
@@ -66,22 +67,34 @@ std::vector<HookId> RegionCASA::getInitialHookList(){
 
 std::vector<std::pair<double,double> >
 RegionCASA::_getPixelVertices( const casa::AnnotationBase::Direction& corners,
-        const casa::CoordinateSystem& csys, const casa::Vector<casa::MDirection>& directions ) const {
+        const casa::CoordinateSystem& csys, const casa::Vector<casa::MDirection>& directions,
+        const CoordinateFormatterInterface& formatter ) const {
     std::vector<casa::Quantity> xx, xy;
     _getWorldVertices(xx, xy, csys, directions );
-    casa::Vector<casa::Double> world = csys.referenceValue();
+    casa::Vector<casa::Double> reference = csys.referenceValue();
     const casa::IPosition dirAxes = csys.directionAxesNumbers();
     casa::String xUnit = csys.worldAxisUnits()[dirAxes[0]];
     casa::String yUnit = csys.worldAxisUnits()[dirAxes[1]];
     int cornerCount = corners.size();
+    int axisCount = reference.size();
+
+    //Convert all the corners in one call.
+    CoordinateFormatterInterface::VD worlds( cornerCount * axisCount );
+    for (int i=0; i<cornerCount; i++) {
+        for ( int j = 0; j < axisCount; j++ ){
+            worlds[i * axisCount + j] = reference[j];
+        }
+        worlds[i * axisCount + dirAxes[0]] = xx[i].getValue(xUnit);
+        worlds[i * axisCount + dirAxes[1]] = xy[i].getValue(yUnit);
+    }
+    CoordinateFormatterInterface::VD pixels;
+    formatter.toPixelBatch( worlds, pixels );
+    int pixelAxisCount = formatter.nAxes();
 
     std::vector<std::pair<double,double> > pixelVertices( cornerCount );
     for (int i=0; i<cornerCount; i++) {
-        world[dirAxes[0]] = xx[i].getValue(xUnit);
-        world[dirAxes[1]] = xy[i].getValue(yUnit);
-        casa::Vector<casa::Double> pixel;
-        csys.toPixel(pixel, world);
-        pixelVertices[i]= std::pair<double,double>( pixel[dirAxes[0]], pixel[dirAxes[1]] );
+        pixelVertices[i]= std::pair<double,double>( pixels[i * pixelAxisCount + dirAxes[0]],
+                pixels[i * pixelAxisCount + dirAxes[1]] );
     }
     return pixelVertices;
 }
@@ -111,6 +124,7 @@ RegionCASA::_loadRegion( const QString & fname, std::shared_ptr<Carta::Lib::Imag
         CCMetaDataInterface* metaData = dynamic_cast<CCMetaDataInterface*>(metaPtr.get());
         if ( metaData ){
             std::shared_ptr<casa::CoordinateSystem> cs = metaData->getCoordinateSystem();
+            CoordinateFormatterInterface::SharedPtr formatter = metaData->coordinateFormatter();
             std::vector < int > dimensions = imagePtr->dims();
             int dimCount = dimensions.size();
             casa::IPosition shape(dimCount);
@@ -130,7 +144,7 @@ RegionCASA::_loadRegion( const QString & fname, std::shared_ptr<Carta::Lib::Imag
                 casa::Vector<casa::MDirection> directions = ann->getConvertedDirections();
                 casa::AnnotationBase::Direction points = ann->getDirections();
                 std::vector<std::pair<double,double> > corners =
-                            _getPixelVertices( points, *cs.get(), directions );
+                            _getPixelVertices( points, *cs.get(), directions, *formatter );
                 int annType = ann->getType();
                 switch( annType ){
                 case casa::AnnotationBase::RECT_BOX : {
@@ -166,22 +180,21 @@ RegionCASA::_loadRegion( const QString & fname, std::shared_ptr<Carta::Lib::Imag
                     const double xradius = (x_is_major ? major_radius : minor_radius);
                     const double yradius = (x_is_major ? minor_radius : major_radius);
 
-                    casa::Vector<casa::Double> world0(2, 0);
-                    casa::Vector<casa::Double> world1(2, 0);
-                    world0[0] = center[0] - xradius;
-                    world0[1] = center[1] - yradius;
-                    world1[0] = center[0] + xradius;
-                    world1[1] = center[1] + yradius;
-                    casa::Vector<casa::Double> pixel0(2, 0);
-                    casa::Vector<casa::Double> pixel1(2, 0);
+                    //Convert both corners in one call.
+                    casa::Matrix<casa::Double> worlds( 2, 2 );
+                    worlds( 0, 0 ) = center[0] - xradius;
+                    worlds( 1, 0 ) = center[1] - yradius;
+                    worlds( 0, 1 ) = center[0] + xradius;
+                    worlds( 1, 1 ) = center[1] + yradius;
+                    casa::Matrix<casa::Double> pixels( 2, 2 );
+                    casa::Vector<casa::Bool> failures( 2, false );
                     std::vector<std::pair<double,double> > ellipseCorners(2);
 
                     const casa::CoordinateSystem ellipsCoord = ellipse->getCsys();
-                    bool firstConvert = ellipsCoord.directionCoordinate().toPixel( pixel0, world0 );
-                    bool secondConvert = ellipsCoord.directionCoordinate().toPixel( pixel1, world1 );
-                    if ( firstConvert && secondConvert ){
-                        ellipseCorners[0] = std::pair<double,double>( pixel0[0], pixel0[1] );
-                        ellipseCorners[1] = std::pair<double,double>( pixel1[0], pixel1[1] );
+                    bool converted = ellipsCoord.directionCoordinate().toPixelMany( pixels, worlds, failures );
+                    if ( converted && !failures[0] && !failures[1] ){
+                        ellipseCorners[0] = std::pair<double,double>( pixels( 0, 0 ), pixels( 1, 0 ) );
+                        ellipseCorners[1] = std::pair<double,double>( pixels( 0, 1 ), pixels( 1, 1 ) );
                         _addCorners( rInfo, ellipseCorners );
                     }
                     else {
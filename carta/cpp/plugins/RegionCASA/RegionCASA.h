@@ -4,6 +4,7 @@
 #pragma once
 
 #include "CartaLib/IPlugin.h"
+#include "CartaLib/ICoordinateFormatter.h"
 #include "casacore/casa/Quanta/Quantum.h"
 #include "casacore/coordinates/Coordinates/CoordinateSystem.h"
 #include "imageanalysis/Annotations/AnnotationBase.h"
@@ -46,11 +47,13 @@ private:
      * @param corners - a list of corner points in world units.
      * @param csys - the coordinate system of the containing image.
      * @param directions - a list of MDirections for the image.
+     * @param formatter - the coordinate formatter of the image, used to convert all corners at once.
      * @return - a list of corner points of a region in pixels.
      */
     std::vector<std::pair<double,double> >
         _getPixelVertices( const casa::AnnotationBase::Direction& corners,
-            const casa::CoordinateSystem& csys, const casa::Vector<casa::MDirection>& directions ) const;
+            const casa::CoordinateSystem& csys, const casa::Vector<casa::MDirection>& directions,
+            const CoordinateFormatterInterface& formatter ) const;
 
     /**
      * Get a lists of x- and y- coordinates of the corner points of a region based on world
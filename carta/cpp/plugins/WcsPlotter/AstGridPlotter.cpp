@@ -1,6 +1,7 @@
 #include "AstGridPlotter.h"
 #include <iostream>
 #include "grfdriver.h"
+#include "CartaLib/Trace.h"
 
 #include <string.h>
 #include <locale.h>
@@ -417,37 +418,37 @@ AstFrameSet* AstGridPlotter::_make2dFrameCelestialExclude( AstFrameSet* wcsinfo
     return newFrame;
 }
 
-bool
-AstGridPlotter::plot()
+AstFrameSetCache::~AstFrameSetCache()
 {
+    clear();
+}
 
-    // setup the graphics driver globals
-    // =================================
-    // copy over pens, making sure we have at least one pen
-//    grfGlobals()-> pens = pens();
-//    if( pens().empty()) {
-//        grfGlobals()->pens.push_back( QPen( QColor( "green"), 1));
-//    }
-    // setup shadow pen
-    grfGlobals()-> lineShadowPenIndex = m_shadowPenIndex;
-    // assign VG composer
-    grfGlobals()-> vgComposer = m_vgc;
-    // pre-cache some things
-    grfGlobals()-> prepare();
-    
-    // Temporarily override numeric locale, otherwise AST will fail to 
-    // parse floating point numbers in the FITS header if the user's 
-    // locale uses a comma as a decimal separator. Back up the old 
-    // locale so that we can switch back afterwards and minimise impact
-    // on the rest of the application.
-    
-    std::string oldLocale = setlocale(LC_NUMERIC, "C");
-
-    // get rid of any ast errors from previous calls, just in case
-    astClearStatus;
+void
+AstFrameSetCache::clear()
+{
+    if ( m_frameSet ) {
+        astAnnul( m_frameSet );
+        m_frameSet = nullptr;
+    }
+    m_key.clear();
+}
 
-    // make sure we clean up resources no matter how we exit this method
-    AstGuard astGuard;
+AstFrameSet *
+AstGridPlotter::_frameSet()
+{
+    // the 2d frameset depends on the header, CarLin and the displayed axes/frames
+    QString key;
+    if ( m_frameSetCache ) {
+        QStringList parts;
+        parts << m_fitsHeader << QString::number( m_carLin );
+        for ( const Carta::Lib::AxisDisplayInfo & info : m_axisDisplayInfos ) {
+            parts << info.toString();
+        }
+        key = parts.join( "\n" );
+        if ( m_frameSetCache-> m_frameSet && m_frameSetCache-> m_key == key ) {
+            return m_frameSetCache-> m_frameSet;
+        }
+    }
 
     // ask AST to read in the FITS header
 #pragma GCC diagnostic push
@@ -456,7 +457,7 @@ AstGridPlotter::plot()
 #pragma GCC diagnostic pop
     if ( ! fitschan ) {
         m_errorString = "astFitsChan returned null :(";
-        return false;
+        return nullptr;
     }
     std::string stdstr = m_fitsHeader.toStdString();
     astPutCards( fitschan, stdstr.c_str() );
@@ -471,19 +472,73 @@ AstGridPlotter::plot()
     AstFrameSet * wcsinfo = static_cast < AstFrameSet * > ( astRead( fitschan ) );
     if ( ! astOK ) {
         m_errorString = "Some AST LIB error, check logs.";
-        return false;
+        return nullptr;
     }
     else if ( wcsinfo == AST__NULL ) {
         m_errorString = "No WCS found";
-        return false;
+        return nullptr;
     }
     else if ( strcmp( astGetC( wcsinfo, "Class" ), "FrameSet" ) ) {
         m_errorString = "check FITS header (astlib)";
-        return false;
+        return nullptr;
     }
 
     AstFrameSet* newFrame = _make2dFrame( wcsinfo );
     if ( newFrame == nullptr ){
+        return nullptr;
+    }
+
+    // keep a reference that survives the current AST context
+    if ( m_frameSetCache ) {
+        m_frameSetCache-> clear();
+        AstFrameSet * cached = static_cast < AstFrameSet * > ( astClone( newFrame ) );
+        astExport( cached );
+        if ( astOK ) {
+            m_frameSetCache-> m_frameSet = cached;
+            m_frameSetCache-> m_key = key;
+        }
+        else {
+            astClearStatus;
+        }
+    }
+    return newFrame;
+} // _frameSet
+
+bool
+AstGridPlotter::plot()
+{
+    CARTA_TRACE_SCOPE( "grid", "AstGridPlotter::plot" );
+
+    // setup the graphics driver globals
+    // =================================
+    // copy over pens, making sure we have at least one pen
+//    grfGlobals()-> pens = pens();
+//    if( pens().empty()) {
+//        grfGlobals()->pens.push_back( QPen( QColor( "green"), 1));
+//    }
+    // setup shadow pen
+    grfGlobals()-> lineShadowPenIndex = m_shadowPenIndex;
+    // assign VG composer
+    grfGlobals()-> vgComposer = m_vgc;
+    // pre-cache some things
+    grfGlobals()-> prepare();
+    
+    // Temporarily override numeric locale, otherwise AST will fail to 
+    // parse floating point numbers in the FITS header if the user's 
+    // locale uses a comma as a decimal separator. Back up the old 
+    // locale so that we can switch back afterwards and minimise impact
+    // on the rest of the application.
+    
+    std::string oldLocale = setlocale(LC_NUMERIC, "C");
+
+    // get rid of any ast errors from previous calls, just in case
+    astClearStatus;
+
+    // make sure we clean up resources no matter how we exit this method
+    AstGuard astGuard;
+
+    AstFrameSet * newFrame = _frameSet();
+    if ( newFrame == nullptr ) {
         return false;
     }
 
@@ -528,15 +583,22 @@ AstGridPlotter::plot()
         astClearStatus;
     }
 
-    if ( true ) {
+    if ( m_gaps.size() == 2 ) {
+        astSetD( plot, "Gap(1)", m_gaps[0] );
+        astSetD( plot, "Gap(2)", m_gaps[1] );
+    }
+    else {
         double g1 = astGetD( plot, "Gap(1)" );
         double g2 = astGetD( plot, "Gap(2)" );
         astSetD( plot, "Gap(1)", g1 * m_densityModifier );
         astSetD( plot, "Gap(2)", g2 * m_densityModifier );
-        if (!astOK ){
-            qWarning() << "Ast error setting gap" << astStatus;
-            astClearStatus;
-        }
+    }
+    if (!astOK ){
+        qWarning() << "Ast error setting gap" << astStatus;
+        astClearStatus;
+    }
+    else {
+        m_gaps = { astGetD( plot, "Gap(1)" ), astGetD( plot, "Gap(2)" ) };
     }
 
     // set system options
@@ -579,8 +641,6 @@ AstGridPlotter::plot()
     }
 
     plot = (AstPlot *) astAnnul( plot );
-    wcsinfo = (AstFrameSet *) astAnnul( wcsinfo );
-    fitschan = (AstFitsChan *) astAnnul( fitschan );
     
     // Restore previous numeric locale
     
@@ -28,6 +28,36 @@ class AstFrameSet;
 
 namespace WcsPlotterPluginNS
 {
+///
+/// Keeps the 2d frameset that AstGridPlotter builds from a FITS header, so that
+/// the header does not have to be parsed again for every plot. The coordinate system
+/// is applied to the plot, not the frameset, so one entry serves all systems.
+///
+class AstFrameSetCache
+{
+public:
+
+    AstFrameSetCache() { }
+
+    ~AstFrameSetCache();
+
+    /// forget the cached frameset
+    void
+    clear();
+
+private:
+
+    AstFrameSetCache( const AstFrameSetCache & ) = delete;
+    AstFrameSetCache &
+    operator= ( const AstFrameSetCache & ) = delete;
+
+    friend class AstGridPlotter;
+
+    /// header, CarLin and axis display info the frameset was made from
+    QString m_key;
+    AstFrameSet * m_frameSet = nullptr;
+};
+
 ///
 /// Renders a wcs grid to a vector graphics composer using starlink's AST library.
 ///
@@ -94,6 +124,29 @@ public:
         m_densityModifier = dm;
     }
 
+    /// use a cache for the frameset parsed from the header, the cache must outlive
+    /// the plotter
+    void
+    setFrameSetCache( AstFrameSetCache * cache )
+    {
+        m_frameSetCache = cache;
+    }
+
+    /// use these gaps between grid lines instead of the ones AST picks for the plot,
+    /// the density modifier is not applied to them
+    void
+    setGaps( double gap1, double gap2 )
+    {
+        m_gaps = { gap1, gap2 };
+    }
+
+    /// gaps between grid lines used by the last successful plot
+    const std::vector < double > &
+    gaps() const
+    {
+        return m_gaps;
+    }
+
     /// perform the actual plot on the image
     /// returns success/failure
     bool
@@ -122,8 +175,18 @@ protected:
 
     VGComposer * m_vgc = nullptr;
 
+    AstFrameSetCache * m_frameSetCache = nullptr;
+
+    /// explicit or last used gaps, empty if neither
+    std::vector < double > m_gaps;
+
 private:
 
+    /// read the header and make the 2d frameset, or get it from the cache
+    /// the returned frameset belongs to the current AST context or the cache
+    AstFrameSet *
+    _frameSet();
+
     /*
     *  Purpose:
     *     Create a FrameSet describing 2 axes of a 3-d FrameSet.
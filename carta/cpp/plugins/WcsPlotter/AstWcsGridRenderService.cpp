@@ -8,6 +8,8 @@
 #include "CartaLib/LinearMap.h"
 #include <QPainter>
 #include <QTime>
+#include <QTransform>
+#include <cmath>
 #include <set>
 
 
@@ -44,6 +46,18 @@ struct AstWcsGridRenderService::Pimpl
 
     // last submitted job id
     IWcsGridRenderService::JobId lastSubmittedJobId = 0;
+
+    // frameset parsed from the fits header
+    AstFrameSetCache frameSetCache;
+
+    // grid lines plotted for the current zoom level, over linesImgRect,
+    // mapped to the screen by scale and offset
+    bool linesValid = false;
+    VG::VGList lines;
+    std::vector < double > linesGaps;
+    QRectF linesImgRect;
+    QPointF linesOffset;
+    double linesScaleX = 0, linesScaleY = 0;
 };
 
 AstWcsGridRenderService::AstWcsGridRenderService()
@@ -72,6 +86,10 @@ AstWcsGridRenderService::setInputImage( Carta::Lib::Image::ImageInterface::Share
 {
     CARTA_ASSERT( image );
 
+    // the header of an image never changes, don't extract it again
+    if ( image == m_iimage && ! m().fitsHeader.isEmpty() ) {
+        return;
+    }
     m_iimage = image;
 
     // get the fits header from this image
@@ -87,6 +105,7 @@ AstWcsGridRenderService::setInputImage( Carta::Lib::Image::ImageInterface::Share
 
     if ( header != m().fitsHeader ) {
         m_vgValid = false;
+        m().linesValid = false;
         m().fitsHeader = header;
     }
 } // setInputImage
@@ -167,11 +186,6 @@ AstWcsGridRenderService::renderNow()
         return m().pens[si( e )];
     };
 
-    // element to font info reference
-    auto fi = [&] ( Element e ) -> Pimpl::FontInfo & {
-        return m().fonts[si( e )];
-    };
-
     // make a new VG composer
 //    VG::VGComposer m_vgc;
 //    m_vgc.clear();
@@ -225,58 +239,160 @@ AstWcsGridRenderService::renderNow()
 
     // draw the grid
     // =============================
+    // Grid lines only depend on the zoom level, so they are plotted over a larger
+    // area than what is visible and reused while the view is panned within it.
+    // Border, ticks and labels are plotted every time, using the same gaps as the
+    // cached lines so that they line up.
+    double sx = m_outRect.width() / m_imgRect.width();
+    double sy = m_outRect.height() / m_imgRect.height();
+    QPointF offset( m_outRect.left() - m_imgRect.left() * sx,
+                    m_outRect.top() - m_imgRect.top() * sy );
+    auto sameScale = [] ( double a, double b ) {
+        return std::abs( a - b ) <= 1e-9 * std::abs( a );
+    };
+    bool reuseLines = m_gridLines && m().linesValid
+                      && sameScale( sx, m().linesScaleX ) && sameScale( sy, m().linesScaleY )
+                      && m().linesImgRect.normalized().contains( m_imgRect.normalized() );
+
     AstGridPlotter sgp;
+    _configure( & sgp );
+    sgp.setInputRect( m_imgRect );
+    sgp.setOutputRect( m_outRect );
+    VG::VGComposer annotations;
+    sgp.setOutputVGComposer( & annotations );
+    if ( m_gridLines ) {
+        sgp.setPlotOption( "Grid=0" );
+    }
+    if ( reuseLines ) {
+        sgp.setGaps( m().linesGaps[0], m().linesGaps[1] );
+    }
+    bool plotSuccess = sgp.plot();
+
+    if ( plotSuccess && m_gridLines && ! reuseLines && sgp.gaps().size() == 2 ) {
+        const double margin = 0.5;
+        QRectF linesImgRect = m_imgRect.adjusted(
+            - margin * m_imgRect.width(), - margin * m_imgRect.height(),
+            margin * m_imgRect.width(), margin * m_imgRect.height() );
+        QRectF linesOutRect( offset.x() + linesImgRect.left() * sx,
+                             offset.y() + linesImgRect.top() * sy,
+                             linesImgRect.width() * sx, linesImgRect.height() * sy );
+
+        AstGridPlotter lgp;
+        _configure( & lgp );
+        lgp.setInputRect( linesImgRect );
+        lgp.setOutputRect( linesOutRect );
+        VG::VGComposer lines;
+        lgp.setOutputVGComposer( & lines );
+        lgp.setGaps( sgp.gaps()[0], sgp.gaps()[1] );
+        lgp.setPlotOption( "Grid=1" );
+        lgp.setPlotOption( "Border=0" );
+        lgp.setPlotOption( "DrawAxes=0" );
+        lgp.setPlotOption( "NumLab=0" );
+        lgp.setPlotOption( "TextLab=0" );
+        lgp.setPlotOption( "MajTickLen=0" );
+        lgp.setPlotOption( "MinTickLen=0" );
+
+        // tolerance is relative to the plot size, keep it the same in pixels
+        lgp.setPlotOption( QString( "Tol=%1" ).arg( 0.01 / ( 1 + 2 * margin ) ) );
+        if ( lgp.plot() ) {
+            m().lines = lines.vgList();
+            m().linesGaps = sgp.gaps();
+            m().linesImgRect = linesImgRect;
+            m().linesOffset = offset;
+            m().linesScaleX = sx;
+            m().linesScaleY = sy;
+            m().linesValid = true;
+            reuseLines = true;
+        }
+        else {
+            qWarning() << "Grid lines rendering error:" << lgp.getError();
+        }
+    }
+
+    // cached lines, shifted to where the view is now and clipped to the grid area
+    if ( reuseLines ) {
+        QPointF shift = offset - m().linesOffset;
+        m_vgc.append < VGE::Save > ();
+        m_vgc.append < VGE::SetClipRect > ( m_outRect );
+        m_vgc.append < VGE::SetTransform > ( QTransform::fromTranslate( shift.x(), shift.y() ), true );
+        m_vgc.appendList( m().lines );
+        m_vgc.append < VGE::Restore > ();
+    }
+    m_vgc.appendList( annotations.vgList() );
+
+//    qDebug() << "plotSuccess=" << plotSuccess;
+//    qDebug() << "plotError=" << sgp.getError();
+    if( ! plotSuccess) {
+        qWarning() << "Grid rendering error:" << sgp.getError();
+    }
+
+    //qDebug() << "Grid rendered in " << t.elapsed() / 1000.0 << "s";
+
+    // Report the result.
+    emit done( m_vgc.vgList(), m().lastSubmittedJobId );
+} // startRendering
+
+void
+AstWcsGridRenderService::_configure( AstGridPlotter * sgp )
+{
+    // local helper - element to integer
+    auto si = [&] ( Element e ) {
+        return static_cast < int > ( e );
+    };
+
+    // element to font info reference
+    auto fi = [&] ( Element e ) -> Pimpl::FontInfo & {
+        return m().fonts[si( e )];
+    };
 
 //    for ( const QPen & pen : m().pens ) {
-//        sgp.pens().push_back( pen );
+//        sgp->pens().push_back( pen );
 //    }
-    sgp.pens() = m().pens;
+    sgp->pens() = m().pens;
 
-    sgp.setInputRect( m_imgRect );
-    sgp.setOutputRect( m_outRect );
-    sgp.setFitsHeader( m().fitsHeader.join( "" ) );
-    sgp.setAxisDisplayInfo( m_axisDisplayInfos );
-    sgp.setOutputVGComposer( & m_vgc );
+    sgp->setFitsHeader( m().fitsHeader.join( "" ) );
+    sgp->setFrameSetCache( & m().frameSetCache );
+    sgp->setAxisDisplayInfo( m_axisDisplayInfos );
 
-//    sgp.setPlotOption( "tol=0.001" ); // this can slow down the grid rendering!!!
-    sgp.setPlotOption( "DrawTitle=0" );
+//    sgp->setPlotOption( "tol=0.001" ); // this can slow down the grid rendering!!!
+    sgp->setPlotOption( "DrawTitle=0" );
 
     if ( !m_gridLines ){
-        sgp.setPlotOption( "Grid=0");
+        sgp->setPlotOption( "Grid=0");
     }
 
     if ( !m_axes ) {
-        sgp.setPlotOption("Border=0");
-        sgp.setPlotOption("DrawAxes(2)=0");
-        sgp.setPlotOption("DrawAxes(1)=0");
-        _turnOffTicks( &sgp );
+        sgp->setPlotOption("Border=0");
+        sgp->setPlotOption("DrawAxes(2)=0");
+        sgp->setPlotOption("DrawAxes(1)=0");
+        _turnOffTicks( sgp );
     }
     else {
         if ( !m_ticks ){
-            _turnOffTicks(&sgp);
+            _turnOffTicks(sgp);
         }
         else {
-            sgp.setPlotOption(QString("MinTickLen(1)=%1").arg( m_tickLength ));
-            sgp.setPlotOption(QString("MinTickLen(2)=%2").arg( m_tickLength ));
+            sgp->setPlotOption(QString("MinTickLen(1)=%1").arg( m_tickLength ));
+            sgp->setPlotOption(QString("MinTickLen(2)=%2").arg( m_tickLength ));
         }
     }
 
     if ( m_internalLabels ) {
-        sgp.setPlotOption( QString( "Labelling=Interior" ) );
+        sgp->setPlotOption( QString( "Labelling=Interior" ) );
     }
     else {
-        sgp.setPlotOption( QString( "Labelling=Exterior" ) );
-        sgp.setPlotOption( QString( "ForceExterior=1" ) ); // undocumented AST option
+        sgp->setPlotOption( QString( "Labelling=Exterior" ) );
+        sgp->setPlotOption( QString( "ForceExterior=1" ) ); // undocumented AST option
     }
 
-    sgp.setPlotOption( "LabelUp(2)=0" ); // align labels to axes
-    sgp.setPlotOption( "Size=9" ); // default font
+    sgp->setPlotOption( "LabelUp(2)=0" ); // align labels to axes
+    sgp->setPlotOption( "Size=9" ); // default font
 
     QString system = _getSystem();
     if ( ! system.isEmpty() ){
        //System only makes sense if the display axes are RA and DEC.
        if ( Carta::Lib::AxisDisplayInfo::isCelestialPlane( m_axisDisplayInfos) ){
-           sgp.setPlotOption( "System=" + system );
+           sgp->setPlotOption( "System=" + system );
        }
    }
 
@@ -285,7 +401,7 @@ AstWcsGridRenderService::renderNow()
         int labelCount = m_labels.size();
         for ( int i = 0; i < labelCount; i++ ){
             int axisIndex = i+ 1;
-            sgp.setPlotOption( QString("TextLab(%1)=1").arg(axisIndex) );
+            sgp->setPlotOption( QString("TextLab(%1)=1").arg(axisIndex) );
             if ( m_labels[i].length() > 0 ){
                 QString baseLabel = m_labels[i];
 
@@ -296,7 +412,7 @@ AstWcsGridRenderService::renderNow()
                 if ( labelFormat != Carta::Lib::AxisLabelInfo::Formats::NONE ){
                     if ( completeFormat.length() > 0 ){
                         QString format = QString( "Format(%1)=%2").arg(axisIndex).arg( completeFormat );
-                        sgp.setPlotOption( format );
+                        sgp->setPlotOption( format );
 
                         //Label with format added - seems to be added automatically for J2000.
                         if ( system != "J2000" ){
@@ -305,94 +421,80 @@ AstWcsGridRenderService::renderNow()
                     }
                     else {
                         QString digits = QString( "Digits(%1)=%2").arg(axisIndex).arg(precision);
-                        sgp.setPlotOption( digits );
+                        sgp->setPlotOption( digits );
                     }
                     QString label = QString( "Label(%1)=%2").arg(axisIndex).arg( baseLabel);
-                    sgp.setPlotOption( label );
+                    sgp->setPlotOption( label );
 
                     //Label location
                     Carta::Lib::AxisLabelInfo::Locations labelLocation = m_labelInfos[i].getLocation();
                     QString location = _getDisplayLocation( labelLocation );
                     if ( location.length() > 0 ){
                         QString edgeStr =QString("Edge(%1)=%2").arg(axisIndex).arg( location );
-                        sgp.setPlotOption( edgeStr );
+                        sgp->setPlotOption( edgeStr );
                     }
                 }
                 //If there is no format, turn axis labelling off
                 else {
-                    _turnOffLabels( &sgp, axisIndex );
+                    _turnOffLabels( sgp, axisIndex );
                 }
             }
         }
     }
     else {
-        _turnOffLabels( &sgp, 1 );
-        _turnOffLabels( &sgp, 2 );
+        _turnOffLabels( sgp, 1 );
+        _turnOffLabels( sgp, 2 );
     }
 
     // fonts
-    sgp.setPlotOption( QString( "Font(TextLab1)=%1" ).arg( fi( Element::LabelText1 ).first ) );
-    sgp.setPlotOption( QString( "Font(TextLab2)=%1" ).arg( fi( Element::LabelText2 ).first ) );
-    sgp.setPlotOption( QString( "Font(NumLab1)=%1" ).arg( fi( Element::NumText1 ).first ) );
-    sgp.setPlotOption( QString( "Font(NumLab2)=%1" ).arg( fi( Element::NumText2 ).first ) );
+    sgp->setPlotOption( QString( "Font(TextLab1)=%1" ).arg( fi( Element::LabelText1 ).first ) );
+    sgp->setPlotOption( QString( "Font(TextLab2)=%1" ).arg( fi( Element::LabelText2 ).first ) );
+    sgp->setPlotOption( QString( "Font(NumLab1)=%1" ).arg( fi( Element::NumText1 ).first ) );
+    sgp->setPlotOption( QString( "Font(NumLab2)=%1" ).arg( fi( Element::NumText2 ).first ) );
 
     // font sizes
-    sgp.setPlotOption( QString( "Size(TextLab1)=%1" ).arg( fi( Element::LabelText1 ).second ) );
-    sgp.setPlotOption( QString( "Size(TextLab2)=%1" ).arg( fi( Element::LabelText2 ).second ) );
-    sgp.setPlotOption( QString( "Size(NumLab1)=%1" ).arg( fi( Element::NumText1 ).second ) );
-    sgp.setPlotOption( QString( "Size(NumLab2)=%1" ).arg( fi( Element::NumText2 ).second ) );
+    sgp->setPlotOption( QString( "Size(TextLab1)=%1" ).arg( fi( Element::LabelText1 ).second ) );
+    sgp->setPlotOption( QString( "Size(TextLab2)=%1" ).arg( fi( Element::LabelText2 ).second ) );
+    sgp->setPlotOption( QString( "Size(NumLab1)=%1" ).arg( fi( Element::NumText1 ).second ) );
+    sgp->setPlotOption( QString( "Size(NumLab2)=%1" ).arg( fi( Element::NumText2 ).second ) );
 
     // line widths
-//    sgp.setPlotOption( QString( "Width(grid1)=%1" ).arg( pi( Element::GridLines1 ).widthF() ) );
-//    sgp.setPlotOption( QString( "Width(grid2)=%1" ).arg( pi( Element::GridLines2 ).widthF() ) );
-//    sgp.setPlotOption( QString( "Width(border)=%1" ).arg( pi( Element::BorderLines ).widthF() ) );
-//    sgp.setPlotOption( QString( "Width(axis1)=%1" ).arg( pi( Element::AxisLines1 ).widthF() ) );
-//    sgp.setPlotOption( QString( "Width(axis2)=%1" ).arg( pi( Element::AxisLines2 ).widthF() ) );
-//    sgp.setPlotOption( QString( "Width(ticks1)=%1" ).arg( pi( Element::TickLines1 ).widthF() ) );
-//    sgp.setPlotOption( QString( "Width(ticks2)=%1" ).arg( pi( Element::TickLines2 ).widthF() ) );
+//    sgp->setPlotOption( QString( "Width(grid1)=%1" ).arg( pi( Element::GridLines1 ).widthF() ) );
+//    sgp->setPlotOption( QString( "Width(grid2)=%1" ).arg( pi( Element::GridLines2 ).widthF() ) );
+//    sgp->setPlotOption( QString( "Width(border)=%1" ).arg( pi( Element::BorderLines ).widthF() ) );
+//    sgp->setPlotOption( QString( "Width(axis1)=%1" ).arg( pi( Element::AxisLines1 ).widthF() ) );
+//    sgp->setPlotOption( QString( "Width(axis2)=%1" ).arg( pi( Element::AxisLines2 ).widthF() ) );
+//    sgp->setPlotOption( QString( "Width(ticks1)=%1" ).arg( pi( Element::TickLines1 ).widthF() ) );
+//    sgp->setPlotOption( QString( "Width(ticks2)=%1" ).arg( pi( Element::TickLines2 ).widthF() ) );
 
     // colors
-    sgp.setPlotOption( QString( "Colour(grid1)=%1" ).arg( si( Element::GridLines1 ) ) );
-    sgp.setPlotOption( QString( "Colour(grid2)=%1" ).arg( si( Element::GridLines2 ) ) );
-    sgp.setPlotOption( QString( "Colour(border)=%1" ).arg( si( Element::BorderLines ) ) );
-    sgp.setPlotOption( QString( "Colour(axis1)=%1" ).arg( si( Element::AxisLines1 ) ) );
-    sgp.setPlotOption( QString( "Colour(axis2)=%1" ).arg( si( Element::AxisLines2 ) ) );
-    sgp.setPlotOption( QString( "Colour(ticks1)=%1" ).arg( si( Element::TickLines1 ) ) );
-    sgp.setPlotOption( QString( "Colour(ticks2)=%1" ).arg( si( Element::TickLines2 ) ) );
-    sgp.setPlotOption( QString( "Colour(NumLab1)=%1" ).arg( si( Element::NumText1 ) ) );
-    sgp.setPlotOption( QString( "Colour(NumLab2)=%1" ).arg( si( Element::NumText2 ) ) );
-    sgp.setPlotOption( QString( "Colour(TextLab1)=%1" ).arg( si( Element::LabelText1 ) ) );
-    sgp.setPlotOption( QString( "Colour(TextLab2)=%1" ).arg( si( Element::LabelText2 ) ) );
+    sgp->setPlotOption( QString( "Colour(grid1)=%1" ).arg( si( Element::GridLines1 ) ) );
+    sgp->setPlotOption( QString( "Colour(grid2)=%1" ).arg( si( Element::GridLines2 ) ) );
+    sgp->setPlotOption( QString( "Colour(border)=%1" ).arg( si( Element::BorderLines ) ) );
+    sgp->setPlotOption( QString( "Colour(axis1)=%1" ).arg( si( Element::AxisLines1 ) ) );
+    sgp->setPlotOption( QString( "Colour(axis2)=%1" ).arg( si( Element::AxisLines2 ) ) );
+    sgp->setPlotOption( QString( "Colour(ticks1)=%1" ).arg( si( Element::TickLines1 ) ) );
+    sgp->setPlotOption( QString( "Colour(ticks2)=%1" ).arg( si( Element::TickLines2 ) ) );
+    sgp->setPlotOption( QString( "Colour(NumLab1)=%1" ).arg( si( Element::NumText1 ) ) );
+    sgp->setPlotOption( QString( "Colour(NumLab2)=%1" ).arg( si( Element::NumText2 ) ) );
+    sgp->setPlotOption( QString( "Colour(TextLab1)=%1" ).arg( si( Element::LabelText1 ) ) );
+    sgp->setPlotOption( QString( "Colour(TextLab2)=%1" ).arg( si( Element::LabelText2 ) ) );
 
-    sgp.setShadowPenIndex( si( Element::Shadow ) );
+    sgp->setShadowPenIndex( si( Element::Shadow ) );
 
 
 
-//    sgp.setPlotOption( "Format(1)=\"+tms.10\"");
-//            sgp.setPlotOption( "Format(1)=\"gtms\"");
+//    sgp->setPlotOption( "Format(1)=\"+tms.10\"");
+//            sgp->setPlotOption( "Format(1)=\"gtms\"");
     // grid density
-    sgp.setDensityModifier( m_gridDensity );
-
-
-
-    // do the actual plot
-    bool plotSuccess = sgp.plot();
-//    qDebug() << "plotSuccess=" << plotSuccess;
-//    qDebug() << "plotError=" << sgp.getError();
-    if( ! plotSuccess) {
-        qWarning() << "Grid rendering error:" << sgp.getError();
-    }
-
-    //qDebug() << "Grid rendered in " << t.elapsed() / 1000.0 << "s";
-
-    // Report the result.
-    emit done( m_vgc.vgList(), m().lastSubmittedJobId );
-} // startRendering
+    sgp->setDensityModifier( m_gridDensity );
+}
 
 void AstWcsGridRenderService::setAxisDisplayInfo( std::vector<Carta::Lib::AxisDisplayInfo> displayInfos ){
     if ( displayInfos.size() != m_axisDisplayInfos.size()){
         m_axisDisplayInfos = displayInfos;
         m_vgValid = false;
+        m().linesValid = false;
     }
     else {
         int infoCount = displayInfos.size();
@@ -400,6 +502,7 @@ void AstWcsGridRenderService::setAxisDisplayInfo( std::vector<Carta::Lib::AxisDi
             if ( displayInfos[i] != m_axisDisplayInfos[i] ){
                 m_axisDisplayInfos[i] = displayInfos[i];
                 m_vgValid = false;
+                m().linesValid = false;
             }
         }
     }
@@ -409,6 +512,7 @@ void AstWcsGridRenderService::setAxisDisplayInfo( std::vector<Carta::Lib::AxisDi
 void AstWcsGridRenderService::setAxesVisible( bool flag ){
     if ( m_axes != flag ){
         m_vgValid = false;
+        m().linesValid = false;
         m_axes = flag;
     }
 }
@@ -419,6 +523,7 @@ AstWcsGridRenderService::setGridDensityModifier( double density )
     if ( m_gridDensity != density ) {
         m_gridDensity = density;
         m_vgValid = false;
+        m().linesValid = false;
     }
 }
 
@@ -427,6 +532,7 @@ AstWcsGridRenderService::setInternalLabels( bool flag )
 {
     if ( m_internalLabels != flag ) {
         m_vgValid = false;
+        m().linesValid = false;
         m_internalLabels = flag;
     }
 }
@@ -435,6 +541,7 @@ void
 AstWcsGridRenderService::setGridLinesVisible( bool flag ){
     if ( m_gridLines != flag ){
         m_vgValid = false;
+        m().linesValid = false;
         m_gridLines = flag;
     }
 }
@@ -446,6 +553,7 @@ AstWcsGridRenderService::setSkyCS( Carta::Lib::KnownSkyCS cs )
     // from the last one
     if ( m().knownSkyCS != cs ) {
         m_vgValid = false;
+        m().linesValid = false;
         m().knownSkyCS = cs;
     }
 }
@@ -481,6 +589,7 @@ void AstWcsGridRenderService::setAxisLabelInfo( int axisIndex, const Carta::Lib:
 
     if ( m_labelInfos[axisIndex] != labelInfo ){
         m_vgValid = false;
+        m().linesValid = false;
         m_labelInfos[axisIndex] = labelInfo;
     }
 }
@@ -491,6 +600,7 @@ AstWcsGridRenderService::setAxisLabel( int axisIndex, const QString& label ){
     CARTA_ASSERT( !label.isEmpty() );
     if ( m_labels[axisIndex] != label ){
         m_vgValid = false;
+        m().linesValid = false;
         m_labels[axisIndex] = label;
     }
 }
@@ -564,6 +674,7 @@ AstWcsGridRenderService::setFont( Carta::Lib::IWcsGridRenderService::Element e,
 
     if ( m().fonts[ind] != fontInfo ) {
         m_vgValid = false;
+        m().linesValid = false;
         m().fonts[ind] = fontInfo;
     }
 }
@@ -573,6 +684,7 @@ AstWcsGridRenderService::setEmptyGrid( bool flag )
 {
     if ( m_emptyGridFlag != flag ) {
         m_vgValid = false;
+        m().linesValid = false;
         m_emptyGridFlag = flag;
     }
 }
@@ -583,6 +695,7 @@ AstWcsGridRenderService::setTickLength( double length )
     CARTA_ASSERT( length >= 0 );
     if ( m_tickLength != length ){
         m_vgValid = false;
+        m().linesValid = false;
         m_tickLength = length;
     }
 }
@@ -592,6 +705,7 @@ AstWcsGridRenderService::setTicksVisible( bool flag )
 {
     if ( m_ticks != flag ){
         m_vgValid = false;
+        m().linesValid = false;
         m_ticks = flag;
     }
 }
@@ -106,6 +106,8 @@ private:
     QString _getDisplayLocation( const Carta::Lib::AxisLabelInfo::Locations& labelLocation ) const;
 
     QString _getSystem();
+    //Apply the current settings to a plotter, except for the input/output rectangles.
+    void _configure( WcsPlotterPluginNS::AstGridPlotter* sgp );
     //Don't draw tick marks.
     void _turnOffTicks(WcsPlotterPluginNS::AstGridPlotter* sgp);
     //Don't label a particular axis
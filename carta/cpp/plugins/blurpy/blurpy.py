@@ -29,4 +29,10 @@ def no_preRenderHook(w, h, data):
 # grayscale blur:
 #    myShape[...] = ndimage.gaussian_filter( myShape, sigma=5)
 
+def no_preRenderRawHook(frame):
+    # frame is a float32 numpy array (rows x columns) sharing memory with the
+    # raw data, so filter it in place (or return a new array of the same shape)
+    print("preRenderRawHook from blurpy.py", frame.shape)
+    ndimage.gaussian_filter( frame, sigma=2, output=frame)
+
 print("end of blurpy.py")
@@ -2,6 +2,7 @@
 #include "PyCppPlugin.h"
 #include "pluginBridge.h"
 #include "CartaLib/Hooks/ColormapsScalar.h"
+#include "CartaLib/Hooks/PreRenderRaw.h"
 #include <QPainter>
 #include <QDebug>
 #include <dlfcn.h>
@@ -56,6 +57,22 @@ static void enableCtrlC()
     qDebug() << "old sigint:" << (void *)(oldSigIntAction.sa_handler);
 }
 
+/// holds the python GIL for its lifetime
+///
+/// The GIL is released after initialization, so python code only runs while one of
+/// these is alive, and other threads are free to run while we are in C++. Every call
+/// into pluginBridge (or any other python API) has to be wrapped in one.
+class GilLock
+{
+public:
+    GilLock() : m_state( PyGILState_Ensure()) {}
+    ~GilLock() { PyGILState_Release( m_state); }
+    GilLock( const GilLock &) = delete;
+    GilLock & operator = ( const GilLock &) = delete;
+private:
+    PyGILState_STATE m_state;
+};
+
 /// initializes the python bridge
 /// only does the initialization on the first call, subsequent calls are ignored
 static void initPythonBridgeOnce()
@@ -67,12 +84,16 @@ static void initPythonBridgeOnce()
     dlopen("libpython2.7.so", RTLD_LAZY | RTLD_GLOBAL);
 
     Py_InitializeEx( 0); // make ctrl-c work?
+    PyEval_InitThreads();
 
     // try to enable ctrl-c...
     enableCtrlC();
 
     // call cython generated code (pluginBridge.pyx)
     initpluginBridge();
+
+    // release the GIL, from now on it is only taken by GilLock
+    PyEval_SaveThread();
 }
 
 PyCppPlug::PyCppPlug(const LoadPlugin::Params & params)
@@ -97,6 +118,7 @@ PyCppPlug::PyCppPlug(const LoadPlugin::Params & params)
     qDebug() << "Asking python to load" << fname;
     std::string cfname = fname.toStdString();
     std::string cfmodname = params.json.name.toStdString();
+    GilLock gil;
     m_pyModId = pb_loadModule( cfname, cfmodname);
 //    m_pyModId = pb_loadModule( fname.toStdString(), params.json.name.toStdString());
     qDebug() << "m_pyModId=" << m_pyModId;
@@ -119,10 +141,12 @@ public:
     ColormapHelper( int pluginId, PyObject * obj) {
         m_pluginId = pluginId;
         m_pyObj = obj;
+        GilLock gil;
         Py_XINCREF( m_pyObj);
     }
 
     virtual ~ColormapHelper() {
+        GilLock gil;
         Py_XDECREF( m_pyObj);
     }
 
@@ -131,10 +155,12 @@ public:
 
     virtual QString name() override
     {
+        GilLock gil;
         return pb_colormapScalarGetName( m_pyObj).c_str();
     }
     virtual void convert(norm_double val, NormRgb & nrgb) override
     {
+        GilLock gil;
         pb_colormapScalarConvert( m_pyObj, val, & nrgb[0]);
     }
 };
@@ -160,16 +186,28 @@ bool PyCppPlug::handleHook(BaseHook & hookData)
         p.drawText( hook.paramsPtr->imgPtr->rect(), Qt::AlignLeft | Qt::AlignTop, txt);
 
         QImage & img = * (hook.paramsPtr->imgPtr);
+        GilLock gil;
         pb_callPreRenderHook( m_pyModId, img.width(), img.height(),
                               img.bytesPerLine(), img.bits());
 
         return true;
     }
 
+    if( hookData.is<Carta::Lib::Hooks::PreRenderRawHook>()) {
+        Carta::Lib::Hooks::PreRenderRawHook & hook =
+                static_cast<Carta::Lib::Hooks::PreRenderRawHook &>( hookData);
+        auto & params = * hook.paramsPtr;
+        // the whole frame goes to python in one call, wrapped as a numpy array
+        // without copying
+        GilLock gil;
+        return pb_callPreRenderRawHook( m_pyModId, params.width, params.height, params.data);
+    }
+
     if( hookData.is<Carta::Lib::Hooks::ColormapsScalarHook>()) {
         Carta::Lib::Hooks::ColormapsScalarHook & hook =
                 static_cast<Carta::Lib::Hooks::ColormapsScalarHook &>( hookData);
         // get the list of raw python objects representing the colormaps
+        GilLock gil;
         std::vector<PyObject*> rawList = pb_colormapScalarGetColormaps( m_pyModId);
         qDebug() << "found" << rawList.size() << "colormaps";
         // wrap them up
@@ -187,11 +225,16 @@ bool PyCppPlug::handleHook(BaseHook & hookData)
 std::vector<HookId> PyCppPlug::getInitialHookList()
 {
     // compile the list of hooks
+    GilLock gil;
     std::vector<HookId> list;
     if( pb_hasPreRenderHook( m_pyModId)) {
         list.push_back( PreRender::staticId);
     }
 
+    if( pb_hasPreRenderRawHook( m_pyModId)) {
+        list.push_back( Carta::Lib::Hooks::PreRenderRawHook::staticId);
+    }
+
     if( pb_hasColormapScalarHook( m_pyModId)) {
         qWarning() << "PyCppPlug: has colormaps";
         list.push_back( Carta::Lib::Hooks::ColormapsScalarHook::staticId);
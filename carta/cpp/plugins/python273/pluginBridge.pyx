@@ -126,6 +126,31 @@ cdef public bool pb_callPreRenderHook( int id, int w, int h, int stride, unsigne
 
     return True
 
+# check if the plugin wants to filter raw frames
+cdef public bool pb_hasPreRenderRawHook( int id):
+    if not id in mods:
+        return False
+    return hasattr(mods[id].loadedMod, 'preRenderRawHook')
+
+# run the raw frame filter of the plugin on a whole frame
+# the float32 frame (h rows of w values, bottom row first) is wrapped in a numpy
+# array without copying; the hook can modify it in place, or return a new array,
+# which is then copied back into the frame with a single numpy call
+cdef public bool pb_callPreRenderRawHook( int id, int w, int h, float * data):
+    if not id in mods:
+        print("!!! could not find mod", id)
+        return False
+    cdef float[:,::1] mv = <float[:h,:w]> data
+    frame = np.asarray( mv)
+    try:
+        result = mods[id].loadedMod.preRenderRawHook( frame)
+        if result is not None and result is not frame:
+            np.copyto( frame, np.asarray( result, dtype=np.float32).reshape( h, w))
+    except Exception as e:
+        print("preRenderRawHook failed:", e)
+        return False
+    return True
+
 # # pyData = data
 # print( "Last line of pluginBridge.pyx...." )
 
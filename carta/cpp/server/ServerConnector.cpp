@@ -2,6 +2,7 @@
 #include "core/MyQApp.h"
 #include "core/Globals.h"
 #include "CartaLib/Hooks/GetInitialFileList.h"
+#include "CartaLib/Trace.h"
 #include "core/SimpleRemoteVGView.h"
 
 #include <QTimer>
@@ -40,6 +41,7 @@ public:
     }
     virtual void RenderView(CSI::PureWeb::Server::RenderTarget target) Q_DECL_OVERRIDE
     {
+        CARTA_TRACE_SCOPE( "connector", "RenderView" );
         CSI::ByteArray bits = target.RenderTargetImage().ImageBytes();
 
         const QImage & qimage = m_iview->getBuffer();
@@ -368,6 +370,7 @@ void ServerConnector::registerView(IView *view)
 
 qint64 ServerConnector::refreshView(IView *view)
 {
+    CARTA_TRACE_SCOPE( "connector", "refreshView" );
     auto pwview = m_pwviews.find( view-> name());
     if( pwview == m_pwviews.end()) {
         qCritical() << "ServerConnector::refreshView::could not find this view";
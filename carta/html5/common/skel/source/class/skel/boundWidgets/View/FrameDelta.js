@@ -0,0 +1,170 @@
+/**
+ * Decoder for the frame delta packets of animated views.
+ *
+ * The format is described in CartaLib/Algorithms/FrameDelta.h. The decoder keeps
+ * the current frame and applies each packet to it; a delta that does not follow
+ * the current frame is rejected and the frame stays invalid until a keyframe.
+ */
+
+qx.Class.define( "skel.boundWidgets.View.FrameDelta", {
+
+    extend: qx.core.Object,
+
+    construct: function() {
+        this.base( arguments );
+    },
+
+    statics: {
+        MAGIC: "CFD1",
+        FLAG_KEYFRAME: 1
+    },
+
+    members: {
+
+        /**
+         * Apply a packet to the current frame.
+         * @param buffer {ArrayBuffer} the packet.
+         * @return {Boolean} true if the packet was valid and applied.
+         */
+        decode: function( buffer ) {
+            var bytes = new Uint8Array( buffer );
+            var pos = 0;
+            var end = bytes.length;
+            var ok = true;
+
+            var fail = function() {
+                ok = false;
+                pos = end;
+            };
+            var varint = function() {
+                var value = 0;
+                var mult = 1;
+                for ( var i = 0; i < 8; i++ ) {
+                    if ( pos >= end ) {
+                        fail();
+                        return 0;
+                    }
+                    var b = bytes[pos++];
+                    value += ( b & 0x7f ) * mult;
+                    if ( !( b & 0x80 ) ) {
+                        return value;
+                    }
+                    mult *= 128;
+                }
+                fail();
+                return 0;
+            };
+
+            var magic = skel.boundWidgets.View.FrameDelta.MAGIC;
+            if ( bytes.length <= magic.length ) {
+                return false;
+            }
+            for ( var m = 0; m < magic.length; m++ ) {
+                if ( bytes[m] !== magic.charCodeAt( m ) ) {
+                    return false;
+                }
+            }
+            pos = magic.length;
+            var keyframe = ( bytes[pos++] & skel.boundWidgets.View.FrameDelta.FLAG_KEYFRAME ) !== 0;
+            var frameNumber = varint();
+            var width = varint();
+            var height = varint();
+            var tileSize = varint();
+            var tileCount = varint();
+            if ( !ok || tileSize <= 0 ) {
+                return false;
+            }
+
+            if ( keyframe ) {
+                this.m_pixels = new Uint8Array( width * height * 4 );
+                this.m_width = width;
+                this.m_height = height;
+            }
+            else if ( this.m_pixels === null || this.m_width !== width ||
+                      this.m_height !== height || frameNumber !== this.m_frameNumber + 1 ) {
+                return false;
+            }
+
+            var pixels = this.m_pixels;
+            var cols = Math.ceil( width / tileSize );
+            var gridTiles = cols * Math.ceil( height / tileSize );
+            var index = -1;
+            for ( var t = 0; t < tileCount; t++ ) {
+                index += varint();
+                var packedSize = varint();
+                var tileEnd = pos + packedSize;
+                if ( !ok || index >= gridTiles || tileEnd > end ) {
+                    this.m_pixels = null;
+                    return false;
+                }
+                var x0 = ( index % cols ) * tileSize;
+                var y0 = Math.floor( index / cols ) * tileSize;
+                var tileWidth = Math.min( tileSize, width - x0 );
+                var byteCount = tileWidth * Math.min( tileSize, height - y0 ) * 4;
+                var rowBytes = tileWidth * 4;
+                var tileEndSaved = end;
+                end = tileEnd;
+                var offset = 0;
+                while ( ok && offset < byteCount ) {
+                    offset += varint();
+                    var literals = varint();
+                    if ( !ok || pos + literals > end || offset + literals > byteCount ) {
+                        fail();
+                        break;
+                    }
+                    for ( var k = 0; k < literals; k++, offset++ ) {
+                        var row = Math.floor( offset / rowBytes );
+                        var target = ( ( y0 + row ) * width + x0 ) * 4 + offset - row * rowBytes;
+                        pixels[target] ^= bytes[pos++];
+                    }
+                }
+                end = tileEndSaved;
+                if ( !ok ) {
+                    this.m_pixels = null;
+                    return false;
+                }
+                pos = tileEnd;
+            }
+            this.m_frameNumber = frameNumber;
+            return true;
+        },
+
+        /**
+         * Draw the current frame.
+         * @param ctx {Object} canvas 2d context.
+         * @return {Boolean} false if there is no valid frame to draw.
+         */
+        draw: function( ctx ) {
+            if ( this.m_pixels === null || this.m_width === 0 || this.m_height === 0 ) {
+                return false;
+            }
+            var image = ctx.createImageData( this.m_width, this.m_height );
+            var out = image.data;
+            var pixels = this.m_pixels;
+            // stored as premultiplied b, g, r, a; image data is straight r, g, b, a
+            for ( var i = 0; i < pixels.length; i += 4 ) {
+                var alpha = pixels[i + 3];
+                var scale = alpha > 0 ? 255 / alpha : 0;
+                out[i] = pixels[i + 2] * scale;
+                out[i + 1] = pixels[i + 1] * scale;
+                out[i + 2] = pixels[i] * scale;
+                out[i + 3] = alpha;
+            }
+            ctx.putImageData( image, 0, 0 );
+            return true;
+        },
+
+        /**
+         * Returns the number of the current frame.
+         * @return {Number} the frame number, -1 before the first keyframe.
+         */
+        getFrameNumber: function() {
+            return this.m_frameNumber;
+        },
+
+        m_pixels: null,
+        m_width: 0,
+        m_height: 0,
+        m_frameNumber: -1
+    }
+});
@@ -0,0 +1,415 @@
+/**
+ * Decoder for packed binary vector graphics streams produced by the server.
+ *
+ * The format is described in CartaLib/VectorGraphics/VGStream.h. A stream can be
+ * decoded into a list of commands, or drawn straight onto a canvas 2d context.
+ */
+
+qx.Class.define( "skel.boundWidgets.View.VGStream", {
+
+    type: "static",
+
+    statics: {
+
+        /**
+         * Opcodes, in the same order as VGOp on the server.
+         */
+        OPS: [ null, "reset", "drawLine", "drawPolyline", "setPenWidth", "setPenColor",
+               "setPen", "setFontIndex", "setFontSize", "save", "restore", "setTransform",
+               "fillRect", "drawRect", "drawText", "storeIndexedPen", "setIndexedPen",
+               "storeIndexedBrush", "setIndexedBrush", "setBrush", "setClipRect" ],
+
+        FONTS: [ "Helvetica", "Monospace", "Courier", "Purisa" ],
+
+        /**
+         * Convert a base64 encoded stream to an ArrayBuffer.
+         * @param str {String} base64 data.
+         * @return {ArrayBuffer} the raw stream.
+         */
+        fromBase64: function( str ) {
+            var bin = window.atob( str );
+            var bytes = new Uint8Array( bin.length );
+            for ( var i = 0; i < bin.length; i++ ) {
+                bytes[i] = bin.charCodeAt( i );
+            }
+            return bytes.buffer;
+        },
+
+        /**
+         * Decode a stream into a list of commands.
+         * @param buffer {ArrayBuffer} the stream.
+         * @return {Object} {ok: whether the whole stream was valid, ops: list of commands,
+         *      each an object with an 'op' name and its arguments}.
+         */
+        decode: function( buffer ) {
+            var view = new DataView( buffer );
+            var pos = 0;
+            var ok = true;
+            var scale = 0;
+            var pens = [];
+            var brushes = [];
+            var ops = [];
+
+            var fail = function() {
+                ok = false;
+                pos = view.byteLength;
+            };
+            var u8 = function() {
+                if ( pos + 1 > view.byteLength ) {
+                    fail();
+                    return 0;
+                }
+                return view.getUint8( pos++ );
+            };
+            var u32 = function() {
+                if ( pos + 4 > view.byteLength ) {
+                    fail();
+                    return 0;
+                }
+                var v = view.getUint32( pos, true );
+                pos += 4;
+                return v;
+            };
+            var real = function() {
+                if ( pos + 4 > view.byteLength ) {
+                    fail();
+                    return 0;
+                }
+                var v = view.getFloat32( pos, true );
+                pos += 4;
+                return v;
+            };
+            var index = function() {
+                var value = 0;
+                var mult = 1;
+                for ( var i = 0; i < 8; i++ ) {
+                    var b = u8();
+                    value += ( b & 0x7f ) * mult;
+                    if ( !( b & 0x80 ) ) {
+                        return value;
+                    }
+                    mult *= 128;
+                }
+                fail();
+                return 0;
+            };
+            var integer = function() {
+                var n = index();
+                return ( n % 2 ) ? -( n + 1 ) / 2 : n / 2;
+            };
+            var count = function( minSize ) {
+                var n = index();
+                if ( n > ( view.byteLength - pos ) / minSize ) {
+                    fail();
+                    return 0;
+                }
+                return n;
+            };
+            var i16 = function() {
+                if ( pos + 2 > view.byteLength ) {
+                    fail();
+                    return 0;
+                }
+                var v = view.getInt16( pos, true );
+                pos += 2;
+                return v;
+            };
+            var coord = function() {
+                return scale > 0 ? i16() / scale : real();
+            };
+            var color = function() {
+                var argb = u32();
+                return "rgba(" + ( ( argb >>> 16 ) & 0xff ) + "," + ( ( argb >>> 8 ) & 0xff ) + ","
+                    + ( argb & 0xff ) + "," + ( ( argb >>> 24 ) / 255 ) + ")";
+            };
+            var rect = function() {
+                var x = coord();
+                var y = coord();
+                var w = coord();
+                return [ x, y, w, coord() ];
+            };
+            var polyline = function() {
+                var n = count( 2 );
+                var pts = new Float32Array( n * 2 );
+                if ( n === 0 ) {
+                    return pts;
+                }
+                if ( scale > 0 ) {
+                    var x = i16();
+                    var y = i16();
+                    pts[0] = x / scale;
+                    pts[1] = y / scale;
+                    for ( var i = 1; i < n; i++ ) {
+                        x += integer();
+                        y += integer();
+                        pts[2 * i] = x / scale;
+                        pts[2 * i + 1] = y / scale;
+                    }
+                }
+                else {
+                    for ( var j = 0; j < 2 * n; j++ ) {
+                        pts[j] = real();
+                    }
+                }
+                return pts;
+            };
+            var tableEntry = function( table ) {
+                var ind = index();
+                if ( ind >= table.length ) {
+                    fail();
+                    return null;
+                }
+                return table[ind];
+            };
+
+            // header
+            var magic = "";
+            for ( var m = 0; m < 4; m++ ) {
+                magic += String.fromCharCode( u8() );
+            }
+            if ( magic !== "VGS1" ) {
+                return { ok: false, ops: [] };
+            }
+            if ( u8() & 1 ) {
+                scale = real();
+                if ( !( scale > 0 ) ) {
+                    fail();
+                }
+            }
+            var nPens = count( 8 );
+            for ( var p = 0; p < nPens; p++ ) {
+                pens.push( { color: color(), width: real(), style: u8(), cap: u8(),
+                             join: u8(), cosmetic: u8() } );
+            }
+            var nBrushes = count( 5 );
+            for ( var b = 0; b < nBrushes; b++ ) {
+                brushes.push( { color: color(), style: u8() } );
+            }
+
+            // commands
+            while ( ok && pos < view.byteLength ) {
+                var name = this.OPS[ u8() ];
+                var cmd = { op: name };
+                switch ( name ) {
+                case "reset":
+                case "save":
+                case "restore":
+                    break;
+                case "drawLine":
+                    cmd.x1 = coord();
+                    cmd.y1 = coord();
+                    cmd.x2 = coord();
+                    cmd.y2 = coord();
+                    break;
+                case "drawPolyline":
+                    cmd.points = polyline();
+                    break;
+                case "setPenWidth":
+                    cmd.width = real();
+                    break;
+                case "setPenColor":
+                    cmd.color = color();
+                    break;
+                case "setPen":
+                    cmd.pen = tableEntry( pens );
+                    break;
+                case "setFontIndex":
+                    cmd.index = index();
+                    break;
+                case "setFontSize":
+                    cmd.size = real();
+                    break;
+                case "setTransform":
+                    cmd.matrix = [ real(), real(), real(), real(), real(), real() ];
+                    cmd.combine = u8() !== 0;
+                    break;
+                case "fillRect":
+                    cmd.rect = rect();
+                    cmd.color = color();
+                    break;
+                case "drawRect":
+                case "setClipRect":
+                    cmd.rect = rect();
+                    break;
+                case "drawText":
+                    var len = count( 1 );
+                    var bytes = new Uint8Array( buffer, pos, len );
+                    pos += len;
+                    cmd.text = decodeURIComponent( escape( String.fromCharCode.apply( null, bytes ) ) );
+                    cmd.x = coord();
+                    cmd.y = coord();
+                    break;
+                case "storeIndexedPen":
+                    cmd.index = index();
+                    cmd.pen = tableEntry( pens );
+                    break;
+                case "storeIndexedBrush":
+                    cmd.index = index();
+                    cmd.brush = tableEntry( brushes );
+                    break;
+                case "setIndexedPen":
+                case "setIndexedBrush":
+                    cmd.index = index();
+                    break;
+                case "setBrush":
+                    cmd.brush = tableEntry( brushes );
+                    break;
+                default:
+                    console.warn( "Unknown VG stream opcode" );
+                    fail();
+                }
+                if ( ok ) {
+                    ops.push( cmd );
+                }
+            }
+            return { ok: ok, ops: ops };
+        },
+
+        /**
+         * Draw a stream onto a canvas.
+         * @param buffer {ArrayBuffer} the stream.
+         * @param ctx {CanvasRenderingContext2D} where to draw.
+         * @return {Boolean} whether the whole stream was valid.
+         */
+        render: function( buffer, ctx ) {
+            var decoded = this.decode( buffer );
+            var fonts = this.FONTS;
+            var defaultPen = { color: "rgba(255,0,0,1)", width: 1, style: 1, cap: 0, join: 0, cosmetic: 1 };
+            var state = null;
+            var stack = [];
+
+            var reset = function() {
+                ctx.setTransform( 1, 0, 0, 1, 0, 0 );
+                state = { pen: defaultPen, brush: { color: "rgba(0,0,0,1)", style: 0 },
+                          pens: [], brushes: [], font: 0, fontSize: 10 };
+                ctx.font = state.fontSize + "pt " + fonts[state.font];
+            };
+            var applyPen = function() {
+                var pen = state.pen;
+                var width = pen.width > 0 ? pen.width : 1;
+                ctx.strokeStyle = pen.color;
+                ctx.lineWidth = width;
+                ctx.lineCap = [ "butt", "square", "round" ][pen.cap] || "butt";
+                ctx.lineJoin = [ "miter", "bevel", "round" ][pen.join] || "miter";
+                if ( pen.style === 2 ) {
+                    ctx.setLineDash( [ 4 * width, 2 * width ] );
+                }
+                else if ( pen.style === 3 ) {
+                    ctx.setLineDash( [ width, 2 * width ] );
+                }
+                else {
+                    ctx.setLineDash( [] );
+                }
+                return pen.style !== 0;
+            };
+            var setFont = function() {
+                ctx.font = state.fontSize + "pt " + ( fonts[state.font] || fonts[0] );
+            };
+
+            reset();
+            decoded.ops.forEach( function( cmd ) {
+                var r = cmd.rect;
+                switch ( cmd.op ) {
+                case "reset":
+                    reset();
+                    break;
+                case "save":
+                    stack.push( qx.lang.Object.clone( state ) );
+                    ctx.save();
+                    break;
+                case "restore":
+                    if ( stack.length > 0 ) {
+                        state = stack.pop();
+                        ctx.restore();
+                    }
+                    break;
+                case "drawLine":
+                    if ( applyPen() ) {
+                        ctx.beginPath();
+                        ctx.moveTo( cmd.x1, cmd.y1 );
+                        ctx.lineTo( cmd.x2, cmd.y2 );
+                        ctx.stroke();
+                    }
+                    break;
+                case "drawPolyline":
+                    var pts = cmd.points;
+                    if ( pts.length >= 4 && applyPen() ) {
+                        ctx.beginPath();
+                        ctx.moveTo( pts[0], pts[1] );
+                        for ( var i = 2; i < pts.length; i += 2 ) {
+                            ctx.lineTo( pts[i], pts[i + 1] );
+                        }
+                        ctx.stroke();
+                    }
+                    break;
+                case "setPenWidth":
+                    state.pen = qx.lang.Object.clone( state.pen );
+                    state.pen.width = cmd.width;
+                    break;
+                case "setPenColor":
+                    state.pen = qx.lang.Object.clone( state.pen );
+                    state.pen.color = cmd.color;
+                    break;
+                case "setPen":
+                    state.pen = cmd.pen;
+                    break;
+                case "setFontIndex":
+                    state.font = cmd.index;
+                    setFont();
+                    break;
+                case "setFontSize":
+                    state.fontSize = cmd.size;
+                    setFont();
+                    break;
+                case "setTransform":
+                    var m = cmd.matrix;
+                    if ( cmd.combine ) {
+                        ctx.transform( m[0], m[1], m[2], m[3], m[4], m[5] );
+                    }
+                    else {
+                        ctx.setTransform( m[0], m[1], m[2], m[3], m[4], m[5] );
+                    }
+                    break;
+                case "fillRect":
+                    ctx.fillStyle = cmd.color;
+                    ctx.fillRect( r[0], r[1], r[2], r[3] );
+                    break;
+                case "drawRect":
+                    if ( state.brush.style !== 0 ) {
+                        ctx.fillStyle = state.brush.color;
+                        ctx.fillRect( r[0], r[1], r[2], r[3] );
+                    }
+                    if ( applyPen() ) {
+                        ctx.strokeRect( r[0], r[1], r[2], r[3] );
+                    }
+                    break;
+                case "drawText":
+                    ctx.fillStyle = state.pen.color;
+                    ctx.fillText( cmd.text, cmd.x, cmd.y );
+                    break;
+                case "storeIndexedPen":
+                    state.pens[cmd.index] = cmd.pen;
+                    break;
+                case "setIndexedPen":
+                    state.pen = state.pens[cmd.index] || defaultPen;
+                    break;
+                case "storeIndexedBrush":
+                    state.brushes[cmd.index] = cmd.brush;
+                    break;
+                case "setIndexedBrush":
+                    state.brush = state.brushes[cmd.index] || state.brush;
+                    break;
+                case "setBrush":
+                    state.brush = cmd.brush;
+                    break;
+                case "setClipRect":
+                    ctx.beginPath();
+                    ctx.rect( r[0], r[1], r[2], r[3] );
+                    ctx.clip();
+                    break;
+                }
+            } );
+            return decoded.ok;
+        }
+    }
+});
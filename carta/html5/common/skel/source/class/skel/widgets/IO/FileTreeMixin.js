@@ -72,8 +72,10 @@ qx.Mixin.define("skel.widgets.IO.FileTreeMixin", {
             this.m_tree.addListener( "changeSelection", function(event){
                 var data = event.getData();
                 if ( data.length > 0 ){
-                    var nodeLabel = data[0].getLabel();
-                    this._nodeSelected( nodeLabel );
+                    //The label may carry the header summary, the model has the
+                    //plain name.
+                    var nodeName = data[0].getModel().getName();
+                    this._nodeSelected( nodeName );
                 }
             }, this );
             this.m_tree.setWidth(300);
@@ -134,6 +136,26 @@ qx.Mixin.define("skel.widgets.IO.FileTreeMixin", {
             return directory;
         },
         
+        /**
+         * Returns the display text of a tree node: the name followed by the
+         * FITS header summary (shape, object, unit) once the server has read it.
+         * @param node {Object} - a file or directory from the server.
+         * @return {String} - the text to display for the node.
+         */
+        _makeLabel : function( node ){
+            var label = node.name;
+            if ( typeof node.shape != "undefined" ){
+                label = label + " [" + node.shape + "]";
+            }
+            if ( typeof node.object != "undefined" ){
+                label = label + " " + node.object;
+            }
+            if ( typeof node.unit != "undefined" ){
+                label = label + " (" + node.unit + ")";
+            }
+            return label;
+        },
+        
         /**
          * Update the tree with the new data.
          * @param anObject {skel.widgets.FileBrowser}.
@@ -180,10 +202,18 @@ qx.Mixin.define("skel.widgets.IO.FileTreeMixin", {
             this.m_path = this.m_jsonObj.name;
             this.m_dirText.setValue( this.m_path );
             this.m_jsonObj.name = "..";
+            this.m_jsonObj.label = this.m_jsonObj.name;
+            var nodeCount = 0;
+            if ( typeof this.m_jsonObj.dir != "undefined" ){
+                nodeCount = this.m_jsonObj.dir.length;
+            }
+            for ( var i = 0; i < nodeCount; i++ ){
+                this.m_jsonObj.dir[i].label = this._makeLabel( this.m_jsonObj.dir[i] );
+            }
             var jsonModel = qx.data.marshal.Json.createModel( this.m_jsonObj);
             if ( this.m_controller === null ){
                 this.m_controller = new qx.data.controller.Tree(jsonModel,
-                        this.m_tree, "dir", "name");
+                        this.m_tree, "dir", "label");
             }
             else {
                 this.m_controller.setModel( jsonModel );
@@ -207,15 +237,29 @@ qx.Mixin.define("skel.widgets.IO.FileTreeMixin", {
          */
         _updateTree : function(dataTree) {
             this.m_jsonObj = qx.lang.Json.parse(dataTree);
+            var complete = this.m_jsonObj.complete;
+            var metadataPending = this.m_jsonObj.metadataPending;
             this._resetModel();
             var errorMan = skel.widgets.ErrorHandler.getInstance();
             errorMan.clearErrors();
+            //The server is still reading the directory or the FITS headers of the
+            //files in it so ask again in a little while, unless the user has moved
+            //on to another directory.
+            if ( complete === false || metadataPending > 0 ){
+                var dirPath = this.m_path;
+                qx.event.Timer.once( function(){
+                    if ( this.m_path == dirPath ){
+                        this._initData( dirPath );
+                    }
+                }, this, this.m_pollInterval );
+            }
         },
         
         
         m_dirText : null,
         m_fileText : null,
         m_path : null,
+        m_pollInterval : 500,
         m_treeDisplay : null,
         m_connector : null,
         m_controller : null,
@@ -279,6 +279,124 @@ class Cartavis:
         result = self.con.cmdTagList("getPluginList")
         return result
 
+    def getHookStats(self, reset=False):
+        """
+        Returns timing information about the plugin hooks dispatched so far.
+        This is a debugging command.
+
+        Parameters
+        ----------
+        reset: boolean
+            Clear the statistics after reading them.
+
+        Returns
+        -------
+        list
+            One string per hook with its name, number of calls, number of
+            calls answered from the memo, total and longest dispatch time.
+        """
+        result = self.con.cmdTagList("getHookStats", reset=reset)
+        return result
+
+    def getFrameCacheStats(self, reset=False):
+        """
+        Returns usage information about the frame cache shared by all
+        image views. This is a debugging command.
+
+        Parameters
+        ----------
+        reset: boolean
+            Clear the hit and miss counters after reading them.
+
+        Returns
+        -------
+        list
+            One string per cache tier (colour-mapped frames and composited
+            viewport images) with its hits, misses, hit ratio, number of
+            entries and bytes used, followed by the total budget in bytes.
+        """
+        result = self.con.cmdTagList("getFrameCacheStats", reset=reset)
+        return result
+
+    def getMemoryUsage(self):
+        """
+        Returns the memory held by caches and large buffers, as accounted
+        by the server's memory governor. This is a debugging command.
+
+        Returns
+        -------
+        list
+            One string per memory consumer with its name, bytes held,
+            peak bytes and whether it can be evicted, followed by the
+            budget, the total bytes used and the number of evictions so
+            far. The governor never refuses memory, so the bytes used
+            can exceed the budget.
+        """
+        result = self.con.cmdTagList("getMemoryUsage")
+        return result
+
+    def getImageMemory(self):
+        """
+        Returns the memory used by the images that are open in any
+        session. Images are shared between views and sessions, so each
+        file is listed once. This is a debugging command.
+
+        Returns
+        -------
+        list
+            One string per open image with its path, number of handles,
+            bytes of pixel data, number of cached permuted views and
+            number of cached clip entries.
+        """
+        result = self.con.cmdTagList("getImageMemory")
+        return result
+
+    def setTracing(self, enabled):
+        """
+        Starts or stops recording timings of the server's hot paths, such
+        as rendering, contouring, histograms, profiles and view refreshes.
+        This is a debugging command.
+
+        Parameters
+        ----------
+        enabled: boolean
+            True to start recording, False to stop.
+
+        Returns
+        -------
+        list
+            An empty list.
+        """
+        result = self.con.cmdTagList("setTracing", enabled=enabled)
+        return result
+
+    def getMetrics(self, reset=False, traceFile=""):
+        """
+        Returns the timings and counters recorded since tracing was turned
+        on or last reset. This is a debugging command.
+
+        Parameters
+        ----------
+        reset: boolean
+            Clear the timings, counters and recorded events after reading
+            them.
+        traceFile: string
+            If given, the server also writes its most recent events to this
+            file in the Chrome trace format, which can be opened in
+            chrome://tracing or Perfetto.
+
+        Returns
+        -------
+        list
+            Whether tracing is on, then one string per traced scope with
+            its number of calls and its total, mean and longest time in
+            milliseconds, one string per counter with its value and, if a
+            trace file was requested, the number of events written to it.
+        """
+        result = self.con.cmdTagList("getMetrics", reset=reset,
+                                     traceFile=traceFile)
+        return result
+
     def getEmptyWindowCount(self):
         """
         Returns the number of empty windows in the application.
@@ -25,6 +25,80 @@ class TagConnector:
         self.socket = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
         self.socket.connect(("localhost", self.port))
         self.tagMessageSocket = TagMessageSocket(self.socket)
+        self.nextRequestId = 0
+        self.pendingReplies = {}
+
+    def sendCmd(self, cmd, ** kwargs):
+        """
+        Send a tag message without waiting for the reply.
+
+        Several commands may be sent this way before any of the replies are
+        read back with getReply(), which saves a round-trip per command.
+
+        Parameters
+        ----------
+        cmd: string
+            The name of the command to send.
+        kwargs: dict
+            The arguments to the command, if any.
+
+        Returns
+        -------
+        integer
+            The id of the request, to be passed to getReply().
+        """
+        requestId = self._newRequestId()
+        self.tagMessageSocket.send(
+            JsonMessage.fromKW(cmd=cmd, args=kwargs, id=requestId).toTagMessage())
+        return requestId
+
+    def getReply(self, requestId):
+        """
+        Return the result of a request sent with sendCmd().
+
+        Replies to other requests that arrive first are kept until they are
+        asked for.
+
+        Parameters
+        ----------
+        requestId: integer
+            The id returned by sendCmd().
+
+        Returns
+        -------
+        list
+            The contents of the list vary depending on the command.
+        """
+        while requestId not in self.pendingReplies:
+            tm = self.tagMessageSocket.receive()
+            result = JsonMessage.fromTagMessage(tm)
+            j = json.loads(str(result.jsonString))
+            self.pendingReplies[j.get('id')] = j
+        return self._unwrapReply(self.pendingReplies.pop(requestId))
+
+    def cmdBatch(self, commands):
+        """
+        Send several commands in one message, return a list of results.
+
+        The commands are executed in order on the server, and the views are
+        only re-rendered once for the whole batch, e.g.:
+
+            cmdBatch([("setGridFontSize", {"imageView": v, "fontSize": 12}),
+                      ("setGridSpacing", {"imageView": v, "spacing": 0.5})])
+
+        Parameters
+        ----------
+        commands: list
+            (command name, arguments dict) tuples.
+
+        Returns
+        -------
+        list
+            One result list per command, in the order of the commands.
+        """
+        batch = [{'cmd': cmd, 'args': args} for cmd, args in commands]
+        replies = self.cmdTagList("batch", commands=batch)
+        return [self._unwrapReply(reply) for reply in replies]
 
     def cmdTagList(self, cmd, ** kwargs):
         """
@@ -50,16 +124,7 @@ class TagConnector:
         list
             The contents of the list vary depending on the command.
         """
-        self.tagMessageSocket.send(
-            JsonMessage.fromKW(cmd=cmd, args=kwargs).toTagMessage())
-        tm = self.tagMessageSocket.receive()
-        result = JsonMessage.fromTagMessage(tm)
-        j = json.loads(str(result.jsonString))
-        try:
-            returnValue = j['result']
-        except KeyError:
-            returnValue = j['error']
-        return returnValue
+        return self.getReply(self.sendCmd(cmd, ** kwargs))
 
     def cmdAsyncList(self, cmd, ** kwargs):
         """
@@ -80,11 +145,18 @@ class TagConnector:
         list
             The contents of the list vary depending on the command.
         """
+        requestId = self._newRequestId()
         self.tagMessageSocket.send(
-            JsonMessage.fromKW(cmd=cmd, args=kwargs).toAsyncMessage())
-        tm = self.tagMessageSocket.receive()
-        result = JsonMessage.fromTagMessage(tm)
-        j = json.loads(str(result.jsonString))
+            JsonMessage.fromKW(cmd=cmd, args=kwargs, id=requestId).toAsyncMessage())
+        return self.getReply(requestId)
+
+    def _newRequestId(self):
+        requestId = self.nextRequestId
+        self.nextRequestId += 1
+        return requestId
+
+    @staticmethod
+    def _unwrapReply(j):
         try:
             returnValue = j['result']
         except KeyError:
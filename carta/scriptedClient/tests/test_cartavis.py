@@ -65,6 +65,34 @@ def test_zoomLevel(cartavisInstance, cleanSlate):
     i[0].setZoomLevel(1.1 * oldZoom)
     assert i[0].getZoomLevel() == 1.1 * oldZoom
 
+def test_batch(cartavisInstance, cleanSlate):
+    """
+    Test that a batch of commands is executed in order and that each
+    command gets its own result back, including unknown commands.
+    """
+    i = cartavisInstance.getImageViews()
+    i[0].loadFile(os.getcwd() + '/data/mexinputtest.fits')
+    oldZoom = i[0].getZoomLevel()
+    results = cartavisInstance.con.cmdBatch([
+        ("setZoomLevel", {"imageView": i[0].getId(), "zoomLevel": 2 * oldZoom}),
+        ("getZoomLevel", {"imageView": i[0].getId()}),
+        ("noSuchCommand", {})])
+    assert len(results) == 3
+    assert float(results[1][0]) == 2 * oldZoom
+    assert results[2] == ['Unknown command']
+
+def test_pipelinedReplies(cartavisInstance, cleanSlate):
+    """
+    Test that replies to pipelined commands can be read back in any order.
+    """
+    i = cartavisInstance.getImageViews()
+    i[0].loadFile(os.getcwd() + '/data/mexinputtest.fits')
+    con = cartavisInstance.con
+    dimensionsId = con.sendCmd("getImageDimensions", imageView=i[0].getId())
+    channelsId = con.sendCmd("getChannelCount", imageView=i[0].getId())
+    assert int(con.getReply(channelsId)[0]) == 1
+    assert [int(d) for d in con.getReply(dimensionsId)] == [10, 10]
+
 @flaky(max_runs=10)
 def test_getCoordinates(cartavisInstance, cleanSlate):
     """